@@ -0,0 +1,182 @@
+#ifndef ADAPTIVE_PUBLISH_CONTROLLER_H
+#define ADAPTIVE_PUBLISH_CONTROLLER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Controlador em malha fechada da publicação MQTT.
+// Mede o tempo gasto em cada publish (pressão do socket TLS), a vazão obtida e
+// o RTT até o broker, e ajusta intervalo, qualidade JPEG e escala do frame
+// dentro dos limites de config.h. Não toca no sensor: o stream HTTP mantém as
+// configurações próprias e o publisher transcodifica quando necessário.
+class AdaptivePublishController
+{
+public:
+  void begin()
+  {
+    interval = constrain(MQTT_PUBLISH_INTERVAL, MQTT_PUBLISH_INTERVAL_MIN, MQTT_PUBLISH_INTERVAL_MAX);
+    quality = constrain(MQTT_JPEG_QUALITY, MQTT_JPEG_QUALITY_BEST, MQTT_JPEG_QUALITY_WORST);
+    scale = 0;
+    healthyStreak = 0;
+    publishMsAvg = 0;
+    rttMsAvg = 0;
+    throughputAvg = 0;
+  }
+
+  // Intervalo atual entre publicações (ms)
+  unsigned long getInterval() const { return interval; }
+
+  // Qualidade JPEG atual na escala do sensor (0-63, menor = melhor)
+  int getQuality() const { return quality; }
+
+  // Qualidade equivalente na escala do codificador (fmt2jpg: 1-100, maior = melhor)
+  uint8_t getEncoderQuality() const
+  {
+    return (uint8_t)constrain(100 - (quality * 95) / 63, 1, 100);
+  }
+
+  // Escala de redução: 0 = 1:1, 1 = 1/2, 2 = 1/4, 3 = 1/8
+  uint8_t getScale() const { return scale; }
+
+  // Vale transcodificar um frame do sensor com 'sourceQuality' só se o
+  // controlador reduziu a escala ou pediu qualidade pelo menos um passo pior
+  // que a do frame. Diferenças menores (ex.: qualidade inicial 12 com o stream
+  // em 10) custam um decode completo para economizar poucos bytes.
+  bool needsTranscode(int sourceQuality) const
+  {
+    return scale > 0 || quality >= sourceQuality + QUALITY_STEP;
+  }
+
+  unsigned long getPublishMs() const { return publishMsAvg; }
+  unsigned long getRttMs() const { return rttMsAvg; }
+
+  // Vazão média das publicações em bytes/s
+  unsigned long getThroughput() const { return throughputAvg; }
+
+  // Registra o resultado de uma tentativa de publicação
+  void onPublish(bool ok, size_t bytes, unsigned long elapsedMs)
+  {
+    publishMsAvg = smooth(publishMsAvg, elapsedMs);
+    if (ok && elapsedMs > 0)
+    {
+      throughputAvg = smooth(throughputAvg, (bytes * 1000UL) / elapsedMs);
+    }
+
+    const bool congested = !ok ||
+                           elapsedMs > MQTT_TARGET_PUBLISH_MS ||
+                           rttMsAvg > MQTT_TARGET_RTT_MS;
+    if (congested)
+    {
+      degrade();
+      return;
+    }
+
+    const bool headroom = elapsedMs < MQTT_TARGET_PUBLISH_MS / 2 &&
+                          rttMsAvg < MQTT_TARGET_RTT_MS / 2;
+    if (headroom && ++healthyStreak >= HEALTHY_SAMPLES_TO_IMPROVE)
+    {
+      healthyStreak = 0;
+      improve();
+    }
+  }
+
+  // Frame excedeu MQTT_MAX_FRAME_SIZE mesmo após ajustes: reduz custo por frame
+  void onOversize()
+  {
+    healthyStreak = 0;
+    if (quality < MQTT_JPEG_QUALITY_WORST)
+    {
+      quality = min(quality + QUALITY_STEP, MQTT_JPEG_QUALITY_WORST);
+    }
+    else if (scale < MQTT_FRAME_SCALE_MAX)
+    {
+      scale++;
+    }
+    log("frame grande demais");
+  }
+
+  // Sem memória para o buffer RGB565 da transcodificação: só a escala reduz
+  // o buffer (a qualidade não muda o tamanho decodificado)
+  void onNoMemory()
+  {
+    healthyStreak = 0;
+    if (scale < MQTT_FRAME_SCALE_MAX)
+    {
+      scale++;
+    }
+    log("sem memoria para transcodificar");
+  }
+
+  // Registra o RTT medido por uma sonda publicada e recebida de volta do broker
+  void onBrokerRtt(unsigned long rttMs)
+  {
+    rttMsAvg = smooth(rttMsAvg, rttMs);
+  }
+
+private:
+  static const int QUALITY_STEP = 4;
+  static const unsigned long INTERVAL_STEP = 250;
+  static const uint8_t HEALTHY_SAMPLES_TO_IMPROVE = 3;
+
+  unsigned long interval = MQTT_PUBLISH_INTERVAL;
+  int quality = MQTT_JPEG_QUALITY;
+  uint8_t scale = 0;
+  uint8_t healthyStreak = 0;
+  unsigned long publishMsAvg = 0;
+  unsigned long rttMsAvg = 0;
+  unsigned long throughputAvg = 0;
+
+  // Média móvel exponencial com peso 1/4 para a amostra nova
+  static unsigned long smooth(unsigned long avg, unsigned long sample)
+  {
+    return avg == 0 ? sample : (avg * 3 + sample) / 4;
+  }
+
+  // Congestionamento: recua o intervalo multiplicativamente e barateia o frame
+  void degrade()
+  {
+    healthyStreak = 0;
+    interval = min(interval + interval / 2, MQTT_PUBLISH_INTERVAL_MAX);
+    if (quality < MQTT_JPEG_QUALITY_WORST)
+    {
+      quality = min(quality + QUALITY_STEP, MQTT_JPEG_QUALITY_WORST);
+    }
+    else if (scale < MQTT_FRAME_SCALE_MAX)
+    {
+      scale++;
+    }
+    log("congestionado");
+  }
+
+  // Folga sustentada: recupera resolução, depois qualidade, depois taxa
+  void improve()
+  {
+    if (scale > 0)
+    {
+      scale--;
+    }
+    else if (quality > MQTT_JPEG_QUALITY_BEST)
+    {
+      quality = max(quality - QUALITY_STEP, MQTT_JPEG_QUALITY_BEST);
+    }
+    else if (interval > MQTT_PUBLISH_INTERVAL_MIN)
+    {
+      interval = (interval > MQTT_PUBLISH_INTERVAL_MIN + INTERVAL_STEP)
+                     ? interval - INTERVAL_STEP
+                     : MQTT_PUBLISH_INTERVAL_MIN;
+    }
+    else
+    {
+      return;
+    }
+    log("folga");
+  }
+
+  void log(const char *reason) const
+  {
+    Serial.printf("[Adaptive] %s -> intervalo=%lu ms, qualidade=%d, escala=1/%u (publish=%lu ms, rtt=%lu ms, %lu B/s)\n",
+                  reason, interval, quality, 1u << scale, publishMsAvg, rttMsAvg, throughputAvg);
+  }
+};
+
+#endif // ADAPTIVE_PUBLISH_CONTROLLER_H
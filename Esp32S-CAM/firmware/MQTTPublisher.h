@@ -7,7 +7,10 @@
 #include "config.h"
 #include "utils.h"
 #include "YoloController.h"
+#include "AdaptivePublishController.h"
+#include "MotionDetector.h"
 #include "esp_camera.h"
+#include <img_converters.h>
 
 // Tentar incluir WiFiClientSecure, se não estiver disponível usar WiFiClient
 #ifdef ESP32
@@ -52,6 +55,12 @@ public:
       Serial.println("[MQTT] Frames grandes podem falhar. Considere atualizar PubSubClient.");
     }
     
+    adaptive.begin();
+    if (pendingMutex == nullptr)
+    {
+      pendingMutex = xSemaphoreCreateMutex();
+    }
+
     client.setServer(MQTT_BROKER, MQTT_PORT);
     client.setCallback([this](char *topic, byte *payload, unsigned int length) {
       this->onMessage(topic, payload, length);
@@ -74,8 +83,15 @@ public:
     }
 
     client.loop();
+    probeLatency();
+    publishDetections();
+    publishPendingFrame();
   }
 
+  // Chamado pelo stream HTTP a cada frame. Só decide se o frame sai (intervalo
+  // e movimento) e guarda uma cópia do JPEG; a transcodificação e o publish
+  // rodam em loop(), fora do stream_handler, que segue para o próximo frame.
+  // Um frame ainda não publicado é substituído pelo mais novo.
   bool publishFrame(camera_fb_t *fb)
   {
     if (!mqttEnabled || !client.connected() || fb == nullptr)
@@ -86,30 +102,61 @@ public:
     static unsigned long lastPublish = 0;
     unsigned long now = millis();
 
-    if (now - lastPublish < MQTT_PUBLISH_INTERVAL)
+    // Com o filtro por movimento, cena estática só publica o frame de manutenção
+    // e o início de um movimento publica sem esperar o intervalo
+    bool motionStarted = false;
+    if (motionGateEnabled)
+    {
+      motionStarted = checkMotion(fb, now);
+      const unsigned long gateInterval = isMotionActive(now) ? adaptive.getInterval() : MQTT_IDLE_PUBLISH_INTERVAL;
+      if (!motionStarted && now - lastPublish < gateInterval)
+      {
+        // Conta só os frames que a publicação por intervalo teria enviado
+        if (now - lastSuppressed >= adaptive.getInterval())
+        {
+          lastSuppressed = now;
+          framesSuppressed++;
+        }
+        return false;
+      }
+    }
+    else if (now - lastPublish < adaptive.getInterval())
     {
       return false; // Ainda não passou o intervalo
     }
 
     lastPublish = now;
+    lastSuppressed = now;
 
-    // Verificar se o frame é muito grande
-    if (fb->len > MQTT_MAX_FRAME_SIZE)
+    if (pendingMutex == nullptr)
     {
-      Serial.printf("[MQTT] Frame muito grande (%u bytes > %u), pulando...\n", 
-                    fb->len, MQTT_MAX_FRAME_SIZE);
       return false;
     }
-    
-    // Ajustar qualidade do sensor
+
+    PendingFrame frame;
+    frame.len = fb->len;
+    frame.width = fb->width;
+    frame.height = fb->height;
     sensor_t *sensor = esp_camera_sensor_get();
-    if (sensor)
+    frame.quality = sensor ? sensor->status.quality : MQTT_JPEG_QUALITY_BEST;
+    frame.buf = (uint8_t *)(psramFound() ? ps_malloc(fb->len) : malloc(fb->len));
+    if (frame.buf == nullptr)
     {
-      sensor->set_quality(sensor, MQTT_JPEG_QUALITY);
+      return false;
     }
-
-    // Processar frame diretamente na RAM
-    return publishFrameDirect(fb);
+    memcpy(frame.buf, fb->buf, fb->len);
+
+    uint8_t *replaced = nullptr;
+    xSemaphoreTake(pendingMutex, portMAX_DELAY);
+    replaced = pending.buf;
+    pending = frame;
+    xSemaphoreGive(pendingMutex);
+    if (replaced != nullptr)
+    {
+      free(replaced);
+      framesReplaced++;
+    }
+    return true;
   }
 
   void publishStatus(const String &status)
@@ -124,6 +171,16 @@ public:
     doc["status"] = status;
     doc["ip"] = WiFi.localIP().toString();
     doc["uptime"] = millis() / 1000;
+    doc["publish_interval"] = adaptive.getInterval();
+    doc["quality"] = adaptive.getQuality();
+    doc["scale"] = adaptive.getScale();
+    doc["publish_ms"] = adaptive.getPublishMs();
+    doc["rtt_ms"] = adaptive.getRttMs();
+    doc["throughput_bps"] = adaptive.getThroughput();
+    doc["motion_gate"] = motionGateEnabled;
+    doc["motion"] = isMotionActive(millis());
+    doc["frames_suppressed"] = framesSuppressed;
+    doc["frames_replaced"] = framesReplaced;
 
     String jsonPayload;
     serializeJson(doc, jsonPayload);
@@ -135,6 +192,21 @@ public:
     return client.connected();
   }
 
+  const AdaptivePublishController &getAdaptive() const
+  {
+    return adaptive;
+  }
+
+  bool isMotionActive(unsigned long now) const
+  {
+    return lastMotion != 0 && now - lastMotion < MOTION_HOLD_MS;
+  }
+
+  uint32_t getFramesSuppressed() const
+  {
+    return framesSuppressed;
+  }
+
   void setEnabled(bool enabled)
   {
     mqttEnabled = enabled;
@@ -145,45 +217,209 @@ public:
   }
 
 private:
+  // Cópia do JPEG do stream à espera de loop()
+  struct PendingFrame
+  {
+    uint8_t *buf = nullptr;
+    size_t len = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    int quality = 0;   // Qualidade do sensor quando o frame foi capturado
+  };
+
+  // Publica o frame guardado por publishFrame(). O sensor não é alterado:
+  // qualidade e resolução do stream HTTP ficam intactas. O frame original é
+  // reaproveitado, a não ser que o controlador tenha reduzido escala ou
+  // qualidade a partir dele (AdaptivePublishController::needsTranscode)
+  void publishPendingFrame()
+  {
+    if (pendingMutex == nullptr || xSemaphoreTake(pendingMutex, 0) != pdTRUE)
+    {
+      return;
+    }
+    PendingFrame frame = pending;
+    pending = PendingFrame();
+    xSemaphoreGive(pendingMutex);
+    if (frame.buf == nullptr)
+    {
+      return;
+    }
+
+    const uint8_t *jpg = frame.buf;
+    size_t jpgLen = frame.len;
+    uint16_t width = frame.width;
+    uint16_t height = frame.height;
+    int quality = frame.quality;
+    uint8_t *transcoded = nullptr;
+
+    if (adaptive.needsTranscode(frame.quality))
+    {
+      if (transcodeFrame(frame, &transcoded, &jpgLen, &width, &height))
+      {
+        jpg = transcoded;
+        quality = adaptive.getQuality();
+      }
+      else
+      {
+        Serial.println("[MQTT] Falha ao transcodificar frame, usando original");
+        jpgLen = frame.len;
+      }
+    }
+
+    // Verificar se o frame é muito grande
+    if (jpgLen > MQTT_MAX_FRAME_SIZE)
+    {
+      Serial.printf("[MQTT] Frame muito grande (%u bytes > %u), pulando...\n",
+                    jpgLen, MQTT_MAX_FRAME_SIZE);
+      adaptive.onOversize();
+    }
+    else
+    {
+      publishFrameDirect(jpg, jpgLen, width, height, quality);
+    }
+    free(transcoded);
+    free(frame.buf);
+  }
+
   // Método para processamento direto na RAM
-  bool publishFrameDirect(camera_fb_t *fb) {
-    size_t base64Size = ((fb->len + 2) / 3) * 4;
+  bool publishFrameDirect(const uint8_t *jpg, size_t len, uint16_t width, uint16_t height, int quality) {
+    size_t base64Size = ((len + 2) / 3) * 4;
     size_t jsonSize = base64Size + 200;
     
     DynamicJsonDocument doc(jsonSize);
     doc["timestamp"] = millis();
     doc["frame_id"] = frameCounter++;
     doc["format"] = "jpeg";
-    doc["width"] = fb->width;
-    doc["height"] = fb->height;
-    doc["size"] = fb->len;
-    doc["quality"] = MQTT_JPEG_QUALITY;
+    doc["width"] = width;
+    doc["height"] = height;
+    doc["size"] = len;
+    doc["quality"] = quality;
+    doc["motion"] = isMotionActive(millis());
+    doc["changed_percent"] = motionDetector.getChangedPercent();
 
     String base64Frame;
-    base64EncodeChunk(fb->buf, fb->len, base64Frame);
+    base64EncodeChunk(jpg, len, base64Frame);
     doc["data"] = base64Frame;
 
     String jsonPayload;
     serializeJson(doc, jsonPayload);
 
+    const unsigned long start = millis();
     bool result = client.publish(MQTT_TOPIC_FRAMES, jsonPayload.c_str());
+    adaptive.onPublish(result, jsonPayload.length(), millis() - start);
     
     if (result) {
       Serial.printf("[MQTT] ✓ Frame publicado (direto): JPEG=%u, JSON=%u bytes\n", 
-                    fb->len, jsonPayload.length());
+                    len, jsonPayload.length());
     }
 
     return result;
   }
 
+  // Decodifica o JPEG do stream na escala pedida pelo controlador e recodifica
+  // com a qualidade atual. O buffer de saída deve ser liberado com free().
+  bool transcodeFrame(const PendingFrame &frame, uint8_t **out, size_t *outLen, uint16_t *width, uint16_t *height)
+  {
+    const uint8_t scale = adaptive.getScale();
+    const uint16_t w = frame.width >> scale;
+    const uint16_t h = frame.height >> scale;
+    const size_t rgbLen = (size_t)w * h * 2;
+
+    uint8_t *rgb = (uint8_t *)(psramFound() ? ps_malloc(rgbLen) : malloc(rgbLen));
+    if (rgb == nullptr)
+    {
+      adaptive.onNoMemory(); // Sem memória para esta escala: reduz a resolução
+      return false;
+    }
+
+    bool ok = jpg2rgb565(frame.buf, frame.len, rgb, (jpg_scale_t)scale) &&
+              fmt2jpg(rgb, rgbLen, w, h, PIXFORMAT_RGB565, adaptive.getEncoderQuality(), out, outLen);
+    free(rgb);
+
+    if (ok)
+    {
+      *width = w;
+      *height = h;
+    }
+    return ok;
+  }
+
+  // Analisa o frame a cada MOTION_CHECK_INTERVAL; retorna true na transição
+  // de cena estática para movimento
+  bool checkMotion(camera_fb_t *fb, unsigned long now)
+  {
+    if (now - lastMotionCheck < MOTION_CHECK_INTERVAL)
+    {
+      return false;
+    }
+    lastMotionCheck = now;
+
+    const bool wasActive = isMotionActive(now);
+    if (motionDetector.update(fb))
+    {
+      lastMotion = now;
+      if (!wasActive)
+      {
+        Serial.printf("[Motion] Movimento detectado (%u%% da cena alterada)\n", motionDetector.getChangedPercent());
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Publica o resultado mais recente produzido pela task de inferência YOLO
+  void publishDetections()
+  {
+    String json;
+    if (yoloController.takeResult(json))
+    {
+      client.publish(MQTT_TOPIC_DETECTIONS, json.c_str());
+    }
+  }
+
+  // Publica o millis() atual no tópico de eco; o RTT é medido em onMessage
+  void probeLatency()
+  {
+    const unsigned long now = millis();
+    if (now - lastLatencyProbe < MQTT_LATENCY_PROBE_INTERVAL)
+    {
+      return;
+    }
+    lastLatencyProbe = now;
+
+    char payload[16];
+    snprintf(payload, sizeof(payload), "%lu", now);
+    client.publish(MQTT_TOPIC_LATENCY, payload);
+  }
+
   WiFiClientSecure espClient;  // Deve vir antes de client
   PubSubClient client;
   unsigned long lastReconnectAttempt = 0;
   const unsigned long RECONNECT_INTERVAL = 10000; // 10 segundos
   uint32_t frameCounter = 0;
+  unsigned long lastLatencyProbe = 0;
+  AdaptivePublishController adaptive;
+  MotionDetector motionDetector;
+  unsigned long lastMotionCheck = 0;
+  unsigned long lastMotion = 0;
+  unsigned long lastSuppressed = 0;
+  uint32_t framesSuppressed = 0;   // Frames que sairiam sem o filtro por movimento
+  uint32_t framesReplaced = 0;   // Frames substituídos antes de loop() publicá-los
+  SemaphoreHandle_t pendingMutex = nullptr;
+  PendingFrame pending;
 
   void onMessage(char *topic, byte *payload, unsigned int length)
   {
+    if (strcmp(topic, MQTT_TOPIC_LATENCY) == 0)
+    {
+      char stamp[16];
+      const unsigned int n = min(length, (unsigned int)(sizeof(stamp) - 1));
+      memcpy(stamp, payload, n);
+      stamp[n] = '\0';
+      adaptive.onBrokerRtt(millis() - strtoul(stamp, nullptr, 10));
+      return;
+    }
+
     String message;
     for (unsigned int i = 0; i < length; i++)
     {
@@ -225,6 +461,12 @@ private:
         setEnabled(enabled);
         Serial.printf("[MQTT] MQTT %s via comando remoto\n", enabled ? "ativado" : "desativado");
       }
+      else if (action == "toggle_motion_gate")
+      {
+        motionGateEnabled = doc.containsKey("enabled") ? doc["enabled"].as<bool>() : !motionGateEnabled;
+        motionDetector.reset();
+        Serial.printf("[MQTT] Filtro por movimento %s via comando remoto\n", motionGateEnabled ? "ativado" : "desativado");
+      }
       else if (action == "restart")
       {
         Serial.println("[MQTT] Reiniciando ESP32 via comando remoto...");
@@ -260,6 +502,7 @@ private:
       {
         Serial.println("[MQTT] Inscrito em: " + String(MQTT_TOPIC_COMMANDS));
       }
+      client.subscribe(MQTT_TOPIC_LATENCY);
 
       // Publicar status inicial
       publishStatus("online");
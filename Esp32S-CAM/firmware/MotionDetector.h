@@ -0,0 +1,135 @@
+#ifndef MOTION_DETECTOR_H
+#define MOTION_DETECTOR_H
+
+#include <Arduino.h>
+#include <JpegLuma.h>
+#include "esp_camera.h"
+#include "config.h"
+
+// Detector de mudança de cena por diferença de quadros.
+// O JPEG é decodificado na escala 1/8 para luma (LumaFrame, o decodificador usa
+// praticamente só os coeficientes DC nessa escala, ~20 ms para VGA) e
+// comparado com uma referência que se adapta lentamente à cena.
+// host/motion_replay compila este mesmo header no PC (jpg2rgb565 sobre a
+// libjpeg) para calibrar os limiares com gravações reais.
+class MotionDetector
+{
+public:
+  ~MotionDetector()
+  {
+    release();
+  }
+
+  // Limiares padrão em config.h (MOTION_PIXEL_THRESHOLD, MOTION_AREA_PERCENT)
+  void setThresholds(uint8_t pixel, uint8_t areaPercent)
+  {
+    pixelThreshold = pixel;
+    areaThreshold = areaPercent;
+  }
+
+  // Analisa um frame JPEG e retorna true se houve movimento
+  bool update(camera_fb_t *fb)
+  {
+    if (fb == nullptr || fb->format != PIXFORMAT_JPEG)
+    {
+      return true; // Sem como comparar: não suprimir a publicação
+    }
+
+    if (!decoded.decode(fb, 3))
+    {
+      return true;
+    }
+    const size_t pixels = (size_t)decoded.width() * decoded.height();
+    if (!ensureReference(pixels))
+    {
+      return true;
+    }
+    return compare(decoded.data(), pixels);
+  }
+
+  // Compara um quadro de luma com a referência e atualiza a referência.
+  // Separado de update() para poder ser exercitado sem a câmera.
+  bool compare(const uint8_t *frame, size_t pixels)
+  {
+    if (!hasReference)
+    {
+      memcpy(reference, frame, pixels);
+      hasReference = true;
+      changedPercent = 100;
+      return true;
+    }
+
+    // Compensa a variação global de brilho (auto-exposição) pela média da diferença
+    int32_t sumDelta = 0;
+    for (size_t i = 0; i < pixels; i++)
+    {
+      sumDelta += (int32_t)frame[i] - reference[i];
+    }
+    const int32_t meanDelta = sumDelta / (int32_t)pixels;
+
+    size_t changed = 0;
+    for (size_t i = 0; i < pixels; i++)
+    {
+      const int32_t delta = (int32_t)frame[i] - reference[i] - meanDelta;
+      if (abs(delta) > pixelThreshold)
+      {
+        changed++;
+      }
+      // Referência com média móvel (peso 1/4) absorve mudanças persistentes
+      reference[i] = (uint8_t)((reference[i] * 3 + frame[i]) >> 2);
+    }
+
+    changedPercent = (uint8_t)((changed * 100) / pixels);
+    return changedPercent >= areaThreshold;
+  }
+
+  // Percentual de pixels alterados na última comparação
+  uint8_t getChangedPercent() const
+  {
+    return changedPercent;
+  }
+
+  void reset()
+  {
+    hasReference = false;
+  }
+
+private:
+  LumaFrame decoded;
+  uint8_t *reference = nullptr;
+  size_t referencePixels = 0;
+  bool hasReference = false;
+  uint8_t changedPercent = 0;
+  uint8_t pixelThreshold = MOTION_PIXEL_THRESHOLD;
+  uint8_t areaThreshold = MOTION_AREA_PERCENT;
+
+  // A referência é refeita apenas quando a resolução do stream muda
+  bool ensureReference(size_t pixels)
+  {
+    if (pixels == referencePixels && reference != nullptr)
+    {
+      return true;
+    }
+
+    release();
+    reference = (uint8_t *)malloc(pixels);
+    if (reference == nullptr)
+    {
+      Serial.println("[Motion] Falha ao alocar buffer de comparação");
+      return false;
+    }
+
+    referencePixels = pixels;
+    hasReference = false;
+    return true;
+  }
+
+  void release()
+  {
+    free(reference);
+    reference = nullptr;
+    referencePixels = 0;
+  }
+};
+
+#endif // MOTION_DETECTOR_H
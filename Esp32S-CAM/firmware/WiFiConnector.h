@@ -3,38 +3,105 @@
 
 #include <WiFi.h>
 #include <Arduino.h>
+#include <WiFiCache.h>
+
+#ifndef WIFI_FAST_CONNECT_TIMEOUT
+#define WIFI_FAST_CONNECT_TIMEOUT 3000  // ms - Sem conexão nesse tempo, volta para varredura + DHCP
+#endif
+
+// Canal/BSSID/IP da última conexão. A RTC sobrevive ao ESP.restart() feito
+// quando a câmera ou o Wi-Fi falham, então a reconexão após reiniciar é rápida.
+RTC_DATA_ATTR static WiFiCache wifiConnectorCache;
 
 class WiFiConnector
 {
 public:
   bool connect(const char *ssid, const char *pass, uint32_t timeoutMs = 30000UL)
   {
+    WiFi.persistent(false);
     WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid, pass);
-
-    Serial.println();
-    Serial.printf("[WiFi] Conectando-se a %s\n", ssid);
 
     const uint32_t start = millis();
-    while (WiFi.status() != WL_CONNECTED)
+    fastPath = false;
+
+    if (wifiConnectorCache.isValidFor(ssid, pass))
+    {
+      Serial.printf("[WiFi] Reconexão rápida a %s (canal %d)\n", ssid, (int)wifiConnectorCache.channel);
+      WiFi.config(IPAddress(wifiConnectorCache.ip), IPAddress(wifiConnectorCache.gateway),
+                  IPAddress(wifiConnectorCache.subnet), IPAddress(wifiConnectorCache.dns));
+      WiFi.begin(ssid, pass, wifiConnectorCache.channel, wifiConnectorCache.bssid);
+      while (WiFi.status() != WL_CONNECTED && millis() - start < WIFI_FAST_CONNECT_TIMEOUT)
+      {
+        delay(10);
+      }
+
+      if (WiFi.status() == WL_CONNECTED)
+      {
+        fastPath = true;
+      }
+      else
+      {
+        Serial.println("[WiFi] Reconexão rápida falhou. Fazendo varredura + DHCP...");
+        wifiConnectorCache.clear();
+        WiFi.disconnect();
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // Volta para DHCP
+      }
+    }
+
+    if (!fastPath)
     {
-      delay(500);
-      Serial.print('.');
-      if (millis() - start > timeoutMs)
+      WiFi.begin(ssid, pass);
+
+      Serial.println();
+      Serial.printf("[WiFi] Conectando-se a %s\n", ssid);
+
+      uint32_t lastDot = millis();
+      while (WiFi.status() != WL_CONNECTED)
       {
-        Serial.println("\n[WiFi] Tempo limite excedido. Reiniciando...");
-        return false;
+        delay(10);
+        if (millis() - lastDot >= 500)
+        {
+          lastDot = millis();
+          Serial.print('.');
+        }
+        if (millis() - start > timeoutMs)
+        {
+          Serial.println("\n[WiFi] Tempo limite excedido. Reiniciando...");
+          return false;
+        }
       }
+      wifiConnectorCache.save(ssid, pass);
     }
 
-    Serial.println("\n[WiFi] Conectado!");
+    connectMs = millis() - start;
+    bootToConnectedMs = millis();
+
+    Serial.printf("\n[WiFi] Conectado em %lu ms%s (%lu ms desde o boot)\n", (unsigned long)connectMs,
+                  fastPath ? " via reconexão rápida" : "", (unsigned long)bootToConnectedMs);
     Serial.print("[WiFi] Endereço IP: ");
     Serial.println(WiFi.localIP());
     return true;
   }
-};
 
-#endif // WIFI_CONNECTOR_H
+  uint32_t getConnectMs() const
+  {
+    return connectMs;
+  }
 
+  uint32_t getBootToConnectedMs() const
+  {
+    return bootToConnectedMs;
+  }
 
+  bool usedFastPath() const
+  {
+    return fastPath;
+  }
 
+private:
+  uint32_t connectMs = 0;
+  uint32_t bootToConnectedMs = 0;
+  bool fastPath = false;
+};
+
+#endif // WIFI_CONNECTOR_H
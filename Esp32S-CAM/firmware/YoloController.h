@@ -3,14 +3,46 @@
 
 #include "esp_camera.h"
 #include <Arduino.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include <PersonDetector.h>
 
+// Cliente assíncrono de inferência YOLO.
+// processFrame() copia o JPEG para uma fila limitada e retorna na hora; uma
+// task em segundo plano envia cada frame ao endpoint HTTP (POST image/jpeg).
+// Se a inferência ficar para trás, o frame mais antigo da fila é descartado.
+// As detecções ficam disponíveis em takeResult() para o MQTTPublisher, que é
+// o único a usar o cliente MQTT (PubSubClient não é thread-safe).
+// Com o detector embarcado ativo, a task classifica o frame localmente antes e
+// só envia ao endpoint os frames com pessoa.
 class YoloController
 {
 public:
+  struct Stats
+  {
+    uint32_t queued = 0;
+    uint32_t dropped = 0;
+    uint32_t inferred = 0;
+    uint32_t errors = 0;
+    uint32_t localNegatives = 0;
+    unsigned long localInferenceMs = 0;
+    unsigned long lastLatencyMs = 0;
+    unsigned long avgLatencyMs = 0;
+  };
+
   void begin(const String &endpoint = "")
   {
     inferenceEndpoint = endpoint;
     enabled = false;
+    localReady = localPersonDetectorEnabled && personDetector.begin();
+
+    if (queue == nullptr)
+    {
+      queue = xQueueCreate(YOLO_QUEUE_LENGTH, sizeof(FrameJob));
+      resultMutex = xSemaphoreCreateMutex();
+      xTaskCreatePinnedToCore(taskEntry, "yolo", YOLO_TASK_STACK, this, 1, &task, 0);
+    }
   }
 
   void setEnabled(bool value)
@@ -39,6 +71,17 @@ public:
     return inferenceEndpoint;
   }
 
+  const Stats &getStats() const
+  {
+    return stats;
+  }
+
+  bool isLocalDetectorReady() const
+  {
+    return localReady;
+  }
+
+  // Enfileira uma cópia do frame para inferência. Não bloqueia o stream.
   void processFrame(camera_fb_t *fb)
   {
     if (!enabled || fb == nullptr)
@@ -46,24 +89,245 @@ public:
       return;
     }
 
+    if (inferenceEndpoint.length() == 0 && !localReady)
+    {
+      const unsigned long now = millis();
+      if (now - lastLogMillis >= 2000)
+      {
+        Serial.println("[YOLO] Endpoint não configurado (YOLO_INFERENCE_ENDPOINT em config.h).");
+        lastLogMillis = now;
+      }
+      return;
+    }
+
     const unsigned long now = millis();
-    if (now - lastLogMillis >= 2000)
+    if (now - lastEnqueue < YOLO_MIN_INTERVAL)
+    {
+      return;
+    }
+    lastEnqueue = now;
+
+    FrameJob job;
+    job.len = fb->len;
+    job.width = fb->width;
+    job.height = fb->height;
+    job.frameId = nextFrameId++;
+    job.buf = (uint8_t *)(psramFound() ? ps_malloc(fb->len) : malloc(fb->len));
+    if (job.buf == nullptr)
     {
-      Serial.printf("[YOLO] Frame pronto (%u bytes). Integre seu pipeline YOLO aqui.\n", fb->len);
-      if (inferenceEndpoint.length() > 0)
+      stats.dropped++;
+      return;
+    }
+    memcpy(job.buf, fb->buf, fb->len);
+
+    // Fila cheia: descarta o frame mais antigo para manter a inferência atual
+    if (uxQueueSpacesAvailable(queue) == 0)
+    {
+      FrameJob stale;
+      if (xQueueReceive(queue, &stale, 0) == pdTRUE)
       {
-        Serial.printf("[YOLO] Endpoint configurado: %s (implementação da chamada HTTP não inclusa).\n", inferenceEndpoint.c_str());
+        free(stale.buf);
+        stats.dropped++;
       }
-      lastLogMillis = now;
+    }
+
+    if (xQueueSend(queue, &job, 0) == pdTRUE)
+    {
+      stats.queued++;
+    }
+    else
+    {
+      free(job.buf);
+      stats.dropped++;
     }
   }
 
+  // Retorna o JSON da última inferência ainda não publicada
+  bool takeResult(String &json)
+  {
+    if (resultMutex == nullptr || xSemaphoreTake(resultMutex, 0) != pdTRUE)
+    {
+      return false;
+    }
+
+    const bool available = resultPending;
+    if (available)
+    {
+      json = pendingResult;
+      resultPending = false;
+    }
+    xSemaphoreGive(resultMutex);
+    return available;
+  }
+
 private:
+  struct FrameJob
+  {
+    uint8_t *buf;
+    size_t len;
+    uint16_t width;
+    uint16_t height;
+    uint32_t frameId;
+  };
+
   bool enabled = false;
   String inferenceEndpoint;
   unsigned long lastLogMillis = 0;
-};
+  unsigned long lastEnqueue = 0;
+  uint32_t nextFrameId = 0;
 
-#endif // YOLO_CONTROLLER_H
+  QueueHandle_t queue = nullptr;
+  SemaphoreHandle_t resultMutex = nullptr;
+  TaskHandle_t task = nullptr;
+  String pendingResult;
+  bool resultPending = false;
+  Stats stats;
+  PersonDetector personDetector;
+  bool localReady = false;
+
+  static void taskEntry(void *arg)
+  {
+    static_cast<YoloController *>(arg)->run();
+  }
+
+  void run()
+  {
+    HTTPClient http;
+    http.setReuse(true); // Mantém a conexão com o servidor entre frames
+    http.setTimeout(YOLO_HTTP_TIMEOUT);
 
+    FrameJob job;
+    while (true)
+    {
+      if (xQueueReceive(queue, &job, portMAX_DELAY) != pdTRUE)
+      {
+        continue;
+      }
+
+      infer(http, job);
+      free(job.buf);
+    }
+  }
+
+  void infer(HTTPClient &http, const FrameJob &job)
+  {
+    const unsigned long start = millis();
+
+    if (localReady)
+    {
+      camera_fb_t frame = {};
+      frame.buf = job.buf;
+      frame.len = job.len;
+      frame.width = job.width;
+      frame.height = job.height;
+      frame.format = PIXFORMAT_JPEG;
+
+      const float score = personDetector.detect(&frame);
+      stats.localInferenceMs = personDetector.getLastInferenceMs();
+      if (score >= 0.0f && score < PERSON_DETECTOR_THRESHOLD)
+      {
+        stats.localNegatives++;
+        return; // Negativo local: o frame não sai do dispositivo
+      }
+      if (inferenceEndpoint.length() == 0)
+      {
+        if (score >= 0.0f)
+        {
+          storeLocalResult(job, score);
+        }
+        else
+        {
+          stats.errors++; // Falha local (ex.: JPEG inválido) e nenhum endpoint para tentar
+          Serial.printf("[YOLO] Falha no detector local no frame %u\n", job.frameId);
+        }
+        return;
+      }
+    }
+
+    http.begin(inferenceEndpoint);
+    http.addHeader("Content-Type", "image/jpeg");
+    http.addHeader("X-Frame-Id", String(job.frameId));
+    const int code = http.POST(job.buf, job.len);
+
+    if (code != HTTP_CODE_OK)
+    {
+      stats.errors++;
+      Serial.printf("[YOLO] Falha na inferência do frame %u (HTTP %d)\n", job.frameId, code);
+      http.end();
+      return;
+    }
 
+    const String body = http.getString();
+    http.end();
+
+    const unsigned long latency = millis() - start;
+    stats.inferred++;
+    stats.lastLatencyMs = latency;
+    stats.avgLatencyMs = stats.avgLatencyMs == 0 ? latency : (stats.avgLatencyMs * 7 + latency) / 8;
+
+    DynamicJsonDocument response(YOLO_RESPONSE_JSON_SIZE);
+    if (deserializeJson(response, body))
+    {
+      stats.errors++;
+      Serial.println("[YOLO] Resposta de inferência inválida");
+      return;
+    }
+
+    // Mantém apenas as detecções acima da confiança mínima
+    DynamicJsonDocument result(YOLO_RESPONSE_JSON_SIZE);
+    result["frame_id"] = job.frameId;
+    result["timestamp"] = millis();
+    result["width"] = job.width;
+    result["height"] = job.height;
+    result["latency_ms"] = latency;
+    result["inference_ms"] = response["inference_ms"];
+    JsonArray detections = result.createNestedArray("detections");
+    for (JsonObject det : response["detections"].as<JsonArray>())
+    {
+      if (det["confidence"].as<float>() >= YOLO_MIN_CONFIDENCE)
+      {
+        detections.add(det);
+      }
+    }
+
+    String json;
+    serializeJson(result, json);
+    Serial.printf("[YOLO] Frame %u: %u detecções em %lu ms\n", job.frameId, detections.size(), latency);
+
+    storeResult(json);
+  }
+
+  // Publica a decisão do classificador embarcado no mesmo formato do endpoint
+  void storeLocalResult(const FrameJob &job, float score)
+  {
+    stats.inferred++;
+
+    DynamicJsonDocument result(512);
+    result["frame_id"] = job.frameId;
+    result["timestamp"] = millis();
+    result["width"] = job.width;
+    result["height"] = job.height;
+    result["source"] = "local";
+    result["inference_ms"] = personDetector.getLastInferenceMs();
+    JsonObject det = result.createNestedArray("detections").createNestedObject();
+    det["label"] = "person";
+    det["confidence"] = score;
+
+    String json;
+    serializeJson(result, json);
+    Serial.printf("[Person] Frame %u: pessoa (%.2f) em %lu ms\n", job.frameId, score, personDetector.getLastInferenceMs());
+    storeResult(json);
+  }
+
+  void storeResult(const String &json)
+  {
+    if (xSemaphoreTake(resultMutex, portMAX_DELAY) == pdTRUE)
+    {
+      pendingResult = json;
+      resultPending = true;
+      xSemaphoreGive(resultMutex);
+    }
+  }
+};
+
+#endif // YOLO_CONTROLLER_H
@@ -33,9 +33,24 @@ const char *WIFI_SSID = "Server";
 const char *WIFI_PASS = "server123";
 
 // =================== Configuração de YOLO ===================
-// Caso possua um endpoint HTTP para inferência YOLO (por exemplo, um servidor Python),
-// informe abaixo. Caso contrário, deixe vazio para utilizar apenas o placeholder local.
+// Caso possua um endpoint HTTP para inferência YOLO (por exemplo, o yolo_server.py
+// desta pasta), informe a URL completa abaixo. Ex.: "http://192.168.1.10:8000/infer"
+// O firmware envia POST image/jpeg e espera JSON:
+// {"detections":[{"label":"person","confidence":0.9,"box":[x,y,w,h]}],"inference_ms":35}
 const char *YOLO_INFERENCE_ENDPOINT = "";
+const uint8_t YOLO_QUEUE_LENGTH = 2;                  // Frames aguardando inferência (excedente descarta o mais antigo)
+const unsigned long YOLO_MIN_INTERVAL = 200;          // Intervalo mínimo entre frames enfileirados (ms)
+const uint16_t YOLO_HTTP_TIMEOUT = 5000;              // Timeout da requisição de inferência (ms)
+const float YOLO_MIN_CONFIDENCE = 0.4f;               // Detecções abaixo disso não são publicadas
+const size_t YOLO_RESPONSE_JSON_SIZE = 4096;          // Capacidade do JSON de resposta
+const uint32_t YOLO_TASK_STACK = 8192;                // Pilha da task de inferência
+
+// Detector de pessoas embarcado (PersonDetector.h + person_model_data.h)
+// Quando o modelo foi treinado, cada frame passa primeiro pelo classificador local:
+// negativos não saem do dispositivo; positivos vão ao endpoint YOLO (se configurado)
+// ou são publicados direto em esp32cam/detections com a confiança local.
+bool localPersonDetectorEnabled = true;
+const float PERSON_DETECTOR_THRESHOLD = 0.6f;         // Probabilidade mínima para considerar "pessoa"
 
 // =================== Configuração MQTT (HiveMQ Cloud) ===================
 // PREENCHA COM SUAS CREDENCIAIS DO HIVEMQ CLOUD:
@@ -53,12 +68,36 @@ const char *MQTT_CLIENT_ID = "esp32cam_device_001";                  // ID únic
 const char *MQTT_TOPIC_FRAMES = "esp32cam/frames";            // Publica frames aqui
 const char *MQTT_TOPIC_STATUS = "esp32cam/status";            // Publica status aqui
 const char *MQTT_TOPIC_COMMANDS = "esp32cam/commands";         // Recebe comandos aqui
+const char *MQTT_TOPIC_DETECTIONS = "esp32cam/detections";     // Publica detecções YOLO aqui
 
 // Configurações de publicação
-const unsigned long MQTT_PUBLISH_INTERVAL = 2000;             // Publica a cada 2 segundos (0.5 FPS)
-const int MQTT_JPEG_QUALITY = 12;                              // Qualidade JPEG (1-63, menor = melhor) - reduzido para frames menores
+const unsigned long MQTT_PUBLISH_INTERVAL = 2000;             // Intervalo inicial: publica a cada 2 segundos (0.5 FPS)
+const int MQTT_JPEG_QUALITY = 12;                              // Qualidade JPEG inicial (1-63, menor = melhor) - reduzido para frames menores
 const int MQTT_MAX_FRAME_SIZE = 20000;                        // Tamanho máximo do frame JPEG em bytes (20KB) - reduzido para evitar problemas de memória
 bool mqttEnabled = true;                                       // Ativar/desativar MQTT
 
+// Controle adaptativo da publicação (AdaptivePublishController.h)
+// O controlador ajusta intervalo, qualidade e resolução dentro destes limites.
+// O stream HTTP (/stream) não é afetado: os frames MQTT são transcodificados.
+const unsigned long MQTT_PUBLISH_INTERVAL_MIN = 500;          // Intervalo mínimo (2 FPS)
+const unsigned long MQTT_PUBLISH_INTERVAL_MAX = 10000;        // Intervalo máximo (0.1 FPS)
+const int MQTT_JPEG_QUALITY_BEST = 10;                        // Melhor qualidade permitida (escala do sensor)
+const int MQTT_JPEG_QUALITY_WORST = 40;                       // Pior qualidade permitida (escala do sensor)
+const uint8_t MQTT_FRAME_SCALE_MAX = 2;                       // Redução máxima da resolução (0=1:1, 1=1/2, 2=1/4, 3=1/8)
+const unsigned long MQTT_TARGET_PUBLISH_MS = 300;             // Tempo alvo de um publish antes de considerar congestionamento
+const unsigned long MQTT_TARGET_RTT_MS = 800;                 // RTT alvo até o broker
+const unsigned long MQTT_LATENCY_PROBE_INTERVAL = 5000;       // Intervalo entre sondas de RTT
+const char *MQTT_TOPIC_LATENCY = "esp32cam/latency";          // Tópico de eco usado para medir o RTT
+
+// Publicação condicionada a movimento (MotionDetector.h)
+// Em cena estática os frames não são publicados, exceto um a cada MQTT_IDLE_PUBLISH_INTERVAL.
+// Ao detectar movimento o frame é publicado imediatamente e a taxa volta ao intervalo adaptativo.
+bool motionGateEnabled = true;                                 // Ativar/desativar o filtro por movimento
+const unsigned long MOTION_CHECK_INTERVAL = 200;               // Intervalo entre análises de movimento (ms)
+const uint8_t MOTION_PIXEL_THRESHOLD = 20;                     // Diferença de luma (0-255) para contar um pixel como alterado
+const uint8_t MOTION_AREA_PERCENT = 2;                         // % de pixels alterados para caracterizar movimento
+const unsigned long MOTION_HOLD_MS = 3000;                     // Mantém a taxa alta por este tempo após o último movimento
+const unsigned long MQTT_IDLE_PUBLISH_INTERVAL = 60000;        // Frame de manutenção em cena estática (1 por minuto)
+
 #endif // CONFIG_H
 
@@ -7,12 +7,14 @@
 #include "CameraController.h"
 #include "YoloController.h"
 #include "MQTTPublisher.h"
+#include "WiFiConnector.h"
 #include <Arduino.h>
 
 // Declarações externas das instâncias globais
 extern CameraController cameraController;
 extern YoloController yoloController;
 extern MQTTPublisher mqttPublisher;
+extern WiFiConnector wifiConnector;
 
 // HTML da interface web
 static const char INDEX_HTML[] PROGMEM = R"rawliteral(
@@ -131,7 +133,11 @@ static const char INDEX_HTML[] PROGMEM = R"rawliteral(
       <strong>Endpoint YOLO:</strong>
       <span id="yoloEndpoint">--</span>
       <br />
-      <small>Integre este firmware a um servidor YOLO externo para inferência completa.</small>
+      <br />
+      <strong>Inferências:</strong>
+      <span id="yoloStats">--</span>
+      <br />
+      <small>Configure YOLO_INFERENCE_ENDPOINT em config.h (ex.: yolo_server.py). Detecções publicadas em esp32cam/detections.</small>
     </div>
   </div>
   <script>
@@ -143,6 +149,9 @@ static const char INDEX_HTML[] PROGMEM = R"rawliteral(
         yoloState = !!data.enabled;
         const endpoint = (data.endpoint || '').length ? data.endpoint : 'não configurado';
         document.getElementById('yoloEndpoint').textContent = endpoint;
+        document.getElementById('yoloStats').textContent =
+          `${data.inferred} ok, ${data.dropped} descartados, ${data.errors} erros, latência média ${data.avg_latency_ms} ms` +
+          (data.local_detector ? ` | local: ${data.local_negatives} negativos, ${data.local_inference_ms} ms` : '');
         updateUI();
       } catch (err) {
         console.error('Falha ao obter estado do YOLO', err);
@@ -195,7 +204,20 @@ static esp_err_t yolo_status_handler(httpd_req_t *req)
   json += yoloController.isEnabled() ? "true" : "false";
   json += ",\"endpoint\":\"";
   json += yoloController.getEndpoint();
-  json += "\"}";
+  json += "\"";
+
+  const YoloController::Stats &stats = yoloController.getStats();
+  json += ",\"queued\":" + String(stats.queued);
+  json += ",\"dropped\":" + String(stats.dropped);
+  json += ",\"inferred\":" + String(stats.inferred);
+  json += ",\"errors\":" + String(stats.errors);
+  json += ",\"last_latency_ms\":" + String(stats.lastLatencyMs);
+  json += ",\"avg_latency_ms\":" + String(stats.avgLatencyMs);
+  json += ",\"local_detector\":";
+  json += yoloController.isLocalDetectorReady() ? "true" : "false";
+  json += ",\"local_negatives\":" + String(stats.localNegatives);
+  json += ",\"local_inference_ms\":" + String(stats.localInferenceMs);
+  json += "}";
   httpd_resp_set_type(req, "application/json");
   return httpd_resp_send(req, json.c_str(), json.length());
 }
@@ -289,12 +311,10 @@ static esp_err_t stream_handler(httpd_req_t *req)
       res = httpd_resp_send_chunk(req, "\r\n", 2);
     }
 
-    // Publicar frame via MQTT APÓS enviar HTTP (não bloqueia stream)
-    // Fazer isso antes de retornar o frame para não perder dados
+    // MQTT depois do HTTP: publishFrame() só copia o JPEG quando o frame deve
+    // sair; transcodificação e publish rodam no loop(), sem travar o stream
     if (res == ESP_OK && mqttPublisher.isConnected() && fb != nullptr)
     {
-      // Criar cópia do frame para MQTT (para não bloquear retorno do frame)
-      // Mas como isso consome memória, vamos processar MQTT de forma assíncrona
       mqttPublisher.publishFrame(fb);
     }
 
@@ -338,7 +358,21 @@ static esp_err_t status_handler(httpd_req_t *req)
   p += sprintf(p, "\"quality\":%u,", sensor->status.quality);
   p += sprintf(p, "\"brightness\":%d,", sensor->status.brightness);
   p += sprintf(p, "\"contrast\":%d,", sensor->status.contrast);
-  p += sprintf(p, "\"saturation\":%d", sensor->status.saturation);
+  p += sprintf(p, "\"saturation\":%d,", sensor->status.saturation);
+
+  // Estado do controlador adaptativo da publicação MQTT
+  const AdaptivePublishController &adaptive = mqttPublisher.getAdaptive();
+  p += sprintf(p, "\"mqtt_interval\":%lu,", adaptive.getInterval());
+  p += sprintf(p, "\"mqtt_quality\":%d,", adaptive.getQuality());
+  p += sprintf(p, "\"mqtt_scale\":%u,", adaptive.getScale());
+  p += sprintf(p, "\"mqtt_publish_ms\":%lu,", adaptive.getPublishMs());
+  p += sprintf(p, "\"mqtt_rtt_ms\":%lu,", adaptive.getRttMs());
+  p += sprintf(p, "\"mqtt_throughput_bps\":%lu,", adaptive.getThroughput());
+
+  // Tempo da última conexão Wi-Fi (reconexão rápida usa canal/BSSID/IP da RTC)
+  p += sprintf(p, "\"wifi_connect_ms\":%lu,", (unsigned long)wifiConnector.getConnectMs());
+  p += sprintf(p, "\"wifi_boot_to_connected_ms\":%lu,", (unsigned long)wifiConnector.getBootToConnectedMs());
+  p += sprintf(p, "\"wifi_fast_connect\":%s", wifiConnector.usedFastPath() ? "true" : "false");
   *p++ = '}';
   *p++ = '\0';
 
@@ -34,6 +34,7 @@ arduino-cli compile --fqbn esp32:esp32:esp32cam `
     --build-property "build.flash_size=4MB" `
     --build-property "build.partitions=default" `
     --build-property "build.psram_type=opi" `
+    --libraries libraries `
     Esp32S-CAM\esp32s-cam.ino
 
 if ($LASTEXITCODE -ne 0) {
@@ -0,0 +1,206 @@
+// Reproduz sequências JPEG gravadas no detector de movimento da ESP32-CAM.
+//
+// Compila o próprio ../firmware/MotionDetector.h (decodificação em 1/8, luma,
+// compensação de brilho global e referência com média móvel) e aplica a mesma
+// política de publicação do MQTTPublisher, informando quais frames seriam
+// publicados e quanta banda seria economizada.
+//
+// Uso:
+//   ./motion_replay gravacao/ --frame-interval 200
+//   ./motion_replay "gravacao/*.jpg" --pixel-threshold 25 --area 3
+//
+// Os frames são lidos em ordem alfabética. Para gravar uma sequência basta salvar
+// os JPEGs do /stream (ex.: ffmpeg -i http://<ip>/stream -q:v 2 gravacao/%05d.jpg)
+// ou os frames recebidos pelo mqtt_viewer.py.
+
+#include <glob.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "MotionDetector.h"
+
+namespace fs = std::filesystem;
+
+struct Opcoes
+{
+  std::string origem;
+  unsigned long frameInterval = 200;
+  unsigned long checkInterval = MOTION_CHECK_INTERVAL;
+  int pixelThreshold = MOTION_PIXEL_THRESHOLD;
+  int area = MOTION_AREA_PERCENT;
+  unsigned long hold = MOTION_HOLD_MS;
+  unsigned long publishInterval = MQTT_PUBLISH_INTERVAL; // O firmware usa o valor adaptativo
+  unsigned long idleInterval = MQTT_IDLE_PUBLISH_INTERVAL;
+  bool verbose = false;
+};
+
+static void uso(const char *prog)
+{
+  printf("Uso: %s <diretório|glob> [opções]\n"
+         "  --frame-interval MS   Intervalo entre frames da gravação (padrão: 200)\n"
+         "  --check-interval MS   Intervalo entre análises (padrão: %lu)\n"
+         "  --pixel-threshold N   Diferença de luma por pixel (padrão: %d)\n"
+         "  --area N              %% de pixels alterados para movimento (padrão: %d)\n"
+         "  --hold MS             Taxa alta após o último movimento (padrão: %lu)\n"
+         "  --publish-interval MS Intervalo com movimento (padrão: %lu)\n"
+         "  --idle-interval MS    Frame de manutenção em cena estática (padrão: %lu)\n"
+         "  -v, --verbose         Mostra também os frames suprimidos\n",
+         prog, MOTION_CHECK_INTERVAL, (int)MOTION_PIXEL_THRESHOLD, (int)MOTION_AREA_PERCENT, MOTION_HOLD_MS,
+         MQTT_PUBLISH_INTERVAL, MQTT_IDLE_PUBLISH_INTERVAL);
+}
+
+static bool lerOpcoes(int argc, char **argv, Opcoes &op)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string a = argv[i];
+    const bool temValor = i + 1 < argc;
+    if (a == "-v" || a == "--verbose")
+      op.verbose = true;
+    else if (a == "--frame-interval" && temValor)
+      op.frameInterval = strtoul(argv[++i], nullptr, 10);
+    else if (a == "--check-interval" && temValor)
+      op.checkInterval = strtoul(argv[++i], nullptr, 10);
+    else if (a == "--pixel-threshold" && temValor)
+      op.pixelThreshold = atoi(argv[++i]);
+    else if (a == "--area" && temValor)
+      op.area = atoi(argv[++i]);
+    else if (a == "--hold" && temValor)
+      op.hold = strtoul(argv[++i], nullptr, 10);
+    else if (a == "--publish-interval" && temValor)
+      op.publishInterval = strtoul(argv[++i], nullptr, 10);
+    else if (a == "--idle-interval" && temValor)
+      op.idleInterval = strtoul(argv[++i], nullptr, 10);
+    else if (a[0] != '-' && op.origem.empty())
+      op.origem = a;
+    else
+      return false;
+  }
+  return !op.origem.empty() && op.frameInterval > 0 && op.pixelThreshold >= 0 && op.pixelThreshold <= 255 &&
+         op.area >= 0 && op.area <= 100;
+}
+
+static std::vector<std::string> listarFrames(const std::string &origem)
+{
+  std::vector<std::string> caminhos;
+  if (fs::is_directory(origem))
+  {
+    for (const auto &entrada : fs::directory_iterator(origem))
+    {
+      std::string ext = entrada.path().extension().string();
+      std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+      if (entrada.is_regular_file() && (ext == ".jpg" || ext == ".jpeg"))
+      {
+        caminhos.push_back(entrada.path().string());
+      }
+    }
+  }
+  else
+  {
+    glob_t g;
+    if (glob(origem.c_str(), 0, nullptr, &g) == 0)
+    {
+      caminhos.assign(g.gl_pathv, g.gl_pathv + g.gl_pathc);
+    }
+    globfree(&g);
+  }
+  std::sort(caminhos.begin(), caminhos.end());
+  return caminhos;
+}
+
+int main(int argc, char **argv)
+{
+  Opcoes op;
+  if (!lerOpcoes(argc, argv, op))
+  {
+    uso(argv[0]);
+    return 2;
+  }
+
+  const std::vector<std::string> caminhos = listarFrames(op.origem);
+  if (caminhos.empty())
+  {
+    printf("Nenhum JPEG encontrado em %s\n", op.origem.c_str());
+    return 1;
+  }
+
+  MotionDetector detector;
+  detector.setThresholds((uint8_t)op.pixelThreshold, (uint8_t)op.area);
+
+  // Mesmos estados do MQTTPublisher; "nenhum" enquanto não houve o evento
+  bool publicou = false, analisou = false, houveMovimento = false;
+  unsigned long ultimaPublicacao = 0, ultimaAnalise = 0, ultimoMovimento = 0;
+  size_t publicados = 0, bytesTotal = 0, bytesPublicados = 0;
+
+  for (size_t i = 0; i < caminhos.size(); i++)
+  {
+    const unsigned long agora = i * op.frameInterval;
+    const std::string nome = fs::path(caminhos[i]).filename().string();
+
+    std::ifstream arq(caminhos[i], std::ios::binary);
+    std::vector<uint8_t> jpg((std::istreambuf_iterator<char>(arq)), std::istreambuf_iterator<char>());
+    bytesTotal += jpg.size();
+
+    camera_fb_t fb = {jpg.data(), jpg.size(), 0, 0, PIXFORMAT_JPEG};
+    if (!hostJpegSize(fb.buf, fb.len, &fb.width, &fb.height))
+    {
+      printf("[%8lu ms] %s: falha ao decodificar, ignorado\n", agora, nome.c_str());
+      continue;
+    }
+
+    bool movimentoAtivo = houveMovimento && agora - ultimoMovimento < op.hold;
+    bool movimentoComecou = false;
+    if (!analisou || agora - ultimaAnalise >= op.checkInterval)
+    {
+      analisou = true;
+      ultimaAnalise = agora;
+      if (detector.update(&fb))
+      {
+        houveMovimento = true;
+        ultimoMovimento = agora;
+        movimentoComecou = !movimentoAtivo;
+        movimentoAtivo = true;
+      }
+    }
+
+    const unsigned long intervalo = movimentoAtivo ? op.publishInterval : op.idleInterval;
+    const bool publica = movimentoComecou || !publicou || agora - ultimaPublicacao >= intervalo;
+    if (publica)
+    {
+      publicou = true;
+      ultimaPublicacao = agora;
+      publicados++;
+      bytesPublicados += jpg.size();
+    }
+
+    if (op.verbose || publica)
+    {
+      printf("[%8lu ms] %s: %3u%% alterado, %-9s -> %s\n", agora, nome.c_str(), detector.getChangedPercent(),
+             movimentoAtivo ? "MOVIMENTO" : "estático", publica ? "PUBLICA" : "suprime");
+    }
+  }
+
+  // Referência: publicação fixa no intervalo sem o filtro por movimento
+  const size_t passo = std::max(1UL, op.publishInterval / op.frameInterval);
+  const size_t fixo = (caminhos.size() + passo - 1) / passo;
+
+  printf("\n========== Resumo ==========\n");
+  printf("Frames na gravação:      %zu (%.1f s)\n", caminhos.size(), caminhos.size() * op.frameInterval / 1000.0);
+  printf("Publicados (filtro):     %zu\n", publicados);
+  printf("Publicados (fixo %lu ms): %zu\n", op.publishInterval, fixo);
+  if (bytesTotal > 0)
+  {
+    printf("Bytes publicados:        %zu de %zu (%.1f%%)\n", bytesPublicados, bytesTotal,
+           100.0 * bytesPublicados / bytesTotal);
+  }
+  printf("Redução de publicações:  %.1f%%\n", 100.0 * (1.0 - (double)publicados / fixo));
+  return 0;
+}
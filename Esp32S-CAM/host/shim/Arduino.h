@@ -0,0 +1,28 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Subconjunto do core Arduino para compilar ../firmware/MotionDetector.h (e a
+// JpegLuma de libraries/) no PC.
+// Só o que ele usa.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+inline bool psramFound() { return false; }
+inline void *ps_malloc(size_t size) { return malloc(size); }
+
+class HostSerial
+{
+public:
+  void println(const char *s) { printf("%s\n", s); }
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,25 @@
+#ifndef HOST_ESP_CAMERA_H
+#define HOST_ESP_CAMERA_H
+
+// camera_fb_t do esp32-camera, com os campos lidos pelo firmware
+
+#include <cstddef>
+#include <cstdint>
+
+typedef enum
+{
+  PIXFORMAT_RGB565,
+  PIXFORMAT_GRAYSCALE,
+  PIXFORMAT_JPEG,
+} pixformat_t;
+
+typedef struct
+{
+  uint8_t *buf;
+  size_t len;
+  size_t width;
+  size_t height;
+  pixformat_t format;
+} camera_fb_t;
+
+#endif // HOST_ESP_CAMERA_H
@@ -0,0 +1,104 @@
+#ifndef HOST_IMG_CONVERTERS_H
+#define HOST_IMG_CONVERTERS_H
+
+// jpg2rgb565 do esp32-camera sobre a libjpeg. Nas escalas reduzidas as duas
+// usam a IDCT reduzida (em 1/8, só o coeficiente DC de cada bloco), e a saída
+// segue o formato do firmware: RGB565 com o byte alto primeiro.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <csetjmp>
+#include <jpeglib.h>
+
+typedef enum
+{
+  JPG_SCALE_NONE,
+  JPG_SCALE_2X,
+  JPG_SCALE_4X,
+  JPG_SCALE_8X,
+  JPG_SCALE_MAX = JPG_SCALE_8X
+} jpg_scale_t;
+
+struct HostJpegError
+{
+  jpeg_error_mgr mgr;
+  jmp_buf jump;
+};
+
+inline void hostJpegErrorExit(j_common_ptr cinfo)
+{
+  longjmp(((HostJpegError *)cinfo->err)->jump, 1);
+}
+
+// Dimensões do JPEG, para preencher camera_fb_t a partir de um arquivo
+inline bool hostJpegSize(const uint8_t *src, size_t len, size_t *width, size_t *height)
+{
+  jpeg_decompress_struct cinfo;
+  HostJpegError err;
+  cinfo.err = jpeg_std_error(&err.mgr);
+  err.mgr.error_exit = hostJpegErrorExit;
+  if (setjmp(err.jump))
+  {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, (unsigned char *)src, (unsigned long)len);
+  jpeg_read_header(&cinfo, TRUE);
+  *width = cinfo.image_width;
+  *height = cinfo.image_height;
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+// O buffer de saída tem (largura >> scale) x (altura >> scale) pixels, como no
+// firmware; colunas e linhas parciais da borda são descartadas
+inline bool jpg2rgb565(const uint8_t *src, size_t src_len, uint8_t *out, jpg_scale_t scale)
+{
+  jpeg_decompress_struct cinfo;
+  HostJpegError err;
+  cinfo.err = jpeg_std_error(&err.mgr);
+  err.mgr.error_exit = hostJpegErrorExit;
+  if (setjmp(err.jump))
+  {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, (unsigned char *)src, (unsigned long)src_len);
+  jpeg_read_header(&cinfo, TRUE);
+
+  cinfo.out_color_space = JCS_RGB;
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = 1u << scale;
+  const size_t outW = cinfo.image_width >> scale;
+  const size_t outH = cinfo.image_height >> scale;
+  jpeg_start_decompress(&cinfo);
+
+  JSAMPARRAY row = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE,
+                                               cinfo.output_width * cinfo.output_components, 1);
+  while (cinfo.output_scanline < cinfo.output_height)
+  {
+    const size_t y = cinfo.output_scanline;
+    jpeg_read_scanlines(&cinfo, row, 1);
+    if (y >= outH)
+    {
+      continue;
+    }
+    uint8_t *dst = out + y * outW * 2;
+    for (size_t x = 0; x < outW; x++)
+    {
+      const uint8_t *p = row[0] + x * 3;
+      const uint16_t v = (uint16_t)(((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3));
+      dst[2 * x] = (uint8_t)(v >> 8);
+      dst[2 * x + 1] = (uint8_t)(v & 0xFF);
+    }
+  }
+
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+#endif // HOST_IMG_CONVERTERS_H
@@ -0,0 +1,321 @@
+#!/usr/bin/env python3
+"""
+Treina, quantiza e exporta o detector de pessoas embarcado (PersonDetector.h).
+
+Arquitetura (entrada 96x96 em tons de cinza):
+    4 x [Conv 3x3, stride 2, padding 'same', ReLU]  canais 8, 16, 32, 32
+    GlobalAveragePooling -> Dense(1) (logit de "pessoa")
+
+Quantização int8 no estilo TFLite: ativações com zero point -128, pesos
+simétricos por canal de saída, bias int32 e requantização por multiplicador
+Q31 + shift. A camada final usa uma escala float (um único produto por frame).
+
+Uso:
+    # 1) Treinar (pip install tensorflow) com um diretório no formato
+    #    Visual Wake Words: dataset/person/*.jpg e dataset/no_person/*.jpg
+    python person_model_tool.py train dataset/ --epochs 20 --out person_model.npz
+
+    # 2) Quantizar com imagens de calibração e gerar o header do firmware
+    python person_model_tool.py export person_model.npz dataset/ \\
+        --out ../libraries/PersonDetector/src/person_model_data.h
+
+    # 3) Avaliar o modelo quantizado (mesma aritmética do firmware)
+    python person_model_tool.py eval person_model.npz dataset/
+"""
+
+import argparse
+import glob
+import os
+
+try:
+    import cv2
+    import numpy as np
+except ImportError:
+    print("Erro: Instale as dependências:")
+    print("  pip install opencv-python numpy")
+    exit(1)
+
+INPUT_SIZE = 96
+CHANNELS = [1, 8, 16, 32, 32]
+ACT_ZERO_POINT = -128
+
+
+# =================== Imagens ===================
+
+def load_gray(path):
+    """Recorte central quadrado redimensionado para 96x96 (igual ao firmware)."""
+    image = cv2.imread(path, cv2.IMREAD_GRAYSCALE)
+    if image is None:
+        return None
+    h, w = image.shape
+    side = min(h, w)
+    y0, x0 = (h - side) // 2, (w - side) // 2
+    crop = image[y0:y0 + side, x0:x0 + side]
+    return cv2.resize(crop, (INPUT_SIZE, INPUT_SIZE), interpolation=cv2.INTER_AREA)
+
+
+def load_dataset(root, limit=None):
+    images, labels = [], []
+    for label, folder in ((1, "person"), (0, "no_person")):
+        paths = sorted(glob.glob(os.path.join(root, folder, "*.jp*g")))
+        if limit:
+            paths = paths[:limit]
+        for path in paths:
+            gray = load_gray(path)
+            if gray is not None:
+                images.append(gray)
+                labels.append(label)
+    if not images:
+        print(f"Nenhuma imagem em {root}/person ou {root}/no_person")
+        exit(1)
+    return np.array(images, np.uint8), np.array(labels, np.int32)
+
+
+# =================== Modelo float (numpy) ===================
+
+def conv_same_s2(x, w, b):
+    """x: (H, W, C), w: (3, 3, C, O) no layout Keras. Padding 'same' de stride 2."""
+    h, wd, _ = x.shape
+    oh, ow = (h + 1) // 2, (wd + 1) // 2
+    pad = np.zeros((oh * 2 + 1, ow * 2 + 1, x.shape[2]), x.dtype)
+    pad[:h, :wd] = x  # 'same' com stride 2 e entrada par: padding só embaixo/à direita
+    out = np.zeros((oh, ow, w.shape[3]), np.float64)
+    for ky in range(3):
+        for kx in range(3):
+            patch = pad[ky:ky + oh * 2:2, kx:kx + ow * 2:2]
+            out += patch @ w[ky, kx]
+    return out + b
+
+
+def float_forward(params, gray, activations=None):
+    x = gray.astype(np.float64)[..., None] / 255.0
+    for i in range(4):
+        x = np.maximum(conv_same_s2(x, params[f"conv{i}_w"], params[f"conv{i}_b"]), 0.0)
+        if activations is not None:
+            activations[i].append(x.max())
+    pooled = x.mean(axis=(0, 1))
+    return float(pooled @ params["fc_w"][:, 0] + params["fc_b"][0])
+
+
+# =================== Quantização ===================
+
+def quantize_multiplier(real):
+    """Converte um multiplicador real em (mult Q31, shift) como no TFLite."""
+    if real == 0:
+        return 0, 0
+    mantissa, exponent = np.frexp(real)
+    mult = int(round(mantissa * (1 << 31)))
+    if mult == (1 << 31):
+        mult //= 2
+        exponent += 1
+    return mult, int(exponent)
+
+
+def quantize(params, calib_images):
+    activations = [[] for _ in range(4)]
+    for gray in calib_images:
+        float_forward(params, gray, activations)
+    # Percentil alto em vez do máximo absoluto: menos sensível a outliers
+    act_max = [max(float(np.percentile(a, 99.9)), 1e-3) for a in activations]
+
+    in_scale = 1.0 / 255.0
+    layers = []
+    for i in range(4):
+        w = params[f"conv{i}_w"]  # (3, 3, C, O)
+        b = params[f"conv{i}_b"]
+        out_scale = act_max[i] / 255.0
+        w_scale = np.maximum(np.abs(w).max(axis=(0, 1, 2)), 1e-8) / 127.0
+        wq = np.clip(np.round(w / w_scale), -127, 127).astype(np.int8)
+        bq = np.round(b / (in_scale * w_scale)).astype(np.int32)
+        mults, shifts = zip(*(quantize_multiplier(in_scale * s / out_scale) for s in w_scale))
+        layers.append({
+            "weights": wq.transpose(3, 0, 1, 2).copy(),  # (O, 3, 3, C): layout do firmware
+            "bias": bq,
+            "mult": np.array(mults, np.int64),
+            "shift": np.array(shifts, np.int64),
+        })
+        in_scale = out_scale
+
+    fw = params["fc_w"][:, 0]
+    fc_w_scale = max(float(np.abs(fw).max()), 1e-8) / 127.0
+    fc_wq = np.clip(np.round(fw / fc_w_scale), -127, 127).astype(np.int8)
+    pixels = (INPUT_SIZE // 16) ** 2
+    return {
+        "layers": layers,
+        "fc_weights": fc_wq,
+        "fc_scale": fc_w_scale * in_scale / pixels,
+        "fc_bias": float(params["fc_b"][0]),
+    }
+
+
+def requantize(acc, mult, shift):
+    """Mesma aritmética de PersonDetector::requantize()."""
+    total = 31 - shift
+    return (acc * mult + (1 << (total - 1))) >> total
+
+
+def int8_forward(model, gray):
+    """Referência inteira do kernel do firmware (para validar a exportação)."""
+    x = gray.astype(np.int64) - 128
+    x = x[..., None]
+    for layer in model["layers"]:
+        h, w, c = x.shape
+        oh, ow = (h + 1) // 2, (w + 1) // 2
+        pad = np.full((oh * 2 + 1, ow * 2 + 1, c), ACT_ZERO_POINT, np.int64)
+        pad[:h, :w] = x
+        acc = np.zeros((oh, ow, layer["weights"].shape[0]), np.int64)
+        for ky in range(3):
+            for kx in range(3):
+                patch = pad[ky:ky + oh * 2:2, kx:kx + ow * 2:2] - ACT_ZERO_POINT
+                acc += patch @ layer["weights"][:, ky, kx, :].astype(np.int64).T
+        acc += layer["bias"]
+        out = requantize(acc, layer["mult"], layer["shift"]) + ACT_ZERO_POINT
+        x = np.clip(out, ACT_ZERO_POINT, 127)
+    sums = x.sum(axis=(0, 1)) - ACT_ZERO_POINT * x.shape[0] * x.shape[1]
+    acc = int((sums * model["fc_weights"].astype(np.int64)).sum())
+    return acc * model["fc_scale"] + model["fc_bias"]
+
+
+# =================== Header C ===================
+
+def c_array(ctype, name, values, per_line=16):
+    values = [int(v) for v in np.asarray(values).ravel()]
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("  " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return f"static const {ctype} {name}[{len(values)}] = {{\n" + "\n".join(lines) + "\n};\n"
+
+
+def write_header(model, path, source):
+    out = []
+    out.append("// Gerado por person_model_tool.py a partir de " + os.path.basename(source) + ".")
+    out.append("// Não edite manualmente: regenere com `person_model_tool.py export`.")
+    out.append("#ifndef PERSON_MODEL_DATA_H")
+    out.append("#define PERSON_MODEL_DATA_H")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append("#define PERSON_MODEL_TRAINED 1")
+    out.append("")
+    out.append("struct PersonConvLayerData")
+    out.append("{")
+    out.append("  uint8_t inChannels;")
+    out.append("  uint8_t outChannels;")
+    out.append("  const int8_t *weights; // [saída][ky][kx][entrada]")
+    out.append("  const int32_t *bias;")
+    out.append("  const int32_t *mult;   // Multiplicador Q31 por canal de saída")
+    out.append("  const int32_t *shift;  // Positivo = deslocamento à esquerda")
+    out.append("};")
+    out.append("")
+    for i, layer in enumerate(model["layers"]):
+        out.append(c_array("int8_t", f"PERSON_CONV{i}_WEIGHTS", layer["weights"]))
+        out.append(c_array("int32_t", f"PERSON_CONV{i}_BIAS", layer["bias"], 8))
+        out.append(c_array("int32_t", f"PERSON_CONV{i}_MULT", layer["mult"], 8))
+        out.append(c_array("int32_t", f"PERSON_CONV{i}_SHIFT", layer["shift"]))
+    out.append("static const PersonConvLayerData PERSON_CONV_LAYERS[4] = {")
+    for i in range(4):
+        out.append(f"  {{{CHANNELS[i]}, {CHANNELS[i + 1]}, PERSON_CONV{i}_WEIGHTS, PERSON_CONV{i}_BIAS, "
+                   f"PERSON_CONV{i}_MULT, PERSON_CONV{i}_SHIFT}},")
+    out.append("};")
+    out.append("")
+    out.append(c_array("int8_t", "PERSON_FC_WEIGHTS", model["fc_weights"]))
+    out.append(f"static const float PERSON_FC_SCALE = {model['fc_scale']:.9e}f;")
+    out.append(f"static const float PERSON_FC_BIAS = {model['fc_bias']:.9e}f;")
+    out.append("")
+    out.append("#endif // PERSON_MODEL_DATA_H")
+    out.append("")
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+    print(f"[Export] Header gravado em {path}")
+
+
+# =================== Comandos ===================
+
+def cmd_train(args):
+    try:
+        import tensorflow as tf
+    except ImportError:
+        print("Erro: para treinar instale: pip install tensorflow")
+        exit(1)
+
+    images, labels = load_dataset(args.dataset)
+    x = images[..., None].astype(np.float32) / 255.0
+    model = tf.keras.Sequential([tf.keras.Input((INPUT_SIZE, INPUT_SIZE, 1))] + [
+        tf.keras.layers.Conv2D(c, 3, strides=2, padding="same", activation="relu") for c in CHANNELS[1:]
+    ] + [
+        tf.keras.layers.GlobalAveragePooling2D(),
+        tf.keras.layers.Dense(1),
+    ])
+    model.compile(optimizer="adam",
+                  loss=tf.keras.losses.BinaryCrossentropy(from_logits=True),
+                  metrics=[tf.keras.metrics.BinaryAccuracy(threshold=0.0)])
+    model.fit(x, labels, epochs=args.epochs, batch_size=64, validation_split=0.1, shuffle=True)
+
+    params = {}
+    convs = [l for l in model.layers if isinstance(l, tf.keras.layers.Conv2D)]
+    for i, layer in enumerate(convs):
+        params[f"conv{i}_w"], params[f"conv{i}_b"] = layer.get_weights()
+    params["fc_w"], params["fc_b"] = model.layers[-1].get_weights()
+    np.savez(args.out, **params)
+    print(f"[Train] Pesos float gravados em {args.out}")
+
+
+def evaluate(params, model, images, labels):
+    agree = correct_float = correct_int8 = 0
+    for gray, label in zip(images, labels):
+        f = float_forward(params, gray) > 0
+        q = int8_forward(model, gray) > 0
+        agree += f == q
+        correct_float += f == bool(label)
+        correct_int8 += q == bool(label)
+    n = len(images)
+    print(f"[Eval] {n} imagens: acurácia float {100.0 * correct_float / n:.1f}%, "
+          f"int8 {100.0 * correct_int8 / n:.1f}%, concordância {100.0 * agree / n:.1f}%")
+
+
+def cmd_export(args):
+    params = dict(np.load(args.weights))
+    images, labels = load_dataset(args.calibration, args.calibration_limit)
+    model = quantize(params, images)
+    evaluate(params, model, images, labels)
+    for path in args.out:
+        write_header(model, path, args.weights)
+
+
+def cmd_eval(args):
+    params = dict(np.load(args.weights))
+    calib, _ = load_dataset(args.calibration or args.dataset, args.calibration_limit)
+    model = quantize(params, calib)
+    images, labels = load_dataset(args.dataset)
+    evaluate(params, model, images, labels)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Detector de pessoas embarcado: treino e exportação int8")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_train = sub.add_parser("train", help="Treina o modelo float (TensorFlow)")
+    p_train.add_argument("dataset", help="Diretório com person/ e no_person/")
+    p_train.add_argument("--epochs", type=int, default=20)
+    p_train.add_argument("--out", default="person_model.npz")
+
+    p_export = sub.add_parser("export", help="Quantiza e gera person_model_data.h")
+    p_export.add_argument("weights", help="Arquivo .npz gerado por train")
+    p_export.add_argument("calibration", help="Diretório com person/ e no_person/ para calibração")
+    p_export.add_argument("--calibration-limit", type=int, default=200,
+                          help="Imagens por classe usadas na calibração")
+    p_export.add_argument("--out", action="append", required=True,
+                          help="Header de saída (pode repetir)")
+
+    p_eval = sub.add_parser("eval", help="Compara acurácia float x int8")
+    p_eval.add_argument("weights")
+    p_eval.add_argument("dataset")
+    p_eval.add_argument("--calibration", help="Diretório de calibração (padrão: o próprio dataset)")
+    p_eval.add_argument("--calibration-limit", type=int, default=200)
+
+    args = parser.parse_args()
+    {"train": cmd_train, "export": cmd_export, "eval": cmd_eval}[args.command](args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""
+Servidor local de inferência YOLO para a ESP32-CAM (substituto para testes).
+
+Implementa o contrato esperado por firmware/YoloController.h:
+    POST /infer  (Content-Type: image/jpeg)
+    -> {"detections":[{"label":"person","confidence":0.9,"box":[x,y,w,h]}],
+        "inference_ms": 35}
+
+Uso:
+    # Servidor com latência simulada (sem dependências extras)
+    python yolo_server.py serve --port 8000 --latency-ms 80 --jitter-ms 20
+
+    # Servidor com inferência real (pip install ultralytics)
+    python yolo_server.py serve --model yolov8n.pt
+
+    # Medir latência e vazão do servidor a partir do PC
+    python yolo_server.py bench http://localhost:8000/infer gravacao/ --concurrency 2 --duration 30
+
+No firmware, configure YOLO_INFERENCE_ENDPOINT = "http://<ip-do-pc>:8000/infer".
+"""
+
+import argparse
+import glob
+import json
+import os
+import random
+import statistics
+import threading
+import time
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class Stats:
+    """Acumula latências e calcula vazão por janela."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = []
+        self.errors = 0
+        self.window_start = time.time()
+
+    def add(self, latency_ms):
+        with self.lock:
+            self.latencies.append(latency_ms)
+
+    def error(self):
+        with self.lock:
+            self.errors += 1
+
+    def snapshot(self, reset=True):
+        with self.lock:
+            elapsed = max(time.time() - self.window_start, 1e-6)
+            latencies = self.latencies
+            errors = self.errors
+            if reset:
+                self.latencies = []
+                self.errors = 0
+                self.window_start = time.time()
+        return latencies, errors, elapsed
+
+
+def summarize(latencies, errors, elapsed):
+    if not latencies:
+        return f"0 req, {errors} erros"
+    ordered = sorted(latencies)
+    p95 = ordered[min(len(ordered) - 1, int(len(ordered) * 0.95))]
+    return (f"{len(latencies)} req em {elapsed:.1f} s ({len(latencies) / elapsed:.2f} fps), "
+            f"latência média {statistics.mean(latencies):.0f} ms, p50 {ordered[len(ordered) // 2]:.0f} ms, "
+            f"p95 {p95:.0f} ms, máx {ordered[-1]:.0f} ms, {errors} erros")
+
+
+# =================== Servidor ===================
+
+class Detector:
+    """Inferência real com ultralytics, ou detecções simuladas."""
+
+    def __init__(self, args):
+        self.args = args
+        self.model = None
+        if args.model:
+            try:
+                from ultralytics import YOLO
+            except ImportError:
+                print("Erro: para inferência real instale: pip install ultralytics")
+                exit(1)
+            self.model = YOLO(args.model)
+
+    def infer(self, jpeg):
+        if self.model is not None:
+            import cv2
+            import numpy as np
+            image = cv2.imdecode(np.frombuffer(jpeg, np.uint8), cv2.IMREAD_COLOR)
+            if image is None:
+                raise ValueError("JPEG inválido")
+            result = self.model(image, verbose=False)[0]
+            detections = []
+            for box in result.boxes:
+                x1, y1, x2, y2 = box.xyxy[0].tolist()
+                detections.append({
+                    "label": result.names[int(box.cls)],
+                    "confidence": round(float(box.conf), 3),
+                    "box": [int(x1), int(y1), int(x2 - x1), int(y2 - y1)],
+                })
+            return detections
+
+        # Simulação: latência configurável e uma pessoa em parte dos frames
+        delay = max(0.0, random.gauss(self.args.latency_ms, self.args.jitter_ms))
+        time.sleep(delay / 1000.0)
+        if random.random() < self.args.person_rate:
+            return [{"label": "person", "confidence": round(random.uniform(0.5, 0.95), 3),
+                     "box": [random.randint(0, 320), random.randint(0, 240), 120, 240]}]
+        return []
+
+
+def make_handler(detector, stats, lock):
+    class InferenceHandler(BaseHTTPRequestHandler):
+        def do_POST(self):
+            if self.path.rstrip("/") != "/infer":
+                self.send_error(404)
+                return
+
+            length = int(self.headers.get("Content-Length", 0))
+            jpeg = self.rfile.read(length)
+            start = time.time()
+            try:
+                # Um modelo por vez, como uma GPU/CPU dedicada
+                with lock:
+                    detections = detector.infer(jpeg)
+            except Exception as exc:
+                stats.error()
+                self.send_error(400, str(exc))
+                return
+
+            inference_ms = int((time.time() - start) * 1000)
+            stats.add(inference_ms)
+            body = json.dumps({"detections": detections, "inference_ms": inference_ms}).encode()
+            self.send_response(200)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, fmt, *args):
+            if detector.args.verbose:
+                super().log_message(fmt, *args)
+
+    return InferenceHandler
+
+
+def serve(args):
+    stats = Stats()
+    detector = Detector(args)
+    server = ThreadingHTTPServer(("0.0.0.0", args.port), make_handler(detector, stats, threading.Lock()))
+
+    def report():
+        while True:
+            time.sleep(args.report_interval)
+            print(f"[Servidor] {summarize(*stats.snapshot())}")
+
+    threading.Thread(target=report, daemon=True).start()
+    mode = f"modelo {args.model}" if args.model else f"simulado ({args.latency_ms}±{args.jitter_ms} ms)"
+    print(f"[Servidor] Inferência {mode} em http://0.0.0.0:{args.port}/infer")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+# =================== Benchmark ===================
+
+def bench(args):
+    if os.path.isdir(args.images):
+        paths = sorted(glob.glob(os.path.join(args.images, "*.jpg")))
+    else:
+        paths = sorted(glob.glob(args.images))
+    if not paths:
+        print(f"Nenhum JPEG encontrado em {args.images}")
+        exit(1)
+    frames = [open(p, "rb").read() for p in paths]
+
+    stats = Stats()
+    deadline = time.time() + args.duration
+
+    def worker(offset):
+        i = offset
+        while time.time() < deadline:
+            request = urllib.request.Request(args.url, data=frames[i % len(frames)],
+                                             headers={"Content-Type": "image/jpeg"})
+            start = time.time()
+            try:
+                with urllib.request.urlopen(request, timeout=10) as response:
+                    json.loads(response.read())
+                stats.add((time.time() - start) * 1000)
+            except Exception:
+                stats.error()
+            i += args.concurrency
+
+    threads = [threading.Thread(target=worker, args=(n,)) for n in range(args.concurrency)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    print(f"[Bench] {len(frames)} imagens, concorrência {args.concurrency}")
+    print(f"[Bench] {summarize(*stats.snapshot(reset=False))}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Servidor/benchmark de inferência YOLO para a ESP32-CAM")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_serve = sub.add_parser("serve", help="Inicia o servidor de inferência")
+    p_serve.add_argument("--port", type=int, default=8000)
+    p_serve.add_argument("--model", help="Pesos ultralytics (ex.: yolov8n.pt). Sem isso, simula.")
+    p_serve.add_argument("--latency-ms", type=float, default=80)
+    p_serve.add_argument("--jitter-ms", type=float, default=20)
+    p_serve.add_argument("--person-rate", type=float, default=0.3,
+                         help="Fração de frames simulados com pessoa")
+    p_serve.add_argument("--report-interval", type=int, default=10)
+    p_serve.add_argument("-v", "--verbose", action="store_true")
+
+    p_bench = sub.add_parser("bench", help="Mede latência e vazão de um endpoint")
+    p_bench.add_argument("url")
+    p_bench.add_argument("images", help="Diretório com JPEGs ou padrão glob")
+    p_bench.add_argument("--concurrency", type=int, default=1)
+    p_bench.add_argument("--duration", type=float, default=20)
+
+    args = parser.parse_args()
+    if args.command == "serve":
+        serve(args)
+    else:
+        bench(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -5,6 +5,7 @@
 //  - Vermelho: 25
 
 #include <Arduino.h>
+#include <MaquinaEstados.h>  // libraries/MaquinaEstados (veja Readme.md)
 
 class Led {
 public:
@@ -24,82 +25,108 @@ private:
 
 enum class LightState { Green, Yellow, Red };
 
+// Estados da máquina (índices da tabela TRAFFIC_STATES, mais abaixo)
+enum TrafficState : uint8_t {
+  STATE_RUNNING,  // Composto: o ciclo inteiro (começa no vermelho)
+  STATE_GREEN,
+  STATE_YELLOW,
+  STATE_RED,
+  NUM_TRAFFIC_STATES
+};
+
 class TrafficLight {
 public:
+  // Definido depois da tabela de estados, que ainda não existe aqui
   TrafficLight(Led* greenLed,
                Led* yellowLed,
                Led* redLed,
                unsigned long greenDurationMs,
                unsigned long yellowDurationMs,
-               unsigned long redDurationMs)
-      : green(greenLed),
-        yellow(yellowLed),
-        red(redLed),
-        greenMs(greenDurationMs),
-        yellowMs(yellowDurationMs),
-        redMs(redDurationMs),
-        state(LightState::Red),
-        lastChange(0) {}
+               unsigned long redDurationMs);
 
   void begin() {
     if (green) green->begin();
     if (yellow) yellow->begin();
     if (red) red->begin();
-    setState(LightState::Red);
+    machine.iniciar(millis());
   }
 
+  // A troca acontece na máquina quando o tempo do estado atual acaba
   void update() {
-    const unsigned long now = millis();
-    const unsigned long elapsed = now - lastChange;
-
-    switch (state) {
-      case LightState::Green:
-        if (elapsed >= greenMs) {
-          setState(LightState::Yellow);
-        }
-        break;
-      case LightState::Yellow:
-        if (elapsed >= yellowMs) {
-          setState(LightState::Red);
-        }
-        break;
-      case LightState::Red:
-        if (elapsed >= redMs) {
-          setState(LightState::Green);
-        }
-        break;
-    }
+    machine.atualizar(millis());
   }
 
-private:
-  void setState(LightState next) {
+  // Chamado pelas ações de entrada dos estados
+  void show(LightState next) {
     // Desliga todos antes de ligar o próximo estado
     if (green) green->off();
     if (yellow) yellow->off();
     if (red) red->off();
 
-    state = next;
-    lastChange = millis();
-
-    if (state == LightState::Green) {
+    if (next == LightState::Green) {
       if (green) green->on();
-    } else if (state == LightState::Yellow) {
+    } else if (next == LightState::Yellow) {
       if (yellow) yellow->on();
     } else { // Red
       if (red) red->on();
     }
   }
 
+  unsigned long getGreenMs() const { return greenMs; }
+  unsigned long getYellowMs() const { return yellowMs; }
+  unsigned long getRedMs() const { return redMs; }
+
+private:
   Led* green;
   Led* yellow;
   Led* red;
   unsigned long greenMs;
   unsigned long yellowMs;
   unsigned long redMs;
-  LightState state;
-  unsigned long lastChange;
+  MaquinaEstados<TrafficLight, NUM_TRAFFIC_STATES> machine;
+};
+
+// Ações e tempos dos estados
+void enterGreen(TrafficLight& t) { t.show(LightState::Green); }
+void enterYellow(TrafficLight& t) { t.show(LightState::Yellow); }
+void enterRed(TrafficLight& t) { t.show(LightState::Red); }
+uint32_t greenTime(const TrafficLight& t) { return t.getGreenMs(); }
+uint32_t yellowTime(const TrafficLight& t) { return t.getYellowMs(); }
+uint32_t redTime(const TrafficLight& t) { return t.getRedMs(); }
+
+constexpr EstadoDef<TrafficLight> TRAFFIC_STATES[] = {
+  // pai, filho inicial, entrada, saída, nome
+  {MAQUINA_SEM_ESTADO, STATE_RED, nullptr, nullptr, "Running"},
+  {STATE_RUNNING, MAQUINA_SEM_ESTADO, enterGreen, nullptr, "Green"},
+  {STATE_RUNNING, MAQUINA_SEM_ESTADO, enterYellow, nullptr, "Yellow"},
+  {STATE_RUNNING, MAQUINA_SEM_ESTADO, enterRed, nullptr, "Red"},
 };
 
+constexpr TransicaoDef<TrafficLight> TRAFFIC_TRANSITIONS[] = {
+  // origem, evento, destino, guarda, ação, após
+  {STATE_GREEN, MAQUINA_EVENTO_TEMPO, STATE_YELLOW, nullptr, nullptr, greenTime},
+  {STATE_YELLOW, MAQUINA_EVENTO_TEMPO, STATE_RED, nullptr, nullptr, yellowTime},
+  {STATE_RED, MAQUINA_EVENTO_TEMPO, STATE_GREEN, nullptr, nullptr, redTime},
+};
+
+constexpr TabelaEstados<TrafficLight, NUM_TRAFFIC_STATES> TRAFFIC_TABLE =
+    criarTabela(TRAFFIC_STATES, TRAFFIC_TRANSITIONS);
+static_assert(tabelaValida(TRAFFIC_TABLE), "Tabela de estados do semaforo invalida");
+
+TrafficLight::TrafficLight(Led* greenLed,
+                           Led* yellowLed,
+                           Led* redLed,
+                           unsigned long greenDurationMs,
+                           unsigned long yellowDurationMs,
+                           unsigned long redDurationMs)
+    : green(greenLed),
+      yellow(yellowLed),
+      red(redLed),
+      greenMs(greenDurationMs),
+      yellowMs(yellowDurationMs),
+      redMs(redDurationMs),
+      machine(TRAFFIC_TABLE, *this) {}
+
 // Ponteiros para demonstrar uso de POO + ponteiros
 Led* ledGreen = nullptr;
 Led* ledYellow = nullptr;
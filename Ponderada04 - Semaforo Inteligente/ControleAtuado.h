@@ -0,0 +1,227 @@
+#ifndef CONTROLE_ATUADO_H
+#define CONTROLE_ATUADO_H
+
+#include <stdint.h>
+#include "TabelaFases.h"
+
+// Controle atuado: a duração dos verdes segue os veículos detectados.
+//
+// Detector: contagem de veículos de uma aproximação, vinda de um sensor na
+// GPIO (botão, IR ou laço indutivo; pulso() pode ser chamado da interrupção)
+// ou de contagens recebidas por MQTT (somar()). As duas origens têm contadores
+// separados, então a ISR e o loop() nunca escrevem a mesma variável.
+//
+// ControleAtuado: estima a fila de cada aproximação pela diferença entre
+// chegadas (detector) e saídas (uma a cada headway enquanto o grupo não está
+// vermelho) e decide, a cada passada, se a fase verde continua:
+//   - verde mínimo: a fase nunca termina antes de minMs (regra do MotorFases)
+//   - fila: ainda há veículos estimados na fila do verde -> estende
+//   - brecha (gap): chegou veículo há menos de brechaMs -> estende
+//   - sem demanda na via transversal -> estende (o verde "descansa" onde está)
+//   - gap-out: nenhum dos casos acima, a fase termina
+//   - max-out: estendida até maxMs com veículos esperando do outro lado
+// A decisão entra no MotorFases como o parâmetro 'estender', então os limites
+// e a sequência do plano (com amarelo) continuam garantidos pela tabela.
+
+#ifndef ATUADO_BRECHA_MS
+#define ATUADO_BRECHA_MS 2000          // Intervalo máximo entre veículos para manter o verde
+#endif
+#ifndef ATUADO_HEADWAY_MS
+#define ATUADO_HEADWAY_MS 1000         // Intervalo de saída da fila com o grupo aberto
+#endif
+#ifndef ATUADO_DEBOUNCE_MS
+#define ATUADO_DEBOUNCE_MS 150         // Pulsos mais próximos que isso são repique do sensor
+#endif
+#ifndef ATUADO_FILA_MAX
+#define ATUADO_FILA_MAX 250.0f         // Limite da estimativa (sensor travado não cresce sem fim)
+#endif
+
+class Detector
+{
+public:
+  // Veículo detectado na GPIO (seguro em ISR: só esta função escreve aqui)
+  void pulso(uint32_t agora)
+  {
+    if (pulsos != 0 && agora - ultimoPulso < ATUADO_DEBOUNCE_MS)
+    {
+      return;
+    }
+    ultimoPulso = agora;
+    pulsos = pulsos + 1;
+  }
+
+  // Veículos contados fora do ESP32 (MQTT)
+  void somar(uint32_t veiculos) { externos += veiculos; }
+
+  uint32_t getContagem() const { return pulsos + externos; }
+
+private:
+  volatile uint32_t pulsos = 0;
+  volatile uint32_t ultimoPulso = 0;
+  uint32_t externos = 0;
+};
+
+enum class MotivoVerde : uint8_t
+{
+  Fixo,          // Fase sem verde ou sem folga (minMs == maxMs)
+  Minimo,        // Ainda no verde mínimo
+  Fila,          // Estendida: fila estimada no verde
+  Brecha,        // Estendida: veículo chegou há menos de brechaMs
+  SemDemanda,    // Estendida: ninguém esperando na via transversal
+  GapOut,        // Terminou: sem fila nem chegadas recentes
+  MaxOut         // Terminou: atingiu maxMs com demanda do outro lado
+};
+
+template <size_t N>
+class ControleAtuado
+{
+public:
+  // Um detector por grupo, na ordem das colunas do plano
+  template <typename... Detectores>
+  ControleAtuado(uint32_t brechaMs, uint32_t headwayMs, Detectores &...dets)
+      : brecha(brechaMs), headway(headwayMs), detectores{&dets...}
+  {
+    static_assert(sizeof...(Detectores) == N, "Um detector por coluna do plano");
+  }
+
+  // Atualiza as filas sem decidir nada (chamar a cada passada em qualquer
+  // plano, para a estimativa estar certa quando o plano atuado entrar)
+  void observar(const Plano<N> &plano, uint8_t fase, uint32_t agora)
+  {
+    const uint32_t dt = iniciado ? agora - ultimaObservacao : 0;
+    ultimaObservacao = agora;
+    iniciado = true;
+    for (size_t g = 0; g < N; g++)
+    {
+      const uint32_t contagem = detectores[g]->getContagem();
+      const uint32_t novos = contagem - vistos[g];
+      vistos[g] = contagem;
+      if (novos > 0)
+      {
+        chegadas[g] += novos;
+        ultimaChegada[g] = agora;
+        houveChegada[g] = true;
+        fila[g] += (float)novos;
+      }
+      if (plano.fases[fase].grupos[g] != Sinal::Vermelho)
+      {
+        fila[g] -= (float)dt / (float)headway;
+      }
+      fila[g] = fila[g] < 0 ? 0 : (fila[g] > ATUADO_FILA_MAX ? ATUADO_FILA_MAX : fila[g]);
+    }
+  }
+
+  // Decide se a fase atual continua. Chamar logo antes de motor.atualizar():
+  // quando retorna false depois de minMs (ou a fase chegou a maxMs) a fase
+  // termina nesta mesma passada, e o motivo é contado uma vez
+  bool estender(const Plano<N> &plano, uint8_t fase, uint32_t tempoNaFase, uint32_t agora)
+  {
+    observar(plano, fase, agora);
+    const Fase<N> &f = plano.fases[fase];
+    bool temVerde = false;
+    bool filaNoVerde = false;
+    bool brechaAberta = false;
+    bool demandaTransversal = false;
+    for (size_t g = 0; g < N; g++)
+    {
+      if (f.grupos[g] == Sinal::Verde)
+      {
+        temVerde = true;
+        filaNoVerde = filaNoVerde || fila[g] >= 1.0f;
+        brechaAberta = brechaAberta || (houveChegada[g] && agora - ultimaChegada[g] < brecha);
+      }
+      else if (fila[g] >= 1.0f)
+      {
+        demandaTransversal = true;
+      }
+    }
+
+    if (!temVerde || f.minMs == f.maxMs)
+    {
+      motivo = MotivoVerde::Fixo;
+      return false;
+    }
+    if (tempoNaFase < f.minMs)
+    {
+      motivo = MotivoVerde::Minimo;
+      return false;
+    }
+
+    if (filaNoVerde)
+    {
+      motivo = MotivoVerde::Fila;
+    }
+    else if (brechaAberta)
+    {
+      motivo = MotivoVerde::Brecha;
+    }
+    else if (!demandaTransversal)
+    {
+      motivo = MotivoVerde::SemDemanda;
+    }
+    else
+    {
+      motivo = MotivoVerde::GapOut;
+      gapOuts++;
+      return false;
+    }
+
+    if (tempoNaFase >= f.maxMs && demandaTransversal)
+    {
+      motivo = MotivoVerde::MaxOut;
+      maxOuts++;
+    }
+    return true;
+  }
+
+  void setParametros(uint32_t brechaMs, uint32_t headwayMs)
+  {
+    brecha = brechaMs;
+    headway = headwayMs;
+  }
+
+  // Veículos estimados na fila do grupo
+  float getFila(size_t grupo) const { return fila[grupo]; }
+  uint32_t getChegadas(size_t grupo) const { return chegadas[grupo]; }
+  MotivoVerde getMotivo() const { return motivo; }
+  uint32_t getGapOuts() const { return gapOuts; }
+  uint32_t getMaxOuts() const { return maxOuts; }
+
+private:
+  uint32_t brecha;
+  uint32_t headway;
+  Detector *detectores[N];
+  uint32_t vistos[N] = {};
+  uint32_t chegadas[N] = {};
+  uint32_t ultimaChegada[N] = {};
+  bool houveChegada[N] = {};
+  float fila[N] = {};
+  uint32_t ultimaObservacao = 0;
+  bool iniciado = false;
+  MotivoVerde motivo = MotivoVerde::Fixo;
+  uint32_t gapOuts = 0;
+  uint32_t maxOuts = 0;
+};
+
+inline const char *nomeMotivo(MotivoVerde m)
+{
+  switch (m)
+  {
+  case MotivoVerde::Minimo:
+    return "minimo";
+  case MotivoVerde::Fila:
+    return "fila";
+  case MotivoVerde::Brecha:
+    return "brecha";
+  case MotivoVerde::SemDemanda:
+    return "sem demanda";
+  case MotivoVerde::GapOut:
+    return "gap-out";
+  case MotivoVerde::MaxOut:
+    return "max-out";
+  default:
+    return "fixo";
+  }
+}
+
+#endif // CONTROLE_ATUADO_H
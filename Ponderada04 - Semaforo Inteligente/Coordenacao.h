@@ -0,0 +1,200 @@
+#ifndef COORDENACAO_H
+#define COORDENACAO_H
+
+#include <stdint.h>
+#include "TabelaFases.h"
+
+// Coordenação de vários cruzamentos em "onda verde".
+//
+// RelogioCoordenado: base de tempo comum. O cruzamento mestre publica o seu
+// millis() (MQTT, semaforo/sync) e os demais estimam o deslocamento e a deriva
+// do próprio relógio em relação a ele. Cada amostra vale mestre - local, que é
+// o deslocamento real menos o atraso da mensagem; como o atraso só soma, a
+// maior amostra de uma janela é a menos atrasada. A cada janela o erro da
+// previsão corrige o deslocamento e, aos poucos, a deriva (cristais diferem em
+// dezenas de ppm), então o relógio continua certo entre amostras e se o broker
+// sumir por um tempo.
+//
+// OndaVerde: com o relógio comum, a fase 0 (verde de S1, a via do corredor) de
+// cada cruzamento deve começar em instantes tempoCoordenado = offset (mod
+// ciclo), com offset = distância até o primeiro cruzamento / velocidade da
+// via. No ciclo coordenado cada fase dura o meio do intervalo [minMs, maxMs];
+// um cruzamento atrasado termina as fases em minMs e um adiantado as estende
+// até maxMs, recuperando até (maxMs - minMs) / 2 por fase pelo caminho mais
+// curto. Nenhuma fase sai dos limites do plano nem é pulada, então as regras
+// de segurança continuam valendo durante a sincronização.
+
+#ifndef COORD_JANELA_AMOSTRAS
+#define COORD_JANELA_AMOSTRAS 8          // Amostras por estimativa (1 por segundo)
+#endif
+#ifndef COORD_GANHO_DERIVA
+#define COORD_GANHO_DERIVA 0.5f          // Fração do erro de cada janela atribuída à deriva
+#endif
+#ifndef COORD_VALIDADE_MS
+#define COORD_VALIDADE_MS 60000UL        // Sem amostras por mais que isso, volta a rodar livre
+#endif
+#ifndef COORD_TOLERANCIA_MS
+#define COORD_TOLERANCIA_MS 50           // Adiantamento aceito sem estender a fase
+#endif
+
+class RelogioCoordenado
+{
+public:
+  void setMestre(bool ehMestre) { mestre = ehMestre; }
+  bool isMestre() const { return mestre; }
+
+  // Mensagem de sincronização: millis() do mestre no envio e millis() local na chegada
+  void amostra(uint32_t tempoMestre, uint32_t local)
+  {
+    const int32_t deslocamento = (int32_t)(tempoMestre - local);
+    ultimaAmostra = local;
+    recebidas++;
+    if (!temEstimativa)
+    {
+      // Primeira amostra: já serve para começar (a janela refina depois)
+      refDeslocamento = deslocamento;
+      refLocal = local;
+      temEstimativa = true;
+    }
+
+    if (amostrasJanela == 0 || deslocamento > melhorDeslocamento)
+    {
+      melhorDeslocamento = deslocamento;
+      melhorLocal = local;
+    }
+    if (++amostrasJanela < COORD_JANELA_AMOSTRAS)
+    {
+      return;
+    }
+    amostrasJanela = 0;
+
+    // Erro da previsão no instante da melhor amostra
+    const int32_t previsto = deslocamentoEm(melhorLocal);
+    const int32_t erro = melhorDeslocamento - previsto;
+    const int32_t intervalo = (int32_t)(melhorLocal - refLocal);
+    if (intervalo > 0 && janelas > 0)
+    {
+      deriva += COORD_GANHO_DERIVA * (float)erro / (float)intervalo;
+    }
+    refDeslocamento = melhorDeslocamento;
+    refLocal = melhorLocal;
+    ultimoErro = erro;
+    janelas++;
+  }
+
+  // Tempo do mestre estimado para o millis() local
+  uint32_t agora(uint32_t local) const
+  {
+    if (mestre || !temEstimativa)
+    {
+      return local;
+    }
+    return local + (uint32_t)deslocamentoEm(local);
+  }
+
+  bool sincronizado(uint32_t local) const
+  {
+    return mestre || (temEstimativa && local - ultimaAmostra < COORD_VALIDADE_MS);
+  }
+
+  int32_t getDeslocamento(uint32_t local) const { return deslocamentoEm(local); }
+  float getDerivaPpm() const { return deriva * 1e6f; }
+  int32_t getUltimoErro() const { return ultimoErro; }
+  uint32_t getAmostras() const { return recebidas; }
+
+private:
+  bool mestre = false;
+  bool temEstimativa = false;
+  int32_t refDeslocamento = 0;
+  uint32_t refLocal = 0;
+  float deriva = 0;              // ms do mestre por ms local, além de 1
+  int32_t melhorDeslocamento = 0;
+  uint32_t melhorLocal = 0;
+  uint8_t amostrasJanela = 0;
+  uint32_t janelas = 0;
+  uint32_t ultimaAmostra = 0;
+  uint32_t recebidas = 0;
+  int32_t ultimoErro = 0;
+
+  int32_t deslocamentoEm(uint32_t local) const
+  {
+    return refDeslocamento + (int32_t)(deriva * (float)(int32_t)(local - refLocal));
+  }
+};
+
+// Duração de cada fase no ciclo coordenado: meio do intervalo [minMs, maxMs]
+template <size_t N>
+constexpr uint32_t duracaoCoordenada(const Fase<N> &fase)
+{
+  return fase.minMs + (fase.maxMs - fase.minMs) / 2;
+}
+
+// Início da fase no ciclo coordenado (seguindo 'proxima' desde a fase 0)
+template <size_t N>
+constexpr uint32_t inicioCoordenado(const Plano<N> &plano, uint8_t fase)
+{
+  uint32_t t = 0;
+  uint8_t f = 0;
+  for (uint8_t passos = 0; passos < plano.numFases && f != fase; passos++)
+  {
+    t += duracaoCoordenada(plano.fases[f]);
+    f = plano.fases[f].proxima;
+  }
+  return t;
+}
+
+template <size_t N>
+constexpr uint32_t cicloCoordenado(const Plano<N> &plano)
+{
+  uint32_t t = 0;
+  uint8_t f = 0;
+  for (uint8_t passos = 0; passos < plano.numFases; passos++)
+  {
+    t += duracaoCoordenada(plano.fases[f]);
+    f = plano.fases[f].proxima;
+    if (f == 0)
+    {
+      break;
+    }
+  }
+  return t;
+}
+
+class OndaVerde
+{
+public:
+  // Instante (no relógio comum, módulo o ciclo) em que a fase 0 deve começar
+  void setOffset(uint32_t offsetMs) { offset = offsetMs; }
+  uint32_t getOffset() const { return offset; }
+
+  // Decide se a fase atual deve ser estendida para alinhar o ciclo. Só tem
+  // efeito depois de minMs (antes disso a fase não terminaria de qualquer jeito)
+  template <size_t N>
+  bool estender(const Plano<N> &plano, uint8_t fase, uint32_t tempoNaFase, uint32_t tempoCoordenado)
+  {
+    const Fase<N> &f = plano.fases[fase];
+    if (tempoNaFase < f.minMs || f.maxMs == f.minMs)
+    {
+      return false;
+    }
+
+    // Onde o ciclo deveria estar agora x onde esta fase termina no ciclo
+    // coordenado. erro > 0: atrasado, termina já (em minMs);
+    // erro < 0: adiantado, espera o relógio comum alcançar (até maxMs)
+    const uint32_t ciclo = cicloCoordenado(plano);
+    const uint32_t alvo = (tempoCoordenado - offset) % ciclo;
+    const uint32_t fimCoordenado = (inicioCoordenado(plano, fase) + duracaoCoordenada(f)) % ciclo;
+    const uint32_t d = (alvo + ciclo - fimCoordenado) % ciclo;
+    erro = d <= ciclo / 2 ? (int32_t)d : (int32_t)d - (int32_t)ciclo;
+    return erro < -COORD_TOLERANCIA_MS;
+  }
+
+  // Último erro calculado (ms; negativo = adiantado em relação à onda)
+  int32_t getErro() const { return erro; }
+
+private:
+  uint32_t offset = 0;
+  int32_t erro = 0;
+};
+
+#endif // COORDENACAO_H
@@ -0,0 +1,192 @@
+#ifndef DIARIO_FASES_H
+#define DIARIO_FASES_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Diário das trocas de fase: um registro binário por troca, com o instante em
+// microssegundos (esp_timer_get_time()), a fase que começou, a duração
+// configurada dela e por que a anterior terminou. A diferença entre dois
+// registros seguidos é a duração real da fase, e a diferença para minMs mostra
+// o atraso do loop (jitter) e as extensões.
+//
+// Anel sem trava: só uma tarefa escreve (o controlador) e qualquer outra pode
+// ler (HTTP, MQTT) sem parar o controlador. Cada posição tem a sequência do
+// evento guardado; o escritor a invalida antes de copiar o evento e a publica
+// depois, e o leitor confere a sequência antes e depois da cópia. Se o
+// escritor der a volta no anel durante a leitura, a cópia é descartada. Com
+// o anel cheio o evento mais antigo é sobrescrito.
+//
+// Formato serializado (little-endian, o mesmo do HTTP e do MQTT):
+//   'D' 'F' versão 0 | seq0 u32 | n u16 | tamanho do registro u16
+//   n x (tempoUs u64 | minMs u16 | maxMs u16 | plano | fase | causa | 0)
+
+#define DIARIO_VERSAO 1
+
+enum class CausaFase : uint8_t
+{
+  Partida,       // Motor iniciado
+  Tempo,         // Fase anterior terminou no tempo da tabela
+  Coordenada,    // Terminou no instante da onda verde
+  GapOut,        // Atuado: sem fila nem chegadas recentes
+  MaxOut,        // Atuado: verde estendido até maxMs
+  TrocaPlano     // Fim do amarelo com troca de plano pendente (entra pela faseEntrada do novo)
+};
+
+struct EventoFase
+{
+  uint64_t tempoUs;   // Logo depois de escrever os GPIOs da fase nova
+  uint16_t minMs;     // Duração configurada da fase que começou (até 65535)
+  uint16_t maxMs;
+  uint8_t plano;      // 0 normal, 1 atuado, 2 noturno (como no histórico)
+  uint8_t fase;       // Fase que começou
+  uint8_t causa;      // CausaFase: por que a fase anterior terminou
+  uint8_t reservado;
+};
+
+template <size_t CAPACIDADE>
+class DiarioFases
+{
+public:
+  static_assert(CAPACIDADE >= 2 && (CAPACIDADE & (CAPACIDADE - 1)) == 0, "Capacidade em potência de 2");
+
+  static constexpr size_t EVENTOS = CAPACIDADE;
+  static constexpr size_t CABECALHO = 12;
+  static constexpr size_t TAM_REGISTRO = 16;
+
+  // Só o controlador chama (um escritor)
+  void registrar(const EventoFase &evento)
+  {
+    const uint32_t n = escritos.load(std::memory_order_relaxed);
+    Posicao &p = posicoes[n & (CAPACIDADE - 1)];
+    p.seq.store(LIVRE, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    p.evento = evento;
+    p.seq.store(n, std::memory_order_release);
+    escritos.store(n + 1, std::memory_order_release);
+  }
+
+  // Sequência do evento mais antigo guardado e do próximo a ser gravado
+  uint32_t primeiraSeq() const
+  {
+    const uint32_t fim = escritos.load(std::memory_order_acquire);
+    return fim > CAPACIDADE ? fim - CAPACIDADE : 0;
+  }
+  uint32_t proxima() const { return escritos.load(std::memory_order_acquire); }
+
+  // Copia até 'max' eventos seguidos a partir de 'desde' (ou do mais antigo
+  // ainda guardado). Retorna quantos e, em 'primeiro', a sequência do primeiro
+  size_t ler(uint32_t desde, EventoFase *saida, size_t max, uint32_t &primeiro) const
+  {
+    const uint32_t fim = escritos.load(std::memory_order_acquire);
+    const uint32_t inicio = fim > CAPACIDADE ? fim - CAPACIDADE : 0;
+    if ((int32_t)(desde - inicio) < 0)
+    {
+      desde = inicio;
+    }
+    primeiro = desde;
+    size_t n = 0;
+    for (uint32_t seq = desde; (int32_t)(fim - seq) > 0 && n < max; seq++)
+    {
+      const Posicao &p = posicoes[seq & (CAPACIDADE - 1)];
+      EventoFase copia;
+      bool valido = p.seq.load(std::memory_order_acquire) == seq;
+      if (valido)
+      {
+        copia = p.evento;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        valido = p.seq.load(std::memory_order_relaxed) == seq;
+      }
+      if (!valido)
+      {
+        // Sobrescrito durante a leitura: pula o início perdido, mas não
+        // deixa buraco no meio do que já foi copiado
+        if (n > 0)
+        {
+          break;
+        }
+        primeiro = seq + 1;
+        continue;
+      }
+      saida[n++] = copia;
+    }
+    return n;
+  }
+
+  // Cabeçalho + registros em 'saida' (CABECALHO + n * TAM_REGISTRO bytes)
+  static size_t serializar(const EventoFase *eventos, size_t n, uint32_t seq0, uint8_t *saida)
+  {
+    escreverCabecalho(seq0, n, saida);
+    return CABECALHO + escreverRegistros(eventos, n, saida + CABECALHO);
+  }
+
+  // As duas partes separadas, para enviar muitos eventos em pedaços
+  static void escreverCabecalho(uint32_t seq0, size_t n, uint8_t *saida)
+  {
+    saida[0] = 'D';
+    saida[1] = 'F';
+    saida[2] = DIARIO_VERSAO;
+    saida[3] = 0;
+    escrever(saida + 4, seq0, 4);
+    escrever(saida + 8, n, 2);
+    escrever(saida + 10, TAM_REGISTRO, 2);
+  }
+
+  static size_t escreverRegistros(const EventoFase *eventos, size_t n, uint8_t *saida)
+  {
+    for (size_t i = 0; i < n; i++, saida += TAM_REGISTRO)
+    {
+      escrever(saida, eventos[i].tempoUs, 8);
+      escrever(saida + 8, eventos[i].minMs, 2);
+      escrever(saida + 10, eventos[i].maxMs, 2);
+      saida[12] = eventos[i].plano;
+      saida[13] = eventos[i].fase;
+      saida[14] = eventos[i].causa;
+      saida[15] = 0;
+    }
+    return n * TAM_REGISTRO;
+  }
+
+private:
+  static constexpr uint32_t LIVRE = 0xFFFFFFFF;
+
+  struct Posicao
+  {
+    std::atomic<uint32_t> seq{LIVRE};
+    EventoFase evento = {};
+  };
+
+  Posicao posicoes[CAPACIDADE];
+  std::atomic<uint32_t> escritos{0};
+
+  static void escrever(uint8_t *p, uint64_t v, size_t bytes)
+  {
+    for (size_t i = 0; i < bytes; i++)
+    {
+      p[i] = (uint8_t)(v >> (8 * i));
+    }
+  }
+};
+
+inline const char *nomeCausa(CausaFase c)
+{
+  switch (c)
+  {
+  case CausaFase::Partida:
+    return "partida";
+  case CausaFase::Tempo:
+    return "tempo";
+  case CausaFase::Coordenada:
+    return "onda verde";
+  case CausaFase::GapOut:
+    return "gap-out";
+  case CausaFase::MaxOut:
+    return "max-out";
+  case CausaFase::TrocaPlano:
+    return "troca de plano";
+  }
+  return "?";
+}
+
+#endif // DIARIO_FASES_H
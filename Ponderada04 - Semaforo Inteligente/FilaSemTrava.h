@@ -0,0 +1,102 @@
+#ifndef FILA_SEM_TRAVA_H
+#define FILA_SEM_TRAVA_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Troca de dados entre a tarefa do controlador e a tarefa de rede sem mutex:
+// nenhuma das duas espera pela outra, então um cliente HTTP lento ou um
+// connect() do MQTT travado não atrasam uma troca de fase.
+//
+// FilaSPSC: fila circular de um produtor e um consumidor (comandos da rede
+// para o controlador, amostras do controlador para a rede). Cada lado só
+// escreve o próprio índice; o item é copiado antes de o índice ser publicado
+// (release) e lido depois de o índice ser visto (acquire). Fila cheia
+// descarta o item novo e conta o descarte.
+//
+// Instantaneo: o último valor de um tipo copiável (a telemetria), escrito por
+// uma tarefa e lido por outras. Contador ímpar = escrita em andamento; o
+// leitor repete a cópia se o contador mudou no meio dela.
+
+template <typename T, size_t N>
+class FilaSPSC
+{
+public:
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "Tamanho em potência de 2");
+
+  // Só o produtor chama
+  bool enviar(const T &item)
+  {
+    const uint32_t e = escrita.load(std::memory_order_relaxed);
+    if (e - leitura.load(std::memory_order_acquire) >= N)
+    {
+      descartados.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    itens[e & (N - 1)] = item;
+    escrita.store(e + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Só o consumidor chama
+  bool receber(T &item)
+  {
+    const uint32_t l = leitura.load(std::memory_order_relaxed);
+    if (l == escrita.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    item = itens[l & (N - 1)];
+    leitura.store(l + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Total já enviado / já recebido (o produtor sabe que o item k foi tratado
+  // quando getRecebidos() passa de k)
+  uint32_t getEnviados() const { return escrita.load(std::memory_order_acquire); }
+  uint32_t getRecebidos() const { return leitura.load(std::memory_order_acquire); }
+  uint32_t getDescartados() const { return descartados.load(std::memory_order_relaxed); }
+
+private:
+  T itens[N];
+  std::atomic<uint32_t> escrita{0};
+  std::atomic<uint32_t> leitura{0};
+  std::atomic<uint32_t> descartados{0};
+};
+
+template <typename T>
+class Instantaneo
+{
+public:
+  // Só uma tarefa escreve
+  void publicar(const T &novo)
+  {
+    const uint32_t v = versao.load(std::memory_order_relaxed);
+    versao.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    valor = novo;
+    versao.store(v + 2, std::memory_order_release);
+  }
+
+  T ler() const
+  {
+    T copia;
+    uint32_t antes;
+    uint32_t depois;
+    do
+    {
+      antes = versao.load(std::memory_order_acquire);
+      copia = valor;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      depois = versao.load(std::memory_order_relaxed);
+    } while ((antes & 1) != 0 || antes != depois);
+    return copia;
+  }
+
+private:
+  T valor = {};
+  std::atomic<uint32_t> versao{0};
+};
+
+#endif // FILA_SEM_TRAVA_H
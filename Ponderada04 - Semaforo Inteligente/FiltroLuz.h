@@ -0,0 +1,87 @@
+#ifndef FILTRO_LUZ_H
+#define FILTRO_LUZ_H
+
+#include <math.h>
+#include <stdint.h>
+
+// Filtro da luminosidade do LDR.
+//
+// Cada amostra de entrada já é a média de um quadro do ADC contínuo (centenas
+// de conversões feitas pelo DMA). A mediana das últimas JANELA amostras tira
+// picos isolados (flash de farol, interferência do Wi-Fi no ADC) e a média
+// móvel exponencial (EMA) suaviza o que sobra. O ruído é o desvio padrão das
+// amostras brutas em torno do valor filtrado, também em EMA, e vai para a
+// telemetria para mostrar quão perto dos limites da histerese o sinal oscila.
+//
+// Não depende do Arduino: dá para testar o mesmo filtro no PC.
+
+template <uint8_t JANELA>
+class FiltroLuz
+{
+public:
+  static_assert(JANELA % 2 == 1 && JANELA <= 15, "Janela da mediana: ímpar e pequena");
+
+  // alfa: peso de cada amostra na EMA (0 < alfa <= 1; menor = mais suave)
+  explicit FiltroLuz(float alfaEma) : alfa(alfaEma) {}
+
+  // Nova amostra bruta; retorna o valor filtrado
+  int amostra(int bruto)
+  {
+    ultimoBruto = bruto;
+    janela[pos] = bruto;
+    pos = (pos + 1) % JANELA;
+    if (cheios < JANELA)
+    {
+      cheios++;
+    }
+    const float m = (float)mediana();
+
+    if (total == 0)
+    {
+      ema = m;
+    }
+    else
+    {
+      ema += alfa * (m - ema);
+      const float desvio = (float)bruto - ema;
+      variancia += alfa * (desvio * desvio - variancia);
+    }
+    total++;
+    return getValor();
+  }
+
+  int getValor() const { return (int)(ema + 0.5f); }
+  int getBruto() const { return ultimoBruto; }
+  float getRuido() const { return sqrtf(variancia); }
+  uint32_t getAmostras() const { return total; }
+
+private:
+  float alfa;
+  int janela[JANELA] = {};
+  uint8_t pos = 0;
+  uint8_t cheios = 0;
+  float ema = 0;
+  float variancia = 0;
+  int ultimoBruto = 0;
+  uint32_t total = 0;
+
+  int mediana() const
+  {
+    // Inserção numa cópia: poucas amostras, sem alocação
+    int ordenada[JANELA];
+    for (uint8_t i = 0; i < cheios; i++)
+    {
+      int v = janela[i];
+      int j = i;
+      while (j > 0 && ordenada[j - 1] > v)
+      {
+        ordenada[j] = ordenada[j - 1];
+        j--;
+      }
+      ordenada[j] = v;
+    }
+    return ordenada[cheios / 2];
+  }
+};
+
+#endif // FILTRO_LUZ_H
@@ -0,0 +1,215 @@
+// Gerado por gerar_pagina.py a partir de web/index.html - não editar à mão.
+#ifndef PAGINA_WEB_H
+#define PAGINA_WEB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+// 11718 bytes de HTML, 3144 bytes em gzip
+#define PAGINA_ETAG "\"37f10a2e8638ac30\""
+static const size_t PAGINA_GZ_TAMANHO = 3144;
+static const uint8_t PAGINA_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x5a, 0xdd, 0x6e, 0x1b, 0xb9,
+    0x15, 0xbe, 0xcf, 0x53, 0x70, 0x15, 0x64, 0x25, 0x6f, 0x35, 0xf2, 0x48, 0xb2, 0x64, 0x5b, 0xb6,
+    0xd5, 0x66, 0xb3, 0x4e, 0x91, 0x22, 0x7f, 0x5d, 0x3b, 0x2d, 0x16, 0x45, 0x2f, 0xa8, 0x19, 0x8e,
+    0xc4, 0x64, 0x66, 0x38, 0xe5, 0x50, 0xb2, 0x9d, 0x45, 0x80, 0x3e, 0x40, 0x81, 0x02, 0x2d, 0x50,
+    0x74, 0xf7, 0xa6, 0x08, 0x5a, 0xb4, 0x57, 0xbd, 0xef, 0xbd, 0xdf, 0x64, 0x5f, 0xa0, 0x7d, 0x84,
+    0x1e, 0x72, 0x38, 0x23, 0x72, 0x7e, 0x24, 0x39, 0x48, 0x16, 0x4e, 0xe2, 0xd1, 0x90, 0x3c, 0xbf,
+    0xdf, 0x39, 0x3c, 0xe7, 0x28, 0xa7, 0x9f, 0x7d, 0xf5, 0xe2, 0xd1, 0xe5, 0x37, 0x2f, 0xcf, 0xd1,
+    0x42, 0x44, 0xe1, 0xf4, 0xde, 0xa9, 0xfc, 0x85, 0x42, 0x1c, 0xcf, 0xcf, 0x5a, 0x89, 0x70, 0xbe,
+    0xfc, 0xba, 0x25, 0xdf, 0x11, 0xec, 0x4f, 0xef, 0x21, 0x74, 0x1a, 0x11, 0x81, 0x91, 0xb7, 0xc0,
+    0x3c, 0x25, 0xe2, 0xac, 0xf5, 0xea, 0xf2, 0xb1, 0x73, 0xd4, 0x5a, 0x2f, 0xc4, 0x38, 0x22, 0x67,
+    0xad, 0x15, 0x25, 0x57, 0x09, 0xe3, 0xa2, 0x85, 0x3c, 0x16, 0x0b, 0x12, 0xc3, 0xc6, 0x2b, 0xea,
+    0x8b, 0xc5, 0x99, 0x4f, 0x56, 0xd4, 0x23, 0x8e, 0xfa, 0xd0, 0x45, 0x34, 0xa6, 0x82, 0xe2, 0xd0,
+    0x49, 0x3d, 0x1c, 0x92, 0xb3, 0x7e, 0xcf, 0xcd, 0x08, 0x09, 0x2a, 0x42, 0x32, 0xbd, 0x20, 0xd1,
+    0xed, 0xfb, 0x80, 0x71, 0x86, 0x9e, 0x00, 0x89, 0x90, 0xce, 0x81, 0x0c, 0x39, 0xdd, 0xcf, 0x16,
+    0xe5, 0xb6, 0x54, 0xdc, 0x64, 0x4f, 0x08, 0x7d, 0x81, 0xbe, 0x45, 0x11, 0xe6, 0x73, 0x1a, 0x4f,
+    0x90, 0x7b, 0x82, 0x12, 0xec, 0xfb, 0x34, 0x9e, 0xab, 0xe7, 0x19, 0xbb, 0x76, 0x52, 0xfa, 0x56,
+    0x7d, 0x9c, 0x31, 0xee, 0x13, 0xee, 0xc0, 0xab, 0x13, 0xf4, 0x4e, 0x1d, 0x9c, 0x31, 0xff, 0x06,
+    0x7d, 0xab, 0x1e, 0x11, 0x0a, 0x40, 0x56, 0x27, 0xc0, 0x11, 0x0d, 0x6f, 0x26, 0xa8, 0x7d, 0x41,
+    0xe6, 0x8c, 0xa0, 0x57, 0x4f, 0xda, 0x5d, 0x74, 0x89, 0x17, 0x2c, 0xc2, 0x5d, 0xf4, 0x73, 0x12,
+    0x93, 0x15, 0xfc, 0xfe, 0x15, 0xe1, 0x3e, 0x8e, 0xe1, 0x21, 0xc5, 0x71, 0xea, 0xa4, 0x84, 0xd3,
+    0xe0, 0x44, 0xd3, 0x98, 0x61, 0xef, 0xcd, 0x9c, 0xb3, 0x65, 0xec, 0x4f, 0x50, 0x48, 0x63, 0x82,
+    0xb9, 0x33, 0xe7, 0xd8, 0xa7, 0x20, 0x7c, 0xa7, 0x3f, 0x1c, 0xf9, 0x64, 0xde, 0x45, 0xf7, 0xc7,
+    0xe3, 0x43, 0x42, 0x30, 0x72, 0x1f, 0xc0, 0xf3, 0xe1, 0xf8, 0x60, 0x86, 0x07, 0xa8, 0xef, 0xba,
+    0x0f, 0xf6, 0x72, 0x22, 0x11, 0x8d, 0x9d, 0x05, 0xa1, 0xf3, 0x85, 0x98, 0xc8, 0x85, 0xd5, 0x22,
+    0x5f, 0x28, 0x14, 0x1b, 0xb8, 0xc9, 0x75, 0xfe, 0xd2, 0x63, 0x21, 0xe3, 0x13, 0x74, 0x7f, 0x38,
+    0x1c, 0x66, 0xaf, 0x32, 0xd5, 0x7a, 0xd2, 0xf4, 0x18, 0x44, 0xe0, 0x85, 0x82, 0x11, 0xbe, 0xce,
+    0x4c, 0x3f, 0x41, 0x47, 0xae, 0x41, 0xa1, 0x30, 0x1d, 0xc2, 0x4b, 0xc1, 0x2c, 0x22, 0xd2, 0xed,
+    0x06, 0x05, 0x41, 0xae, 0x85, 0x83, 0xc1, 0x19, 0xb0, 0xdb, 0x93, 0x0e, 0xe1, 0x25, 0x29, 0xae,
+    0x16, 0x54, 0x10, 0x9b, 0x2e, 0xd8, 0x5b, 0x08, 0x16, 0x4d, 0xd0, 0xd0, 0x60, 0x59, 0xa3, 0x89,
+    0xcd, 0x71, 0xd1, 0xb7, 0xfd, 0x02, 0x3e, 0x24, 0xb0, 0xbb, 0x37, 0x22, 0x51, 0x03, 0xf9, 0xbe,
+    0x41, 0x5e, 0xc9, 0x99, 0x2e, 0xb0, 0xcf, 0xae, 0xe0, 0x50, 0x72, 0xad, 0xfe, 0x1e, 0xc0, 0x5f,
+    0x3e, 0x9f, 0xe1, 0x8e, 0xdb, 0x55, 0x3f, 0xbd, 0xe1, 0x5e, 0x1d, 0xe7, 0xa4, 0x8e, 0x71, 0xbf,
+    0xd7, 0x5f, 0x33, 0x66, 0x09, 0xf6, 0xa8, 0x00, 0x90, 0xb8, 0xbd, 0x63, 0xdb, 0xe4, 0x98, 0xfb,
+    0xc5, 0x69, 0x13, 0x0a, 0x96, 0x59, 0x34, 0x0c, 0x25, 0x2c, 0x96, 0xa9, 0xed, 0xcb, 0xc2, 0x2c,
+    0xc3, 0x8a, 0x7b, 0x0a, 0x3d, 0xcd, 0xfd, 0x0a, 0xdd, 0x5a, 0x4d, 0x57, 0x59, 0x40, 0x9d, 0xb4,
+    0xd5, 0x1c, 0x14, 0xc0, 0x12, 0x1c, 0x00, 0x0b, 0x31, 0xc7, 0xc0, 0x7d, 0xea, 0x19, 0xe2, 0x2b,
+    0x02, 0x2d, 0x86, 0x29, 0x22, 0x38, 0x25, 0x5d, 0x83, 0xde, 0xfa, 0x6d, 0x45, 0xc3, 0xc9, 0x82,
+    0xad, 0x4c, 0x4c, 0xe4, 0x84, 0x34, 0xcd, 0x10, 0x0b, 0xf2, 0x4d, 0xc7, 0x19, 0x25, 0xd7, 0x7b,
+    0x0d, 0x62, 0x8e, 0xa4, 0x33, 0xdc, 0x2d, 0xde, 0x48, 0x05, 0x16, 0xcb, 0x14, 0xa2, 0x87, 0xae,
+    0x4d, 0xea, 0xd3, 0x34, 0x09, 0x31, 0x18, 0x5e, 0xbe, 0xcd, 0x89, 0xcb, 0x67, 0x47, 0x90, 0x28,
+    0x91, 0x8c, 0x1d, 0xc0, 0xe1, 0x32, 0x8a, 0xc1, 0xac, 0x9c, 0x24, 0x04, 0x8b, 0x8e, 0x44, 0xb4,
+    0x13, 0x50, 0xd1, 0x95, 0x51, 0x05, 0x01, 0xd0, 0x19, 0x48, 0xe4, 0x77, 0x51, 0x3f, 0xe0, 0x7b,
+    0x85, 0x7c, 0x73, 0x9c, 0xd8, 0x76, 0x6d, 0x44, 0xae, 0x2d, 0x1c, 0x38, 0x35, 0xda, 0x21, 0x36,
+    0x6a, 0xc3, 0xd6, 0x84, 0xc7, 0xfd, 0xe0, 0x28, 0x38, 0x0e, 0x70, 0x03, 0x40, 0xa4, 0xbd, 0xea,
+    0x3c, 0x88, 0xc3, 0xb0, 0xc1, 0x4b, 0x86, 0x78, 0x3d, 0xec, 0x09, 0xba, 0x22, 0xb5, 0xa8, 0x6c,
+    0x4c, 0x50, 0x07, 0x8f, 0x1e, 0x3e, 0x1e, 0xb9, 0x59, 0x82, 0x3a, 0x18, 0x61, 0xf7, 0xe0, 0xd8,
+    0x4e, 0x50, 0x75, 0xc1, 0x6e, 0xc0, 0x40, 0xe5, 0xf3, 0x0e, 0xe4, 0xf3, 0x51, 0x03, 0x02, 0x24,
+    0x00, 0x14, 0x0a, 0x14, 0x00, 0x0e, 0xc7, 0xe0, 0x8e, 0xc3, 0x51, 0x17, 0x92, 0x52, 0x17, 0x14,
+    0x3a, 0xd8, 0x6b, 0x34, 0xf5, 0x62, 0x58, 0x17, 0x9b, 0x10, 0x85, 0x3b, 0x25, 0x05, 0x23, 0x6c,
+    0x8f, 0x1a, 0x59, 0xf4, 0x56, 0x38, 0x5c, 0x92, 0xfa, 0x14, 0x70, 0xb4, 0x66, 0xa3, 0xde, 0x5f,
+    0xe9, 0x1c, 0x3d, 0x63, 0xa1, 0x6f, 0x11, 0x04, 0x08, 0xd2, 0x98, 0xa5, 0xd4, 0x87, 0x84, 0xe2,
+    0xd4, 0xe5, 0xe1, 0x2c, 0xdf, 0x4a, 0x38, 0xc0, 0x1d, 0xd5, 0x78, 0x32, 0xc4, 0x33, 0x12, 0x56,
+    0xc1, 0x1f, 0x84, 0xa4, 0xd0, 0xe9, 0xf5, 0x32, 0x15, 0x34, 0xb8, 0x71, 0xf4, 0x3d, 0x0b, 0xb6,
+    0x07, 0x25, 0x89, 0x33, 0x23, 0xe2, 0x8a, 0x90, 0x78, 0x07, 0xa3, 0x58, 0x8a, 0x8c, 0x5d, 0x5b,
+    0x9a, 0x84, 0xb3, 0x39, 0x27, 0x69, 0xea, 0xcc, 0xf0, 0x5a, 0x7a, 0x7d, 0x83, 0x48, 0x40, 0xe4,
+    0x44, 0xf2, 0xcb, 0x6a, 0xd8, 0x84, 0x6f, 0xe2, 0xca, 0x9f, 0x1d, 0xf0, 0x2d, 0x33, 0x4b, 0x10,
+    0x4a, 0x94, 0x2c, 0xa8, 0xef, 0xaf, 0x35, 0x48, 0x58, 0x8e, 0x7a, 0x4e, 0x20, 0xce, 0x01, 0xd1,
+    0x75, 0xc8, 0xa2, 0x31, 0x14, 0x25, 0x80, 0x2f, 0x99, 0xed, 0x47, 0xe5, 0xfc, 0xd2, 0xdf, 0xab,
+    0xd7, 0x2d, 0xa0, 0xe1, 0xda, 0xc8, 0xc6, 0xb5, 0xfb, 0x60, 0x97, 0x3b, 0xfd, 0xd8, 0xcd, 0x22,
+    0x26, 0x08, 0xfc, 0x43, 0x57, 0x47, 0x4c, 0x10, 0x1c, 0x79, 0xf0, 0x3c, 0xd2, 0x1f, 0x0e, 0x46,
+    0xae, 0x6b, 0x87, 0xcf, 0x8e, 0xf1, 0xad, 0x0c, 0x0d, 0x60, 0x1d, 0x99, 0x11, 0xde, 0x80, 0x03,
+    0x95, 0x77, 0x14, 0x82, 0xd3, 0x72, 0xf6, 0xa9, 0x40, 0x64, 0xfb, 0xc5, 0xdd, 0x80, 0xee, 0xa6,
+    0xa8, 0xd3, 0x16, 0x8d, 0x98, 0xcf, 0x00, 0x29, 0xfe, 0x9c, 0xa4, 0x9b, 0x41, 0xab, 0xd2, 0xad,
+    0x05, 0x42, 0x58, 0x74, 0xae, 0xb8, 0x7c, 0x2d, 0xff, 0xdd, 0x51, 0x72, 0x8d, 0x6a, 0xc1, 0x92,
+    0x9a, 0x32, 0x42, 0xc9, 0x51, 0x88, 0x51, 0x64, 0x60, 0x75, 0x45, 0xda, 0x37, 0xa8, 0x7d, 0x19,
+    0x8f, 0xb6, 0x85, 0xc6, 0xd6, 0x1c, 0x0c, 0x26, 0x5d, 0xf2, 0x54, 0xda, 0xd4, 0x27, 0x01, 0x5e,
+    0x86, 0xa2, 0x2a, 0xd7, 0x8f, 0x96, 0x94, 0x3f, 0x3c, 0xed, 0x66, 0x72, 0xd2, 0x78, 0x83, 0xa4,
+    0xa5, 0xa8, 0xce, 0xeb, 0xd0, 0xf1, 0x78, 0x6c, 0x53, 0x5a, 0x42, 0xd6, 0x81, 0x3a, 0xb9, 0x9a,
+    0x07, 0x3f, 0xe9, 0x75, 0x6e, 0x46, 0xd5, 0x66, 0xa4, 0x88, 0xb8, 0x06, 0x27, 0x23, 0x5d, 0x4a,
+    0xd9, 0x38, 0x99, 0xa0, 0x98, 0xc5, 0x4d, 0x85, 0x5c, 0x7f, 0x50, 0xc2, 0x8e, 0xbe, 0x37, 0x1a,
+    0x6e, 0x0d, 0x03, 0x51, 0x39, 0x60, 0x12, 0x46, 0x4d, 0x80, 0x5b, 0x0d, 0x09, 0x8d, 0x17, 0xd0,
+    0x68, 0x88, 0x93, 0xe6, 0x2c, 0xac, 0x0a, 0x10, 0x9f, 0x78, 0x8c, 0xe3, 0x0c, 0x9c, 0xa6, 0xac,
+    0x85, 0xad, 0x67, 0x21, 0xf3, 0xde, 0x9c, 0x6c, 0xad, 0x59, 0xb6, 0x83, 0x7c, 0x2b, 0xdc, 0x0e,
+    0x2c, 0xb8, 0x95, 0xab, 0xd1, 0xb5, 0xf5, 0x77, 0xab, 0x27, 0x07, 0x8d, 0xf5, 0xe4, 0x58, 0x87,
+    0xf4, 0xc6, 0x72, 0x52, 0xf2, 0x29, 0x61, 0xb9, 0x9e, 0x91, 0x5b, 0x39, 0xe7, 0x48, 0xd0, 0xdd,
+    0x2d, 0x56, 0x37, 0x77, 0x78, 0x06, 0xe9, 0x18, 0xd8, 0xe3, 0xf0, 0x63, 0x26, 0x02, 0x8b, 0xb8,
+    0x58, 0xf2, 0xf8, 0x8e, 0xa2, 0x07, 0xc1, 0xf1, 0x51, 0x71, 0x93, 0x8d, 0x0e, 0x3d, 0xfb, 0xf2,
+    0xd2, 0xd4, 0x69, 0x1c, 0x30, 0x68, 0x7c, 0x3d, 0x89, 0x8f, 0xfa, 0xdc, 0x60, 0x57, 0xb4, 0xf5,
+    0x15, 0x70, 0xf3, 0x35, 0xb8, 0x31, 0x60, 0x2d, 0xe6, 0x1e, 0xf3, 0x9b, 0xb2, 0xd3, 0x31, 0xf1,
+    0x48, 0x50, 0x91, 0x40, 0x25, 0xc1, 0x66, 0x29, 0xca, 0xf9, 0xbf, 0x98, 0x07, 0x3c, 0x62, 0x4b,
+    0x4e, 0x01, 0xa6, 0xcf, 0xc9, 0x55, 0x1b, 0xb2, 0x0f, 0x83, 0x2a, 0x4d, 0x96, 0x5a, 0xe5, 0xec,
+    0xe7, 0x8f, 0x87, 0xc3, 0xa3, 0x03, 0xbb, 0xbc, 0x24, 0x11, 0x96, 0x83, 0x0c, 0x67, 0x45, 0xd3,
+    0x25, 0xbe, 0x6b, 0x41, 0x67, 0x87, 0xa5, 0x4a, 0x6d, 0xc3, 0x9a, 0xde, 0x7d, 0x68, 0xd4, 0x92,
+    0x0d, 0x17, 0x6a, 0x49, 0x9c, 0x72, 0x41, 0x77, 0x64, 0x50, 0xcd, 0xcb, 0xa0, 0x81, 0xdb, 0x54,
+    0xd1, 0x0d, 0xbc, 0x21, 0x19, 0x35, 0x56, 0x74, 0x75, 0x2d, 0xad, 0xf9, 0xb2, 0x56, 0x75, 0x25,
+    0xb4, 0x4f, 0x79, 0xe6, 0xd9, 0x09, 0xca, 0x72, 0x7f, 0x63, 0xd1, 0xb0, 0xe9, 0x6e, 0x6b, 0x48,
+    0x02, 0xe1, 0xf2, 0xed, 0xba, 0xb2, 0x07, 0x6e, 0x40, 0xb0, 0x09, 0x06, 0xf5, 0xe5, 0xdf, 0xfd,
+    0x3e, 0x96, 0x3f, 0x3b, 0x27, 0xc9, 0xba, 0xe2, 0xd4, 0xad, 0x49, 0x56, 0xa3, 0x8a, 0x9c, 0x3d,
+    0x48, 0x89, 0x11, 0x09, 0x17, 0xac, 0x27, 0x23, 0xac, 0x84, 0xec, 0xc3, 0x03, 0x6f, 0xe8, 0x9d,
+    0x94, 0x2c, 0xa0, 0xe9, 0xea, 0xd5, 0x6e, 0x2d, 0xbf, 0xc1, 0xb0, 0xdf, 0x85, 0x7b, 0x7f, 0xac,
+    0x79, 0x9a, 0xfc, 0x30, 0x20, 0x89, 0x84, 0x75, 0xec, 0x82, 0xe1, 0xb1, 0xd7, 0x1f, 0x34, 0xb1,
+    0xcb, 0x56, 0x1b, 0xd8, 0x1d, 0x0c, 0xbb, 0xfd, 0xd1, 0xb8, 0xdb, 0x3f, 0xaa, 0xf2, 0x03, 0xfd,
+    0x7c, 0x52, 0xc3, 0x6d, 0x70, 0x88, 0xc9, 0xd8, 0x6d, 0xe2, 0x96, 0xad, 0xd6, 0x73, 0x1b, 0x1e,
+    0x77, 0xfb, 0x87, 0x07, 0xdd, 0xe3, 0xb1, 0xcd, 0xac, 0x08, 0x3f, 0xbb, 0x9d, 0x6a, 0xbe, 0xfa,
+    0xcc, 0xe4, 0xb3, 0xbd, 0x55, 0xaa, 0xbb, 0x09, 0x33, 0xce, 0x3f, 0x7b, 0x43, 0x6e, 0x02, 0x8e,
+    0x23, 0x28, 0x87, 0x93, 0x65, 0x98, 0xae, 0xd3, 0x94, 0xcc, 0xad, 0x32, 0xa7, 0x82, 0xea, 0x45,
+    0x4f, 0xda, 0xcf, 0xe5, 0x45, 0x12, 0x7b, 0xe6, 0x0a, 0x28, 0x93, 0xaf, 0x19, 0xe6, 0x4b, 0x28,
+    0x74, 0xd9, 0xb1, 0xbf, 0x8e, 0x62, 0x1c, 0xd3, 0x48, 0xdf, 0xfb, 0x19, 0xb7, 0x7e, 0x0a, 0x56,
+    0x0a, 0xe4, 0x8c, 0xd5, 0x96, 0x2a, 0x22, 0x3e, 0xc5, 0xa8, 0x63, 0x0c, 0x03, 0xc7, 0x32, 0xca,
+    0xf7, 0x0a, 0x4a, 0xe6, 0x08, 0xce, 0x1a, 0xbe, 0x41, 0x21, 0x53, 0x08, 0x69, 0xcf, 0x67, 0x9a,
+    0xaa, 0x36, 0x28, 0xcb, 0x8c, 0x23, 0x35, 0x95, 0xe0, 0x0e, 0x07, 0xe5, 0xbf, 0xa7, 0xfb, 0x7a,
+    0xda, 0x7b, 0xba, 0x9f, 0x0d, 0xa2, 0x4f, 0xe5, 0xe4, 0x56, 0x8d, 0x81, 0x7d, 0xba, 0x42, 0x5e,
+    0x88, 0xd3, 0xf4, 0xac, 0x55, 0xd0, 0x6d, 0x65, 0x63, 0x61, 0x73, 0x2d, 0xd3, 0x49, 0x2f, 0xc0,
+    0xd2, 0xa2, 0x3f, 0xfd, 0xdf, 0xdf, 0xbe, 0xff, 0x27, 0x6a, 0x18, 0x33, 0xc3, 0x72, 0xbe, 0x33,
+    0x99, 0x5e, 0xd0, 0x14, 0x24, 0xc4, 0x50, 0xcf, 0xa3, 0x47, 0xc0, 0x82, 0xb3, 0x90, 0x98, 0xbb,
+    0xe5, 0xfb, 0x4b, 0x0e, 0x54, 0xc8, 0x9c, 0x9d, 0xee, 0x27, 0x9a, 0xf7, 0x3e, 0x30, 0x9f, 0xde,
+    0xab, 0xc8, 0x21, 0x07, 0x68, 0x6b, 0x29, 0x8c, 0x05, 0xc3, 0x9e, 0xc5, 0x7a, 0xed, 0x0e, 0xd9,
+    0xe4, 0xb5, 0x10, 0xf5, 0xf3, 0x17, 0x4f, 0x8d, 0x91, 0x81, 0x71, 0x52, 0xea, 0x38, 0x04, 0x1d,
+    0xff, 0xf4, 0x1e, 0x99, 0x3b, 0x40, 0xb5, 0xa1, 0xb5, 0xc9, 0x60, 0xa0, 0x46, 0x1f, 0x19, 0xe9,
+    0x70, 0x79, 0xdd, 0x9a, 0x3a, 0x8e, 0xd6, 0xa2, 0xb4, 0x5d, 0xf9, 0xe2, 0xac, 0x65, 0x35, 0x83,
+    0x72, 0x36, 0x62, 0x45, 0x8e, 0xbc, 0x48, 0x4d, 0x10, 0x1f, 0x9e, 0xb4, 0xa6, 0x4f, 0xbf, 0xfa,
+    0x1a, 0x0c, 0x1e, 0x43, 0xad, 0x5b, 0x22, 0x5c, 0xfe, 0xb8, 0x5d, 0xeb, 0x67, 0xd0, 0x6c, 0x56,
+    0xb4, 0xfd, 0xe1, 0xfb, 0xef, 0xfe, 0xfb, 0x9f, 0x3f, 0x22, 0xb9, 0x86, 0x1e, 0x0a, 0xb8, 0x6b,
+    0x77, 0xd4, 0x56, 0x76, 0xae, 0x6a, 0xff, 0x27, 0xd0, 0xf9, 0x1c, 0xe4, 0x05, 0x71, 0xe0, 0x8f,
+    0x86, 0xd1, 0x26, 0xd5, 0x4d, 0xd4, 0xd8, 0xd2, 0xd6, 0x8f, 0x94, 0x1a, 0x90, 0x52, 0x9d, 0x22,
+    0xd9, 0xa6, 0x82, 0xca, 0x25, 0x9e, 0x3e, 0xbf, 0xfd, 0xf7, 0x0a, 0xf2, 0x21, 0x80, 0xd7, 0xc6,
+    0x87, 0x5a, 0x2c, 0xef, 0xce, 0x41, 0xf1, 0x92, 0x70, 0x99, 0x2c, 0x5b, 0x53, 0xf7, 0x41, 0x79,
+    0xe7, 0x06, 0x1f, 0x9a, 0x73, 0xa4, 0x56, 0x93, 0x3f, 0xac, 0x81, 0x4c, 0xe6, 0x97, 0xfc, 0xd5,
+    0x63, 0xf5, 0x46, 0xbb, 0x40, 0x27, 0x2d, 0xf7, 0x41, 0x6b, 0xba, 0x03, 0x8a, 0xf4, 0x21, 0xbb,
+    0xe0, 0xd8, 0x36, 0x36, 0xab, 0x3a, 0xb5, 0xea, 0xf7, 0x92, 0x9b, 0x2b, 0xe6, 0x3d, 0x4f, 0xa1,
+    0xab, 0x63, 0x08, 0xfa, 0x89, 0x06, 0x93, 0x4e, 0x1f, 0x85, 0x58, 0x6e, 0x18, 0xb9, 0x6e, 0x75,
+    0xcf, 0x8e, 0xa8, 0x30, 0x46, 0x2e, 0x26, 0x14, 0x94, 0xc7, 0xf4, 0x16, 0xb5, 0x9a, 0x99, 0x53,
+    0x3d, 0x3e, 0x84, 0x66, 0xa6, 0x05, 0x79, 0xe1, 0x1f, 0x7f, 0x41, 0xf2, 0x11, 0xb2, 0x9f, 0xa0,
+    0x1e, 0xab, 0xf0, 0xdf, 0x44, 0xe2, 0xb9, 0x6a, 0x5a, 0x5a, 0xd3, 0x1f, 0xfe, 0xfa, 0x7b, 0x19,
+    0x6e, 0xd9, 0xc7, 0x3b, 0x52, 0x50, 0x9d, 0x89, 0x94, 0xe3, 0x0f, 0xdf, 0x21, 0xfd, 0xc9, 0xa6,
+    0x60, 0x58, 0x60, 0xb7, 0x5c, 0xba, 0x18, 0xe4, 0xce, 0xae, 0xfb, 0xc2, 0xa4, 0xee, 0xbe, 0x6f,
+    0x4d, 0x8b, 0x74, 0x0e, 0x51, 0x20, 0xb3, 0x46, 0x0a, 0x09, 0x63, 0x50, 0x97, 0x9d, 0x2b, 0x57,
+    0x97, 0x69, 0xee, 0x6c, 0xb1, 0xd8, 0x2a, 0x62, 0x94, 0x77, 0x8d, 0x2d, 0xe4, 0x63, 0x81, 0x1d,
+    0xe9, 0xa6, 0xb3, 0x16, 0x5e, 0x5b, 0x3e, 0xcb, 0x50, 0xa6, 0xf9, 0x33, 0x1a, 0x5b, 0x89, 0x66,
+    0xfd, 0xa2, 0x45, 0x36, 0xb6, 0xbd, 0xa1, 0x48, 0xe7, 0x2e, 0xd9, 0x99, 0x6a, 0xe6, 0x0e, 0x9b,
+    0xac, 0xe9, 0x22, 0x4d, 0x55, 0xfb, 0xc9, 0x26, 0x7b, 0x67, 0x4f, 0x99, 0xd9, 0xdd, 0xee, 0x8d,
+    0x4a, 0xf9, 0xac, 0x29, 0x55, 0xe4, 0xa7, 0xac, 0xb0, 0x2b, 0xa7, 0xc0, 0xb7, 0x28, 0x2f, 0xa1,
+    0xf5, 0xbd, 0xd1, 0x77, 0x38, 0xf1, 0x2b, 0x49, 0xa3, 0xee, 0xa0, 0xae, 0x85, 0x8b, 0x73, 0x37,
+    0x24, 0x0c, 0xd9, 0xd5, 0x4e, 0x47, 0x55, 0x59, 0x5b, 0x1c, 0x84, 0xec, 0x45, 0xe2, 0x9a, 0x73,
+    0xf5, 0x77, 0x4c, 0xd9, 0x26, 0x3a, 0x73, 0xaf, 0x4b, 0x94, 0xfe, 0xf6, 0x84, 0xf7, 0x71, 0x4d,
+    0x36, 0xf8, 0x40, 0x93, 0x0d, 0x3e, 0xd4, 0x64, 0x83, 0x8f, 0x6d, 0xb2, 0xc1, 0x0e, 0xd7, 0xed,
+    0x07, 0x21, 0xd7, 0x9c, 0x42, 0x98, 0xb0, 0x5d, 0x0c, 0x1b, 0xd2, 0x90, 0x6a, 0x25, 0x64, 0x38,
+    0xfd, 0xf9, 0x3d, 0x7a, 0xf8, 0xf2, 0x09, 0x3a, 0x8f, 0x7d, 0x35, 0xef, 0xb3, 0x6b, 0x94, 0xd3,
+    0x64, 0xf3, 0xf1, 0xfc, 0x14, 0xfa, 0xc5, 0xc5, 0x8b, 0xe7, 0xd0, 0x5c, 0x73, 0x8c, 0xe4, 0xcc,
+    0x70, 0xce, 0xf1, 0xed, 0xbf, 0x6e, 0xff, 0xce, 0x26, 0x45, 0x01, 0xaa, 0x88, 0xc9, 0xe9, 0xc8,
+    0x74, 0x3f, 0xab, 0x98, 0x4e, 0xf7, 0xd5, 0xa7, 0x66, 0x4e, 0xeb, 0x86, 0xa7, 0x3a, 0xe7, 0xdf,
+    0x70, 0xdd, 0xbd, 0x82, 0x5e, 0x83, 0x40, 0x65, 0x83, 0x48, 0x2e, 0x9a, 0x92, 0xca, 0xc7, 0xe9,
+    0x62, 0xc6, 0xc0, 0x7a, 0x29, 0xfa, 0x35, 0x99, 0x21, 0xb6, 0xb4, 0xe4, 0x44, 0xc1, 0x12, 0x72,
+    0x09, 0x86, 0xde, 0x29, 0x42, 0xcf, 0x7e, 0x79, 0x79, 0xd9, 0x33, 0x1c, 0x94, 0x34, 0xbb, 0xc7,
+    0xf4, 0xd3, 0x69, 0xea, 0x71, 0x9a, 0x88, 0x6c, 0x1d, 0xa7, 0x37, 0xb1, 0x07, 0x44, 0xe3, 0x6c,
+    0x2a, 0x84, 0x65, 0x31, 0x47, 0xdf, 0x62, 0xde, 0xd9, 0x33, 0xc6, 0x7d, 0xeb, 0xff, 0xea, 0x21,
+    0x9b, 0xb6, 0x38, 0x15, 0x08, 0x8a, 0x8b, 0x04, 0x1e, 0x08, 0x3a, 0x43, 0xf8, 0x0a, 0x53, 0x81,
+    0x02, 0x22, 0xbc, 0x45, 0xa7, 0xad, 0x4d, 0xd6, 0x2e, 0x26, 0x8e, 0xd0, 0x15, 0xb2, 0x14, 0xda,
+    0x7d, 0xde, 0xc9, 0xf6, 0xe5, 0x07, 0x7b, 0xaf, 0x53, 0x16, 0x77, 0xd6, 0xa3, 0xe7, 0x77, 0xc8,
+    0xc3, 0x40, 0x01, 0x75, 0x08, 0xe7, 0x8c, 0xef, 0x95, 0x18, 0xc2, 0x4d, 0xd3, 0x53, 0x0b, 0x9d,
+    0xf6, 0x39, 0xfc, 0x42, 0x98, 0xad, 0x25, 0x9d, 0xb4, 0xbb, 0x28, 0x3b, 0x54, 0xd0, 0xd2, 0xed,
+    0x8f, 0xfa, 0xb5, 0xbf, 0x0f, 0x3d, 0x06, 0xf3, 0x54, 0x13, 0x22, 0x13, 0x34, 0x02, 0xc8, 0x83,
+    0x14, 0x00, 0x4f, 0x4e, 0xe6, 0x98, 0x23, 0x8c, 0x92, 0xdb, 0xf7, 0xe0, 0x45, 0x3c, 0x41, 0x0c,
+    0xbd, 0x7c, 0x71, 0x71, 0x89, 0x5e, 0xdf, 0xbe, 0x87, 0xcd, 0x2b, 0x16, 0xae, 0x08, 0xbc, 0x8a,
+    0xd9, 0x0a, 0xce, 0x28, 0xad, 0xea, 0x0c, 0x26, 0x24, 0x6d, 0x2e, 0xb3, 0x7c, 0x47, 0x52, 0xff,
+    0x40, 0xab, 0xb5, 0xd1, 0x4f, 0x94, 0x70, 0x5d, 0xf9, 0xff, 0x71, 0x88, 0x58, 0x30, 0x68, 0xe8,
+    0xdb, 0x52, 0x98, 0x36, 0x7a, 0xf7, 0xe9, 0x4d, 0x99, 0xe9, 0xa0, 0x04, 0xd8, 0x62, 0xcc, 0x42,
+    0xed, 0x5c, 0x12, 0x79, 0xef, 0xad, 0x39, 0x80, 0xad, 0x1f, 0xe6, 0x6e, 0x41, 0x66, 0x2d, 0x9d,
+    0x4f, 0xaf, 0x98, 0xb7, 0x8c, 0xa0, 0x84, 0xe8, 0xcd, 0x89, 0x38, 0x0f, 0x89, 0x7c, 0xfc, 0xf2,
+    0xe6, 0x89, 0xdf, 0x69, 0x43, 0x81, 0xdc, 0xde, 0xeb, 0xc9, 0x4a, 0xe3, 0x51, 0x56, 0x58, 0x82,
+    0x85, 0x24, 0x69, 0xeb, 0x6b, 0xdd, 0xf5, 0xd8, 0x40, 0xda, 0x32, 0xc9, 0x0a, 0x6a, 0xd8, 0xf8,
+    0x0c, 0x8b, 0x45, 0x0f, 0xb6, 0x75, 0xfa, 0xae, 0xdb, 0x45, 0x9d, 0xca, 0x39, 0xb4, 0x8f, 0x54,
+    0xa9, 0x88, 0xbe, 0x90, 0xc3, 0x83, 0x42, 0xb1, 0x4d, 0xc2, 0xe8, 0x6a, 0xbd, 0x22, 0x93, 0x62,
+    0xa5, 0x06, 0x2e, 0x1d, 0xcd, 0x7f, 0x0f, 0x3c, 0xd7, 0x7e, 0xd0, 0xde, 0x4a, 0xd4, 0xac, 0xc8,
+    0x81, 0xac, 0x4a, 0x20, 0xbd, 0xec, 0x8b, 0xca, 0xb3, 0x42, 0x17, 0x8b, 0x54, 0x9d, 0x4d, 0xa5,
+    0x8b, 0x2c, 0x2b, 0xc8, 0x17, 0x97, 0x20, 0x22, 0xcb, 0x0d, 0xa6, 0x3a, 0x32, 0x39, 0x76, 0xff,
+    0x29, 0x6a, 0x1b, 0x75, 0x52, 0x1b, 0x4d, 0xb4, 0x65, 0xe4, 0x06, 0x5d, 0x8f, 0xc8, 0x3d, 0xfa,
+    0x51, 0xae, 0xb7, 0xb3, 0xe2, 0xa7, 0xbd, 0xdd, 0x42, 0x45, 0xdb, 0x57, 0x31, 0x50, 0x21, 0xcf,
+    0x26, 0x2d, 0xb2, 0xba, 0x7b, 0x1b, 0x93, 0xa2, 0xe8, 0x06, 0x26, 0xea, 0xea, 0x78, 0x8e, 0x23,
+    0x19, 0x39, 0xd9, 0x02, 0x92, 0x21, 0xd3, 0xa9, 0xa8, 0x9c, 0x7d, 0x53, 0xa1, 0xb4, 0xc9, 0xbf,
+    0x82, 0xdb, 0x41, 0x1f, 0xa3, 0x38, 0xdf, 0xc0, 0xec, 0xb3, 0x8a, 0xfd, 0x3e, 0xff, 0x1c, 0x7d,
+    0xf6, 0x71, 0x45, 0xc8, 0x9c, 0xb1, 0x83, 0xc2, 0x1f, 0x2e, 0x42, 0x9d, 0x47, 0xb2, 0xfc, 0x86,
+    0xd4, 0xd7, 0xe0, 0xdb, 0x24, 0xad, 0x0e, 0x4f, 0x72, 0x79, 0x9f, 0x42, 0x9f, 0xde, 0x13, 0x6c,
+    0x3e, 0x0f, 0x49, 0x27, 0x97, 0xa1, 0x0b, 0xd9, 0x65, 0x49, 0xb6, 0xeb, 0xbf, 0x1e, 0x4e, 0xdc,
+    0x81, 0xda, 0x5a, 0x95, 0x0b, 0x1a, 0x2d, 0x43, 0x7d, 0x43, 0xea, 0x6f, 0x0b, 0xa0, 0x29, 0x91,
+    0xb9, 0x3e, 0x2b, 0x67, 0x52, 0xd4, 0x99, 0xe1, 0x94, 0xc8, 0x81, 0x02, 0x18, 0x4d, 0x65, 0xea,
+    0x7c, 0xfc, 0x97, 0x1b, 0xe1, 0x42, 0x97, 0x42, 0x69, 0xc5, 0xc8, 0xd6, 0x8c, 0xd9, 0xce, 0x83,
+    0x35, 0xa7, 0x75, 0xfd, 0x6f, 0x65, 0xc5, 0xa7, 0x34, 0x82, 0xbb, 0x1d, 0x09, 0xd9, 0x29, 0x95,
+    0x2d, 0xf1, 0xbb, 0x25, 0xe1, 0x37, 0x17, 0x24, 0x84, 0x8a, 0x88, 0xf1, 0x87, 0x61, 0xd8, 0x69,
+    0xcb, 0x39, 0x25, 0x58, 0x01, 0xc8, 0x9d, 0x63, 0xb8, 0x1e, 0x42, 0x74, 0x36, 0x35, 0x92, 0x78,
+    0x68, 0x98, 0x87, 0x93, 0x88, 0xad, 0xc0, 0x3c, 0x2c, 0x06, 0xd3, 0xb4, 0xf3, 0xd1, 0xe6, 0xda,
+    0xd7, 0xef, 0xca, 0xa6, 0xa2, 0x01, 0xaa, 0x0a, 0xa8, 0x44, 0x54, 0x8d, 0x8a, 0x5e, 0x9a, 0xe4,
+    0x55, 0x29, 0xca, 0x49, 0x16, 0x3b, 0x9b, 0x1d, 0x98, 0x57, 0xfb, 0x96, 0xff, 0xb0, 0xef, 0x37,
+    0x4b, 0xb7, 0x89, 0xda, 0xe0, 0xce, 0xd4, 0xde, 0x21, 0x62, 0xce, 0x8a, 0x4d, 0xa5, 0x64, 0x60,
+    0x4f, 0x50, 0x6a, 0x60, 0x64, 0x76, 0xfb, 0x3e, 0xa5, 0x50, 0x14, 0x74, 0x3c, 0xea, 0x81, 0x9a,
+    0x50, 0x4d, 0x25, 0x21, 0x11, 0xb2, 0x38, 0xe0, 0x14, 0xa3, 0x08, 0xd3, 0x54, 0xbf, 0xbb, 0x2e,
+    0x80, 0xa2, 0x08, 0xbe, 0x64, 0x5c, 0xd2, 0x49, 0x42, 0xea, 0x29, 0xe8, 0x77, 0xf5, 0x4d, 0x98,
+    0xd5, 0xe2, 0x12, 0x5b, 0x17, 0x7d, 0x44, 0x8a, 0x6e, 0x40, 0xbd, 0x18, 0xec, 0x64, 0x3c, 0x55,
+    0xbe, 0xd7, 0x6a, 0xbb, 0xa3, 0xbd, 0xa0, 0xe1, 0xd8, 0x7c, 0xfc, 0x5d, 0x19, 0xc5, 0x1b, 0x20,
+    0xf8, 0x9b, 0xa2, 0xa1, 0xfd, 0xad, 0x81, 0xc4, 0x99, 0x89, 0xc4, 0x99, 0xe4, 0x70, 0xbe, 0x82,
+    0xf3, 0x92, 0x1d, 0x81, 0xd6, 0xbe, 0xd3, 0xf6, 0xc0, 0x2e, 0x6f, 0xc0, 0x3d, 0x50, 0x3d, 0xc2,
+    0x4e, 0xa3, 0x36, 0x9a, 0xf5, 0x24, 0xc1, 0x94, 0x08, 0x15, 0x57, 0x79, 0xad, 0x22, 0xe1, 0x79,
+    0xaf, 0x92, 0x8c, 0xa0, 0xb8, 0xc5, 0x3e, 0x46, 0x03, 0x70, 0xc6, 0x1c, 0x6e, 0x5a, 0x1d, 0x31,
+    0x70, 0x56, 0x8e, 0x8e, 0xf9, 0x0a, 0x87, 0x9d, 0x22, 0xea, 0xba, 0xf2, 0x8b, 0xb6, 0xfc, 0x4a,
+    0xbf, 0xa2, 0xb0, 0xf9, 0xaa, 0xc7, 0xe2, 0x90, 0x61, 0x5f, 0x96, 0x58, 0xf9, 0xae, 0x93, 0x6c,
+    0x10, 0xae, 0xab, 0x5e, 0xe8, 0xc2, 0xd5, 0x08, 0x1c, 0xda, 0x07, 0xf5, 0xbf, 0xb6, 0xff, 0x0f,
+    0x85, 0xd2, 0x05, 0x1e, 0xc6, 0x2d, 0x00, 0x00,
+};
+
+#endif // PAGINA_WEB_H
@@ -0,0 +1,65 @@
+#ifndef PLANO_CRUZAMENTO_H
+#define PLANO_CRUZAMENTO_H
+
+#include "TabelaFases.h"
+
+// Planos do cruzamento da maquete: dois grupos semafóricos (S1 e S2) que se
+// cruzam, então nunca podem estar verdes juntos.
+
+constexpr size_t NUM_GRUPOS = 2;  // S1, S2
+
+constexpr bool CONFLITOS[NUM_GRUPOS][NUM_GRUPOS] = {
+    {false, true},
+    {true, false},
+};
+
+constexpr uint32_t TEMPO_VERDE = 3000;
+constexpr uint32_t TEMPO_VERDE_MAX = 4500;   // Verde estendido (coordenação em onda verde)
+constexpr uint32_t TEMPO_AMARELO = 1500;
+constexpr uint32_t TEMPO_PISCA = 500;
+constexpr uint32_t TEMPO_VERMELHO_GERAL = 1000;     // Entrada do noturno: todos em vermelho
+constexpr uint32_t TEMPO_VERDE_MIN_ATUADO = 2000;   // Controle atuado: verde mínimo
+constexpr uint32_t TEMPO_VERDE_MAX_ATUADO = 10000;  // Controle atuado: max-out
+
+// Ciclo normal (antigos estados 0-3 do switch)
+constexpr Fase<NUM_GRUPOS> FASES_NORMAL[] = {
+    {{Sinal::Verde, Sinal::Vermelho}, TEMPO_VERDE, TEMPO_VERDE_MAX, 1},
+    {{Sinal::Amarelo, Sinal::Vermelho}, TEMPO_AMARELO, TEMPO_AMARELO, 2},
+    {{Sinal::Vermelho, Sinal::Verde}, TEMPO_VERDE, TEMPO_VERDE_MAX, 3},
+    {{Sinal::Vermelho, Sinal::Amarelo}, TEMPO_AMARELO, TEMPO_AMARELO, 0},
+};
+
+// Controle atuado: mesma sequência, verdes entre o mínimo e o max-out
+// conforme os detectores (ControleAtuado.h)
+constexpr Fase<NUM_GRUPOS> FASES_ATUADO[] = {
+    {{Sinal::Verde, Sinal::Vermelho}, TEMPO_VERDE_MIN_ATUADO, TEMPO_VERDE_MAX_ATUADO, 1},
+    {{Sinal::Amarelo, Sinal::Vermelho}, TEMPO_AMARELO, TEMPO_AMARELO, 2},
+    {{Sinal::Vermelho, Sinal::Verde}, TEMPO_VERDE_MIN_ATUADO, TEMPO_VERDE_MAX_ATUADO, 3},
+    {{Sinal::Vermelho, Sinal::Amarelo}, TEMPO_AMARELO, TEMPO_AMARELO, 0},
+};
+
+// Modo noturno: amarelo piscando nos dois grupos. A fase 0 (vermelho geral)
+// só roda na entrada, para o amarelo que encerrava um verde terminar em
+// vermelho antes do pisca
+constexpr Fase<NUM_GRUPOS> FASES_NOTURNO[] = {
+    {{Sinal::Vermelho, Sinal::Vermelho}, TEMPO_VERMELHO_GERAL, TEMPO_VERMELHO_GERAL, 1},
+    {{Sinal::Amarelo, Sinal::Amarelo}, TEMPO_PISCA, TEMPO_PISCA, 2},
+    {{Sinal::Apagado, Sinal::Apagado}, TEMPO_PISCA, TEMPO_PISCA, 1},
+};
+
+constexpr Plano<NUM_GRUPOS> PLANO_NORMAL = criarPlano("normal", FASES_NORMAL);
+constexpr Plano<NUM_GRUPOS> PLANO_ATUADO = criarPlano("atuado", FASES_ATUADO);
+constexpr Plano<NUM_GRUPOS> PLANO_NOTURNO = criarPlano("noturno", FASES_NOTURNO);
+
+static_assert(planoValido(PLANO_NORMAL, CONFLITOS), "Plano normal inseguro");
+static_assert(planoValido(PLANO_ATUADO, CONFLITOS), "Plano atuado inseguro");
+static_assert(planoValido(PLANO_NOTURNO, CONFLITOS), "Plano noturno inseguro");
+
+static_assert(trocaPlanoSegura(PLANO_NORMAL, PLANO_ATUADO) && trocaPlanoSegura(PLANO_ATUADO, PLANO_NORMAL),
+              "Troca normal <-> atuado insegura");
+static_assert(trocaPlanoSegura(PLANO_NORMAL, PLANO_NOTURNO) && trocaPlanoSegura(PLANO_NOTURNO, PLANO_NORMAL),
+              "Troca normal <-> noturno insegura");
+static_assert(trocaPlanoSegura(PLANO_ATUADO, PLANO_NOTURNO) && trocaPlanoSegura(PLANO_NOTURNO, PLANO_ATUADO),
+              "Troca atuado <-> noturno insegura");
+
+#endif // PLANO_CRUZAMENTO_H
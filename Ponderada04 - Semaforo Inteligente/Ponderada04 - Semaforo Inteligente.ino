@@ -1,6 +1,17 @@
 #include <WiFi.h>
 #include <WebServer.h>
 #include <PubSubClient.h>
+#include "esp_timer.h"
+#include "TabelaFases.h"       // Motor de fases dirigido por tabela
+#include "PlanoCruzamento.h"   // Planos normal/noturno (verificados em compilação)
+#include "Coordenacao.h"       // Relógio comum e onda verde entre cruzamentos
+#include "ControleAtuado.h"    // Verdes conforme os detectores de veículos
+#include "FiltroLuz.h"         // Mediana + EMA da luminosidade do LDR
+#include "PaginaWeb.h"         // Painel em gzip (gerado de web/index.html)
+#include "SerieTemporal.h"     // Histórico compactado (delta + varint) da telemetria
+#include "DiarioFases.h"       // Trocas de fase com instante em microssegundos
+#include "FilaSemTrava.h"      // Comandos e telemetria entre as tarefas, sem mutex
+#include <MaquinaEstados.h>    // Modo de operação (libraries/MaquinaEstados)
 // ==================== WI-FI AP ======================
 const char* ssid = "iPhone";
 const char* password = "12345678";
@@ -15,6 +26,7 @@ const int mqtt_port = 1883;
 const char* mqtt_client_id = "semaforo_inteligente";
 const char* mqtt_topic_telemetria = "semaforo/telemetria";
 const char* mqtt_topic_comandos = "semaforo/comandos";
+char mqttClientId[48];  // mqtt_client_id + ID_CRUZAMENTO (IDs repetidos derrubam um ao outro no broker)
 WiFiClient espClient;
 PubSubClient mqttClient(espClient);
 unsigned long ultimaPublicacaoMQTT = 0;
@@ -22,6 +34,53 @@ const unsigned long intervaloPublicacaoMQTT = 5000;  // Publica a cada 5 segundo
 unsigned long ultimaTentativaReconexaoMQTT = 0;
 const unsigned long intervaloReconexaoMQTT = 10000;  // Tenta reconectar a cada 10 segundos
 bool mqttDisponivel = false;  // Flag para indicar se MQTT está disponível
+// ========== COORDENAÇÃO (ONDA VERDE) ================
+// Vários cruzamentos no mesmo corredor: o de ID 0 cria a rede Wi-Fi (como
+// antes) e publica o seu millis() em semaforo/sync; os demais entram na rede
+// dele como estação, sincronizam o relógio e deslocam o ciclo pelo offset
+const int ID_CRUZAMENTO = 0;
+const bool COORDENACAO_ATIVA = false;             // true para formar a onda verde
+const unsigned long OFFSET_ONDA_MS = 0;           // Distância até o cruzamento 0 / velocidade (ex.: 250 m a 50 km/h = 18000)
+const char* mqtt_topic_sync = "semaforo/sync";
+const unsigned long intervaloSyncMQTT = 1000;     // Mestre publica o relógio a cada 1 segundo
+unsigned long ultimoSyncMQTT = 0;
+// ========= DETECTORES (CONTROLE ATUADO) =============
+// Um sensor por aproximação (botão, IR ou laço indutivo) entre o pino e o GND:
+// cada pulso é um veículo. Contagens feitas fora do ESP32 chegam por MQTT em
+// semaforo/detectores ("S1" = um veículo, "S2:3" = três veículos)
+const int DET_S1 = 18;
+const int DET_S2 = 19;
+const bool CONTROLE_ATUADO = false;               // true para os verdes seguirem os detectores
+const char* mqtt_topic_detectores = "semaforo/detectores";
+// ========== HISTÓRICO (SÉRIE TEMPORAL) ==============
+// Amostras de luminosidade, fase e modo a cada segundo e a cada troca de
+// fase, guardadas compactadas no ESP32 (64 blocos de 256 bytes, ~1 h). Os
+// blocos cheios saem em lote por MQTT (binário, veja historico_reader.py);
+// com o broker fora, ficam guardados e vão todos na reconexão
+const unsigned long intervaloHistorico = 1000;
+const char* mqtt_topic_historico = "semaforo/historico";
+typedef SerieTemporal<64, 256> Historico;
+uint32_t historicoPublicado = 0;                  // Próxima amostra ainda não enviada por MQTT
+// ============ DIÁRIO DAS TROCAS DE FASE =============
+// Cada troca de fase vira um registro binário com esp_timer_get_time(); os
+// últimos 256 (~10 min de ciclo normal) ficam em /eventos (CSV ou binário) e
+// saem em lotes por MQTT para medir a duração real de cada fase
+const char* mqtt_topic_eventos = "semaforo/eventos";
+typedef DiarioFases<256> Diario;
+const size_t LOTE_EVENTOS = 32;                   // Eventos por mensagem MQTT
+const unsigned long intervaloEventosMQTT = 10000; // Lote incompleto sai depois de 10 segundos
+uint32_t eventosPublicados = 0;                   // Próximo evento ainda não enviado por MQTT
+// ================ TAREFAS (FreeRTOS) ================
+// O controlador roda sozinho no núcleo 1, com prioridade alta e período fixo;
+// HTTP e MQTT rodam no núcleo 0, junto da pilha Wi-Fi. Entre os dois só há
+// filas sem trava (FilaSemTrava.h): um cliente HTTP lento ou um connect() do
+// MQTT travado não atrasam nenhuma troca de fase
+const uint32_t PERIODO_CONTROLE_MS = 1;           // Uma passada do controlador por tick do FreeRTOS
+const UBaseType_t PRIORIDADE_CONTROLE = 10;       // Acima do loop() e da tarefa de rede
+const UBaseType_t PRIORIDADE_REDE = 1;
+const BaseType_t NUCLEO_CONTROLE = 1;
+const BaseType_t NUCLEO_REDE = 0;
+const unsigned long JANELA_JITTER_MS = 10000;     // Telemetria traz o pior jitter dos últimos 10 s
 // =============== PINOS DO SEMÁFORO ==================
 const int S1_red    = 27;
 const int S1_yellow = 14;
@@ -31,9 +90,151 @@ const int S2_yellow = 25;
 const int S2_green  = 26;
 // =============== LDR ================================
 const int LDR_PIN = 32;
+// Amostragem contínua por DMA: cada quadro é a média de LDR_CONVERSOES
+// conversões a LDR_FREQ_HZ (~78 quadros/s), sem analogRead() no loop
+const uint32_t LDR_FREQ_HZ = 20000;               // Menor taxa do ADC contínuo do ESP32
+const uint32_t LDR_CONVERSOES = 256;
+const unsigned long LDR_PERIODO_MS = 20;          // Sem ADC contínuo (core < 3.0): um analogRead a cada 20 ms
+const float LDR_ALFA_EMA = 0.05f;                 // Peso de cada quadro na média (constante de ~0,25 s)
+// Histerese (ajustável por MQTT: "histerese:1800:2200" ou "histerese:1800:2200:1000")
+const int LDR_LIMITE_NOTURNO = 1800;              // Entra no modo noturno abaixo disso
+const int LDR_LIMITE_DIURNO = 2200;               // Volta ao modo normal acima disso
+const unsigned long LDR_CONFIRMACAO_MS = 1000;    // Tempo além do limite antes de trocar o modo
 
-// =============== DECLARAÇÕES FORWARD =================
-void publicarTelemetriaMQTT();  // Declaração forward para uso na classe
+// ============ MODO DE OPERAÇÃO ======================
+// Automático (histerese do LDR) ou manual, numa máquina de estados
+// hierárquica: a confirmação da histerese é um estado temporizado e os
+// comandos de modo valem em qualquer estado (tratados na raiz). A máquina só
+// escolhe entre o plano noturno e o diurno; as fases seguem no MotorFases
+//
+//   OPERANDO
+//   ├── AUTOMATICO
+//   │   ├── AUTO_DIURNO:  DIA <-> CONFIRMANDO_NOITE
+//   │   └── AUTO_NOTURNO: NOITE <-> CONFIRMANDO_DIA
+//   └── MANUAL: MANUAL_NORMAL | MANUAL_NOTURNO
+struct ContextoModo {
+  int luz = 0;   // Luminosidade filtrada da passada atual
+  // Ajustados baseado nos valores reais do LDR (Noturno: 0-2000, Diurno: 2000-5000)
+  int limiteEntrar = LDR_LIMITE_NOTURNO;
+  int limiteSair = LDR_LIMITE_DIURNO;
+  unsigned long confirmacaoMs = LDR_CONFIRMACAO_MS;
+};
+
+enum EstadoModo : uint8_t {
+  ESTADO_OPERANDO,
+  ESTADO_AUTOMATICO,
+  ESTADO_AUTO_DIURNO,
+  ESTADO_DIA,
+  ESTADO_CONFIRMANDO_NOITE,   // Abaixo de limiteEntrar, esperando confirmacaoMs
+  ESTADO_AUTO_NOTURNO,
+  ESTADO_NOITE,
+  ESTADO_CONFIRMANDO_DIA,     // Acima de limiteSair, esperando confirmacaoMs
+  ESTADO_MANUAL,
+  ESTADO_MANUAL_NORMAL,
+  ESTADO_MANUAL_NOTURNO,
+  NUM_ESTADOS_MODO
+};
+
+enum EventoModo : uint8_t {
+  EVENTO_AUTO,
+  EVENTO_NORMAL,
+  EVENTO_NOTURNO,
+  EVENTO_LUZ   // Luminosidade nova em ContextoModo::luz (a cada passada)
+};
+
+bool luzEscura(const ContextoModo& c) { return c.luz < c.limiteEntrar; }
+bool luzNaoEscura(const ContextoModo& c) { return !luzEscura(c); }
+bool luzClara(const ContextoModo& c) { return c.luz > c.limiteSair; }
+bool luzNaoClara(const ContextoModo& c) { return !luzClara(c); }
+uint32_t tempoConfirmacao(const ContextoModo& c) { return c.confirmacaoMs; }
+
+void avisarModoAuto(ContextoModo&) { Serial.println("[Modo] Alterado para AUTOMATICO"); }
+void avisarModoNormal(ContextoModo&) { Serial.println("[Modo] Alterado para NORMAL"); }
+void avisarModoNoturno(ContextoModo&) { Serial.println("[Modo] Alterado para NOTURNO"); }
+void avisarEntradaNoturno(ContextoModo& c) {
+  Serial.printf("[Histerese] Entrando em modo NOTURNO (LDR=%d < %d)\n", c.luz, c.limiteEntrar);
+}
+void avisarSaidaNoturno(ContextoModo& c) {
+  Serial.printf("[Histerese] Saindo do modo NOTURNO - Modo NORMAL (LDR=%d > %d)\n", c.luz, c.limiteSair);
+}
+
+constexpr EstadoDef<ContextoModo> ESTADOS_MODO[] = {
+  // pai, filho inicial, entrada, saída, nome
+  {MAQUINA_SEM_ESTADO, ESTADO_AUTOMATICO, nullptr, nullptr, "OPERANDO"},
+  {ESTADO_OPERANDO, ESTADO_AUTO_DIURNO, nullptr, nullptr, "AUTOMATICO"},
+  {ESTADO_AUTOMATICO, ESTADO_DIA, nullptr, nullptr, "AUTO_DIURNO"},
+  {ESTADO_AUTO_DIURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "DIA"},
+  {ESTADO_AUTO_DIURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "CONFIRMANDO_NOITE"},
+  {ESTADO_AUTOMATICO, ESTADO_NOITE, nullptr, nullptr, "AUTO_NOTURNO"},
+  {ESTADO_AUTO_NOTURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "NOITE"},
+  {ESTADO_AUTO_NOTURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "CONFIRMANDO_DIA"},
+  {ESTADO_OPERANDO, ESTADO_MANUAL_NORMAL, nullptr, nullptr, "MANUAL"},
+  {ESTADO_MANUAL, MAQUINA_SEM_ESTADO, nullptr, nullptr, "MANUAL_NORMAL"},
+  {ESTADO_MANUAL, MAQUINA_SEM_ESTADO, nullptr, nullptr, "MANUAL_NOTURNO"},
+};
+
+constexpr TransicaoDef<ContextoModo> TRANSICOES_MODO[] = {
+  // origem, evento, destino, guarda, ação, após
+  {ESTADO_OPERANDO, EVENTO_NORMAL, ESTADO_MANUAL_NORMAL, nullptr, avisarModoNormal, nullptr},
+  {ESTADO_OPERANDO, EVENTO_NOTURNO, ESTADO_MANUAL_NOTURNO, nullptr, avisarModoNoturno, nullptr},
+  {ESTADO_AUTOMATICO, EVENTO_AUTO, MAQUINA_SEM_ESTADO, nullptr, avisarModoAuto, nullptr},
+  {ESTADO_DIA, EVENTO_LUZ, ESTADO_CONFIRMANDO_NOITE, luzEscura, nullptr, nullptr},
+  {ESTADO_CONFIRMANDO_NOITE, EVENTO_LUZ, ESTADO_DIA, luzNaoEscura, nullptr, nullptr},
+  {ESTADO_CONFIRMANDO_NOITE, MAQUINA_EVENTO_TEMPO, ESTADO_AUTO_NOTURNO, nullptr, avisarEntradaNoturno, tempoConfirmacao},
+  {ESTADO_NOITE, EVENTO_LUZ, ESTADO_CONFIRMANDO_DIA, luzClara, nullptr, nullptr},
+  {ESTADO_CONFIRMANDO_DIA, EVENTO_LUZ, ESTADO_NOITE, luzNaoClara, nullptr, nullptr},
+  {ESTADO_CONFIRMANDO_DIA, MAQUINA_EVENTO_TEMPO, ESTADO_AUTO_DIURNO, nullptr, avisarSaidaNoturno, tempoConfirmacao},
+  // O manual volta ao automático no plano em que estava
+  {ESTADO_MANUAL_NORMAL, EVENTO_AUTO, ESTADO_AUTO_DIURNO, nullptr, avisarModoAuto, nullptr},
+  {ESTADO_MANUAL_NOTURNO, EVENTO_AUTO, ESTADO_AUTO_NOTURNO, nullptr, avisarModoAuto, nullptr},
+};
+
+constexpr TabelaEstados<ContextoModo, NUM_ESTADOS_MODO> TABELA_MODO = criarTabela(ESTADOS_MODO, TRANSICOES_MODO);
+static_assert(tabelaValida(TABELA_MODO), "Tabela do modo de operacao invalida");
+
+// ============ COMANDOS (REDE -> CONTROLADOR) =========
+// HTTP e MQTT não mexem no controlador: enfileiram o comando e ele aplica no
+// começo da passada seguinte (no máximo PERIODO_CONTROLE_MS depois)
+enum class TipoComando : uint8_t {
+  ModoAuto,
+  ModoNormal,
+  ModoNoturno,
+  ControleAtuado,   // a = 1 atuado, 0 tempo fixo
+  Histerese,        // a = limite para entrar, b = para sair, c = confirmação (ms)
+  Sync,             // a = millis() do mestre, b = millis() local na chegada
+  Veiculos          // a = grupo (0 = S1, 1 = S2), b = quantidade
+};
+
+struct Comando {
+  TipoComando tipo;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+};
+
+FilaSPSC<Comando, 16> filaComandos;
+
+// Amostras do histórico no sentido contrário: o controlador só enfileira e a
+// tarefa de rede guarda na série (e publica por MQTT)
+struct AmostraPendente {
+  uint32_t tempo;
+  int16_t luz;
+  uint8_t estado;
+};
+
+FilaSPSC<AmostraPendente, 128> filaHistorico;
+Historico historico;
+
+// =============== DETECTORES ==========================
+Detector detectorS1;
+Detector detectorS2;
+
+void IRAM_ATTR isrDetectorS1() { detectorS1.pulso(millis()); }
+void IRAM_ATTR isrDetectorS2() { detectorS2.pulso(millis()); }
+
+// =============== LDR (ADC CONTÍNUO) ==================
+volatile bool quadroLdrPronto = false;
+void ARDUINO_ISR_ATTR quadroLdrCompleto() { quadroLdrPronto = true; }
 
 // =============== CLASSES ============================
 class Semaforo {
@@ -48,10 +249,15 @@ public:
     apagar();
   }
 
-  void verde() const { setEstado(LOW, LOW, HIGH); }
-  void amarelo() const { setEstado(LOW, HIGH, LOW); }
-  void vermelho() const { setEstado(HIGH, LOW, LOW); }
-  void amareloPisca(bool ligado) const { setEstado(LOW, ligado ? HIGH : LOW, LOW); }
+  // Chamado pelo MotorFases só quando o sinal do grupo muda
+  void aplicar(Sinal sinal) const {
+    switch (sinal) {
+      case Sinal::Verde:    setEstado(LOW, LOW, HIGH); break;
+      case Sinal::Amarelo:  setEstado(LOW, HIGH, LOW); break;
+      case Sinal::Vermelho: setEstado(HIGH, LOW, LOW); break;
+      default:              apagar(); break;
+    }
+  }
   void apagar() const { setEstado(LOW, LOW, LOW); }
 
 private:
@@ -66,175 +272,411 @@ private:
   }
 };
 
+// O ADC contínuo enche o buffer por DMA e avisa pelo callback; o loop só
+// busca a média pronta quando há quadro novo, sem esperar conversão
+class AmostradorLDR {
+public:
+  explicit AmostradorLDR(int pin) : pino(pin) {}
+
+  bool begin() {
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    const uint8_t pinos[] = {(uint8_t)pino};
+    analogContinuousSetWidth(12);
+    analogContinuousSetAtten(ADC_11db);
+    continuo = analogContinuous(pinos, 1, LDR_CONVERSOES, LDR_FREQ_HZ, &quadroLdrCompleto) && analogContinuousStart();
+#endif
+    if (!continuo) {
+      pinMode(pino, INPUT);
+    }
+    return continuo;
+  }
+
+  // true quando há uma média nova
+  bool ler(int& media) {
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    if (continuo) {
+      if (!quadroLdrPronto) return false;
+      quadroLdrPronto = false;
+      adc_continuous_data_t* dados = nullptr;
+      if (!analogContinuousRead(&dados, 0) || dados == nullptr) return false;
+      media = dados[0].avg_read_raw;
+      return true;
+    }
+#endif
+    unsigned long agora = millis();
+    if (agora - ultimaLeitura < LDR_PERIODO_MS) return false;
+    ultimaLeitura = agora;
+    media = analogRead(pino);
+    return true;
+  }
+
+  bool isContinuo() const { return continuo; }
+
+private:
+  int pino;
+  bool continuo = false;
+  unsigned long ultimaLeitura = 0;
+};
+
 class SemaforoInteligente {
 public:
   struct Telemetria {
     int luz = 0;
+    int luzBruta = 0;
+    float ruidoLdr = 0;
+    uint32_t amostrasLdr = 0;
+    int limiteNoturno = 0;
+    int limiteDiurno = 0;
     bool autoAtivo = true;
     bool noturnoAtivo = false;
+    bool coordenado = false;
+    bool sincronizado = false;
+    int32_t erroOndaMs = 0;
+    bool atuado = false;
+    int filaS1 = 0;
+    int filaS2 = 0;
+    uint32_t veiculosS1 = 0;
+    uint32_t veiculosS2 = 0;
+    uint32_t gapOuts = 0;
+    uint32_t maxOuts = 0;
+    uint32_t jitterUs = 0;          // Pior desvio do período do tick na última janela
+    uint32_t jitterMaxUs = 0;       // Pior desvio desde a partida
+    int32_t atrasoTrocaMaxUs = 0;   // Pior atraso de uma troca de fase no tempo da tabela
+    uint32_t comandosAplicados = 0;
     unsigned long timestamp = 0;
   };
 
-  SemaforoInteligente(Semaforo& s1Ref, Semaforo& s2Ref, int ldrPin)
+  SemaforoInteligente(Semaforo& s1Ref, Semaforo& s2Ref, int ldrPin, Detector& d1Ref, Detector& d2Ref)
       : semaforo1(s1Ref),
         semaforo2(s2Ref),
-        ldrPin(ldrPin) {}
+        motor(s1Ref, s2Ref),
+        atuado(ATUADO_BRECHA_MS, ATUADO_HEADWAY_MS, d1Ref, d2Ref),
+        detector1(d1Ref),
+        detector2(d2Ref),
+        ldr(ldrPin) {}
 
   void begin() {
     Serial.println("[SemaforoInteligente] Inicializando semaforos...");
     semaforo1.begin();
     semaforo2.begin();
-    pinMode(ldrPin, INPUT);
-    tempoAnterior = millis();
-    tempoPisca = millis();
+    if (ldr.begin()) {
+      Serial.printf("[LDR] ADC continuo (DMA): %lu Hz, media de %lu conversoes por quadro\n",
+                    (unsigned long)LDR_FREQ_HZ, (unsigned long)LDR_CONVERSOES);
+    } else {
+      Serial.printf("[LDR] ADC continuo indisponivel, analogRead a cada %lu ms\n", LDR_PERIODO_MS);
+    }
+    modo.iniciar(millis());
+    motor.iniciar(PLANO_NORMAL, millis());
+    registrarEvento(CausaFase::Partida);
     atualizarTelemetria();
     Serial.println("[SemaforoInteligente] Inicializacao completa");
   }
 
+  // Uma passada, a cada PERIODO_CONTROLE_MS na tarefa do controlador
   void atualizar() {
+    aplicarComandos();
     lerLuminosidade();
-    if (modoAuto) aplicarHisterese();
-    if (modoNoturno) cicloNoturno();
-    else cicloNormal();
+    // Histerese: só os estados do automático tratam EVENTO_LUZ
+    unsigned long agora = millis();
+    modoCtx.luz = luminosidade;
+    modo.despachar(EVENTO_LUZ, agora);
+    modo.atualizar(agora);
+    executarPlano(isModoNoturno() ? PLANO_NOTURNO : planoDiurno());
+    registrarHistorico();
     atualizarTelemetria();
-    publicarTelemetriaMQTT();
   }
 
-  void setModoAuto() {
-    modoAuto = true;
-    Serial.println("[Modo] Alterado para AUTOMATICO");
+  // Intervalo real entre duas passadas menos o período (em módulo)
+  void registrarTick(uint32_t desvioUs) {
+    unsigned long agora = millis();
+    if (desvioUs > jitterJanela) jitterJanela = desvioUs;
+    if (desvioUs > jitterMax) jitterMax = desvioUs;
+    if (agora - inicioJanelaJitter >= JANELA_JITTER_MS) {
+      jitterUltimaJanela = jitterJanela;
+      jitterJanela = 0;
+      inicioJanelaJitter = agora;
+    }
   }
 
-  void setModoNormal() {
-    modoAuto = false;
-    modoNoturno = false;
-    Serial.println("[Modo] Alterado para NORMAL");
+  // Os métodos de configuração e de modo rodam só na tarefa do controlador
+  // (ou no setup, antes de ela começar); HTTP e MQTT usam enviarComando()
+
+  // Chamar antes de begin(). O mestre é a referência de tempo do corredor
+  void configurarCoordenacao(bool ativa, bool mestre, unsigned long offsetMs) {
+    coordenado = ativa;
+    relogio.setMestre(mestre);
+    onda.setOffset(offsetMs);
   }
 
-  void setModoNoturno() {
-    modoAuto = false;
-    modoNoturno = true;
-    Serial.println("[Modo] Alterado para NOTURNO");
+  // Mensagem de semaforo/sync (millis() do mestre no envio e o local na chegada)
+  void receberSync(uint32_t tempoMestre, uint32_t local) {
+    relogio.amostra(tempoMestre, local);
   }
 
-  bool isModoAuto() const { return modoAuto; }
-  bool isModoNoturno() const { return modoNoturno; }
-  bool isModoNormal() const { return !modoAuto && !modoNoturno; }
+  // Verdes conforme os detectores (vale nos modos automático e normal; com a
+  // onda verde ativa o ciclo coordenado tem prioridade)
+  void setControleAtuado(bool ativo) {
+    controleAtuado = ativo;
+    Serial.printf("[Atuado] Controle %s\n", ativo ? "ATUADO" : "de tempo FIXO");
+  }
+
+  // Limites da histerese sobre a luminosidade filtrada. Retorna false (e não
+  // muda nada) se o limite para sair não ficar acima do limite para entrar
+  bool configurarHisterese(int entrarNoturno, int sairNoturno, unsigned long confirmacao) {
+    if (entrarNoturno >= sairNoturno) return false;
+    modoCtx.limiteEntrar = entrarNoturno;
+    modoCtx.limiteSair = sairNoturno;
+    modoCtx.confirmacaoMs = confirmacao;
+    Serial.printf("[Histerese] Noturno < %d, normal > %d, confirmacao %lu ms\n", modoCtx.limiteEntrar,
+                  modoCtx.limiteSair, modoCtx.confirmacaoMs);
+    return true;
+  }
+
+  // Os avisos no Serial ficam nas ações da tabela TRANSICOES_MODO
+  void setModoAuto() { modo.despachar(EVENTO_AUTO, millis()); }
+  void setModoNormal() { modo.despachar(EVENTO_NORMAL, millis()); }
+  void setModoNoturno() { modo.despachar(EVENTO_NOTURNO, millis()); }
+
+  bool isModoAuto() const { return modo.esta(ESTADO_AUTOMATICO); }
+  bool isModoNoturno() const { return modo.esta(ESTADO_AUTO_NOTURNO) || modo.esta(ESTADO_MANUAL_NOTURNO); }
+  bool isModoNormal() const { return modo.esta(ESTADO_MANUAL_NORMAL); }
+  bool isControleAtuado() const { return controleAtuado; }
   int getLuminosidade() const { return luminosidade; }
-  const Telemetria& getTelemetria() const { return telemetriaAtual; }
+  const RelogioCoordenado& getRelogio() const { return relogio; }
+  const Diario& getDiario() const { return diario; }
+  // Cópia consistente da última passada (pode ser chamado de outra tarefa)
+  Telemetria getTelemetria() const { return telemetriaPublicada.ler(); }
 
 private:
-  // Ajustados baseado nos valores reais do LDR (Noturno: 0-2000, Diurno: 2000-5000)
-  static constexpr int LIMITE_ENTRAR_NOTURNO = 1800;  // Entra no modo noturno quando < 1800
-  static constexpr int LIMITE_SAIR_NOTURNO = 2200;    // Sai do modo noturno quando > 2200
-  static constexpr unsigned long TEMPO_VERDE = 3000;
-  static constexpr unsigned long TEMPO_AMARELO = 1500;
-  static constexpr unsigned long TEMPO_PISCA = 500;
+  void atualizarTelemetria() {
+    telemetriaAtual.luz = luminosidade;
+    telemetriaAtual.luzBruta = filtroLuz.getBruto();
+    telemetriaAtual.ruidoLdr = filtroLuz.getRuido();
+    telemetriaAtual.amostrasLdr = filtroLuz.getAmostras();
+    telemetriaAtual.limiteNoturno = modoCtx.limiteEntrar;
+    telemetriaAtual.limiteDiurno = modoCtx.limiteSair;
+    telemetriaAtual.autoAtivo = isModoAuto();
+    telemetriaAtual.noturnoAtivo = isModoNoturno();
+    telemetriaAtual.coordenado = coordenado;
+    telemetriaAtual.sincronizado = coordenado && relogio.sincronizado(millis());
+    telemetriaAtual.erroOndaMs = onda.getErro();
+    telemetriaAtual.atuado = &motor.getPlano() == &PLANO_ATUADO;
+    telemetriaAtual.filaS1 = (int)(atuado.getFila(0) + 0.5f);
+    telemetriaAtual.filaS2 = (int)(atuado.getFila(1) + 0.5f);
+    telemetriaAtual.veiculosS1 = atuado.getChegadas(0);
+    telemetriaAtual.veiculosS2 = atuado.getChegadas(1);
+    telemetriaAtual.gapOuts = atuado.getGapOuts();
+    telemetriaAtual.maxOuts = atuado.getMaxOuts();
+    telemetriaAtual.jitterUs = jitterUltimaJanela;
+    telemetriaAtual.jitterMaxUs = jitterMax;
+    telemetriaAtual.atrasoTrocaMaxUs = atrasoTrocaMax;
+    telemetriaAtual.comandosAplicados = filaComandos.getRecebidos();
+    telemetriaAtual.timestamp = millis();
+    telemetriaPublicada.publicar(telemetriaAtual);
+  }
+
+  ContextoModo modoCtx;
+  MaquinaEstados<ContextoModo, NUM_ESTADOS_MODO> modo{TABELA_MODO, modoCtx};
 
   Semaforo& semaforo1;
   Semaforo& semaforo2;
-  int ldrPin;
+  MotorFases<NUM_GRUPOS, Semaforo> motor;
+  RelogioCoordenado relogio;
+  OndaVerde onda;
+  bool coordenado = false;
+  ControleAtuado<NUM_GRUPOS> atuado;
+  Detector& detector1;
+  Detector& detector2;
+  bool controleAtuado = false;
+  unsigned long ultimaAmostraHistorico = 0;
+  uint8_t ultimoEstadoHistorico = 0xFF;
+  Diario diario;
+  int64_t eventoAnteriorUs = 0;
+  uint32_t minMsAnterior = 0;
+  int32_t atrasoTrocaMax = 0;
+  uint32_t jitterJanela = 0;
+  uint32_t jitterUltimaJanela = 0;
+  uint32_t jitterMax = 0;
+  unsigned long inicioJanelaJitter = 0;
+  AmostradorLDR ldr;
+  FiltroLuz<5> filtroLuz{LDR_ALFA_EMA};
 
   int luminosidade = 0;
-  bool modoAuto = true;
-  bool modoNoturno = false;
-  unsigned long tempoAnterior = 0;
-  int estado = 0;
-  unsigned long tempoPisca = 0;
-  bool piscaEstado = false;
   Telemetria telemetriaAtual;
+  Instantaneo<Telemetria> telemetriaPublicada;
+
+  void aplicarComandos() {
+    Comando c;
+    while (filaComandos.receber(c)) {
+      switch (c.tipo) {
+        case TipoComando::ModoAuto:       setModoAuto(); break;
+        case TipoComando::ModoNormal:     setModoNormal(); break;
+        case TipoComando::ModoNoturno:    setModoNoturno(); break;
+        case TipoComando::ControleAtuado: setControleAtuado(c.a != 0); break;
+        case TipoComando::Histerese:      configurarHisterese((int)c.a, (int)c.b, c.c); break;
+        case TipoComando::Sync:           receberSync(c.a, c.b); break;
+        case TipoComando::Veiculos:       (c.a == 0 ? detector1 : detector2).somar(c.b); break;
+      }
+    }
+  }
 
   void lerLuminosidade() {
     static unsigned long ultimoPrint = 0;
-    luminosidade = analogRead(ldrPin);
+    int media;
+    if (ldr.ler(media)) {
+      luminosidade = filtroLuz.amostra(media);
+    }
     // Print a cada 2 segundos para não poluir o Serial
     if (millis() - ultimoPrint >= 2000) {
-      Serial.printf("[LDR] Luminosidade: %d\n", luminosidade);
+      Serial.printf("[LDR] Luminosidade: %d (bruta %d, ruido %.1f)\n", luminosidade, filtroLuz.getBruto(),
+                    filtroLuz.getRuido());
       ultimoPrint = millis();
     }
   }
 
-  void aplicarHisterese() {
-    bool mudou = false;
-    if (luminosidade < LIMITE_ENTRAR_NOTURNO && !modoNoturno) {
-      modoNoturno = true;
-      mudou = true;
-      Serial.printf("[Histerese] Entrando em modo NOTURNO (LDR=%d < %d)\n", 
-                    luminosidade, LIMITE_ENTRAR_NOTURNO);
-    }
-    if (luminosidade > LIMITE_SAIR_NOTURNO && modoNoturno) {
-      modoNoturno = false;
-      mudou = true;
-      Serial.printf("[Histerese] Saindo do modo NOTURNO - Modo NORMAL (LDR=%d > %d)\n", 
-                    luminosidade, LIMITE_SAIR_NOTURNO);
+  // Plano atual no histórico e no diário: 0 normal, 1 atuado, 2 noturno
+  uint8_t codigoPlano() const {
+    const Plano<NUM_GRUPOS>* plano = &motor.getPlano();
+    return plano == &PLANO_NOTURNO ? 2 : (plano == &PLANO_ATUADO ? 1 : 0);
+  }
+
+  // Estado de uma amostra do histórico: bits 0-3 fase, 4-5 plano, 6 modo
+  // automático, 7 onda verde
+  uint8_t estadoHistorico() const {
+    return (motor.getFase() & 0x0F) | (codigoPlano() << 4) | (isModoAuto() ? 0x40 : 0) | (coordenado ? 0x80 : 0);
+  }
+
+  // Logo depois da troca (os GPIOs da fase nova já foram escritos)
+  void registrarEvento(CausaFase causa) {
+    const Fase<NUM_GRUPOS>& fase = motor.getPlano().fases[motor.getFase()];
+    EventoFase evento = {};
+    evento.tempoUs = (uint64_t)esp_timer_get_time();
+    evento.minMs = (uint16_t)(fase.minMs < 65535 ? fase.minMs : 65535);
+    evento.maxMs = (uint16_t)(fase.maxMs < 65535 ? fase.maxMs : 65535);
+    evento.plano = codigoPlano();
+    evento.fase = motor.getFase();
+    evento.causa = (uint8_t)causa;
+    diario.registrar(evento);
+    // Atraso da troca só nas fases que terminam no tempo da tabela (as
+    // estendidas passam de minMs de propósito); inclui o ±1 ms do millis()
+    if (causa == CausaFase::Tempo && eventoAnteriorUs != 0) {
+      int32_t atraso = (int32_t)((int64_t)evento.tempoUs - eventoAnteriorUs - (int64_t)minMsAnterior * 1000);
+      if (atraso > atrasoTrocaMax) atrasoTrocaMax = atraso;
     }
+    eventoAnteriorUs = (int64_t)evento.tempoUs;
+    minMsAnterior = fase.minMs;
   }
 
-  void cicloNormal() {
+  void registrarHistorico() {
     unsigned long agora = millis();
-    switch (estado) {
-      case 0:
-        semaforo1.verde();
-        semaforo2.vermelho();
-        if (agora - tempoAnterior >= TEMPO_VERDE) transicaoPara(1, agora);
-        break;
-      case 1:
-        semaforo1.amarelo();
-        semaforo2.vermelho();
-        if (agora - tempoAnterior >= TEMPO_AMARELO) transicaoPara(2, agora);
-        break;
-      case 2:
-        semaforo1.vermelho();
-        semaforo2.verde();
-        if (agora - tempoAnterior >= TEMPO_VERDE) transicaoPara(3, agora);
-        break;
-      case 3:
-        semaforo1.vermelho();
-        semaforo2.amarelo();
-        if (agora - tempoAnterior >= TEMPO_AMARELO) transicaoPara(0, agora);
-        break;
-      default:
-        estado = 0;
-        break;
+    uint8_t estado = estadoHistorico();
+    if (estado != ultimoEstadoHistorico || agora - ultimaAmostraHistorico >= intervaloHistorico) {
+      filaHistorico.enviar(AmostraPendente{(uint32_t)agora, (int16_t)luminosidade, estado});
+      ultimoEstadoHistorico = estado;
+      ultimaAmostraHistorico = agora;
     }
   }
 
-  void transicaoPara(int novoEstado, unsigned long agora) {
-    estado = novoEstado;
-    tempoAnterior = agora;
-    Serial.printf("[Ciclo Normal] Transicao para estado %d\n", novoEstado);
+  const Plano<NUM_GRUPOS>& planoDiurno() const {
+    return controleAtuado && !coordenado ? PLANO_ATUADO : PLANO_NORMAL;
   }
 
-  void cicloNoturno() {
+  // A troca de modo só agenda a troca de plano (feita no fim do amarelo); no
+  // resto das passadas só compara o tempo da fase atual, sem tocar nos GPIOs
+  void executarPlano(const Plano<NUM_GRUPOS>& plano) {
+    if (&motor.getDestino() != &plano) {
+      motor.trocarPlano(plano);
+      Serial.printf("[Plano] Troca para %s agendada\n", plano.nome);
+    }
+    // Na onda verde, as fases com folga (maxMs > minMs) terminam no instante
+    // que alinha o ciclo ao relógio comum; sem sincronismo, roda livre
     unsigned long agora = millis();
-    if (agora - tempoPisca >= TEMPO_PISCA) {
-      tempoPisca = agora;
-      piscaEstado = !piscaEstado;
+    bool estender = false;
+    if (coordenado && &motor.getPlano() == &PLANO_NORMAL && relogio.sincronizado(agora)) {
+      estender = onda.estender(PLANO_NORMAL, motor.getFase(), motor.getTempoNaFase(agora), relogio.agora(agora));
+    }
+    // A fila dos detectores é estimada em qualquer plano; só o atuado a usa
+    if (&motor.getPlano() == &PLANO_ATUADO) {
+      estender = atuado.estender(PLANO_ATUADO, motor.getFase(), motor.getTempoNaFase(agora), agora);
+    } else {
+      atuado.observar(motor.getPlano(), motor.getFase(), agora);
+    }
+    const Plano<NUM_GRUPOS>* anterior = &motor.getPlano();
+    const uint32_t duracao = motor.getTempoNaFase(agora);
+    if (motor.atualizar(agora, estender)) {
+      registrarEvento(causaTroca(anterior));
+      if (&motor.getPlano() != anterior) {
+        Serial.printf("[Plano] %s ativo\n", motor.getPlano().nome);
+      } else if (&motor.getPlano() == &PLANO_NORMAL) {
+        Serial.printf("[Ciclo Normal] Transicao para estado %d\n", motor.getFase());
+      } else if (&motor.getPlano() == &PLANO_ATUADO && atuado.getMotivo() != MotivoVerde::Fixo) {
+        Serial.printf("[Atuado] Verde encerrado por %s apos %lu ms (fila S1=%.1f S2=%.1f)\n",
+                      nomeMotivo(atuado.getMotivo()), (unsigned long)duracao, atuado.getFila(0), atuado.getFila(1));
+      }
     }
-    semaforo1.amareloPisca(piscaEstado);
-    semaforo2.amareloPisca(piscaEstado);
-  }
-
-  void atualizarTelemetria() {
-    telemetriaAtual.luz = luminosidade;
-    telemetriaAtual.autoAtivo = modoAuto;
-    telemetriaAtual.noturnoAtivo = modoNoturno;
-    telemetriaAtual.timestamp = millis();
   }
 
-  void publicarTelemetriaMQTT() {
-    // Chama a função global que tem acesso ao mqttClient
-    ::publicarTelemetriaMQTT();
+  // Por que a fase anterior terminou (o motivo do atuado é o da última decisão)
+  CausaFase causaTroca(const Plano<NUM_GRUPOS>* anterior) const {
+    if (&motor.getPlano() != anterior) return CausaFase::TrocaPlano;
+    if (anterior == &PLANO_ATUADO) {
+      if (atuado.getMotivo() == MotivoVerde::GapOut) return CausaFase::GapOut;
+      // Verde estendido até maxMs, com ou sem demanda do outro lado (o
+      // contador de max-out do atuado só conta os com demanda)
+      if (atuado.getMotivo() != MotivoVerde::Fixo && atuado.getMotivo() != MotivoVerde::Minimo) return CausaFase::MaxOut;
+    }
+    if (coordenado && anterior == &PLANO_NORMAL && relogio.sincronizado(millis())) return CausaFase::Coordenada;
+    return CausaFase::Tempo;
   }
 };
 
 Semaforo semaforoPrincipal(S1_red, S1_yellow, S1_green);
 Semaforo semaforoSecundario(S2_red, S2_yellow, S2_green);
-SemaforoInteligente controlador(semaforoPrincipal, semaforoSecundario, LDR_PIN);
+SemaforoInteligente controlador(semaforoPrincipal, semaforoSecundario, LDR_PIN, detectorS1, detectorS2);
 // ======================================================
 // ================== FUNÇÕES MQTT =====================
 // ======================================================
+// Só a tarefa de rede chama (a fila tem um produtor). Retorna o número do
+// comando, que o controlador confirma em Telemetria::comandosAplicados, ou 0
+// se a fila estiver cheia
+uint32_t enviarComando(TipoComando tipo, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0) {
+  if (!filaComandos.enviar(Comando{tipo, a, b, c})) {
+    Serial.println("[Comando] Fila cheia, comando descartado");
+    return 0;
+  }
+  return filaComandos.getEnviados();
+}
+
 void callbackMQTT(char* topic, byte* payload, unsigned int length) {
+  // Relógio do mestre (1 por segundo): tratado antes dos logs para não atrasar
+  // a amostra nem poluir o Serial
+  if (strcmp(topic, mqtt_topic_sync) == 0) {
+    char texto[16];
+    unsigned int n = length < sizeof(texto) - 1 ? length : sizeof(texto) - 1;
+    memcpy(texto, payload, n);
+    texto[n] = '\0';
+    enviarComando(TipoComando::Sync, strtoul(texto, nullptr, 10), millis());
+    return;
+  }
+
+  // Contagem de veículos: "S1", "S2" ou "S1:3"
+  if (strcmp(topic, mqtt_topic_detectores) == 0) {
+    char texto[16];
+    unsigned int n = length < sizeof(texto) - 1 ? length : sizeof(texto) - 1;
+    memcpy(texto, payload, n);
+    texto[n] = '\0';
+    const char* sep = strchr(texto, ':');
+    unsigned long veiculos = sep ? strtoul(sep + 1, nullptr, 10) : 1;
+    if ((texto[0] == 'S' || texto[0] == 's') && texto[1] == '1') {
+      enviarComando(TipoComando::Veiculos, 0, veiculos);
+    } else if ((texto[0] == 'S' || texto[0] == 's') && texto[1] == '2') {
+      enviarComando(TipoComando::Veiculos, 1, veiculos);
+    } else {
+      Serial.printf("[MQTT] Deteccao ignorada: %s\n", texto);
+    }
+    return;
+  }
+
   Serial.print("[MQTT] Mensagem recebida no topico: ");
   Serial.println(topic);
   
@@ -248,18 +690,103 @@ void callbackMQTT(char* topic, byte* payload, unsigned int length) {
   // Processar comandos recebidos via MQTT
   if (String(topic) == mqtt_topic_comandos) {
     if (mensagem == "auto" || mensagem == "AUTO") {
-      controlador.setModoAuto();
+      enviarComando(TipoComando::ModoAuto);
       Serial.println("[MQTT] Comando executado: Modo Automático");
     } else if (mensagem == "normal" || mensagem == "NORMAL") {
-      controlador.setModoNormal();
+      enviarComando(TipoComando::ModoNormal);
       Serial.println("[MQTT] Comando executado: Modo Normal");
     } else if (mensagem == "noturno" || mensagem == "NOTURNO") {
-      controlador.setModoNoturno();
+      enviarComando(TipoComando::ModoNoturno);
       Serial.println("[MQTT] Comando executado: Modo Noturno");
+    } else if (mensagem == "atuado" || mensagem == "ATUADO") {
+      enviarComando(TipoComando::ControleAtuado, 1);
+      Serial.println("[MQTT] Comando executado: Controle Atuado");
+    } else if (mensagem == "fixo" || mensagem == "FIXO") {
+      enviarComando(TipoComando::ControleAtuado, 0);
+      Serial.println("[MQTT] Comando executado: Tempo Fixo");
+    } else if (mensagem.startsWith("histerese:")) {
+      int entrar = 0, sair = 0;
+      unsigned long confirmacao = LDR_CONFIRMACAO_MS;
+      // Validado aqui (o controlador repete a checagem) para o erro sair já no log
+      if (sscanf(mensagem.c_str(), "histerese:%d:%d:%lu", &entrar, &sair, &confirmacao) >= 2 && entrar < sair &&
+          enviarComando(TipoComando::Histerese, (uint32_t)entrar, (uint32_t)sair, confirmacao) != 0) {
+        Serial.println("[MQTT] Comando executado: Histerese");
+      } else {
+        Serial.println("[MQTT] ERRO: use histerese:<entrar noturno>:<sair noturno>[:<confirmacao ms>]");
+      }
     }
   }
 }
 
+void inscreverSyncMQTT() {
+  if (COORDENACAO_ATIVA && ID_CRUZAMENTO != 0 && mqttClient.subscribe(mqtt_topic_sync)) {
+    Serial.print("[MQTT] Inscrito no topico: ");
+    Serial.println(mqtt_topic_sync);
+  }
+}
+
+void inscreverDetectoresMQTT() {
+  if (mqttClient.subscribe(mqtt_topic_detectores)) {
+    Serial.print("[MQTT] Inscrito no topico: ");
+    Serial.println(mqtt_topic_detectores);
+  }
+}
+
+// Mestre da onda verde: publica o próprio millis() como relógio do corredor
+void publicarSyncMQTT() {
+  if (!COORDENACAO_ATIVA || ID_CRUZAMENTO != 0) return;
+  unsigned long agora = millis();
+  if (agora - ultimoSyncMQTT >= intervaloSyncMQTT) {
+    ultimoSyncMQTT = agora;
+    mqttClient.publish(mqtt_topic_sync, String(millis()).c_str());
+  }
+}
+
+// Amostras enfileiradas pelo controlador entram na série (só esta tarefa
+// mexe no histórico, então a consulta HTTP e o MQTT não precisam de trava)
+void guardarHistorico() {
+  AmostraPendente a;
+  while (filaHistorico.receber(a)) {
+    historico.registrar(a.tempo, a.luz, a.estado);
+  }
+}
+
+// Um bloco fechado por passada (não segura a tarefa); na reconexão o atraso
+// acumulado sai em sequência. Só avança o cursor se o publish deu certo
+void publicarHistoricoMQTT() {
+  static uint8_t lote[Historico::TAM_MAX_SERIALIZADO];
+  uint32_t inicio = 0, fim = 0;
+  size_t tamanho = historico.blocoFechado(historicoPublicado, lote, inicio, fim);
+  if (tamanho == 0) return;
+  if (mqttClient.publish(mqtt_topic_historico, lote, tamanho)) {
+    historico.confirmarEnvio(historicoPublicado, inicio);
+    historicoPublicado = fim;
+    Serial.printf("[MQTT] Historico publicado ate a amostra %lu (%u bytes)\n", (unsigned long)fim, (unsigned)tamanho);
+  }
+}
+
+// Lotes binários do diário (formato em DiarioFases.h): sai com LOTE_EVENTOS
+// pendentes ou depois de intervaloEventosMQTT. O cursor só avança se o publish
+// deu certo; o que o anel sobrescrever antes disso aparece como salto de seq
+void publicarEventosMQTT() {
+  static EventoFase eventos[LOTE_EVENTOS];
+  static uint8_t lote[Diario::CABECALHO + LOTE_EVENTOS * Diario::TAM_REGISTRO];
+  static unsigned long ultimoEnvio = 0;
+  const Diario& diario = controlador.getDiario();
+  const uint32_t pendentes = diario.proxima() - eventosPublicados;
+  if (pendentes == 0) return;
+  if (pendentes < LOTE_EVENTOS && millis() - ultimoEnvio < intervaloEventosMQTT) return;
+  uint32_t primeiro = 0;
+  size_t n = diario.ler(eventosPublicados, eventos, LOTE_EVENTOS, primeiro);
+  if (n == 0) return;
+  size_t tamanho = Diario::serializar(eventos, n, primeiro, lote);
+  if (mqttClient.publish(mqtt_topic_eventos, lote, tamanho)) {
+    eventosPublicados = primeiro + n;
+    ultimoEnvio = millis();
+    Serial.printf("[MQTT] Diario publicado: eventos %lu a %lu\n", (unsigned long)primeiro, (unsigned long)(eventosPublicados - 1));
+  }
+}
+
 void tentarReconectarMQTT() {
   // Função não bloqueante - tenta reconectar apenas se passou o intervalo
   unsigned long agora = millis();
@@ -269,9 +796,11 @@ void tentarReconectarMQTT() {
     ultimaTentativaReconexaoMQTT = agora;
     
     Serial.print("[MQTT] Tentando conectar ao broker...");
-    if (mqttClient.connect(mqtt_client_id)) {
+    if (mqttClient.connect(mqttClientId)) {
       Serial.println(" Conectado!");
       mqttDisponivel = true;
+      inscreverSyncMQTT();
+      inscreverDetectoresMQTT();
       // Subscrever ao tópico de comandos
       if (mqttClient.subscribe(mqtt_topic_comandos)) {
         Serial.print("[MQTT] Inscrito no topico: ");
@@ -288,6 +817,37 @@ void tentarReconectarMQTT() {
   }
 }
 
+// Mesmo JSON do /status e da telemetria MQTT
+String montarStatusJSON() {
+  const auto& telemetria = controlador.getTelemetria();
+  String json = "{";
+  json += "\"luminosidade\":" + String(telemetria.luz) + ",";
+  json += "\"luminosidadeBruta\":" + String(telemetria.luzBruta) + ",";
+  json += "\"ruidoLdr\":" + String(telemetria.ruidoLdr, 1) + ",";
+  json += "\"amostrasLdr\":" + String(telemetria.amostrasLdr) + ",";
+  json += "\"limiteNoturno\":" + String(telemetria.limiteNoturno) + ",";
+  json += "\"limiteDiurno\":" + String(telemetria.limiteDiurno) + ",";
+  json += "\"modoAuto\":" + String(telemetria.autoAtivo ? "true" : "false") + ",";
+  json += "\"modoNoturno\":" + String(telemetria.noturnoAtivo ? "true" : "false") + ",";
+  json += "\"cruzamento\":" + String(ID_CRUZAMENTO) + ",";
+  json += "\"coordenado\":" + String(telemetria.coordenado ? "true" : "false") + ",";
+  json += "\"sincronizado\":" + String(telemetria.sincronizado ? "true" : "false") + ",";
+  json += "\"erroOndaMs\":" + String(telemetria.erroOndaMs) + ",";
+  json += "\"atuado\":" + String(telemetria.atuado ? "true" : "false") + ",";
+  json += "\"filaS1\":" + String(telemetria.filaS1) + ",";
+  json += "\"filaS2\":" + String(telemetria.filaS2) + ",";
+  json += "\"veiculosS1\":" + String(telemetria.veiculosS1) + ",";
+  json += "\"veiculosS2\":" + String(telemetria.veiculosS2) + ",";
+  json += "\"gapOuts\":" + String(telemetria.gapOuts) + ",";
+  json += "\"maxOuts\":" + String(telemetria.maxOuts) + ",";
+  json += "\"jitterUs\":" + String(telemetria.jitterUs) + ",";
+  json += "\"jitterMaxUs\":" + String(telemetria.jitterMaxUs) + ",";
+  json += "\"atrasoTrocaMaxUs\":" + String(telemetria.atrasoTrocaMaxUs) + ",";
+  json += "\"timestamp\":" + String(telemetria.timestamp);
+  json += "}";
+  return json;
+}
+
 void publicarTelemetriaMQTT() {
   // Verifica conexão sem bloquear
   if (!mqttClient.connected()) {
@@ -298,20 +858,15 @@ void publicarTelemetriaMQTT() {
   
   mqttDisponivel = true;
   mqttClient.loop();  // Manter conexão ativa e processar mensagens
+  publicarSyncMQTT();
+  publicarHistoricoMQTT();
+  publicarEventosMQTT();
   
   unsigned long agora = millis();
   if (agora - ultimaPublicacaoMQTT >= intervaloPublicacaoMQTT) {
     ultimaPublicacaoMQTT = agora;
     
-    const auto& telemetria = controlador.getTelemetria();
-    
-    // Criar JSON da telemetria
-    String json = "{";
-    json += "\"luminosidade\":" + String(telemetria.luz) + ",";
-    json += "\"modoAuto\":" + String(telemetria.autoAtivo ? "true" : "false") + ",";
-    json += "\"modoNoturno\":" + String(telemetria.noturnoAtivo ? "true" : "false") + ",";
-    json += "\"timestamp\":" + String(telemetria.timestamp);
-    json += "}";
+    const String json = montarStatusJSON();
     
     // Publicar no tópico (não bloqueia se falhar)
     if (mqttClient.publish(mqtt_topic_telemetria, json.c_str())) {
@@ -326,407 +881,181 @@ void publicarTelemetriaMQTT() {
 // ======================================================
 // ================== FUNÇÃO HTML =======================
 // ======================================================
+// Página do painel: blob gzip gerado por gerar_pagina.py a partir de
+// web/index.html. Sai da flash como está, sem montar String a cada GET; com o
+// mesmo ETag o navegador nem baixa de novo (304). Os dados vêm de /status
 void handleRoot() {
   Serial.println("[HTTP] Requisicao recebida: /");
-  int luxAtual = controlador.getLuminosidade();
-  bool autoAtivo = controlador.isModoAuto();
-  bool noturnoAtivo = controlador.isModoNoturno();
-  String modoAtual = autoAtivo ? "Automático" : (noturnoAtivo ? "Noturno" : "Normal");
-  
-  String html = R"(
-<!DOCTYPE html>
-<html lang="pt-BR">
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1.0">
-  <title>Semáforo Inteligente</title>
-  <style>
-    * { margin: 0; padding: 0; box-sizing: border-box; }
-    body {
-      font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-      background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-      min-height: 100vh;
-      padding: 20px;
-      color: #333;
-    }
-    .container {
-      max-width: 800px;
-      margin: 0 auto;
-    }
-    .header {
-      text-align: center;
-      color: white;
-      margin-bottom: 30px;
-      padding: 20px;
-    }
-    .header h1 {
-      font-size: 2.5em;
-      margin-bottom: 10px;
-      text-shadow: 2px 2px 4px rgba(0,0,0,0.3);
-    }
-    .header p {
-      font-size: 1.1em;
-      opacity: 0.9;
-    }
-    .card {
-      background: white;
-      border-radius: 20px;
-      padding: 30px;
-      margin-bottom: 20px;
-      box-shadow: 0 10px 30px rgba(0,0,0,0.2);
-      transition: transform 0.3s ease, box-shadow 0.3s ease;
-    }
-    .card:hover {
-      transform: translateY(-5px);
-      box-shadow: 0 15px 40px rgba(0,0,0,0.3);
-    }
-    .status-grid {
-      display: grid;
-      grid-template-columns: repeat(auto-fit, minmax(200px, 1fr));
-      gap: 20px;
-      margin-bottom: 30px;
-    }
-    .status-item {
-      text-align: center;
-      padding: 20px;
-      background: #f8f9fa;
-      border-radius: 15px;
-      transition: all 0.3s ease;
-    }
-    .status-item.active {
-      background: linear-gradient(135deg, #4CAF50 0%, #45a049 100%);
-      color: white;
-      transform: scale(1.05);
-      box-shadow: 0 5px 15px rgba(76, 175, 80, 0.4);
-    }
-    .status-item h3 {
-      font-size: 0.9em;
-      margin-bottom: 10px;
-      opacity: 0.8;
-    }
-    .status-item .value {
-      font-size: 1.8em;
-      font-weight: bold;
-    }
-    .luminosidade-container {
-      margin: 20px 0;
-    }
-    .luminosidade-label {
-      display: flex;
-      justify-content: space-between;
-      margin-bottom: 10px;
-      font-weight: 600;
-    }
-    .progress-bar {
-      width: 100%;
-      height: 30px;
-      background: #e0e0e0;
-      border-radius: 15px;
-      overflow: hidden;
-      position: relative;
-      box-shadow: inset 0 2px 5px rgba(0,0,0,0.1);
-    }
-    .progress-fill {
-      height: 100%;
-      background: linear-gradient(90deg, #ffd700 0%, #ff8c00 50%, #ff4500 100%);
-      border-radius: 15px;
-      transition: width 0.5s ease;
-      display: flex;
-      align-items: center;
-      justify-content: center;
-      color: white;
-      font-weight: bold;
-      font-size: 0.9em;
-    }
-    .modo-badges {
-      display: flex;
-      gap: 10px;
-      flex-wrap: wrap;
-      justify-content: center;
-      margin-top: 20px;
-    }
-    .badge {
-      padding: 10px 20px;
-      border-radius: 25px;
-      font-weight: 600;
-      transition: all 0.3s ease;
-      cursor: default;
-    }
-    .badge.active {
-      background: linear-gradient(135deg, #4CAF50 0%, #45a049 100%);
-      color: white;
-      box-shadow: 0 5px 15px rgba(76, 175, 80, 0.4);
-    }
-    .badge.inactive {
-      background: #e0e0e0;
-      color: #666;
-    }
-    .buttons-container {
-      display: grid;
-      grid-template-columns: repeat(auto-fit, minmax(200px, 1fr));
-      gap: 15px;
-      margin-top: 20px;
-    }
-    .btn {
-      padding: 15px 30px;
-      border: none;
-      border-radius: 12px;
-      font-size: 1em;
-      font-weight: 600;
-      cursor: pointer;
-      text-decoration: none;
-      display: block;
-      text-align: center;
-      transition: all 0.3s ease;
-      color: white;
-      box-shadow: 0 4px 15px rgba(0,0,0,0.2);
-    }
-    .btn:hover {
-      transform: translateY(-2px);
-      box-shadow: 0 6px 20px rgba(0,0,0,0.3);
-    }
-    .btn:active {
-      transform: translateY(0);
-    }
-    .btn-auto {
-      background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-    }
-    .btn-normal {
-      background: linear-gradient(135deg, #4CAF50 0%, #45a049 100%);
-    }
-    .btn-noturno {
-      background: linear-gradient(135deg, #ff9800 0%, #f57c00 100%);
-    }
-    .info-section {
-      background: #f8f9fa;
-      padding: 20px;
-      border-radius: 15px;
-      margin-top: 20px;
-    }
-    .info-section code {
-      background: #e9ecef;
-      padding: 5px 10px;
-      border-radius: 5px;
-      font-family: 'Courier New', monospace;
-      color: #d63384;
-    }
-    .semaforo-visual {
-      display: flex;
-      justify-content: center;
-      gap: 30px;
-      margin: 30px 0;
-      flex-wrap: wrap;
-    }
-    .semaforo {
-      width: 80px;
-      height: 200px;
-      background: #2c3e50;
-      border-radius: 10px;
-      padding: 10px;
-      display: flex;
-      flex-direction: column;
-      gap: 10px;
-      box-shadow: 0 5px 15px rgba(0,0,0,0.3);
-    }
-    .luz {
-      flex: 1;
-      border-radius: 50%;
-      background: #1a1a1a;
-      transition: all 0.3s ease;
-      box-shadow: inset 0 0 20px rgba(0,0,0,0.5);
-    }
-    .luz.vermelho.on { background: #e74c3c; box-shadow: 0 0 20px #e74c3c, inset 0 0 20px rgba(231,76,60,0.5); }
-    .luz.amarelo.on { background: #f39c12; box-shadow: 0 0 20px #f39c12, inset 0 0 20px rgba(243,156,18,0.5); }
-    .luz.verde.on { background: #27ae60; box-shadow: 0 0 20px #27ae60, inset 0 0 20px rgba(39,174,96,0.5); }
-    .semaforo-label {
-      text-align: center;
-      margin-top: 10px;
-      font-weight: 600;
-      color: white;
-    }
-    @keyframes pulse {
-      0%, 100% { opacity: 1; }
-      50% { opacity: 0.5; }
-    }
-    .luz.piscando {
-      animation: pulse 1s infinite;
+  server.sendHeader("ETag", PAGINA_ETAG);
+  server.sendHeader("Cache-Control", "max-age=3600");
+  if (server.header("If-None-Match") == PAGINA_ETAG) {
+    server.send(304);
+    Serial.println("[HTTP] Resposta enviada: 304 Not Modified");
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (const char*)PAGINA_GZ, PAGINA_GZ_TAMANHO);
+  Serial.println("[HTTP] Resposta enviada: 200 OK");
+}
+
+// Troca de modo: POST (painel) responde com o status novo em JSON, sem
+// recarregar a página; GET (links e favoritos antigos) volta para a página.
+// O POST espera o controlador aplicar o comando (uma passada, ~1 ms; no
+// máximo 50 passadas) para o JSON já trazer o modo novo
+void responderModo(uint32_t comando) {
+  if (server.method() == HTTP_POST) {
+    for (int i = 0; i < 50 && comando != 0 && (int32_t)(controlador.getTelemetria().comandosAplicados - comando) < 0; i++) {
+      vTaskDelay(pdMS_TO_TICKS(PERIODO_CONTROLE_MS));
     }
-    @media (max-width: 600px) {
-      .header h1 { font-size: 2em; }
-      .status-grid { grid-template-columns: 1fr; }
-      .buttons-container { grid-template-columns: 1fr; }
+    server.send(200, "application/json", montarStatusJSON());
+  } else {
+    server.sendHeader("Location", "/");
+    server.send(303);
+  }
+}
+
+void setAuto()    { Serial.println("[HTTP] Requisicao recebida: /auto"); responderModo(enviarComando(TipoComando::ModoAuto)); }
+void setNormal()  { Serial.println("[HTTP] Requisicao recebida: /normal"); responderModo(enviarComando(TipoComando::ModoNormal)); }
+void setAtuado()  { Serial.println("[HTTP] Requisicao recebida: /atuado"); responderModo(enviarComando(TipoComando::ControleAtuado, 1)); }
+void setFixo()    { Serial.println("[HTTP] Requisicao recebida: /fixo"); responderModo(enviarComando(TipoComando::ControleAtuado, 0)); }
+void setNoturno() { Serial.println("[HTTP] Requisicao recebida: /noturno"); responderModo(enviarComando(TipoComando::ModoNoturno)); }
+
+// Histórico decodificado: /historico?desde=<seq>&max=<n> (padrão: últimas
+// 100 amostras). "proxima" é o cursor para a consulta seguinte
+void handleHistorico() {
+  Historico& h = historico;
+  uint32_t desde = h.proxima() > 100 ? h.proxima() - 100 : 0;
+  if (server.hasArg("desde")) desde = strtoul(server.arg("desde").c_str(), nullptr, 10);
+  size_t max = 100;
+  if (server.hasArg("max")) max = constrain(server.arg("max").toInt(), 1, 300);
+  Serial.printf("[HTTP] Requisicao recebida: /historico (desde %lu)\n", (unsigned long)desde);
+
+  String json;
+  json.reserve(96 + max * 28);
+  json += "{\"primeira\":" + String(h.primeiraSeq());
+  json += ",\"perdidas\":" + String(h.getPerdidas());
+  json += ",\"bytes\":" + String((unsigned long)h.getBytesUsados());
+  json += ",\"amostras\":[";
+  uint32_t proxima = desde;
+  bool primeira = true;
+  h.paraCada(desde, max, [&](const AmostraSerie& a) {
+    if (!primeira) json += ",";
+    primeira = false;
+    json += "[" + String(a.seq) + "," + String(a.tempo) + "," + String(a.luz) + "," + String(a.estado) + "]";
+    proxima = a.seq + 1;
+  });
+  json += "],\"proxima\":" + String(proxima) + "}";
+  server.send(200, "application/json", json);
+}
+
+// Diário das trocas de fase: /eventos?desde=<seq>&formato=csv|bin (padrão:
+// todos os guardados em CSV). No CSV, duracao_us vai até o evento seguinte
+// (vazio na fase em curso) e desvio_us = duracao_us - min_ms * 1000
+void handleEventos() {
+  static EventoFase eventos[Diario::EVENTOS];
+  const Diario& diario = controlador.getDiario();
+  uint32_t desde = server.hasArg("desde") ? strtoul(server.arg("desde").c_str(), nullptr, 10) : 0;
+  uint32_t primeiro = 0;
+  size_t n = diario.ler(desde, eventos, sizeof(eventos) / sizeof(eventos[0]), primeiro);
+  Serial.printf("[HTTP] Requisicao recebida: /eventos (%u eventos desde %lu)\n", (unsigned)n, (unsigned long)primeiro);
+
+  if (server.arg("formato") == "bin") {
+    // Um cabeçalho para todos os eventos, registros em pedaços de LOTE_EVENTOS
+    static uint8_t pedaco[LOTE_EVENTOS * Diario::TAM_REGISTRO];
+    server.setContentLength(Diario::CABECALHO + n * Diario::TAM_REGISTRO);
+    server.send(200, "application/octet-stream", "");
+    Diario::escreverCabecalho(primeiro, n, pedaco);
+    server.sendContent((const char*)pedaco, Diario::CABECALHO);
+    for (size_t i = 0; i < n; i += LOTE_EVENTOS) {
+      size_t tamanho = Diario::escreverRegistros(eventos + i, n - i < LOTE_EVENTOS ? n - i : LOTE_EVENTOS, pedaco);
+      server.sendContent((const char*)pedaco, tamanho);
     }
-  </style>
-</head>
-<body>
-  <div class="container">
-    <div class="header">
-      <h1>🚦 Semáforo Inteligente</h1>
-      <p>Sistema de Controle Inteligente de Tráfego</p>
-    </div>
-
-    <div class="card">
-      <div class="status-grid">
-        <div class="status-item" id="statusLuminosidade">
-          <h3>💡 Luminosidade</h3>
-          <div class="value" id="lux">)" + String(luxAtual) + R"(</div>
-          <div style="font-size: 0.8em; margin-top: 5px; opacity: 0.7;">LDR Sensor</div>
-        </div>
-        <div class="status-item" id="statusModo">
-          <h3>⚙️ Modo Atual</h3>
-          <div class="value" id="modoAtual">)" + modoAtual + R"(</div>
-          <div style="font-size: 0.8em; margin-top: 5px; opacity: 0.7;">Estado do Sistema</div>
-        </div>
-      </div>
-
-      <div class="luminosidade-container">
-        <div class="luminosidade-label">
-          <span>Nível de Luminosidade</span>
-          <span id="luxPercent">0%</span>
-        </div>
-        <div class="progress-bar">
-          <div class="progress-fill" id="progressFill" style="width: 0%"></div>
-        </div>
-        <div style="display: flex; justify-content: space-between; margin-top: 5px; font-size: 0.8em; opacity: 0.7;">
-          <span>Escuro (0)</span>
-          <span>Claro (5000)</span>
-        </div>
-      </div>
-
-      <div class="modo-badges">
-        <span class="badge" id="badgeAuto">🤖 Automático</span>
-        <span class="badge" id="badgeNormal">☀️ Normal</span>
-        <span class="badge" id="badgeNoturno">🌙 Noturno</span>
-      </div>
-    </div>
-
-    <div class="card">
-      <h2 style="margin-bottom: 20px; text-align: center;">Controle de Modos</h2>
-      <div class="buttons-container">
-        <a href="/auto" class="btn btn-auto">🤖 Modo Automático</a>
-        <a href="/normal" class="btn btn-normal">☀️ Modo Normal</a>
-        <a href="/noturno" class="btn btn-noturno">🌙 Modo Noturno</a>
-      </div>
-    </div>
-
-    <div class="card">
-      <div class="semaforo-visual">
-        <div>
-          <div class="semaforo">
-            <div class="luz vermelho" id="s1-red"></div>
-            <div class="luz amarelo" id="s1-yellow"></div>
-            <div class="luz verde" id="s1-green"></div>
-          </div>
-          <div class="semaforo-label">Semáforo 1</div>
-        </div>
-        <div>
-          <div class="semaforo">
-            <div class="luz vermelho" id="s2-red"></div>
-            <div class="luz amarelo" id="s2-yellow"></div>
-            <div class="luz verde" id="s2-green"></div>
-          </div>
-          <div class="semaforo-label">Semáforo 2</div>
-        </div>
-      </div>
-    </div>
-
-    <div class="card">
-      <div class="info-section">
-        <h3 style="margin-bottom: 10px;">📡 API Endpoint</h3>
-        <p style="margin-bottom: 10px;">Endpoint JSON para integração:</p>
-        <code>/status</code>
-        <p style="margin-top: 10px; font-size: 0.9em; opacity: 0.7;">
-          Use este endpoint para dashboards Web ou integração futura com MQTT.
-        </p>
-      </div>
-    </div>
-  </div>
-
-  <script>
-    async function atualizar() {
-      try {
-        const response = await fetch('/status');
-        const data = await response.json();
-        
-        // Atualizar luminosidade
-        document.getElementById('lux').textContent = data.luminosidade;
-        const percent = Math.min(100, (data.luminosidade / 5000) * 100);
-        document.getElementById('luxPercent').textContent = Math.round(percent) + '%';
-        document.getElementById('progressFill').style.width = percent + '%';
-        
-        // Atualizar modo
-        const modoTexto = data.modoAuto ? 'Automático' : (data.modoNoturno ? 'Noturno' : 'Normal');
-        document.getElementById('modoAtual').textContent = modoTexto;
-        
-        // Atualizar badges
-        document.getElementById('badgeAuto').className = 'badge ' + (data.modoAuto ? 'active' : 'inactive');
-        document.getElementById('badgeNormal').className = 'badge ' + (!data.modoNoturno && !data.modoAuto ? 'active' : 'inactive');
-        document.getElementById('badgeNoturno').className = 'badge ' + (data.modoNoturno && !data.modoAuto ? 'active' : 'inactive');
-        
-        // Atualizar status items
-        document.getElementById('statusLuminosidade').classList.toggle('active', true);
-        document.getElementById('statusModo').classList.toggle('active', true);
-        
-        // Simulação visual dos semáforos (baseado no modo)
-        atualizarSemaforos(data.modoNoturno);
-      } catch (error) {
-        console.error('Erro ao atualizar:', error);
-      }
+    return;
+  }
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/csv", "seq,tempo_us,plano,fase,causa,min_ms,max_ms,duracao_us,desvio_us\n");
+  static const char* planos[] = {"normal", "atuado", "noturno"};
+  String linhas;
+  linhas.reserve(2048);
+  for (size_t i = 0; i < n; i++) {
+    const EventoFase& e = eventos[i];
+    linhas += String(primeiro + i) + "," + String((unsigned long long)e.tempoUs) + "," + planos[e.plano % 3] + "," +
+              String(e.fase) + "," + nomeCausa((CausaFase)e.causa) + "," + String(e.minMs) + "," + String(e.maxMs) + ",";
+    if (i + 1 < n) {
+      int64_t duracao = (int64_t)(eventos[i + 1].tempoUs - e.tempoUs);
+      linhas += String((long long)duracao) + "," + String((long long)(duracao - (int64_t)e.minMs * 1000));
+    } else {
+      linhas += ",";
     }
-    
-    function atualizarSemaforos(noturno) {
-      // Limpar todos
-      document.querySelectorAll('.luz').forEach(l => {
-        l.classList.remove('on', 'piscando');
-      });
-      
-      if (noturno) {
-        // Modo noturno: amarelo piscando
-        document.getElementById('s1-yellow').classList.add('on', 'piscando');
-        document.getElementById('s2-yellow').classList.add('on', 'piscando');
-      } else {
-        // Modo normal: simulação básica (ciclo completo seria mais complexo)
-        // Por simplicidade, mostra verde no S1 e vermelho no S2
-        document.getElementById('s1-green').classList.add('on');
-        document.getElementById('s2-red').classList.add('on');
-      }
+    linhas += "\n";
+    if (linhas.length() > 1900) {
+      server.sendContent(linhas);
+      linhas = "";
     }
-    
-    // Atualizar a cada 2 segundos
-    setInterval(atualizar, 2000);
-    window.onload = atualizar;
-  </script>
-</body>
-</html>
-)";
-  
-  server.send(200, "text/html", html);
-  Serial.println("[HTTP] Resposta enviada: 200 OK");
+  }
+  if (linhas.length() > 0) server.sendContent(linhas);
+  server.sendContent("");
 }
 
-void setAuto()    { Serial.println("[HTTP] Requisicao recebida: /auto"); controlador.setModoAuto();   server.sendHeader("Location", "/"); server.send(303); }
-void setNormal()  { Serial.println("[HTTP] Requisicao recebida: /normal"); controlador.setModoNormal(); server.sendHeader("Location", "/"); server.send(303); }
-void setNoturno() { Serial.println("[HTTP] Requisicao recebida: /noturno"); controlador.setModoNoturno();server.sendHeader("Location", "/"); server.send(303); }
-
 void handleStatus() {
   Serial.println("[HTTP] Requisicao recebida: /status");
   const auto& telemetria = controlador.getTelemetria();
-  String json = "{";
-  json += "\"luminosidade\":" + String(telemetria.luz) + ",";
-  json += "\"modoAuto\":" + String(telemetria.autoAtivo ? "true" : "false") + ",";
-  json += "\"modoNoturno\":" + String(telemetria.noturnoAtivo ? "true" : "false") + ",";
-  json += "\"timestamp\":" + String(telemetria.timestamp);
-  json += "}";
-  server.send(200, "application/json", json);
+  server.send(200, "application/json", montarStatusJSON());
   Serial.printf("[HTTP] JSON enviado: luz=%d, auto=%s, noturno=%s\n", 
                 telemetria.luz, 
                 telemetria.autoAtivo ? "true" : "false",
                 telemetria.noturnoAtivo ? "true" : "false");
 }
 // ======================================================
+// ======================= TAREFAS =======================
+// ======================================================
+// Uma passada de cada tarefa fica fora do laço para o simulador do host/
+// (semaforo_sim) chamar o mesmo código no relógio simulado. O controlador
+// mede com esp_timer o intervalo real entre duas passadas; o desvio para o
+// período é o jitter do tick
+void passadaControle(int64_t& anterior) {
+  int64_t agora = esp_timer_get_time();
+  if (anterior != 0) {
+    int64_t desvio = agora - anterior - (int64_t)PERIODO_CONTROLE_MS * 1000;
+    controlador.registrarTick((uint32_t)(desvio < 0 ? -desvio : desvio));
+  }
+  anterior = agora;
+  controlador.atualizar();
+}
+
+void passadaRede() {
+  server.handleClient();
+  guardarHistorico();
+  publicarTelemetriaMQTT();
+}
+
+// Controlador: acorda a cada PERIODO_CONTROLE_MS pelo tick do FreeRTOS
+// (vTaskDelayUntil não acumula atraso)
+void tarefaControle(void*) {
+  TickType_t proximo = xTaskGetTickCount();
+  int64_t anterior = 0;
+  for (;;) {
+    vTaskDelayUntil(&proximo, pdMS_TO_TICKS(PERIODO_CONTROLE_MS));
+    passadaControle(anterior);
+  }
+}
+
+// Rede: HTTP, MQTT (inclusive a reconexão, que pode bloquear por segundos) e
+// o histórico, no núcleo da pilha Wi-Fi
+void tarefaRede(void*) {
+  for (;;) {
+    passadaRede();
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
+}
+// ======================================================
 // ======================== SETUP ========================
 // ======================================================
 void setup() {
+  // Com buffer, um print da tarefa do controlador só copia e volta (sem ele,
+  // espera a UART transmitir a 115200 baud, ~0,1 ms por caractere)
+  Serial.setTxBufferSize(1024);
   Serial.begin(115200);
   delay(1000);
   Serial.println("\n\n========================================");
@@ -734,20 +1063,39 @@ void setup() {
   Serial.println("========================================\n");
   
   Serial.println("[Setup] Inicializando controlador...");
+  controlador.configurarCoordenacao(COORDENACAO_ATIVA, ID_CRUZAMENTO == 0, OFFSET_ONDA_MS);
+  controlador.setControleAtuado(CONTROLE_ATUADO);
   controlador.begin();
+  pinMode(DET_S1, INPUT_PULLUP);
+  pinMode(DET_S2, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(DET_S1), isrDetectorS1, FALLING);
+  attachInterrupt(digitalPinToInterrupt(DET_S2), isrDetectorS2, FALLING);
+  // Os semáforos já funcionam enquanto o Wi-Fi e o MQTT sobem
+  xTaskCreatePinnedToCore(tarefaControle, "controle", 4096, nullptr, PRIORIDADE_CONTROLE, nullptr, NUCLEO_CONTROLE);
+  Serial.printf("[Setup] Controlador no nucleo %ld, prioridade %lu, periodo %lu ms\n", (long)NUCLEO_CONTROLE,
+                (unsigned long)PRIORIDADE_CONTROLE, (unsigned long)PERIODO_CONTROLE_MS);
   Serial.println("[Setup] Limites LDR configurados:");
-  Serial.println("  - Entrar modo NOTURNO: < 1800 (faixa: 0-2000)");
-  Serial.println("  - Sair modo NOTURNO:  > 2200 (faixa: 2000-5000)");
+  Serial.printf("  - Entrar modo NOTURNO: < %d (faixa: 0-2000)\n", LDR_LIMITE_NOTURNO);
+  Serial.printf("  - Sair modo NOTURNO:  > %d (faixa: 2000-5000)\n", LDR_LIMITE_DIURNO);
+  Serial.printf("  - Confirmacao: %lu ms alem do limite\n", LDR_CONFIRMACAO_MS);
   
-  Serial.println("[Setup] Configurando Access Point...");
-  bool apOk = WiFi.softAP(ssid, password);
-  if (apOk) {
-    Serial.print("[Setup] AP criado com sucesso! SSID: ");
-    Serial.println(ssid);
-    Serial.print("[Setup] IP do Access Point: ");
-    Serial.println(WiFi.softAPIP());
+  if (ID_CRUZAMENTO == 0) {
+    Serial.println("[Setup] Configurando Access Point...");
+    bool apOk = WiFi.softAP(ssid, password);
+    if (apOk) {
+      Serial.print("[Setup] AP criado com sucesso! SSID: ");
+      Serial.println(ssid);
+      Serial.print("[Setup] IP do Access Point: ");
+      Serial.println(WiFi.softAPIP());
+    } else {
+      Serial.println("[Setup] ERRO: Falha ao criar Access Point!");
+    }
   } else {
-    Serial.println("[Setup] ERRO: Falha ao criar Access Point!");
+    // Demais cruzamentos do corredor entram na rede do cruzamento 0 (não bloqueia:
+    // o MQTT tenta de novo a cada 10 segundos até a conexão sair)
+    Serial.printf("[Setup] Cruzamento %d: conectando a rede %s...\n", ID_CRUZAMENTO, ssid);
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(ssid, password);
   }
   
   Serial.println("[Setup] Configurando rotas HTTP...");
@@ -755,14 +1103,28 @@ void setup() {
   server.on("/auto", setAuto);
   server.on("/normal", setNormal);
   server.on("/noturno", setNoturno);
+  server.on("/atuado", setAtuado);
+  server.on("/fixo", setFixo);
   server.on("/status", handleStatus);
+  server.on("/historico", handleHistorico);
+  server.on("/eventos", handleEventos);
+  const char* cabecalhos[] = {"If-None-Match"};
+  server.collectHeaders(cabecalhos, 1);
   
   Serial.println("[Setup] Iniciando servidor HTTP na porta 80...");
   server.begin();
   Serial.println("[Setup] Servidor HTTP iniciado com sucesso!");
   
   Serial.println("[Setup] Configurando cliente MQTT...");
+  if (ID_CRUZAMENTO == 0) {
+    snprintf(mqttClientId, sizeof(mqttClientId), "%s", mqtt_client_id);
+  } else {
+    snprintf(mqttClientId, sizeof(mqttClientId), "%s_%d", mqtt_client_id, ID_CRUZAMENTO);
+  }
   mqttClient.setServer(mqtt_server, mqtt_port);
+  // O padrão do PubSubClient (256 bytes) não comporta a telemetria (~370
+  // bytes) nem um lote do histórico (até 276 bytes + tópico)
+  mqttClient.setBufferSize(1024);
   mqttClient.setCallback(callbackMQTT);
   Serial.print("[Setup] Broker MQTT: ");
   Serial.print(mqtt_server);
@@ -776,9 +1138,11 @@ void setup() {
   // Tentar conectar ao broker MQTT (não bloqueia se não conseguir)
   Serial.println("[Setup] Tentando conectar ao broker MQTT...");
   Serial.println("[Setup] NOTA: O sistema funcionara normalmente mesmo sem MQTT.");
-  if (mqttClient.connect(mqtt_client_id)) {
+  if (mqttClient.connect(mqttClientId)) {
     Serial.println("[Setup] Conectado ao broker MQTT com sucesso!");
     mqttDisponivel = true;
+    inscreverSyncMQTT();
+    inscreverDetectoresMQTT();
     if (mqttClient.subscribe(mqtt_topic_comandos)) {
       Serial.print("[Setup] Inscrito no topico de comandos: ");
       Serial.println(mqtt_topic_comandos);
@@ -791,6 +1155,9 @@ void setup() {
     mqttDisponivel = false;
   }
   
+  xTaskCreatePinnedToCore(tarefaRede, "rede", 8192, nullptr, PRIORIDADE_REDE, nullptr, NUCLEO_REDE);
+  Serial.printf("[Setup] HTTP e MQTT no nucleo %ld\n", (long)NUCLEO_REDE);
+
   Serial.println("\n========================================");
   Serial.println("  SISTEMA PRONTO!");
   Serial.println("========================================\n");
@@ -799,14 +1166,11 @@ void setup() {
 // ========================= LOOP ========================
 // ======================================================
 void loop() {
-  static unsigned long ultimoHeartbeat = 0;
-  
-  server.handleClient();
-  controlador.atualizar();
-  
-  // Heartbeat a cada 10 segundos para confirmar que está rodando
-  if (millis() - ultimoHeartbeat >= 10000) {
-    Serial.println("[Heartbeat] Sistema operacional");
-    ultimoHeartbeat = millis();
-  }
+  // O controlador e a rede rodam nas próprias tarefas; aqui só o heartbeat,
+  // a cada 10 segundos, com o jitter medido
+  const auto telemetria = controlador.getTelemetria();
+  Serial.printf("[Heartbeat] Sistema operacional (jitter do tick %lu us, pior %lu us, pior atraso de troca %ld us)\n",
+                (unsigned long)telemetria.jitterUs, (unsigned long)telemetria.jitterMaxUs,
+                (long)telemetria.atrasoTrocaMaxUs);
+  vTaskDelay(pdMS_TO_TICKS(10000));
 }
@@ -0,0 +1,270 @@
+#ifndef SERIE_TEMPORAL_H
+#define SERIE_TEMPORAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Histórico da telemetria no próprio ESP32: luminosidade, fase e modo, com
+// amostras a cada segundo e a cada troca de fase.
+//
+// As amostras ficam em blocos de tamanho fixo num anel. O primeiro registro de
+// cada bloco é absoluto (no cabeçalho) e os seguintes guardam só diferenças em
+// varint:
+//   varint((dt << 1) | mudouEstado)   ms desde a amostra anterior
+//   varint(zigzag(dLuz))              diferença de luminosidade
+//   [estado]                          1 byte, só se mudou
+// Uma amostra típica ocupa 3 bytes em vez de 7 (tempo, luz e estado).
+// Cada bloco decodifica sozinho: quando o anel enche, o bloco mais antigo é
+// descartado inteiro e nenhum registro perde a referência.
+//
+// Cada amostra tem um número de sequência crescente. O publicador guarda até
+// onde já enviou e, ao reconectar, manda os blocos fechados que faltam; a
+// consulta HTTP também usa a sequência como cursor.
+//
+// Formato de um bloco serializado (little-endian, o mesmo do MQTT):
+//   'S' 'T' versão estado0 | seq0 u32 | t0 u32 | luz0 i16 | n u16 | bytes u16 | dados
+
+#define SERIE_VERSAO 1
+
+struct AmostraSerie
+{
+  uint32_t seq;
+  uint32_t tempo;   // millis()
+  int16_t luz;
+  uint8_t estado;
+};
+
+template <size_t BLOCOS, size_t TAM_BLOCO>
+class SerieTemporal
+{
+public:
+  static_assert(BLOCOS >= 2, "Pelo menos dois blocos (um fechado e um em uso)");
+  static_assert(TAM_BLOCO >= 16 && TAM_BLOCO <= 65535, "Tamanho de bloco inválido");
+
+  static constexpr size_t CABECALHO = 20;
+  static constexpr size_t TAM_MAX_SERIALIZADO = CABECALHO + TAM_BLOCO;
+
+  void registrar(uint32_t tempo, int16_t luz, uint8_t estado)
+  {
+    Bloco *b = &blocos[atual];
+    uint8_t reg[11];
+    size_t tam = 0;
+    if (b->n > 0)
+    {
+      const uint32_t dt = tempo - ultima.tempo;
+      const bool mudou = estado != ultima.estado;
+      tam = codificar(reg, ((uint64_t)dt << 1) | (mudou ? 1 : 0));
+      const int32_t dl = (int32_t)luz - ultima.luz;
+      tam += codificar(reg + tam, ((uint32_t)dl << 1) ^ (uint32_t)(dl >> 31));
+      if (mudou)
+      {
+        reg[tam++] = estado;
+      }
+      if (b->usado + tam > TAM_BLOCO)
+      {
+        fecharBloco();
+        b = &blocos[atual];
+      }
+    }
+
+    if (b->n == 0)
+    {
+      b->seq0 = proximaSeq;
+      b->t0 = tempo;
+      b->luz0 = luz;
+      b->estado0 = estado;
+      b->usado = 0;
+    }
+    else
+    {
+      memcpy(b->dados + b->usado, reg, tam);
+      b->usado += (uint16_t)tam;
+    }
+    b->n++;
+    ultima = {proximaSeq, tempo, luz, estado};
+    proximaSeq++;
+  }
+
+  // Sequência da amostra mais antiga guardada e da próxima a ser gravada
+  uint32_t primeiraSeq() const { return blocos[antigo].n > 0 ? blocos[antigo].seq0 : proximaSeq; }
+  uint32_t proxima() const { return proximaSeq; }
+  // Amostras sobrescritas antes de serem publicadas
+  uint32_t getPerdidas() const { return perdidas; }
+  size_t getBytesUsados() const
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < BLOCOS; i++)
+    {
+      total += blocos[i].n > 0 ? CABECALHO + blocos[i].usado : 0;
+    }
+    return total;
+  }
+
+  // Percorre as amostras com seq >= desde (no máximo 'max'); retorna quantas
+  template <typename F>
+  size_t paraCada(uint32_t desde, size_t max, F &&f) const
+  {
+    size_t entregues = 0;
+    for (size_t k = 0; k < BLOCOS && entregues < max; k++)
+    {
+      const Bloco &b = blocos[(antigo + k) % BLOCOS];
+      if (b.n == 0 || (int32_t)(b.seq0 + b.n - desde) <= 0)
+      {
+        continue;
+      }
+      decodificar(b, [&](const AmostraSerie &a) {
+        if ((int32_t)(a.seq - desde) >= 0 && entregues < max)
+        {
+          f(a);
+          entregues++;
+        }
+      });
+    }
+    return entregues;
+  }
+
+  // Próximo bloco fechado com amostras a partir de 'desde', serializado em
+  // 'saida' (TAM_MAX_SERIALIZADO bytes). Retorna o tamanho (0 = nenhum), em
+  // 'inicio' a primeira sequência do bloco e em 'fim' a sequência logo depois
+  // dele, para o cursor do publicador
+  size_t blocoFechado(uint32_t desde, uint8_t *saida, uint32_t &inicio, uint32_t &fim) const
+  {
+    for (size_t k = 0; k < BLOCOS; k++)
+    {
+      const size_t i = (antigo + k) % BLOCOS;
+      const Bloco &b = blocos[i];
+      if (i == atual)
+      {
+        break;
+      }
+      if (b.n == 0 || (int32_t)(b.seq0 + b.n - desde) <= 0)
+      {
+        continue;
+      }
+      inicio = b.seq0;
+      fim = b.seq0 + b.n;
+      return serializar(b, saida);
+    }
+    return 0;
+  }
+
+  // O publicador enviou o bloco que começa em 'inicio' com o cursor em 'desde'.
+  // Chamado só depois do publish: uma falha não conta a mesma lacuna de novo
+  void confirmarEnvio(uint32_t desde, uint32_t inicio)
+  {
+    if ((int32_t)(inicio - desde) > 0)
+    {
+      // O anel passou por cima do que ainda não tinha sido enviado
+      perdidas += inicio - desde;
+    }
+  }
+
+private:
+  struct Bloco
+  {
+    uint32_t seq0 = 0;
+    uint32_t t0 = 0;
+    int16_t luz0 = 0;
+    uint8_t estado0 = 0;
+    uint16_t n = 0;
+    uint16_t usado = 0;
+    uint8_t dados[TAM_BLOCO];
+  };
+
+  Bloco blocos[BLOCOS];
+  size_t atual = 0;
+  size_t antigo = 0;
+  uint32_t proximaSeq = 0;
+  uint32_t perdidas = 0;
+  AmostraSerie ultima = {};
+
+  void fecharBloco()
+  {
+    atual = (atual + 1) % BLOCOS;
+    if (atual == antigo)
+    {
+      antigo = (antigo + 1) % BLOCOS;
+    }
+    blocos[atual].n = 0;
+    blocos[atual].usado = 0;
+  }
+
+  static size_t codificar(uint8_t *p, uint64_t v)
+  {
+    size_t i = 0;
+    while (v >= 0x80)
+    {
+      p[i++] = (uint8_t)(v | 0x80);
+      v >>= 7;
+    }
+    p[i++] = (uint8_t)v;
+    return i;
+  }
+
+  static uint64_t ler(const uint8_t *p, size_t fim, size_t &pos)
+  {
+    uint64_t v = 0;
+    for (int deslocamento = 0; pos < fim && deslocamento < 64; deslocamento += 7)
+    {
+      const uint8_t byte = p[pos++];
+      v |= (uint64_t)(byte & 0x7f) << deslocamento;
+      if ((byte & 0x80) == 0)
+      {
+        break;
+      }
+    }
+    return v;
+  }
+
+  template <typename F>
+  static void decodificar(const Bloco &b, F &&f)
+  {
+    AmostraSerie a = {b.seq0, b.t0, b.luz0, b.estado0};
+    f(a);
+    size_t pos = 0;
+    for (uint16_t i = 1; i < b.n && pos < b.usado; i++)
+    {
+      const uint64_t dt = ler(b.dados, b.usado, pos);
+      const uint32_t z = (uint32_t)ler(b.dados, b.usado, pos);
+      a.seq++;
+      a.tempo += (uint32_t)(dt >> 1);
+      a.luz = (int16_t)(a.luz + (int32_t)((z >> 1) ^ (0u - (z & 1))));
+      if ((dt & 1) && pos < b.usado)
+      {
+        a.estado = b.dados[pos++];
+      }
+      f(a);
+    }
+  }
+
+  static size_t serializar(const Bloco &b, uint8_t *p)
+  {
+    p[0] = 'S';
+    p[1] = 'T';
+    p[2] = SERIE_VERSAO;
+    p[3] = b.estado0;
+    escrever32(p + 4, b.seq0);
+    escrever32(p + 8, b.t0);
+    p[12] = (uint8_t)b.luz0;
+    p[13] = (uint8_t)((uint16_t)b.luz0 >> 8);
+    p[14] = (uint8_t)b.n;
+    p[15] = (uint8_t)(b.n >> 8);
+    p[16] = (uint8_t)b.usado;
+    p[17] = (uint8_t)(b.usado >> 8);
+    p[18] = 0;
+    p[19] = 0;
+    memcpy(p + CABECALHO, b.dados, b.usado);
+    return CABECALHO + b.usado;
+  }
+
+  static void escrever32(uint8_t *p, uint32_t v)
+  {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+  }
+};
+
+#endif // SERIE_TEMPORAL_H
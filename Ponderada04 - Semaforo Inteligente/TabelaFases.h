@@ -0,0 +1,343 @@
+#ifndef TABELA_FASES_H
+#define TABELA_FASES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Motor de fases dirigido por tabela, para N grupos semafóricos (aproximações).
+//
+// Cada fase diz o sinal de todos os grupos e quanto tempo ela dura; o plano é
+// um vetor constexpr de fases com a próxima fase de cada uma. O motor só chama
+// aplicar() nos grupos cujo sinal muda na troca de fase: entre trocas, uma
+// passada do loop() custa uma subtração e uma comparação, sem tocar em GPIO.
+//
+// A troca de plano (ex.: normal -> atuado) não corta uma fase ao meio: ela
+// fica pendente até terminar uma fase sem nenhum verde (fim do amarelo). O
+// novo plano continua pela fase com os mesmos sinais que a próxima do plano
+// antigo (S1 amarelo -> S2 verde, nos dois planos) ou, se não houver uma, pela
+// fase 0. Assim um verde nunca é cortado sem amarelo, um amarelo nunca volta
+// para verde e o grupo que esperava não perde a vez.
+//
+// As regras de segurança são verificadas em tempo de compilação sobre o plano
+// (static_assert com planoValido()) e sobre cada troca entre planos
+// (trocaPlanoSegura()), então um plano com verdes conflitantes nem compila.
+// Não depende do Arduino: o tempo chega por parâmetro e a saída é qualquer
+// tipo com aplicar(Sinal), o que permite simular o mesmo plano no PC (veja
+// host/).
+
+enum class Sinal : uint8_t
+{
+  Vermelho,
+  Amarelo,
+  Verde,
+  Apagado
+};
+
+template <size_t N>
+struct Fase
+{
+  Sinal grupos[N];
+  uint32_t minMs;   // Duração normal da fase
+  uint32_t maxMs;   // Limite quando a fase é estendida (atualizar com estender)
+  uint8_t proxima;  // Índice da fase seguinte no plano
+};
+
+template <size_t N>
+struct Plano
+{
+  const char *nome;
+  const Fase<N> *fases;
+  uint8_t numFases;
+};
+
+template <size_t N, size_t F>
+constexpr Plano<N> criarPlano(const char *nome, const Fase<N> (&fases)[F])
+{
+  static_assert(F > 0 && F < 256, "Plano precisa de 1 a 255 fases");
+  return Plano<N>{nome, fases, (uint8_t)F};
+}
+
+// ---- Verificações de segurança (constexpr) ----
+
+template <size_t N>
+constexpr bool faseSemVerde(const Fase<N> &fase)
+{
+  for (size_t g = 0; g < N; g++)
+  {
+    if (fase.grupos[g] == Sinal::Verde)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <size_t N>
+constexpr bool mesmosSinais(const Fase<N> &a, const Fase<N> &b)
+{
+  for (size_t g = 0; g < N; g++)
+  {
+    if (a.grupos[g] != b.grupos[g])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// O grupo 'g' está no amarelo que encerra um verde (e não no amarelo piscante
+// do noturno): alguma fase que leva à fase 'f' tem o grupo em verde
+template <size_t N>
+constexpr bool amareloDepoisDeVerde(const Plano<N> &plano, uint8_t f, size_t g)
+{
+  if (plano.fases[f].grupos[g] != Sinal::Amarelo)
+  {
+    return false;
+  }
+  for (uint8_t p = 0; p < plano.numFases; p++)
+  {
+    if (plano.fases[p].proxima == f && plano.fases[p].grupos[g] == Sinal::Verde)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Da fase 'f' do plano para 'seguinte' (do mesmo plano ou de outro): verde só
+// continua verde ou passa para amarelo, e o amarelo que encerra um verde só
+// passa para vermelho
+template <size_t N>
+constexpr bool transicaoSegura(const Plano<N> &plano, uint8_t f, const Fase<N> &seguinte)
+{
+  const Fase<N> &atual = plano.fases[f];
+  for (size_t g = 0; g < N; g++)
+  {
+    if (atual.grupos[g] == Sinal::Verde && seguinte.grupos[g] != Sinal::Verde && seguinte.grupos[g] != Sinal::Amarelo)
+    {
+      return false;
+    }
+    if (amareloDepoisDeVerde(plano, f, g) && seguinte.grupos[g] != Sinal::Vermelho)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Fase do plano 'para' em que o motor entra ao trocar de plano no fim da fase
+// 'f' de 'de': a que tem os mesmos sinais que a próxima de 'de', senão a 0
+template <size_t N>
+constexpr uint8_t faseEntrada(const Plano<N> &de, uint8_t f, const Plano<N> &para)
+{
+  const Fase<N> &proxima = de.fases[de.fases[f].proxima];
+  for (uint8_t e = 0; e < para.numFases; e++)
+  {
+    if (mesmosSinais(para.fases[e], proxima))
+    {
+      return e;
+    }
+  }
+  return 0;
+}
+
+// Nenhuma fase tem dois grupos conflitantes em verde ao mesmo tempo
+template <size_t N>
+constexpr bool semVerdesConflitantes(const Plano<N> &plano, const bool (&conflitos)[N][N])
+{
+  for (uint8_t f = 0; f < plano.numFases; f++)
+  {
+    for (size_t a = 0; a < N; a++)
+    {
+      for (size_t b = a + 1; b < N; b++)
+      {
+        if ((conflitos[a][b] || conflitos[b][a]) &&
+            plano.fases[f].grupos[a] == Sinal::Verde && plano.fases[f].grupos[b] == Sinal::Verde)
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Um grupo em verde só pode continuar verde ou passar para amarelo
+template <size_t N>
+constexpr bool verdeTerminaEmAmarelo(const Plano<N> &plano)
+{
+  for (uint8_t f = 0; f < plano.numFases; f++)
+  {
+    const Fase<N> &atual = plano.fases[f];
+    const Fase<N> &seguinte = plano.fases[atual.proxima];
+    for (size_t g = 0; g < N; g++)
+    {
+      if (atual.grupos[g] == Sinal::Verde && seguinte.grupos[g] != Sinal::Verde && seguinte.grupos[g] != Sinal::Amarelo)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// O amarelo que encerra um verde termina em vermelho (nunca volta para verde)
+template <size_t N>
+constexpr bool amareloTerminaEmVermelho(const Plano<N> &plano)
+{
+  for (uint8_t f = 0; f < plano.numFases; f++)
+  {
+    for (size_t g = 0; g < N; g++)
+    {
+      if (amareloDepoisDeVerde(plano, f, g) && plano.fases[plano.fases[f].proxima].grupos[g] != Sinal::Vermelho)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Transições dentro do plano e durações coerentes (0 < min <= max)
+template <size_t N>
+constexpr bool transicoesValidas(const Plano<N> &plano)
+{
+  for (uint8_t f = 0; f < plano.numFases; f++)
+  {
+    const Fase<N> &fase = plano.fases[f];
+    if (fase.proxima >= plano.numFases || fase.minMs == 0 || fase.minMs > fase.maxMs)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <size_t N>
+constexpr bool planoValido(const Plano<N> &plano, const bool (&conflitos)[N][N])
+{
+  return transicoesValidas(plano) && semVerdesConflitantes(plano, conflitos) && verdeTerminaEmAmarelo(plano) &&
+         amareloTerminaEmVermelho(plano);
+}
+
+// Trocar de 'de' para 'para' é seguro no fim de qualquer fase sem verde de
+// 'de' (onde o motor aplica a troca pendente), entrando pela faseEntrada()
+template <size_t N>
+constexpr bool trocaPlanoSegura(const Plano<N> &de, const Plano<N> &para)
+{
+  for (uint8_t f = 0; f < de.numFases; f++)
+  {
+    if (faseSemVerde(de.fases[f]) && !transicaoSegura(de, f, para.fases[faseEntrada(de, f, para)]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ---- Motor ----
+
+template <size_t N, typename Saida>
+class MotorFases
+{
+public:
+  // Um grupo de saída por aproximação, na ordem das colunas do plano
+  template <typename... Grupos>
+  explicit MotorFases(Grupos &...saidas) : grupos{&saidas...}
+  {
+    static_assert(sizeof...(Grupos) == N, "Um grupo de saída por coluna do plano");
+  }
+
+  // Começa o plano pela fase 0, escrevendo todos os grupos (só na partida;
+  // com o motor rodando use trocarPlano)
+  void iniciar(const Plano<N> &novoPlano, uint32_t agora)
+  {
+    plano = &novoPlano;
+    pendente = nullptr;
+    atual = 0;
+    inicio = agora;
+    for (size_t g = 0; g < N; g++)
+    {
+      sinais[g] = plano->fases[0].grupos[g];
+      grupos[g]->aplicar(sinais[g]);
+    }
+    escritas += N;
+  }
+
+  // Agenda a troca para o fim da próxima fase sem verdes (o novo plano entra
+  // pela faseEntrada()). Pedir o plano atual cancela uma troca pendente
+  void trocarPlano(const Plano<N> &novoPlano)
+  {
+    pendente = &novoPlano == plano ? nullptr : &novoPlano;
+  }
+
+  // Avança de fase quando o tempo acaba. Com 'estender', a fase vai até maxMs
+  // em vez de minMs. Retorna true se houve troca de fase
+  bool atualizar(uint32_t agora, bool estender = false)
+  {
+    const Fase<N> &fase = plano->fases[atual];
+    const uint32_t decorrido = agora - inicio;
+    if (decorrido < fase.minMs || (estender && decorrido < fase.maxMs))
+    {
+      return false;
+    }
+    if (pendente != nullptr && faseSemVerde(fase))
+    {
+      const uint8_t entrada = faseEntrada(*plano, atual, *pendente);
+      plano = pendente;
+      pendente = nullptr;
+      trocasPlano++;
+      entrar(entrada, agora);
+    }
+    else
+    {
+      entrar(fase.proxima, agora);
+    }
+    return true;
+  }
+
+  const Plano<N> &getPlano() const { return *plano; }
+  // Plano em que o motor vai ficar (o pendente, se houver troca agendada)
+  const Plano<N> &getDestino() const { return pendente != nullptr ? *pendente : *plano; }
+  uint8_t getFase() const { return atual; }
+  Sinal getSinal(size_t grupo) const { return sinais[grupo]; }
+  uint32_t getTempoNaFase(uint32_t agora) const { return agora - inicio; }
+  uint32_t getTrocas() const { return trocas; }
+  uint32_t getTrocasPlano() const { return trocasPlano; }
+  uint32_t getEscritas() const { return escritas; }
+
+private:
+  Saida *grupos[N];
+  const Plano<N> *plano = nullptr;
+  const Plano<N> *pendente = nullptr;
+  Sinal sinais[N] = {};
+  uint8_t atual = 0;
+  uint32_t inicio = 0;
+  uint32_t trocas = 0;
+  uint32_t trocasPlano = 0;
+  uint32_t escritas = 0;
+
+  void entrar(uint8_t proxima, uint32_t agora)
+  {
+    // Primeiro os grupos que fecham, depois os que abrem: mesmo no meio das
+    // escritas não há dois verdes acesos
+    const Fase<N> &fase = plano->fases[proxima];
+    for (int abrindo = 0; abrindo < 2; abrindo++)
+    {
+      for (size_t g = 0; g < N; g++)
+      {
+        if (fase.grupos[g] != sinais[g] && (fase.grupos[g] == Sinal::Verde) == (abrindo == 1))
+        {
+          sinais[g] = fase.grupos[g];
+          grupos[g]->aplicar(sinais[g]);
+          escritas++;
+        }
+      }
+    }
+    atual = proxima;
+    inicio = agora;
+    trocas++;
+  }
+};
+
+#endif // TABELA_FASES_H
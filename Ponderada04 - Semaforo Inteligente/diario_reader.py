@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""
+Leitor do diário de trocas de fase do Semáforo Inteligente (DiarioFases.h).
+
+Cada troca de fase é registrada no ESP32 com o instante em microssegundos
+(esp_timer_get_time()). Este script lê os registros, pelo HTTP (/eventos em
+binário) ou pelo MQTT (semaforo/eventos), e calcula a duração real de cada
+fase em relação ao tempo configurado (TEMPO_* em PlanoCruzamento.h): média,
+desvio padrão (jitter) e o pior atraso por plano e fase.
+
+Uso:
+    python diario_reader.py --url http://192.168.4.1       # lê o que o ESP32 guardou
+    python diario_reader.py --broker localhost             # acompanha ao vivo (Ctrl+C: resumo)
+    python diario_reader.py --broker localhost --csv eventos.csv
+"""
+
+import argparse
+import csv
+import statistics
+import struct
+import sys
+
+CABECALHO = struct.Struct("<2sBxIHH")   # "DF", versão, seq0, n, tamanho do registro
+REGISTRO = struct.Struct("<QHHBBBx")    # tempoUs, minMs, maxMs, plano, fase, causa
+PLANOS = {0: "normal", 1: "atuado", 2: "noturno"}
+CAUSAS = ["partida", "tempo", "onda verde", "gap-out", "max-out", "troca de plano"]
+TOPICO = "semaforo/eventos"
+
+
+def decodificar(payload):
+    """Retorna a lista de eventos (seq, tempo_us, min_ms, max_ms, plano, fase, causa)."""
+    if len(payload) < CABECALHO.size:
+        raise ValueError("lote truncado")
+    magico, versao, seq, n, tamanho = CABECALHO.unpack_from(payload, 0)
+    if magico != b"DF" or versao != 1 or tamanho < REGISTRO.size:
+        raise ValueError("não é um lote do diário (versão 1)")
+    eventos = []
+    for i in range(n):
+        pos = CABECALHO.size + i * tamanho
+        if pos + REGISTRO.size > len(payload):
+            break
+        eventos.append((seq + i,) + REGISTRO.unpack_from(payload, pos))
+    return eventos
+
+
+class Diario:
+    def __init__(self, caminho_csv):
+        self.anterior = None
+        self.duracoes = {}
+        self.perdidos = 0
+        self.arquivo = open(caminho_csv, "a", newline="") if caminho_csv else None
+        self.csv = csv.writer(self.arquivo) if self.arquivo else None
+        if self.arquivo and self.arquivo.tell() == 0:
+            self.csv.writerow(["seq", "tempo_us", "plano", "fase", "causa", "min_ms", "max_ms", "duracao_us", "desvio_us"])
+
+    def lote(self, payload):
+        try:
+            eventos = decodificar(payload)
+        except ValueError as erro:
+            print(f"[Diario] Ignorado: {erro}", file=sys.stderr)
+            return
+        for evento in eventos:
+            self.evento(evento)
+        if self.arquivo:
+            self.arquivo.flush()
+
+    def evento(self, evento):
+        seq, tempo, min_ms, max_ms, plano, fase, causa = evento
+        if self.anterior is not None and seq <= self.anterior[0]:
+            return  # repetido
+        if self.anterior is not None and seq != self.anterior[0] + 1:
+            print(f"[Diario] Lacuna: eventos {self.anterior[0] + 1} a {seq - 1} perdidos")
+            self.perdidos += seq - self.anterior[0] - 1
+            self.anterior = None
+        if self.anterior is not None:
+            self.fechar(self.anterior, tempo - self.anterior[1], causa)
+        self.anterior = evento
+
+    # A fase do evento anterior durou até este; 'causa' diz por que terminou
+    def fechar(self, evento, duracao_us, causa):
+        seq, tempo, min_ms, max_ms, plano, fase, _ = evento
+        desvio = duracao_us - min_ms * 1000
+        chave = (PLANOS.get(plano, "?"), fase, min_ms, max_ms)
+        self.duracoes.setdefault(chave, []).append((duracao_us, causa))
+        if self.csv:
+            self.csv.writerow([seq, tempo, chave[0], fase, CAUSAS[evento[6]] if evento[6] < len(CAUSAS) else "?",
+                               min_ms, max_ms, duracao_us, desvio])
+        else:
+            fim = CAUSAS[causa] if causa < len(CAUSAS) else "?"
+            print(f"{seq:7d} {tempo / 1e6:12.6f}s  {chave[0]:8s} fase {fase}  "
+                  f"{duracao_us / 1000.0:9.3f} ms (min {min_ms}, {desvio / 1000.0:+8.3f} ms)  fim: {fim}")
+
+    def resumo(self):
+        if not self.duracoes:
+            print("Nenhuma fase completa registrada")
+            return
+        print()
+        print("plano    fase  min/max ms    n    media ms  jitter ms  pior atraso ms  outras causas")
+        for (plano, fase, min_ms, max_ms), valores in sorted(self.duracoes.items()):
+            duracoes = [d for d, _ in valores]
+            media = statistics.mean(duracoes) / 1000.0
+            jitter = statistics.pstdev(duracoes) / 1000.0
+            # Atraso só conta as fases que terminaram no tempo da tabela (causa
+            # "tempo"); na onda verde e no atuado a duração muda de propósito
+            no_tempo = [d - min_ms * 1000 for d, c in valores if c == 1]
+            pior = "%.3f" % (max(no_tempo) / 1000.0) if no_tempo else "-"
+            estendidas = len(valores) - len(no_tempo)
+            print(f"{plano:8s} {fase:4d}  {min_ms:5d}/{max_ms:<5d} {len(duracoes):5d} {media:10.3f} {jitter:10.3f} "
+                  f"{pior:>15s} {estendidas:14d}")
+        if self.perdidos:
+            print(f"{self.perdidos} eventos perdidos (sobrescritos antes da leitura)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--url", help="endereço do ESP32 (lê /eventos?formato=bin uma vez)")
+    parser.add_argument("--broker", default="localhost")
+    parser.add_argument("--porta", type=int, default=1883)
+    parser.add_argument("--csv", help="acrescenta as fases neste arquivo CSV")
+    args = parser.parse_args()
+
+    diario = Diario(args.csv)
+    if args.url:
+        from urllib.request import urlopen
+        with urlopen(args.url.rstrip("/") + "/eventos?formato=bin", timeout=10) as resposta:
+            diario.lote(resposta.read())
+        diario.resumo()
+        return
+
+    try:
+        import paho.mqtt.client as mqtt
+    except ImportError:
+        print("Erro: Instale as dependências:")
+        print("  pip install paho-mqtt")
+        exit(1)
+
+    def on_connect(client, userdata, flags, rc):
+        print(f"[MQTT] Conectado a {args.broker}:{args.porta}, inscrito em {TOPICO}")
+        client.subscribe(TOPICO)
+
+    client = mqtt.Client(client_id="diario_reader")
+    client.on_connect = on_connect
+    client.on_message = lambda client, userdata, msg: diario.lote(msg.payload)
+    client.connect(args.broker, args.porta)
+    try:
+        client.loop_forever()
+    except KeyboardInterrupt:
+        pass
+    diario.resumo()
+
+
+if __name__ == "__main__":
+    main()
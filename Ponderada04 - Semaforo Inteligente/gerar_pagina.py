@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""
+Gera PaginaWeb.h (página do painel comprimida em gzip) a partir de web/index.html.
+
+O firmware envia o blob como está, com Content-Encoding: gzip, ETag e
+Cache-Control: o ESP32 não monta nem comprime nada por requisição e o
+navegador só baixa a página de novo quando o conteúdo muda.
+
+Uso (rodar de novo sempre que editar web/index.html):
+    python gerar_pagina.py
+    python gerar_pagina.py web/index.html --out PaginaWeb.h
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+
+AQUI = os.path.dirname(os.path.abspath(__file__))
+
+
+def comprimir(dados):
+    # mtime=0: o mesmo HTML gera sempre os mesmos bytes (e o mesmo ETag)
+    return gzip.compress(dados, compresslevel=9, mtime=0)
+
+
+def escrever_header(gz, tamanho_original, origem, caminho):
+    etag = hashlib.sha1(gz).hexdigest()[:16]
+    out = [
+        "// Gerado por gerar_pagina.py a partir de %s - não editar à mão." % origem,
+        "#ifndef PAGINA_WEB_H",
+        "#define PAGINA_WEB_H",
+        "",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        "#ifndef PROGMEM",
+        "#define PROGMEM",
+        "#endif",
+        "",
+        "// %d bytes de HTML, %d bytes em gzip" % (tamanho_original, len(gz)),
+        '#define PAGINA_ETAG "\\"%s\\""' % etag,
+        "static const size_t PAGINA_GZ_TAMANHO = %d;" % len(gz),
+        "static const uint8_t PAGINA_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(gz), 16):
+        out.append("    " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+    out += ["};", "", "#endif // PAGINA_WEB_H", ""]
+    with open(caminho, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+    print("%s: %d -> %d bytes (%.0f%%), ETag %s" % (caminho, tamanho_original, len(gz),
+                                                   100.0 * len(gz) / tamanho_original, etag))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("html", nargs="?", default=os.path.join(AQUI, "web", "index.html"))
+    parser.add_argument("--out", default=os.path.join(AQUI, "PaginaWeb.h"))
+    args = parser.parse_args()
+
+    with open(args.html, "rb") as f:
+        dados = f.read()
+    origem = os.path.relpath(args.html, os.path.dirname(os.path.abspath(args.out))).replace(os.sep, "/")
+    escrever_header(comprimir(dados), len(dados), origem, args.out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Leitor do histórico do Semáforo Inteligente (SerieTemporal.h).
+
+O ESP32 publica em semaforo/historico blocos binários com amostras de
+luminosidade, fase e modo comprimidas em delta + varint. Este script se
+inscreve no tópico, decodifica cada bloco e imprime as amostras (ou grava
+CSV). Blocos repetidos, que chegam quando o ESP32 reenvia depois de uma
+falha, são ignorados pelo número de sequência.
+
+Uso:
+    python historico_reader.py                          # broker em localhost
+    python historico_reader.py --broker 192.168.4.2 --csv historico.csv
+    python historico_reader.py --arquivo lote.bin       # decodifica um bloco salvo
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+CABECALHO = struct.Struct("<2sBBIIhHH2x")   # "ST", versão, estado0, seq0, t0, luz0, n, bytes
+PLANOS = {0: "normal", 1: "atuado", 2: "noturno"}
+TOPICO = "semaforo/historico"
+
+
+def ler_varint(dados, pos):
+    valor = 0
+    deslocamento = 0
+    while pos < len(dados):
+        byte = dados[pos]
+        pos += 1
+        valor |= (byte & 0x7F) << deslocamento
+        deslocamento += 7
+        if not byte & 0x80:
+            break
+    return valor, pos
+
+
+def decodificar(payload):
+    """Retorna a lista de amostras (seq, millis, luz, estado) de um bloco."""
+    if len(payload) < CABECALHO.size:
+        raise ValueError("bloco truncado")
+    magico, versao, estado, seq, tempo, luz, n, tamanho = CABECALHO.unpack_from(payload, 0)
+    if magico != b"ST" or versao != 1:
+        raise ValueError("não é um bloco de histórico (versão 1)")
+    dados = payload[CABECALHO.size:CABECALHO.size + tamanho]
+
+    amostras = [(seq, tempo, luz, estado)]
+    pos = 0
+    for _ in range(1, n):
+        if pos >= len(dados):
+            break
+        dt, pos = ler_varint(dados, pos)
+        z, pos = ler_varint(dados, pos)
+        seq += 1
+        tempo = (tempo + (dt >> 1)) & 0xFFFFFFFF
+        luz += (z >> 1) ^ -(z & 1)
+        if dt & 1:
+            estado = dados[pos]
+            pos += 1
+        amostras.append((seq, tempo, luz, estado))
+    return amostras
+
+
+def descrever(estado):
+    return "fase %d, %s%s%s" % (estado & 0x0F, PLANOS.get((estado >> 4) & 3, "?"),
+                                ", auto" if estado & 0x40 else "", ", onda verde" if estado & 0x80 else "")
+
+
+class Saida:
+    def __init__(self, caminho_csv):
+        self.ultima_seq = -1
+        self.arquivo = open(caminho_csv, "a", newline="") if caminho_csv else None
+        self.csv = csv.writer(self.arquivo) if self.arquivo else None
+        if self.arquivo and self.arquivo.tell() == 0:
+            self.csv.writerow(["seq", "millis", "luminosidade", "fase", "plano", "auto", "onda_verde"])
+
+    def bloco(self, payload):
+        try:
+            amostras = decodificar(payload)
+        except ValueError as erro:
+            print(f"[Historico] Ignorado: {erro}", file=sys.stderr)
+            return
+        novas = [a for a in amostras if a[0] > self.ultima_seq]
+        if novas and self.ultima_seq >= 0 and novas[0][0] != self.ultima_seq + 1:
+            print(f"[Historico] Lacuna: amostras {self.ultima_seq + 1} a {novas[0][0] - 1} perdidas")
+        for seq, tempo, luz, estado in novas:
+            if self.csv:
+                self.csv.writerow([seq, tempo, luz, estado & 0x0F, PLANOS.get((estado >> 4) & 3, "?"),
+                                   int(bool(estado & 0x40)), int(bool(estado & 0x80))])
+            else:
+                print(f"{seq:8d} {tempo / 1000.0:12.3f}s  luz {luz:5d}  {descrever(estado)}")
+        if novas:
+            self.ultima_seq = novas[-1][0]
+            print(f"[Historico] Bloco com {len(amostras)} amostras ({len(payload)} bytes), "
+                  f"{len(novas)} novas até a seq {self.ultima_seq}")
+        if self.arquivo:
+            self.arquivo.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--broker", default="localhost")
+    parser.add_argument("--porta", type=int, default=1883)
+    parser.add_argument("--csv", help="acrescenta as amostras neste arquivo CSV")
+    parser.add_argument("--arquivo", help="decodifica um bloco salvo em arquivo em vez de usar MQTT")
+    args = parser.parse_args()
+
+    saida = Saida(args.csv)
+    if args.arquivo:
+        with open(args.arquivo, "rb") as f:
+            saida.bloco(f.read())
+        return
+
+    try:
+        import paho.mqtt.client as mqtt
+    except ImportError:
+        print("Erro: Instale as dependências:")
+        print("  pip install paho-mqtt")
+        exit(1)
+
+    def on_connect(client, userdata, flags, rc):
+        print(f"[MQTT] Conectado a {args.broker}:{args.porta}, inscrito em {TOPICO}")
+        client.subscribe(TOPICO)
+
+    client = mqtt.Client(client_id="historico_reader")
+    client.on_connect = on_connect
+    client.on_message = lambda client, userdata, msg: saida.bloco(msg.payload)
+    client.connect(args.broker, args.porta)
+    try:
+        client.loop_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
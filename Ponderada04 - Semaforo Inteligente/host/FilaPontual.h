@@ -0,0 +1,100 @@
+#ifndef FILA_PONTUAL_H
+#define FILA_PONTUAL_H
+
+#include <cstdint>
+#include <deque>
+
+// Fila pontual numa linha de retenção (um movimento de uma aproximação).
+//
+// Os veículos chegam à linha num instante conhecido e ficam numa fila FIFO
+// sem extensão física. Com o sinal verde, sai um veículo por vez respeitando o
+// intervalo de saturação (headway); amarelo e vermelho retêm. O atraso de cada
+// veículo é a espera na linha; ele "parou" se esperou mais que o limite.
+
+struct Veiculo
+{
+  double entrada = 0;    // s - entrada no sistema
+  double chegada = 0;    // s - chegada a esta linha de retenção
+  double atraso = 0;     // s - soma das esperas até aqui
+  uint32_t paradas = 0;
+};
+
+class FilaPontual
+{
+public:
+  explicit FilaPontual(double headwayS = 2.0, double limiteParadaS = 1.0)
+      : headway(headwayS), limiteParada(limiteParadaS)
+  {
+  }
+
+  // Chegadas em ordem de chegada (a fila de cima descarrega em ordem)
+  void chegar(const Veiculo &v) { fila.push_back(v); }
+
+  // Avança até o instante t. 'saiu' recebe cada veículo liberado
+  template <typename F>
+  void atualizar(double t, bool verde, F &&saiu)
+  {
+    size_t esperando = 0;
+    for (const Veiculo &v : fila)
+    {
+      if (v.chegada > t)
+      {
+        break;
+      }
+      esperando++;
+    }
+    if (esperando > maiorFila)
+    {
+      maiorFila = esperando;
+    }
+
+    while (verde && !fila.empty() && fila.front().chegada <= t && t - ultimaSaida >= headway)
+    {
+      Veiculo v = fila.front();
+      fila.pop_front();
+      const double espera = t - v.chegada;
+      v.atraso += espera;
+      if (espera > limiteParada)
+      {
+        v.paradas++;
+        paradas++;
+      }
+      atrasoTotal += espera;
+      liberados++;
+      ultimaSaida = t;
+      saiu(v);
+    }
+  }
+
+  // Veículos já na linha (chegada <= t)
+  size_t tamanho(double t) const
+  {
+    size_t n = 0;
+    for (const Veiculo &v : fila)
+    {
+      if (v.chegada > t)
+      {
+        break;
+      }
+      n++;
+    }
+    return n;
+  }
+
+  uint64_t getLiberados() const { return liberados; }
+  uint64_t getParadas() const { return paradas; }
+  double getAtrasoTotal() const { return atrasoTotal; }
+  size_t getMaiorFila() const { return maiorFila; }
+
+private:
+  double headway;
+  double limiteParada;
+  std::deque<Veiculo> fila;
+  double ultimaSaida = -1e9;
+  uint64_t liberados = 0;
+  uint64_t paradas = 0;
+  double atrasoTotal = 0;
+  size_t maiorFila = 0;
+};
+
+#endif // FILA_PONTUAL_H
@@ -0,0 +1,348 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Núcleo do Arduino-ESP32 simulado para compilar o firmware no PC
+// (semaforo_sim.cpp). Só o que o .ino usa, com o comportamento que importa
+// para o controlador:
+//   - relógio em microssegundos que só anda quando o simulador manda
+//     (millis() com 32 bits, como no ESP32; delay() avança o relógio);
+//   - GPIO com o nível de cada pino e um gancho a cada digitalWrite();
+//   - interrupções por pino, disparadas pelo simulador (detectores);
+//   - ADC: analogRead() e o ADC contínuo, com o valor e os quadros vindos do
+//     simulador;
+//   - FreeRTOS sem escalonador: as tarefas são só registradas e o simulador
+//     chama as passadas delas (vTaskDelay/vTaskDelayUntil não fazem nada);
+//   - Serial com o instante simulado em cada linha, desligado por padrão.
+// O estado fica no namespace sim, lido e escrito pelo simulador.
+
+#include <algorithm>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define PROGMEM
+#define IRAM_ATTR
+#define ARDUINO_ISR_ATTR
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// API do core 3.x (ADC contínuo)
+#define ESP_ARDUINO_VERSION_MAJOR 3
+
+// ==================== FreeRTOS ======================
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdPASS 1
+
+namespace sim
+{
+constexpr int NUM_PINOS = 40;
+
+// ------------------ Relógio ------------------
+inline int64_t agoraUs = 0;           // esp_timer_get_time()
+inline uint32_t millisInicial = 0;    // Soma ao millis() (testar o estouro dos 49,7 dias)
+
+// ------------------ GPIO ---------------------
+inline uint8_t nivel[NUM_PINOS] = {};
+inline uint8_t modoPino[NUM_PINOS] = {};
+inline void (*aoEscrever)(int pino, int nivel) = nullptr;   // Depois de cada digitalWrite()
+inline void (*isr[NUM_PINOS])() = {};
+inline int bordaIsr[NUM_PINOS] = {};
+
+// ------------------ ADC ----------------------
+inline int adc[NUM_PINOS] = {};                  // Valor de analogRead() em cada pino
+inline bool adcContinuoDisponivel = true;        // false: o firmware cai no analogRead()
+inline bool adcContinuoAtivo = false;
+inline int adcContinuoPino = -1;
+inline uint32_t adcConversoes = 0;
+inline uint32_t adcFrequenciaHz = 0;
+inline void (*adcQuadroPronto)() = nullptr;
+
+// ------------------ Tarefas ------------------
+struct Tarefa
+{
+  const char *nome;
+  TaskFunction_t funcao;
+  uint32_t pilha;
+  UBaseType_t prioridade;
+  BaseType_t nucleo;
+};
+inline Tarefa tarefas[8];
+inline int numTarefas = 0;
+
+// ------------------ Serial -------------------
+inline FILE *saidaLog = nullptr;    // nullptr: o Serial não formata nada
+inline bool inicioLinha = true;
+
+inline void escreverLog(const char *texto, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    if (inicioLinha)
+    {
+      fprintf(saidaLog, "[%12.6f] ", agoraUs / 1e6);
+      inicioLinha = false;
+    }
+    if (texto[i] == '\r')
+      continue;
+    fputc(texto[i], saidaLog);
+    if (texto[i] == '\n')
+      inicioLinha = true;
+  }
+}
+} // namespace sim
+
+inline unsigned long millis() { return (uint32_t)(sim::millisInicial + (uint64_t)(sim::agoraUs / 1000)); }
+inline unsigned long micros() { return (uint32_t)sim::agoraUs; }
+inline void delay(unsigned long ms) { sim::agoraUs += (int64_t)ms * 1000; }
+
+inline void pinMode(int pino, int modo)
+{
+  sim::modoPino[pino] = (uint8_t)modo;
+  if (modo == INPUT_PULLUP)
+    sim::nivel[pino] = HIGH;
+}
+
+inline void digitalWrite(int pino, int nivel)
+{
+  sim::nivel[pino] = nivel ? HIGH : LOW;
+  if (sim::aoEscrever)
+    sim::aoEscrever(pino, sim::nivel[pino]);
+}
+
+inline int digitalRead(int pino) { return sim::nivel[pino]; }
+inline int analogRead(int pino) { return sim::adc[pino]; }
+
+inline int digitalPinToInterrupt(int pino) { return pino; }
+
+inline void attachInterrupt(int pino, void (*funcao)(), int borda)
+{
+  sim::isr[pino] = funcao;
+  sim::bordaIsr[pino] = borda;
+}
+
+inline void detachInterrupt(int pino) { sim::isr[pino] = nullptr; }
+
+// ADC contínuo: o simulador escreve a média em sim::quadroAdc e chama
+// sim::adcQuadroPronto, como o driver no fim de um quadro por DMA
+typedef enum
+{
+  ADC_0db,
+  ADC_2_5db,
+  ADC_6db,
+  ADC_11db
+} adc_attenuation_t;
+
+typedef struct
+{
+  uint8_t pin;
+  uint8_t channel;
+  int avg_read_raw;
+  int avg_read_mvolts;
+} adc_continuous_data_t;
+
+namespace sim
+{
+inline adc_continuous_data_t quadroAdc = {};
+}
+
+inline void analogContinuousSetWidth(uint8_t) {}
+inline void analogContinuousSetAtten(adc_attenuation_t) {}
+
+inline bool analogContinuous(const uint8_t pinos[], size_t n, uint32_t conversoes, uint32_t frequenciaHz,
+                             void (*funcao)(void))
+{
+  if (!sim::adcContinuoDisponivel || n != 1)
+    return false;
+  sim::adcContinuoPino = pinos[0];
+  sim::adcConversoes = conversoes;
+  sim::adcFrequenciaHz = frequenciaHz;
+  sim::adcQuadroPronto = funcao;
+  sim::quadroAdc.pin = pinos[0];
+  return true;
+}
+
+inline bool analogContinuousStart()
+{
+  sim::adcContinuoAtivo = sim::adcQuadroPronto != nullptr;
+  return sim::adcContinuoAtivo;
+}
+
+inline bool analogContinuousStop()
+{
+  sim::adcContinuoAtivo = false;
+  return true;
+}
+
+inline bool analogContinuousRead(adc_continuous_data_t **dados, uint32_t)
+{
+  if (!sim::adcContinuoAtivo)
+    return false;
+  *dados = &sim::quadroAdc;
+  return true;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *,
+                                          UBaseType_t prioridade, TaskHandle_t *, BaseType_t nucleo)
+{
+  if (sim::numTarefas == (int)(sizeof(sim::tarefas) / sizeof(sim::tarefas[0])))
+    return 0;
+  sim::tarefas[sim::numTarefas++] = sim::Tarefa{nome, funcao, pilha, prioridade, nucleo};
+  return pdPASS;
+}
+
+inline TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+inline void vTaskDelay(TickType_t) {}
+inline void vTaskDelayUntil(TickType_t *, TickType_t) {}
+
+// ==================== String ========================
+class String
+{
+public:
+  String() {}
+  String(const char *texto) : s(texto ? texto : "") {}
+  String(const std::string &texto) : s(texto) {}
+  explicit String(char c) : s(1, c) {}
+  explicit String(unsigned char v) : s(std::to_string(v)) {}
+  explicit String(int v) : s(std::to_string(v)) {}
+  explicit String(unsigned int v) : s(std::to_string(v)) {}
+  explicit String(long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long v) : s(std::to_string(v)) {}
+  explicit String(long long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long long v) : s(std::to_string(v)) {}
+  explicit String(float v, unsigned int casas = 2) : String((double)v, casas) {}
+  explicit String(double v, unsigned int casas = 2)
+  {
+    char texto[48];
+    snprintf(texto, sizeof(texto), "%.*f", (int)casas, v);
+    s = texto;
+  }
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned int length() const { return (unsigned int)s.size(); }
+  bool reserve(unsigned int n)
+  {
+    s.reserve(n);
+    return true;
+  }
+  long toInt() const { return atol(s.c_str()); }
+  bool startsWith(const char *prefixo) const { return s.compare(0, strlen(prefixo), prefixo) == 0; }
+
+  String &operator+=(const String &o)
+  {
+    s += o.s;
+    return *this;
+  }
+  String &operator+=(const char *o)
+  {
+    s += o;
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    s += c;
+    return *this;
+  }
+
+  friend String operator+(String a, const String &b) { return a += b; }
+  friend String operator+(String a, const char *b) { return a += b; }
+  friend String operator+(const char *a, const String &b) { return String(a) += b; }
+
+  bool operator==(const String &o) const { return s == o.s; }
+  bool operator==(const char *o) const { return s == o; }
+  bool operator!=(const String &o) const { return s != o.s; }
+  bool operator!=(const char *o) const { return s != o; }
+
+private:
+  std::string s;
+};
+
+// ==================== Serial ========================
+class Print;
+
+class Printable
+{
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &saida) const = 0;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(const uint8_t *dados, size_t n) = 0;
+
+  size_t print(const char *texto) { return write((const uint8_t *)texto, strlen(texto)); }
+  size_t print(const String &texto) { return write((const uint8_t *)texto.c_str(), texto.length()); }
+  size_t print(char c) { return write((const uint8_t *)&c, 1); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int casas = 2) { return printf("%.*f", casas, v); }
+  size_t print(const Printable &p) { return p.printTo(*this); }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T>
+  size_t println(const T &v)
+  {
+    size_t n = print(v);
+    return n + println();
+  }
+
+  size_t printf(const char *formato, ...) __attribute__((format(printf, 2, 3)))
+  {
+    if (!ativo())
+      return 0;
+    char texto[512];
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(texto, sizeof(texto), formato, args);
+    va_end(args);
+    if (n < 0)
+      return 0;
+    return write((const uint8_t *)texto, std::min((size_t)n, sizeof(texto) - 1));
+  }
+
+protected:
+  virtual bool ativo() const { return true; }
+};
+
+class HardwareSerial : public Print
+{
+public:
+  void begin(unsigned long) {}
+  size_t setTxBufferSize(size_t n) { return n; }
+
+  size_t write(const uint8_t *dados, size_t n) override
+  {
+    if (sim::saidaLog)
+      sim::escreverLog((const char *)dados, n);
+    return n;
+  }
+
+protected:
+  bool ativo() const override { return sim::saidaLog != nullptr; }
+};
+
+inline HardwareSerial Serial;
+
+#endif // SIM_ARDUINO_H
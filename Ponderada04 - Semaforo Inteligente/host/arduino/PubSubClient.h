@@ -0,0 +1,168 @@
+#ifndef SIM_PUBSUBCLIENT_H
+#define SIM_PUBSUBCLIENT_H
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+
+#include "Arduino.h"
+#include "WiFi.h"
+
+// Cliente MQTT com um broker simulado (QoS 0, como o PubSubClient):
+//   - connect() só dá certo com sim::brokerDisponivel; se o broker cai, a
+//     conexão cai junto (connected() passa a false);
+//   - publish() falha desconectado ou se a mensagem não cabe no buffer
+//     (setBufferSize), e conta mensagens e bytes por tópico;
+//   - mensagens do simulador (entregar()) só chegam aos tópicos inscritos e
+//     vão para o callback dentro de loop(), na tarefa de rede.
+
+namespace sim
+{
+inline bool brokerDisponivel = true;
+// Depois de cada publish() aceito
+inline void (*aoPublicar)(const char *topico, const uint8_t *dados, unsigned int n) = nullptr;
+} // namespace sim
+
+#define MQTT_CONNECTION_LOST -3
+#define MQTT_CONNECT_FAILED -2
+#define MQTT_CONNECTED 0
+
+class PubSubClient
+{
+public:
+  typedef void (*Callback)(char *, uint8_t *, unsigned int);
+
+  struct Topico
+  {
+    uint32_t mensagens = 0;
+    uint64_t bytes = 0;
+  };
+
+  explicit PubSubClient(WiFiClient &) {}
+
+  PubSubClient &setServer(const char *, uint16_t) { return *this; }
+  PubSubClient &setCallback(Callback funcao)
+  {
+    callback = funcao;
+    return *this;
+  }
+  bool setBufferSize(uint16_t tamanho)
+  {
+    buffer = tamanho;
+    return true;
+  }
+
+  bool connect(const char *)
+  {
+    tentativas++;
+    if (!sim::brokerDisponivel)
+    {
+      estado = MQTT_CONNECT_FAILED;
+      return false;
+    }
+    conectado = true;
+    estado = MQTT_CONNECTED;
+    inscricoes.clear();   // Sessão limpa, como o PubSubClient
+    conexoes++;
+    return true;
+  }
+
+  bool connected()
+  {
+    if (conectado && !sim::brokerDisponivel)
+    {
+      conectado = false;
+      estado = MQTT_CONNECTION_LOST;
+      recebidas.clear();
+    }
+    return conectado;
+  }
+
+  bool loop()
+  {
+    if (!connected())
+      return false;
+    while (!recebidas.empty())
+    {
+      Mensagem m = recebidas.front();
+      recebidas.pop_front();
+      if (callback)
+        callback(&m.topico[0], (uint8_t *)m.dados.data(), (unsigned int)m.dados.size());
+      entregues++;
+    }
+    return true;
+  }
+
+  bool subscribe(const char *topico)
+  {
+    if (!connected())
+      return false;
+    inscricoes.insert(topico);
+    return true;
+  }
+
+  bool publish(const char *topico, const char *texto) { return publish(topico, (const uint8_t *)texto, strlen(texto)); }
+  bool publish(const char *topico, const uint8_t *dados, unsigned int n)
+  {
+    if (!connected())
+      return false;
+    // Cabeçalho fixo (até 5 bytes) + tamanho do tópico (2) + tópico + dados
+    if (5 + 2 + strlen(topico) + n > buffer)
+    {
+      grandesDemais++;
+      return false;
+    }
+    Topico &t = publicados[topico];
+    t.mensagens++;
+    t.bytes += n;
+    if (sim::aoPublicar)
+      sim::aoPublicar(topico, dados, n);
+    return true;
+  }
+
+  int state() const { return estado; }
+
+  // ---------- Só no simulador ----------
+  // Mensagem de outro cliente pelo broker. false se ela se perde (cliente
+  // desconectado ou não inscrito no tópico)
+  bool entregar(const std::string &topico, const std::string &dados)
+  {
+    if (!connected() || inscricoes.count(topico) == 0)
+    {
+      perdidas++;
+      return false;
+    }
+    recebidas.push_back(Mensagem{topico, dados});
+    return true;
+  }
+
+  const std::map<std::string, Topico> &getPublicados() const { return publicados; }
+  uint32_t getEntregues() const { return entregues; }
+  uint32_t getPerdidas() const { return perdidas; }
+  uint32_t getGrandesDemais() const { return grandesDemais; }
+  uint32_t getTentativas() const { return tentativas; }
+  uint32_t getConexoes() const { return conexoes; }
+
+private:
+  struct Mensagem
+  {
+    std::string topico;
+    std::string dados;
+  };
+
+  Callback callback = nullptr;
+  size_t buffer = 256;   // Padrão do PubSubClient
+  bool conectado = false;
+  int estado = MQTT_CONNECT_FAILED;
+  std::set<std::string> inscricoes;
+  std::deque<Mensagem> recebidas;
+  std::map<std::string, Topico> publicados;
+  uint32_t entregues = 0;
+  uint32_t perdidas = 0;
+  uint32_t grandesDemais = 0;
+  uint32_t tentativas = 0;
+  uint32_t conexoes = 0;
+};
+
+#endif // SIM_PUBSUBCLIENT_H
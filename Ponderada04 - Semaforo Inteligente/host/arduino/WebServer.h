@@ -0,0 +1,148 @@
+#ifndef SIM_WEBSERVER_H
+#define SIM_WEBSERVER_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+// Servidor HTTP simulado: as rotas de server.on() são as do firmware e as
+// requisições vêm do simulador (requisitar()), atendidas uma por
+// handleClient(), como no WebServer do ESP32. A resposta fica em
+// getResposta() para o simulador conferir.
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+enum HTTPMethod
+{
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_POST
+};
+
+class WebServer
+{
+public:
+  typedef void (*Rota)();
+
+  struct Resposta
+  {
+    int codigo = 0;
+    std::string tipo;
+    std::map<std::string, std::string> cabecalhos;
+    std::string corpo;
+  };
+
+  explicit WebServer(int) {}
+
+  void on(const char *caminho, Rota rota) { rotas[caminho] = rota; }
+  void collectHeaders(const char *nomes[], size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      coletados.push_back(nomes[i]);
+  }
+  void begin() { ativo = true; }
+
+  void handleClient()
+  {
+    if (!ativo || pendentes.empty())
+      return;
+    atual = pendentes.front();
+    pendentes.pop_front();
+    resposta = Resposta();
+    cabecalhosResposta.clear();
+    std::map<std::string, Rota>::const_iterator rota = rotas.find(atual.caminho);
+    if (rota != rotas.end())
+      rota->second();
+    else
+      send(404, "text/plain", String(("Not found: " + atual.caminho).c_str()));
+    atendidas++;
+  }
+
+  // ---------- Para as rotas ----------
+  HTTPMethod method() const { return atual.metodo; }
+  bool hasArg(const char *nome) const { return atual.args.count(nome) != 0; }
+  String arg(const char *nome) const
+  {
+    std::map<std::string, std::string>::const_iterator a = atual.args.find(nome);
+    return a == atual.args.end() ? String() : String(a->second);
+  }
+  String header(const char *nome) const
+  {
+    std::map<std::string, std::string>::const_iterator c = atual.cabecalhos.find(nome);
+    return c == atual.cabecalhos.end() ? String() : String(c->second);
+  }
+
+  void sendHeader(const char *nome, const char *valor) { cabecalhosResposta[nome] = valor; }
+  void setContentLength(size_t) {}
+  void send(int codigo) { send(codigo, "", ""); }
+  void send(int codigo, const char *tipo, const String &corpo) { send(codigo, tipo, corpo.c_str()); }
+  void send(int codigo, const char *tipo, const char *corpo)
+  {
+    resposta.codigo = codigo;
+    resposta.tipo = tipo;
+    resposta.cabecalhos = cabecalhosResposta;
+    resposta.corpo = corpo;
+  }
+  void send_P(int codigo, const char *tipo, const char *dados, size_t n)
+  {
+    send(codigo, tipo, "");
+    resposta.corpo.assign(dados, n);
+  }
+  void sendContent(const String &texto) { resposta.corpo += texto.c_str(); }
+  void sendContent(const char *dados, size_t n) { resposta.corpo.append(dados, n); }
+
+  // ---------- Só no simulador ----------
+  // "/historico?desde=10&max=5"; cabeçalhos como "If-None-Match: valor"
+  void requisitar(const std::string &url, HTTPMethod metodo = HTTP_GET, const std::string &cabecalho = "")
+  {
+    Requisicao r;
+    r.metodo = metodo;
+    size_t q = url.find('?');
+    r.caminho = url.substr(0, q);
+    while (q != std::string::npos)
+    {
+      size_t fim = url.find('&', q + 1);
+      std::string par = url.substr(q + 1, fim == std::string::npos ? std::string::npos : fim - q - 1);
+      size_t igual = par.find('=');
+      r.args[par.substr(0, igual)] = igual == std::string::npos ? "" : par.substr(igual + 1);
+      q = fim;
+    }
+    size_t doisPontos = cabecalho.find(':');
+    size_t valor = cabecalho.find_first_not_of(' ', doisPontos + 1);
+    if (doisPontos != std::string::npos && valor != std::string::npos)
+    {
+      std::string nome = cabecalho.substr(0, doisPontos);
+      for (const std::string &c : coletados)
+        if (c == nome)
+          r.cabecalhos[nome] = cabecalho.substr(valor);
+    }
+    pendentes.push_back(r);
+  }
+
+  const Resposta &getResposta() const { return resposta; }
+  uint32_t getAtendidas() const { return atendidas; }
+  size_t getPendentes() const { return pendentes.size(); }
+
+private:
+  struct Requisicao
+  {
+    HTTPMethod metodo = HTTP_GET;
+    std::string caminho;
+    std::map<std::string, std::string> args;
+    std::map<std::string, std::string> cabecalhos;
+  };
+
+  std::map<std::string, Rota> rotas;
+  std::vector<std::string> coletados;
+  std::deque<Requisicao> pendentes;
+  Requisicao atual;
+  std::map<std::string, std::string> cabecalhosResposta;
+  Resposta resposta;
+  uint32_t atendidas = 0;
+  bool ativo = false;
+};
+
+#endif // SIM_WEBSERVER_H
@@ -0,0 +1,43 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include "Arduino.h"
+
+// Wi-Fi simulado: o AP sobe na hora e a estação "conecta" sem rádio. A
+// disponibilidade da rede para o MQTT fica no broker (PubSubClient.h)
+
+#define WIFI_STA 1
+#define WIFI_AP 2
+
+class IPAddress : public Printable
+{
+public:
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octetos{a, b, c, d} {}
+
+  size_t printTo(Print &saida) const override
+  {
+    char texto[16];
+    snprintf(texto, sizeof(texto), "%u.%u.%u.%u", octetos[0], octetos[1], octetos[2], octetos[3]);
+    return saida.print(texto);
+  }
+
+private:
+  uint8_t octetos[4];
+};
+
+class WiFiClient
+{
+};
+
+class WiFiClass
+{
+public:
+  bool softAP(const char *, const char *) { return true; }
+  IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+  bool mode(int) { return true; }
+  int begin(const char *, const char *) { return 0; }
+};
+
+inline WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,9 @@
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include "Arduino.h"
+
+// Microssegundos desde a partida, no relógio simulado (64 bits, sem estouro)
+inline int64_t esp_timer_get_time() { return sim::agoraUs; }
+
+#endif // SIM_ESP_TIMER_H
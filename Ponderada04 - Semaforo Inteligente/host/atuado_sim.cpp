@@ -0,0 +1,282 @@
+// Simulação no PC de um cruzamento isolado com chegadas aleatórias nas duas
+// aproximações (S1 e S2), rodando o motor de fases do firmware
+// (../TabelaFases.h) em dois modos:
+//   fixo    - verdes de duração fixa
+//   atuado  - ControleAtuado (../ControleAtuado.h): verde mínimo, extensão por
+//             fila e por brecha, gap-out e max-out, com um detector por
+//             aproximação que conta cada veículo na chegada à fila
+//
+// Os veículos seguem o modelo de fila pontual (FilaPontual.h). Para cada
+// cenário de demanda são reportados, por aproximação, o fluxo atendido
+// (veículos/hora), a espera média e a maior fila.
+//
+// Por padrão os tempos são de um cruzamento real (verde fixo de 20 s, atuado
+// entre 8 e 40 s, amarelo de 3 s, saída de 2 s por veículo). Com --maquete
+// roda os planos do firmware (PLANO_NORMAL x PLANO_ATUADO de
+// ../PlanoCruzamento.h) com os parâmetros ATUADO_* do firmware.
+//
+// Uso: ./atuado_sim [--fluxo-s1 VEIC_H --fluxo-s2 VEIC_H] [--horas H]
+//                   [--verde-fixo S] [--verde-min S] [--verde-max S] [--amarelo S]
+//                   [--brecha S] [--headway S] [--semente S] [--maquete]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "TabelaFases.h"
+#include "PlanoCruzamento.h"
+#include "ControleAtuado.h"
+#include "FilaPontual.h"
+
+struct Opcoes
+{
+  double fluxo[2] = {0, 0};   // veículos/h por aproximação (0 = cenários padrão)
+  double horas = 2;
+  double verdeFixo = 20;
+  double verdeMin = 8;
+  double verdeMax = 40;
+  double amarelo = 3;
+  double brecha = 3;
+  double headway = 2;
+  unsigned semente = 1;
+  bool maquete = false;
+};
+
+struct SaidaNula
+{
+  void aplicar(Sinal) {}
+};
+
+struct Resultado
+{
+  uint64_t atendidos[2] = {};
+  double espera[2] = {};
+  size_t maiorFila[2] = {};
+  size_t filaFinal[2] = {};
+  uint32_t ciclos = 0;
+  uint32_t gapOuts = 0;
+  uint32_t maxOuts = 0;
+};
+
+// Plano de duas fases verdes com amarelo, montado em tempo de execução
+struct PlanoSim
+{
+  Fase<NUM_GRUPOS> fases[4];
+  Plano<NUM_GRUPOS> plano;
+
+  PlanoSim(const char *nome, uint32_t minMs, uint32_t maxMs, uint32_t amareloMs)
+      : fases{
+            {{Sinal::Verde, Sinal::Vermelho}, minMs, maxMs, 1},
+            {{Sinal::Amarelo, Sinal::Vermelho}, amareloMs, amareloMs, 2},
+            {{Sinal::Vermelho, Sinal::Verde}, minMs, maxMs, 3},
+            {{Sinal::Vermelho, Sinal::Amarelo}, amareloMs, amareloMs, 0},
+        },
+        plano{nome, fases, 4}
+  {
+  }
+};
+
+static Resultado simular(const Plano<NUM_GRUPOS> &plano, bool atuado, const Opcoes &op, const double (&fluxo)[2],
+                         uint32_t brechaMs, uint32_t headwayMs)
+{
+  const double dt = 0.05;
+  const double aquecimento = 600;  // 10 min para as filas se formarem
+  const double fim = aquecimento + op.horas * 3600.0;
+
+  // Mesmas chegadas nos dois modos (mesma semente)
+  std::mt19937 rng(op.semente);
+  std::vector<std::exponential_distribution<double>> chegadas;
+  double proxima[2];
+  for (int a = 0; a < 2; a++)
+  {
+    chegadas.emplace_back(std::max(fluxo[a], 1e-6) / 3600.0);
+    proxima[a] = chegadas[a](rng);
+  }
+
+  SaidaNula s1, s2;
+  MotorFases<NUM_GRUPOS, SaidaNula> motor(s1, s2);
+  Detector d1, d2;
+  Detector *detectores[2] = {&d1, &d2};
+  ControleAtuado<NUM_GRUPOS> controle(brechaMs, headwayMs, d1, d2);
+  FilaPontual filas[2] = {FilaPontual(headwayMs / 1000.0), FilaPontual(headwayMs / 1000.0)};
+  motor.iniciar(plano, 0);
+
+  Resultado r;
+  for (double t = 0; t < fim; t += dt)
+  {
+    const uint32_t agora = (uint32_t)std::llround(t * 1000.0);
+    for (int a = 0; a < 2; a++)
+    {
+      while (proxima[a] <= t)
+      {
+        Veiculo v;
+        v.entrada = proxima[a];
+        v.chegada = proxima[a];
+        filas[a].chegar(v);
+        detectores[a]->pulso((uint32_t)std::llround(proxima[a] * 1000.0));
+        proxima[a] += chegadas[a](rng);
+      }
+    }
+
+    // Mesma lógica do executarPlano() do firmware
+    bool estender = false;
+    if (atuado)
+    {
+      estender = controle.estender(plano, motor.getFase(), motor.getTempoNaFase(agora), agora);
+    }
+    if (motor.atualizar(agora, estender) && motor.getFase() == 0 && t >= aquecimento)
+    {
+      r.ciclos++;
+    }
+
+    for (int a = 0; a < 2; a++)
+    {
+      filas[a].atualizar(t, motor.getSinal(a) == Sinal::Verde, [&](const Veiculo &v) {
+        if (v.entrada >= aquecimento)
+        {
+          r.atendidos[a]++;
+          r.espera[a] += v.atraso;
+        }
+      });
+      if (t >= aquecimento)
+      {
+        r.maiorFila[a] = std::max(r.maiorFila[a], filas[a].tamanho(t));
+      }
+    }
+  }
+  for (int a = 0; a < 2; a++)
+  {
+    r.filaFinal[a] = filas[a].tamanho(fim);
+  }
+  r.gapOuts = controle.getGapOuts();
+  r.maxOuts = controle.getMaxOuts();
+  return r;
+}
+
+static void imprimir(const char *modo, const Resultado &r, const Opcoes &op)
+{
+  printf("  %-7s", modo);
+  for (int a = 0; a < 2; a++)
+  {
+    const double n = r.atendidos[a] > 0 ? (double)r.atendidos[a] : 1.0;
+    printf(" | %6.0f %8.1f %5zu", r.atendidos[a] / op.horas, r.espera[a] / n, r.maiorFila[a]);
+  }
+  const double total = (double)(r.atendidos[0] + r.atendidos[1]);
+  const double esperaMedia = total > 0 ? (r.espera[0] + r.espera[1]) / total : 0;
+  printf(" | %6.1f %6.1f", esperaMedia, r.ciclos > 0 ? op.horas * 3600.0 / r.ciclos : 0.0);
+  if (r.gapOuts + r.maxOuts > 0)
+  {
+    printf("   gap-out %u, max-out %u", r.gapOuts, r.maxOuts);
+  }
+  if (r.filaFinal[0] + r.filaFinal[1] > 10)
+  {
+    printf("   (saturado: %zu/%zu na fila no fim)", r.filaFinal[0], r.filaFinal[1]);
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+  Opcoes op;
+  for (int i = 1; i < argc; i++)
+  {
+    const bool temValor = i + 1 < argc;
+    if (!strcmp(argv[i], "--fluxo-s1") && temValor)
+      op.fluxo[0] = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--fluxo-s2") && temValor)
+      op.fluxo[1] = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--horas") && temValor)
+      op.horas = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--verde-fixo") && temValor)
+      op.verdeFixo = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--verde-min") && temValor)
+      op.verdeMin = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--verde-max") && temValor)
+      op.verdeMax = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--amarelo") && temValor)
+      op.amarelo = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--brecha") && temValor)
+      op.brecha = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--headway") && temValor)
+      op.headway = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--semente") && temValor)
+      op.semente = (unsigned)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--maquete"))
+      op.maquete = true;
+    else
+    {
+      fprintf(stderr,
+              "Uso: %s [--fluxo-s1 VEIC_H --fluxo-s2 VEIC_H] [--horas H] [--verde-fixo S] [--verde-min S]\n"
+              "          [--verde-max S] [--amarelo S] [--brecha S] [--headway S] [--semente S] [--maquete]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (op.horas <= 0 || op.verdeMin <= 0 || op.verdeMin > op.verdeMax || op.verdeFixo <= 0 || op.amarelo <= 0 ||
+      op.headway <= 0 || op.fluxo[0] < 0 || op.fluxo[1] < 0)
+  {
+    fprintf(stderr, "Parâmetros inválidos (tempos positivos, verde mínimo <= máximo)\n");
+    return 2;
+  }
+
+  // Planos: os do firmware (--maquete) ou montados com os tempos das opções
+  PlanoSim fixoSim("fixo", (uint32_t)(op.verdeFixo * 1000), (uint32_t)(op.verdeFixo * 1000), (uint32_t)(op.amarelo * 1000));
+  PlanoSim atuadoSim("atuado", (uint32_t)(op.verdeMin * 1000), (uint32_t)(op.verdeMax * 1000), (uint32_t)(op.amarelo * 1000));
+  const Plano<NUM_GRUPOS> &planoFixo = op.maquete ? PLANO_NORMAL : fixoSim.plano;
+  const Plano<NUM_GRUPOS> &planoAtuado = op.maquete ? PLANO_ATUADO : atuadoSim.plano;
+  const uint32_t brechaMs = op.maquete ? ATUADO_BRECHA_MS : (uint32_t)(op.brecha * 1000);
+  const uint32_t headwayMs = op.maquete ? ATUADO_HEADWAY_MS : (uint32_t)(op.headway * 1000);
+  if (!planoValido(planoFixo, CONFLITOS) || !planoValido(planoAtuado, CONFLITOS))
+  {
+    fprintf(stderr, "Plano inválido\n");
+    return 2;
+  }
+
+  const double capacidade = 3600.0 / (headwayMs / 1000.0);
+  printf("Cruzamento isolado%s: fixo com verde de %.1f s, atuado com verde de %.1f a %.1f s (brecha %.1f s),\n"
+         "amarelo %.1f s, saída de %.1f s/veículo (%.0f veic/h de verde), %.1f h por cenário\n\n",
+         op.maquete ? " (planos do firmware)" : "", planoFixo.fases[0].minMs / 1000.0, planoAtuado.fases[0].minMs / 1000.0,
+         planoAtuado.fases[0].maxMs / 1000.0, brechaMs / 1000.0, planoFixo.fases[1].minMs / 1000.0, headwayMs / 1000.0,
+         capacidade, op.horas);
+
+  std::vector<std::pair<double, double>> cenarios;
+  if (op.fluxo[0] > 0 || op.fluxo[1] > 0)
+  {
+    cenarios.push_back({op.fluxo[0], op.fluxo[1]});
+  }
+  else
+  {
+    // Frações da capacidade: vazio, equilibrado, desequilibrado, pico
+    const double fracoes[][2] = {{0.05, 0.05}, {0.25, 0.25}, {0.40, 0.08}, {0.50, 0.15}, {0.38, 0.38}};
+    for (const auto &f : fracoes)
+    {
+      cenarios.push_back({std::round(f[0] * capacidade / 10) * 10, std::round(f[1] * capacidade / 10) * 10});
+    }
+  }
+
+  printf("  %-7s | %-20s | %-20s | %-13s\n", "", "S1", "S2", "Total");
+  printf("  %-7s | %6s %8s %5s | %6s %8s %5s | %6s %6s\n", "Modo", "veic/h", "espera s", "fila", "veic/h", "espera s",
+         "fila", "espera", "ciclo");
+  for (const auto &c : cenarios)
+  {
+    const double fluxo[2] = {c.first, c.second};
+    printf("Demanda S1 %.0f veic/h, S2 %.0f veic/h\n", fluxo[0], fluxo[1]);
+    const Resultado fixo = simular(planoFixo, false, op, fluxo, brechaMs, headwayMs);
+    const Resultado atuado = simular(planoAtuado, true, op, fluxo, brechaMs, headwayMs);
+    imprimir("fixo", fixo, op);
+    imprimir("atuado", atuado, op);
+    const double nf = (double)(fixo.atendidos[0] + fixo.atendidos[1]);
+    const double na = (double)(atuado.atendidos[0] + atuado.atendidos[1]);
+    if (nf > 0 && na > 0)
+    {
+      const double ef = (fixo.espera[0] + fixo.espera[1]) / nf;
+      const double ea = (atuado.espera[0] + atuado.espera[1]) / na;
+      printf("  espera média %+.0f%%, fluxo atendido %+.1f%% (atuado x fixo)\n\n", 100.0 * (ea / ef - 1.0),
+             100.0 * (na / nf - 1.0));
+    }
+  }
+  return 0;
+}
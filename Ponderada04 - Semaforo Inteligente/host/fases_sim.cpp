@@ -0,0 +1,331 @@
+// Simulação no PC do motor de fases (../TabelaFases.h) com os planos do
+// firmware (../PlanoCruzamento.h) e um cruzamento de 4 aproximações.
+//
+// Verifica, a cada escrita de saída (inclusive no meio de uma troca de fase),
+// que nenhum par de grupos conflitantes fica verde ao mesmo tempo, que nenhum
+// grupo vai de verde direto para vermelho e que o amarelo depois de um verde
+// sempre termina em vermelho (inclusive nas trocas de plano). O relógio começa perto do estouro
+// do millis() para cobrir a volta do contador. No fim mede o custo de uma
+// passada do loop() contra o switch antigo, que reescrevia os 6 GPIOs sempre.
+//
+// Uso: ./fases_sim [--horas H] [--passo-us US] [--troca-modo-s S] [--passadas N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <utility>
+
+#include "TabelaFases.h"
+#include "PlanoCruzamento.h"
+
+// ---- Cruzamento de 4 aproximações (N, S, L, O) com conversão protegida ----
+
+constexpr size_t GRUPOS_4 = 4;  // Norte, Sul, Leste, Oeste
+
+// Norte x Sul e Leste x Oeste seguem juntos; os eixos se cruzam. Na fase de
+// conversão à esquerda do Norte, o Sul (que cruzaria a conversão) fica parado
+constexpr bool CONFLITOS_4[GRUPOS_4][GRUPOS_4] = {
+    {false, false, true, true},
+    {false, false, true, true},
+    {true, true, false, false},
+    {true, true, false, false},
+};
+
+// A conversão do Norte vem antes do verde do eixo (o Norte segue verde quando
+// o Sul abre): um amarelo do Norte seguido de verde não passaria no
+// amareloTerminaEmVermelho()
+constexpr Fase<GRUPOS_4> FASES_4[] = {
+    {{Sinal::Verde, Sinal::Vermelho, Sinal::Vermelho, Sinal::Vermelho}, 8000, 12000, 1},
+    {{Sinal::Verde, Sinal::Verde, Sinal::Vermelho, Sinal::Vermelho}, 20000, 40000, 2},
+    {{Sinal::Amarelo, Sinal::Amarelo, Sinal::Vermelho, Sinal::Vermelho}, 3000, 3000, 3},
+    {{Sinal::Vermelho, Sinal::Vermelho, Sinal::Verde, Sinal::Verde}, 15000, 30000, 4},
+    {{Sinal::Vermelho, Sinal::Vermelho, Sinal::Amarelo, Sinal::Amarelo}, 3000, 3000, 0},
+};
+
+constexpr Plano<GRUPOS_4> PLANO_4 = criarPlano("4 aproximacoes", FASES_4);
+static_assert(planoValido(PLANO_4, CONFLITOS_4), "Plano de 4 aproximações inseguro");
+
+// ---- Saída simulada com verificação a cada escrita ----
+
+template <size_t N>
+struct Verificador;
+
+template <size_t N>
+struct SaidaSim
+{
+  Verificador<N> *verificador = nullptr;
+  Sinal sinal = Sinal::Apagado;
+  bool amareloDeVerde = false;
+  uint32_t escritas = 0;
+
+  void aplicar(Sinal novo)
+  {
+    if (sinal == Sinal::Verde && novo == Sinal::Vermelho)
+    {
+      verificador->verdeParaVermelho++;
+    }
+    if (amareloDeVerde && novo != Sinal::Vermelho)
+    {
+      verificador->amareloSemVermelho++;
+    }
+    amareloDeVerde = sinal == Sinal::Verde && novo == Sinal::Amarelo;
+    sinal = novo;
+    escritas++;
+    verificador->conferir();
+  }
+};
+
+template <size_t N>
+struct Verificador
+{
+  const bool (*conflitos)[N];
+  SaidaSim<N> saidas[N];
+  uint32_t agora = 0;
+  uint64_t verdesConflitantes = 0;
+  uint64_t verdeParaVermelho = 0;
+  uint64_t amareloSemVermelho = 0;
+  uint64_t tempoVerde[N] = {};
+
+  void conferir()
+  {
+    for (size_t a = 0; a < N; a++)
+    {
+      for (size_t b = a + 1; b < N; b++)
+      {
+        if (conflitos[a][b] && saidas[a].sinal == Sinal::Verde && saidas[b].sinal == Sinal::Verde)
+        {
+          if (verdesConflitantes == 0)
+          {
+            printf("  ✗ Verdes conflitantes: grupos %zu e %zu em t=%lu ms\n", a, b, (unsigned long)agora);
+          }
+          verdesConflitantes++;
+        }
+      }
+    }
+  }
+};
+
+template <size_t N, size_t... I>
+MotorFases<N, SaidaSim<N>> criarMotor(SaidaSim<N> (&saidas)[N], std::index_sequence<I...>)
+{
+  return MotorFases<N, SaidaSim<N>>(saidas[I]...);
+}
+
+struct Opcoes
+{
+  double horas = 1.0;
+  uint32_t passoUs = 50;
+  uint32_t trocaModoS = 0;
+  uint64_t passadas = 20000000;
+};
+
+// Roda 'horas' de relógio simulado; com trocaModoS > 0 alterna entre os planos
+// em instantes aleatórios (média trocaModoS), como o LDR/comandos fariam
+template <size_t N>
+bool simular(const char *titulo, const Plano<N> *const *planos, size_t numPlanos,
+             const bool (&conflitos)[N][N], const char *const *nomes, const Opcoes &op)
+{
+  printf("%s\n", titulo);
+  Verificador<N> v;
+  v.conflitos = conflitos;
+  for (size_t g = 0; g < N; g++)
+  {
+    v.saidas[g].verificador = &v;
+  }
+  MotorFases<N, SaidaSim<N>> motor = criarMotor(v.saidas, std::make_index_sequence<N>());
+
+  std::mt19937 rng(42);
+  std::exponential_distribution<double> proximaTroca(op.trocaModoS > 0 ? 1.0 / (op.trocaModoS * 1000.0) : 1.0);
+
+  const uint64_t totalUs = (uint64_t)(op.horas * 3600e6);
+  const uint32_t inicioMs = 0xFFFFFFFFu - 60000u;  // estoura o millis() no 1º minuto
+  size_t planoAtual = 0;
+  uint64_t trocasModo = 0;
+  uint64_t proximaTrocaMs = op.trocaModoS > 0 && numPlanos > 1 ? (uint64_t)proximaTroca(rng) : UINT64_MAX;
+  uint64_t pedidoMs = 0;
+  uint64_t esperaMaxMs = 0;
+  uint64_t passadas = 0;
+  uint32_t ultimoMs = inicioMs;
+
+  v.agora = inicioMs;
+  motor.iniciar(*planos[0], v.agora);
+  for (uint64_t us = 0; us < totalUs; us += op.passoUs, passadas++)
+  {
+    const uint64_t ms = us / 1000;
+    v.agora = inicioMs + (uint32_t)ms;
+    for (size_t g = 0; g < N; g++)
+    {
+      if (v.saidas[g].sinal == Sinal::Verde)
+      {
+        v.tempoVerde[g] += v.agora - ultimoMs;
+      }
+    }
+    ultimoMs = v.agora;
+
+    if (ms >= proximaTrocaMs)
+    {
+      planoAtual = (planoAtual + 1) % numPlanos;
+      motor.trocarPlano(*planos[planoAtual]);
+      if (&motor.getPlano() != planos[planoAtual])
+      {
+        pedidoMs = ms;  // Só uma troca agendada por vez (um novo pedido substitui)
+      }
+      trocasModo++;
+      proximaTrocaMs = ms + 1 + (uint64_t)proximaTroca(rng);
+    }
+    const uint32_t trocasPlanoAntes = motor.getTrocasPlano();
+    motor.atualizar(v.agora);
+    if (motor.getTrocasPlano() != trocasPlanoAntes && ms - pedidoMs > esperaMaxMs)
+    {
+      esperaMaxMs = ms - pedidoMs;
+    }
+  }
+
+  uint64_t escritas = 0;
+  for (size_t g = 0; g < N; g++)
+  {
+    escritas += v.saidas[g].escritas;
+  }
+  printf("  %.2f h simuladas, %llu passadas do loop, %u trocas de fase\n",
+         op.horas, (unsigned long long)passadas, motor.getTrocas());
+  if (trocasModo > 0)
+  {
+    printf("  %llu pedidos de troca de plano, %u trocas feitas, espera máxima até o fim do amarelo: %llu ms\n",
+           (unsigned long long)trocasModo, motor.getTrocasPlano(), (unsigned long long)esperaMaxMs);
+  }
+  printf("  Escritas de grupo: %llu (%.6f por passada; o switch antigo fazia 1 por grupo por passada)\n",
+         (unsigned long long)escritas, (double)escritas / passadas);
+  for (size_t g = 0; g < N; g++)
+  {
+    printf("  Verde %-6s %5.1f%% do tempo\n", nomes[g], 100.0 * v.tempoVerde[g] / (totalUs / 1000.0));
+  }
+  const bool ok = v.verdesConflitantes == 0 && v.verdeParaVermelho == 0 && v.amareloSemVermelho == 0;
+  printf("  %s Verdes conflitantes: %llu, verde direto para vermelho: %llu, amarelo sem vermelho: %llu\n\n",
+         ok ? "✓" : "✗", (unsigned long long)v.verdesConflitantes, (unsigned long long)v.verdeParaVermelho,
+         (unsigned long long)v.amareloSemVermelho);
+  return ok;
+}
+
+// ---- Custo por passada do loop() ----
+
+// 3 GPIOs por grupo, como Semaforo::setEstado
+static volatile uint8_t gpio[6];
+
+struct SaidaGpio
+{
+  uint8_t base;
+  void aplicar(Sinal s)
+  {
+    gpio[base] = s == Sinal::Vermelho;
+    gpio[base + 1] = s == Sinal::Amarelo;
+    gpio[base + 2] = s == Sinal::Verde;
+  }
+};
+
+// Reprodução do cicloNormal() antigo: switch sobre o estado e os 6 GPIOs
+// reescritos em toda passada
+struct CicloLegado
+{
+  int estado = 0;
+  uint32_t tempoAnterior = 0;
+  SaidaGpio s1{0}, s2{3};
+
+  void atualizar(uint32_t agora)
+  {
+    switch (estado)
+    {
+    case 0:
+      s1.aplicar(Sinal::Verde);
+      s2.aplicar(Sinal::Vermelho);
+      if (agora - tempoAnterior >= TEMPO_VERDE) { estado = 1; tempoAnterior = agora; }
+      break;
+    case 1:
+      s1.aplicar(Sinal::Amarelo);
+      s2.aplicar(Sinal::Vermelho);
+      if (agora - tempoAnterior >= TEMPO_AMARELO) { estado = 2; tempoAnterior = agora; }
+      break;
+    case 2:
+      s1.aplicar(Sinal::Vermelho);
+      s2.aplicar(Sinal::Verde);
+      if (agora - tempoAnterior >= TEMPO_VERDE) { estado = 3; tempoAnterior = agora; }
+      break;
+    case 3:
+      s1.aplicar(Sinal::Vermelho);
+      s2.aplicar(Sinal::Amarelo);
+      if (agora - tempoAnterior >= TEMPO_AMARELO) { estado = 0; tempoAnterior = agora; }
+      break;
+    }
+  }
+};
+
+template <typename F>
+static double nsPorPassada(uint64_t passadas, uint32_t passoUs, F &&passada)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < passadas; i++)
+  {
+    passada((uint32_t)(i * passoUs / 1000));
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / passadas;
+}
+
+static void medirCusto(const Opcoes &op)
+{
+  printf("Custo por passada do loop() (%llu passadas, uma a cada %u µs simulados)\n",
+         (unsigned long long)op.passadas, op.passoUs);
+
+  SaidaGpio s1{0}, s2{3};
+  MotorFases<NUM_GRUPOS, SaidaGpio> motor(s1, s2);
+  motor.iniciar(PLANO_NORMAL, 0);
+  const uint32_t escritasAntes = motor.getEscritas();
+  const double nsMotor = nsPorPassada(op.passadas, op.passoUs, [&](uint32_t agora) { motor.atualizar(agora); });
+
+  CicloLegado legado;
+  const double nsLegado = nsPorPassada(op.passadas, op.passoUs, [&](uint32_t agora) { legado.atualizar(agora); });
+
+  printf("  Tabela de fases: %6.2f ns/passada, %u escritas de grupo\n", nsMotor, motor.getEscritas() - escritasAntes);
+  printf("  switch antigo:   %6.2f ns/passada, %llu escritas de grupo\n", nsLegado,
+         (unsigned long long)op.passadas * NUM_GRUPOS);
+  printf("  (no ESP32 cada escrita de grupo são 3 digitalWrite)\n");
+}
+
+int main(int argc, char **argv)
+{
+  Opcoes op;
+  for (int i = 1; i < argc; i++)
+  {
+    const bool temValor = i + 1 < argc;
+    if (!strcmp(argv[i], "--horas") && temValor)
+      op.horas = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--passo-us") && temValor)
+      op.passoUs = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--troca-modo-s") && temValor)
+      op.trocaModoS = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--passadas") && temValor)
+      op.passadas = strtoull(argv[++i], nullptr, 10);
+    else
+    {
+      fprintf(stderr, "Uso: %s [--horas H] [--passo-us US] [--troca-modo-s S] [--passadas N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (op.passoUs == 0 || op.horas <= 0)
+  {
+    fprintf(stderr, "--passo-us e --horas precisam ser positivos\n");
+    return 2;
+  }
+
+  const Plano<NUM_GRUPOS> *planosMaquete[] = {&PLANO_NORMAL, &PLANO_ATUADO, &PLANO_NOTURNO};
+  const char *nomesMaquete[] = {"S1", "S2"};
+  const Plano<GRUPOS_4> *planos4[] = {&PLANO_4};
+  const char *nomes4[] = {"Norte", "Sul", "Leste", "Oeste"};
+
+  bool ok = simular("Maquete (S1/S2, planos normal, atuado e noturno)", planosMaquete,
+                    op.trocaModoS > 0 ? 3 : 1, CONFLITOS, nomesMaquete, op);
+  ok = simular("Cruzamento de 4 aproximacoes", planos4, 1, CONFLITOS_4, nomes4, op) && ok;
+  medirCusto(op);
+  return ok ? 0 : 1;
+}
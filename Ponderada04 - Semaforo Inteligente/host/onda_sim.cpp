@@ -0,0 +1,328 @@
+// Simulação no PC de um corredor com dezenas de cruzamentos, cada um rodando o
+// motor de fases do firmware (../TabelaFases.h, ../PlanoCruzamento.h) com o
+// seu próprio millis() (início aleatório e deriva do cristal).
+//
+// Compara o atraso dos veículos na via principal (S1) em três cenários:
+//   livre       - cada cruzamento roda o ciclo a partir do próprio boot
+//   coordenado  - relógio comum via mensagens de sincronização do cruzamento 0
+//                 (latência variável, como pelo broker MQTT) + onda verde
+//   ideal       - onda verde com relógio perfeito (limite da coordenação)
+//
+// Os veículos seguem o modelo de fila pontual (FilaPontual.h) nos dois sentidos;
+// a onda é montada para o sentido "ida" (do cruzamento 0 para o último).
+//
+// Uso: ./onda_sim [--cruzamentos N] [--distancia-m M] [--velocidade-kmh V]
+//                 [--fluxo VEIC_H] [--horas H] [--deriva-ppm P] [--latencia-ms L]
+//                 [--aquecimento-min M] [--semente S]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "TabelaFases.h"
+#include "PlanoCruzamento.h"
+#include "Coordenacao.h"
+#include "FilaPontual.h"
+
+struct Opcoes
+{
+  int cruzamentos = 24;
+  double distanciaM = 250;     // média entre cruzamentos (±30%)
+  double velocidadeKmh = 50;
+  double fluxo = 150;          // veículos/h por sentido
+  double horas = 1;
+  double derivaPpm = 50;       // desvio máximo do cristal (uniforme em ±)
+  double latenciaMs = 20;      // média da parte variável do atraso das mensagens
+  double aquecimentoMin = 5;   // veículos que entram antes disso não contam
+  unsigned semente = 1;
+};
+
+enum class Cenario
+{
+  Livre,
+  Coordenado,
+  Ideal
+};
+
+static const char *nomeCenario(Cenario c)
+{
+  return c == Cenario::Livre ? "livre" : (c == Cenario::Coordenado ? "coordenado" : "ideal");
+}
+
+// O motor só precisa de um destino para aplicar(); o sinal é lido via getSinal()
+struct SaidaNula
+{
+  void aplicar(Sinal) {}
+};
+
+struct Mensagem
+{
+  double entrega;   // s - instante real da chegada
+  uint32_t tempoMestre;
+};
+
+struct Controlador
+{
+  SaidaNula s1, s2;
+  MotorFases<NUM_GRUPOS, SaidaNula> motor{s1, s2};
+  RelogioCoordenado relogio;
+  OndaVerde onda;
+  double boot;          // valor inicial do millis() (ms)
+  double fatorRelogio;  // 1 + deriva
+  std::vector<Mensagem> pendentes;
+
+  uint32_t millisEm(double t) const
+  {
+    return (uint32_t)(uint64_t)std::llround(boot + t * 1000.0 * fatorRelogio);
+  }
+};
+
+struct Resultado
+{
+  uint64_t veiculos[2] = {};
+  double atraso[2] = {};
+  uint64_t paradas[2] = {};
+  uint64_t semParar[2] = {};
+  double erroSyncSoma = 0;
+  double erroSyncMax = 0;
+  uint64_t erroSyncAmostras = 0;
+  double erroOndaSoma = 0;
+  uint64_t erroOndaAmostras = 0;
+};
+
+static Resultado simular(Cenario cenario, const Opcoes &op, const std::vector<double> &posicoes)
+{
+  const int n = op.cruzamentos;
+  const double v = op.velocidadeKmh / 3.6;
+  const double dt = 0.01;
+  const double fim = op.horas * 3600.0;
+  const double aquecimento = op.aquecimentoMin * 60.0;
+
+  // Relógios e ruído iguais em todos os cenários (mesma semente)
+  std::mt19937 rng(op.semente);
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  std::exponential_distribution<double> latencia(1.0 / std::max(op.latenciaMs, 0.001));
+
+  std::vector<Controlador> ctrl(n);
+  for (int i = 0; i < n; i++)
+  {
+    Controlador &c = ctrl[i];
+    c.boot = unif(rng) * 600000.0;  // ligados em instantes diferentes (até 10 min)
+    c.fatorRelogio = 1.0 + (unif(rng) * 2.0 - 1.0) * op.derivaPpm * 1e-6;
+    if (cenario == Cenario::Ideal)
+    {
+      c.boot = 0;
+      c.fatorRelogio = 1.0;
+    }
+    c.relogio.setMestre(i == 0 || cenario == Cenario::Ideal);
+    c.onda.setOffset((uint32_t)std::llround(posicoes[i] / v * 1000.0) % cicloCoordenado(PLANO_NORMAL));
+    c.motor.iniciar(PLANO_NORMAL, c.millisEm(0));
+  }
+
+  // Filas por cruzamento e sentido (0 = ida, 1 = volta)
+  std::vector<FilaPontual> filas[2] = {std::vector<FilaPontual>(n), std::vector<FilaPontual>(n)};
+  std::exponential_distribution<double> chegadas(op.fluxo / 3600.0);
+  double proximaChegada[2] = {chegadas(rng), chegadas(rng)};
+  uint32_t proximoSync = 0;
+
+  Resultado r;
+  auto saiuDoSistema = [&](int sentido, const Veiculo &veic) {
+    if (veic.entrada < aquecimento)
+    {
+      return;
+    }
+    r.veiculos[sentido]++;
+    r.atraso[sentido] += veic.atraso;
+    r.paradas[sentido] += veic.paradas;
+    r.semParar[sentido] += veic.paradas == 0;
+  };
+
+  for (double t = 0; t < fim; t += dt)
+  {
+    // Sincronização: o mestre publica o millis() a cada segundo
+    if (cenario == Cenario::Coordenado)
+    {
+      const uint32_t mestre = ctrl[0].millisEm(t);
+      if ((int32_t)(mestre - proximoSync) >= 0)
+      {
+        proximoSync = mestre + 1000;
+        for (int i = 1; i < n; i++)
+        {
+          double atraso = 0.005 + latencia(rng) / 1000.0;
+          if (unif(rng) < 0.02)
+          {
+            atraso += 0.3;  // broker ocupado / retransmissão Wi-Fi
+          }
+          ctrl[i].pendentes.push_back({t + atraso, mestre});
+        }
+      }
+      for (int i = 1; i < n; i++)
+      {
+        std::vector<Mensagem> &p = ctrl[i].pendentes;
+        for (size_t k = 0; k < p.size();)
+        {
+          if (p[k].entrega <= t)
+          {
+            ctrl[i].relogio.amostra(p[k].tempoMestre, ctrl[i].millisEm(t));
+            p[k] = p.back();
+            p.pop_back();
+          }
+          else
+          {
+            k++;
+          }
+        }
+      }
+    }
+
+    // Controladores: mesma lógica do executarPlano() do firmware
+    for (int i = 0; i < n; i++)
+    {
+      Controlador &c = ctrl[i];
+      const uint32_t agora = c.millisEm(t);
+      bool estender = false;
+      if (cenario != Cenario::Livre && c.relogio.sincronizado(agora))
+      {
+        estender = c.onda.estender(PLANO_NORMAL, c.motor.getFase(), c.motor.getTempoNaFase(agora), c.relogio.agora(agora));
+      }
+      if (c.motor.atualizar(agora, estender) && c.motor.getFase() == 1 && t >= aquecimento && cenario != Cenario::Livre)
+      {
+        // Erro residual da onda no fim do verde de S1
+        r.erroOndaSoma += std::fabs((double)c.onda.getErro());
+        r.erroOndaAmostras++;
+      }
+
+      if (cenario == Cenario::Coordenado && i > 0 && t >= aquecimento)
+      {
+        const double erro = std::fabs((double)(int32_t)(c.relogio.agora(agora) - ctrl[0].millisEm(t)));
+        r.erroSyncSoma += erro;
+        r.erroSyncMax = std::max(r.erroSyncMax, erro);
+        r.erroSyncAmostras++;
+      }
+    }
+
+    // Veículos
+    for (int sentido = 0; sentido < 2; sentido++)
+    {
+      while (proximaChegada[sentido] <= t)
+      {
+        Veiculo veic;
+        veic.entrada = proximaChegada[sentido];
+        veic.chegada = proximaChegada[sentido];
+        filas[sentido][sentido == 0 ? 0 : n - 1].chegar(veic);
+        proximaChegada[sentido] += chegadas(rng);
+      }
+      for (int k = 0; k < n; k++)
+      {
+        const int i = sentido == 0 ? k : n - 1 - k;
+        const bool verde = ctrl[i].motor.getSinal(0) == Sinal::Verde;
+        filas[sentido][i].atualizar(t, verde, [&](Veiculo veic) {
+          const int proximo = sentido == 0 ? i + 1 : i - 1;
+          if (proximo < 0 || proximo >= n)
+          {
+            saiuDoSistema(sentido, veic);
+            return;
+          }
+          veic.chegada = t + std::fabs(posicoes[proximo] - posicoes[i]) / v;
+          filas[sentido][proximo].chegar(veic);
+        });
+      }
+    }
+  }
+  return r;
+}
+
+int main(int argc, char **argv)
+{
+  Opcoes op;
+  for (int i = 1; i < argc; i++)
+  {
+    const bool temValor = i + 1 < argc;
+    if (!strcmp(argv[i], "--cruzamentos") && temValor)
+      op.cruzamentos = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--distancia-m") && temValor)
+      op.distanciaM = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--velocidade-kmh") && temValor)
+      op.velocidadeKmh = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--fluxo") && temValor)
+      op.fluxo = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--horas") && temValor)
+      op.horas = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--deriva-ppm") && temValor)
+      op.derivaPpm = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--latencia-ms") && temValor)
+      op.latenciaMs = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--aquecimento-min") && temValor)
+      op.aquecimentoMin = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--semente") && temValor)
+      op.semente = (unsigned)atoi(argv[++i]);
+    else
+    {
+      fprintf(stderr,
+              "Uso: %s [--cruzamentos N] [--distancia-m M] [--velocidade-kmh V] [--fluxo VEIC_H]\n"
+              "          [--horas H] [--deriva-ppm P] [--latencia-ms L] [--aquecimento-min M] [--semente S]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (op.cruzamentos < 2 || op.velocidadeKmh <= 0 || op.fluxo <= 0 || op.horas * 60 <= op.aquecimentoMin)
+  {
+    fprintf(stderr, "Parâmetros inválidos (mínimo 2 cruzamentos; duração maior que o aquecimento)\n");
+    return 2;
+  }
+
+  // Posições ao longo do corredor
+  std::mt19937 rng(op.semente + 1000);
+  std::uniform_real_distribution<double> espaco(0.7 * op.distanciaM, 1.3 * op.distanciaM);
+  std::vector<double> posicoes(op.cruzamentos, 0.0);
+  for (int i = 1; i < op.cruzamentos; i++)
+  {
+    posicoes[i] = posicoes[i - 1] + espaco(rng);
+  }
+
+  printf("Corredor: %d cruzamentos em %.1f km, %.0f km/h, %.0f veic/h por sentido, ciclo coordenado %u ms, %.1f h (aquecimento %.0f min)\n\n",
+         op.cruzamentos, posicoes.back() / 1000.0, op.velocidadeKmh, op.fluxo, cicloCoordenado(PLANO_NORMAL), op.horas,
+         op.aquecimentoMin);
+  printf("%-11s | %-27s | %-27s | %-27s\n", "Cenário", "Atraso médio (s) ida/volta", "Paradas/veíc ida/volta",
+         "Sem parar ida/volta");
+
+  Resultado base;
+  const Cenario cenarios[] = {Cenario::Livre, Cenario::Coordenado, Cenario::Ideal};
+  for (Cenario c : cenarios)
+  {
+    const Resultado r = simular(c, op, posicoes);
+    double atraso[2], paradas[2], semParar[2];
+    for (int s = 0; s < 2; s++)
+    {
+      const double n = r.veiculos[s] > 0 ? (double)r.veiculos[s] : 1.0;
+      atraso[s] = r.atraso[s] / n;
+      paradas[s] = r.paradas[s] / n;
+      semParar[s] = 100.0 * r.semParar[s] / n;
+    }
+    printf("%-11s | %11.1f / %-13.1f | %11.2f / %-13.2f | %10.1f%% / %-12.1f%%\n", nomeCenario(c), atraso[0], atraso[1],
+           paradas[0], paradas[1], semParar[0], semParar[1]);
+    if (c == Cenario::Livre)
+    {
+      base = r;
+    }
+    else
+    {
+      const double n0 = base.veiculos[0] > 0 ? (double)base.veiculos[0] : 1.0;
+      const double n = r.veiculos[0] > 0 ? (double)r.veiculos[0] : 1.0;
+      printf("%-11s   ida: atraso %+.0f%% x livre", "", 100.0 * ((r.atraso[0] / n) / (base.atraso[0] / n0) - 1.0));
+      if (r.erroOndaAmostras > 0)
+      {
+        printf(", erro residual da onda %.0f ms", r.erroOndaSoma / r.erroOndaAmostras);
+      }
+      if (r.erroSyncAmostras > 0)
+      {
+        printf(", relógio: erro médio %.1f ms (máx %.0f ms)", r.erroSyncSoma / r.erroSyncAmostras, r.erroSyncMax);
+      }
+      printf("\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,1243 @@
+// Simulação de eventos discretos do firmware completo (o .ino, sem alterar
+// nada nele) no PC. O núcleo do Arduino, o Wi-Fi, o servidor HTTP e o
+// cliente MQTT vêm de arduino/ (relógio, GPIO e ADC simulados); no lugar do
+// FreeRTOS, uma agenda de eventos ordenada pelo instante chama as passadas das
+// tarefas (passadaControle a cada 1 ms, com jitter opcional; passadaRede a
+// cada 2 ms; loop() a cada 10 s) e injeta o que vem de fora:
+//   - LDR: dia e noite sintéticos (nuvens, ruído e faróis) ou um traço em CSV,
+//     em quadros do ADC contínuo (256 conversões a 20 kHz);
+//   - veículos: chegadas de Poisson nos pinos dos detectores (interrupção);
+//   - comandos: aleatórios e/ou de um roteiro, por MQTT ou HTTP, com o broker
+//     caindo e voltando;
+//   - painel: um GET /status a cada poucos segundos.
+// Como o relógio só anda de evento em evento, dias de operação rodam em
+// segundos.
+//
+// A cada escrita de GPIO, passada do controlador e verificação periódica, o
+// simulador confere:
+//   - nunca dois grupos conflitantes em verde (CONFLITOS), em nenhuma escrita;
+//   - no fim de cada passada, no máximo uma lâmpada acesa por semáforo;
+//   - verde sempre passa pelo amarelo, o amarelo depois do verde dura pelo
+//     menos TEMPO_AMARELO e termina em vermelho (o amarelo piscante do
+//     noturno não vem de um verde), e o verde dura o menor verde mínimo dos
+//     planos;
+//   - apagado só no pisca do noturno (nunca mais que a fase apagada);
+//   - cada fase terminada no tempo da tabela (diário) dura de minMs - 1 ms
+//     (resolução do millis()) a minMs + período + jitter;
+//   - histerese: no automático, luz além do limite (com folga) por mais que a
+//     confirmação + assentamento do filtro tem que ter trocado o modo, e o
+//     modo só troca se a luz ficou além do limite durante a confirmação;
+//   - comandos aplicados em até --latencia-ms, com o efeito esperado;
+//   - toda mensagem MQTT cabe no buffer e o HTTP não responde erro.
+// Sai com código 1 se alguma verificação falhar.
+//
+// Uso: ./semaforo_sim [--horas H | --dias D] [--semente S] [--jitter-us US]
+//                     [--ldr TRACO.csv] [--hora-inicial H] [--ruido R] [--farois-hora N]
+//                     [--roteiro ARQ] [--comandos-hora N] [--veiculos-hora N] [--painel-s S]
+//                     [--sem-broker] [--sem-adc-continuo] [--millis-inicial MS]
+//                     [--folga-ldr N] [--assentamento-ms MS] [--latencia-ms MS] [--log ARQ|-]
+
+#include <Arduino.h>   // arduino/: núcleo simulado (o Arduino inclui sozinho no .ino)
+#include "../Ponderada04 - Semaforo Inteligente.ino"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Opcoes
+{
+  double horas = 24;
+  unsigned semente = 1;
+  uint32_t jitterUs = 100;          // Atraso de cada passada do controlador: 0 a jitterUs
+  std::string ldr;                  // Traço em CSV (vazio = dia e noite sintéticos)
+  double horaInicial = 12;          // Hora do dia na partida (sintético)
+  double ruido = 30;                // Desvio padrão do ruído por quadro do ADC
+  double faroisHora = 30;           // Faróis passando pelo LDR
+  std::string roteiro;
+  double comandosHora = 4;          // Comandos aleatórios (MQTT e HTTP)
+  double veiculosHora = 300;        // Por aproximação
+  double painelS = 2;               // GET /status do painel (0 = sem painel)
+  bool semBroker = false;
+  bool semAdcContinuo = false;
+  uint32_t millisInicial = 0;
+  int folgaLdr = 150;               // Folga sobre os limites na verificação da histerese
+  uint32_t assentamentoMs = 2000;   // Atraso do filtro (mediana + EMA) até passar do limite
+  uint32_t latenciaMs = 5;          // Do comando chegar ao broker/HTTP até o controlador aplicar
+  std::string log;                  // Serial do firmware ("-" = terminal)
+};
+
+// ==================== Agenda de eventos ====================
+enum class TipoEvento : uint8_t
+{
+  Controle,      // passadaControle()
+  Rede,          // passadaRede()
+  Loop,          // loop() do Arduino
+  QuadroAdc,     // Fim de um quadro do ADC contínuo
+  Farol,         // Início de um pico de luz no LDR
+  Veiculo,       // dado = grupo
+  Roteiro,       // dado = linha do roteiro
+  Aleatorio,     // Comando aleatório
+  Painel,        // GET /status
+  Verificacao    // Verificações periódicas (100 ms)
+};
+
+struct Evento
+{
+  int64_t tempoUs;
+  uint64_t seq;   // Mesmo instante: na ordem em que foram agendados
+  TipoEvento tipo;
+  uint32_t dado;
+};
+
+struct DepoisDe
+{
+  bool operator()(const Evento &a, const Evento &b) const
+  {
+    return a.tempoUs != b.tempoUs ? a.tempoUs > b.tempoUs : a.seq > b.seq;
+  }
+};
+
+class Agenda
+{
+public:
+  void agendar(int64_t tempoUs, TipoEvento tipo, uint32_t dado = 0) { fila.push(Evento{tempoUs, seq++, tipo, dado}); }
+
+  bool proximo(Evento &e)
+  {
+    if (fila.empty())
+      return false;
+    e = fila.top();
+    fila.pop();
+    return true;
+  }
+
+private:
+  std::priority_queue<Evento, std::vector<Evento>, DepoisDe> fila;
+  uint64_t seq = 0;
+};
+
+// ==================== LDR ====================
+// Luz "limpa" (sem ruído nem faróis), o sinal que as verificações usam
+// (limpa + faróis) e a lida pelo ADC (sinal + ruído). Sintético: noite 700, dia 3400, amanhecer 5h30-6h30, anoitecer
+// 17h30-18h30, nuvens lentas (Ornstein-Uhlenbeck) durante o dia
+class Luz
+{
+public:
+  Luz(const Opcoes &op, std::mt19937 &gen) : op(op), gen(gen) {}
+
+  bool carregar(const std::string &caminho)
+  {
+    std::ifstream arquivo(caminho);
+    if (!arquivo)
+      return false;
+    std::string linha;
+    int colTempo = 0;
+    int colLuz = 1;
+    double escala = 1e6;   // tempo_s
+    double origem = NAN;
+    while (std::getline(arquivo, linha))
+    {
+      if (linha.empty() || linha[0] == '#')
+        continue;
+      std::vector<std::string> campos = separar(linha);
+      if (campos.empty() || !(isdigit((unsigned char)campos[0][0]) || campos[0][0] == '-' || campos[0][0] == '.'))
+      {
+        // Cabeçalho: CSV do historico_reader.py (millis, luminosidade) ou tempo_s,valor
+        for (size_t i = 0; i < campos.size(); i++)
+        {
+          if (campos[i] == "millis")
+          {
+            colTempo = (int)i;
+            escala = 1e3;
+          }
+          else if (campos[i] == "luminosidade")
+            colLuz = (int)i;
+        }
+        continue;
+      }
+      if ((int)campos.size() <= std::max(colTempo, colLuz))
+        continue;
+      double t = atof(campos[colTempo].c_str());
+      if (std::isnan(origem))
+        origem = t;
+      pontos.push_back({(int64_t)((t - origem) * escala), atof(campos[colLuz].c_str())});
+    }
+    return !pontos.empty();
+  }
+
+  // Chamado a cada quadro, em ordem de tempo
+  void avancar(int64_t agoraUs, double dtS)
+  {
+    const double teta = 1.0 / 600.0;   // Nuvens mudam em ~10 min
+    const double sigma = 0.12 * std::sqrt(2 * teta);
+    nuvem += teta * (0.85 - nuvem) * dtS + sigma * std::sqrt(dtS) * normal(gen);
+    nuvem = std::min(1.0, std::max(0.3, nuvem));
+    limpa = fixa >= 0 ? fixa : (pontos.empty() ? sintetica(agoraUs) : traco(agoraUs));
+    sinal = limpa + (agoraUs < farolAteUs ? farolAmplitude : 0);
+    double lida = sinal + op.ruido * normal(gen);
+    adc = (int)std::lround(std::min(4095.0, std::max(0.0, lida)));
+  }
+
+  void farol(int64_t agoraUs)
+  {
+    farolAteUs = agoraUs + (int64_t)std::uniform_int_distribution<int>(100, 700)(gen) * 1000;
+    farolAmplitude = std::uniform_real_distribution<double>(800, 2000)(gen);
+    farois++;
+  }
+
+  void fixar(double valor) { fixa = valor; }   // Roteiro: "ldr 1500" (negativo volta ao traço)
+
+  double getLimpa() const { return limpa; }
+  double getSinal() const { return sinal; }
+  int getAdc() const { return adc; }
+  uint32_t getFarois() const { return farois; }
+  size_t getPontos() const { return pontos.size(); }
+
+private:
+  struct Ponto
+  {
+    int64_t tempoUs;
+    double valor;
+  };
+
+  const Opcoes &op;
+  std::mt19937 &gen;
+  std::normal_distribution<double> normal{0.0, 1.0};
+  std::vector<Ponto> pontos;
+  size_t cursor = 0;
+  double nuvem = 0.85;
+  double fixa = -1;
+  double limpa = 0;
+  double sinal = 0;
+  int adc = 0;
+  int64_t farolAteUs = 0;
+  double farolAmplitude = 0;
+  uint32_t farois = 0;
+
+  static std::vector<std::string> separar(const std::string &linha)
+  {
+    std::vector<std::string> campos;
+    std::stringstream ss(linha);
+    std::string campo;
+    while (std::getline(ss, campo, ','))
+    {
+      size_t a = campo.find_first_not_of(" \t\r");
+      size_t b = campo.find_last_not_of(" \t\r");
+      campos.push_back(a == std::string::npos ? "" : campo.substr(a, b - a + 1));
+    }
+    return campos;
+  }
+
+  static double rampa(double h, double inicio)
+  {
+    double x = std::min(1.0, std::max(0.0, h - inicio));
+    return x * x * (3 - 2 * x);
+  }
+
+  double sintetica(int64_t agoraUs) const
+  {
+    double h = std::fmod(op.horaInicial + agoraUs / 3.6e9, 24.0);
+    double sol = rampa(h, 5.5) - rampa(h, 17.5);
+    return 700 + 2700 * sol * nuvem;
+  }
+
+  // Interpolação linear; depois do último ponto fica no último valor
+  double traco(int64_t agoraUs)
+  {
+    while (cursor + 1 < pontos.size() && pontos[cursor + 1].tempoUs <= agoraUs)
+      cursor++;
+    const Ponto &a = pontos[cursor];
+    if (cursor + 1 >= pontos.size() || agoraUs <= a.tempoUs)
+      return a.valor;
+    const Ponto &b = pontos[cursor + 1];
+    return a.valor + (b.valor - a.valor) * (double)(agoraUs - a.tempoUs) / (double)(b.tempoUs - a.tempoUs);
+  }
+};
+
+// ==================== Verificações ====================
+enum Regra
+{
+  REGRA_CONFLITO,
+  REGRA_LAMPADAS,
+  REGRA_VERDE_VERMELHO,
+  REGRA_AMARELO_CURTO,
+  REGRA_AMARELO_SEM_VERMELHO,
+  REGRA_VERDE_CURTO,
+  REGRA_APAGADO,
+  REGRA_TEMPO_FASE,
+  REGRA_HISTERESE_ATRASO,
+  REGRA_HISTERESE_ESPURIA,
+  REGRA_COMANDO,
+  REGRA_MQTT_BUFFER,
+  REGRA_HTTP,
+  NUM_REGRAS
+};
+
+const char *const NOMES_REGRAS[NUM_REGRAS] = {
+    "Verdes conflitantes (a cada escrita de GPIO)",
+    "Mais de uma lampada acesa num semaforo",
+    "Verde direto para vermelho",
+    "Amarelo apos verde menor que TEMPO_AMARELO",
+    "Amarelo apos verde sem ir para vermelho",
+    "Verde menor que o verde minimo dos planos",
+    "Semaforo apagado alem do pisca",
+    "Fase no tempo da tabela fora de [min - 1 ms, min + periodo + jitter]",
+    "Histerese: modo nao trocou com a luz alem do limite",
+    "Histerese: modo trocou sem a luz alem do limite",
+    "Comando nao aplicado no prazo ou sem o efeito esperado",
+    "Mensagem MQTT maior que o buffer",
+    "Resposta HTTP de erro",
+};
+
+struct Falhas
+{
+  uint64_t n[NUM_REGRAS] = {};
+  int impressas = 0;
+
+  void registrar(Regra regra, const char *formato, ...) __attribute__((format(printf, 3, 4)))
+  {
+    n[regra]++;
+    if (impressas >= 10)
+      return;
+    impressas++;
+    char texto[256];
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(texto, sizeof(texto), formato, args);
+    va_end(args);
+    printf("  ✗ [%10.3f s] %s: %s\n", sim::agoraUs / 1e6, NOMES_REGRAS[regra], texto);
+  }
+
+  uint64_t total() const
+  {
+    uint64_t t = 0;
+    for (uint64_t v : n)
+      t += v;
+    return t;
+  }
+};
+
+Falhas falhas;
+
+struct Estatistica
+{
+  uint64_t n = 0;
+  double soma = 0;
+  double min = INFINITY;
+  double max = -INFINITY;
+
+  void amostra(double v)
+  {
+    n++;
+    soma += v;
+    min = std::min(min, v);
+    max = std::max(max, v);
+  }
+  double media() const { return n ? soma / n : 0; }
+};
+
+// Pinos de cada grupo (mesma ordem de CONFLITOS)
+const int PINOS_GRUPO[NUM_GRUPOS][3] = {
+    {S1_red, S1_yellow, S1_green},
+    {S2_red, S2_yellow, S2_green},
+};
+
+// Limites tirados dos planos do firmware
+uint32_t menorVerdeMs()
+{
+  uint32_t menor = UINT32_MAX;
+  for (const Plano<NUM_GRUPOS> *p : {&PLANO_NORMAL, &PLANO_ATUADO, &PLANO_NOTURNO})
+    for (size_t f = 0; f < p->numFases; f++)
+      for (size_t g = 0; g < NUM_GRUPOS; g++)
+        if (p->fases[f].grupos[g] == Sinal::Verde)
+          menor = std::min(menor, p->fases[f].minMs);
+  return menor;
+}
+
+uint32_t maiorApagadoMs()
+{
+  uint32_t maior = 0;
+  for (const Plano<NUM_GRUPOS> *p : {&PLANO_NORMAL, &PLANO_ATUADO, &PLANO_NOTURNO})
+    for (size_t f = 0; f < p->numFases; f++)
+      for (size_t g = 0; g < NUM_GRUPOS; g++)
+        if (p->fases[f].grupos[g] == Sinal::Apagado)
+          maior = std::max(maior, p->fases[f].maxMs);
+  return maior;
+}
+
+// Sinal de cada semáforo visto pelos GPIOs
+class Observador
+{
+public:
+  Observador(uint32_t jitterUs)
+      : verdeMinUs((int64_t)menorVerdeMs() * 1000), apagadoMaxUs((int64_t)(maiorApagadoMs() + 2 * PERIODO_CONTROLE_MS) * 1000 + jitterUs)
+  {
+  }
+
+  // A cada digitalWrite: só o conflito, que não pode aparecer nem no meio de
+  // uma troca (os outros estados intermediários são normais)
+  void escrita()
+  {
+    for (size_t a = 0; a < NUM_GRUPOS; a++)
+      for (size_t b = a + 1; b < NUM_GRUPOS; b++)
+        if (CONFLITOS[a][b] && sim::nivel[PINOS_GRUPO[a][2]] && sim::nivel[PINOS_GRUPO[b][2]])
+          falhas.registrar(REGRA_CONFLITO, "S%zu e S%zu em verde", a + 1, b + 1);
+  }
+
+  // No fim de cada passada do controlador
+  void passada(int64_t agoraUs)
+  {
+    for (size_t g = 0; g < NUM_GRUPOS; g++)
+    {
+      Grupo &gr = grupos[g];
+      const int acesas = sim::nivel[PINOS_GRUPO[g][0]] + sim::nivel[PINOS_GRUPO[g][1]] + sim::nivel[PINOS_GRUPO[g][2]];
+      if (acesas > 1)
+      {
+        if (!gr.variasAcesas)
+          falhas.registrar(REGRA_LAMPADAS, "S%zu com %d lampadas", g + 1, acesas);
+        gr.variasAcesas = true;
+        continue;
+      }
+      gr.variasAcesas = false;
+      const Sinal sinal = sim::nivel[PINOS_GRUPO[g][2]]   ? Sinal::Verde
+                          : sim::nivel[PINOS_GRUPO[g][1]] ? Sinal::Amarelo
+                          : sim::nivel[PINOS_GRUPO[g][0]] ? Sinal::Vermelho
+                                                          : Sinal::Apagado;
+      if (!gr.iniciado)
+      {
+        gr = Grupo();
+        gr.iniciado = true;
+        gr.sinal = sinal;
+        gr.desdeUs = agoraUs;
+        continue;
+      }
+      if (sinal == gr.sinal)
+      {
+        if (sinal == Sinal::Apagado && agoraUs - gr.desdeUs > apagadoMaxUs && !gr.apagadoAvisado)
+        {
+          falhas.registrar(REGRA_APAGADO, "S%zu apagado ha %.3f s", g + 1, (agoraUs - gr.desdeUs) / 1e6);
+          gr.apagadoAvisado = true;
+        }
+        continue;
+      }
+      const int64_t duracao = agoraUs - gr.desdeUs;
+      if (gr.sinal == Sinal::Verde)
+      {
+        verdes[g].amostra(duracao / 1e6);
+        if (sinal == Sinal::Vermelho)
+          falhas.registrar(REGRA_VERDE_VERMELHO, "S%zu", g + 1);
+        // Sem tolerância para o millis(): a fase é medida em ms inteiros
+        if (duracao < verdeMinUs - 1000)
+          falhas.registrar(REGRA_VERDE_CURTO, "S%zu verde por %.3f s", g + 1, duracao / 1e6);
+      }
+      else if (gr.sinal == Sinal::Amarelo && gr.anterior == Sinal::Verde)
+      {
+        amarelos.amostra(duracao / 1e6);
+        if (duracao < (int64_t)TEMPO_AMARELO * 1000 - 1000)
+          falhas.registrar(REGRA_AMARELO_CURTO, "S%zu amarelo por %.3f s", g + 1, duracao / 1e6);
+        if (sinal != Sinal::Vermelho)
+          falhas.registrar(REGRA_AMARELO_SEM_VERMELHO, "S%zu amarelo para %s", g + 1,
+                           sinal == Sinal::Verde ? "verde" : "apagado");
+      }
+      gr.anterior = gr.sinal;
+      gr.sinal = sinal;
+      gr.desdeUs = agoraUs;
+      gr.apagadoAvisado = false;
+    }
+  }
+
+  Estatistica verdes[NUM_GRUPOS];
+  Estatistica amarelos;   // Só os que vêm depois de um verde
+
+private:
+  struct Grupo
+  {
+    bool iniciado = false;
+    Sinal sinal = Sinal::Apagado;
+    Sinal anterior = Sinal::Apagado;
+    int64_t desdeUs = 0;
+    bool variasAcesas = false;
+    bool apagadoAvisado = false;
+  };
+
+  Grupo grupos[NUM_GRUPOS];
+  const int64_t verdeMinUs;
+  const int64_t apagadoMaxUs;
+};
+
+// Fases do diário do firmware: duração real x minMs nas que terminaram no
+// tempo da tabela
+class ConferenciaDiario
+{
+public:
+  explicit ConferenciaDiario(uint32_t jitterUs) : atrasoMaxUs((int64_t)PERIODO_CONTROLE_MS * 1000 + jitterUs) {}
+
+  void ler()
+  {
+    static EventoFase eventos[Diario::EVENTOS];
+    const Diario &d = controlador.getDiario();
+    uint32_t primeiro = 0;
+    size_t n = d.ler(proximo, eventos, Diario::EVENTOS, primeiro);
+    if (primeiro != proximo)
+    {
+      perdidos += primeiro - proximo;
+      temAnterior = false;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+      const EventoFase &e = eventos[i];
+      if (temAnterior && e.causa == (uint8_t)CausaFase::Tempo)
+      {
+        const int64_t atraso = (int64_t)(e.tempoUs - anterior.tempoUs) - (int64_t)anterior.minMs * 1000;
+        atrasos.amostra(atraso);
+        if (atraso < -1000 || atraso > atrasoMaxUs)
+          falhas.registrar(REGRA_TEMPO_FASE, "plano %u fase %u: %lld us alem de %u ms", anterior.plano, anterior.fase,
+                           (long long)atraso, anterior.minMs);
+      }
+      causas[e.causa < 6 ? e.causa : 5]++;
+      anterior = e;
+      temAnterior = true;
+    }
+    proximo = primeiro + (uint32_t)n;
+  }
+
+  Estatistica atrasos;
+  uint32_t causas[6] = {};
+  uint32_t perdidos = 0;
+
+private:
+  const int64_t atrasoMaxUs;
+  uint32_t proximo = 0;
+  EventoFase anterior = {};
+  bool temAnterior = false;
+};
+
+// Histerese contra a luz sem ruído, com os faróis, passada por um FiltroLuz
+// igual ao do firmware: um farol curto não pode trocar o modo, mas faróis
+// emendados (ou a cauda da EMA depois deles) por mais que a confirmação podem.
+// "desde" = instante em que a luz filtrada passou a ficar continuamente
+// daquele lado (-1: não está)
+class ConferenciaHisterese
+{
+public:
+  explicit ConferenciaHisterese(const Opcoes &op) : op(op) {}
+
+  // A cada quadro do ADC
+  void luz(double sinal, int64_t agoraUs)
+  {
+    const int v = filtro.amostra((int)std::lround(sinal));
+    atualizar(abaixo, v < entrar - op.folgaLdr, agoraUs);
+    atualizar(acima, v > sair + op.folgaLdr, agoraUs);
+    atualizar(abaixoFolgado, v < entrar + op.folgaLdr, agoraUs);
+    atualizar(acimaFolgado, v > sair - op.folgaLdr, agoraUs);
+  }
+
+  void novosLimites(int e, int s, uint32_t c, int64_t agoraUs)
+  {
+    entrar = e;
+    sair = s;
+    confirmacaoMs = c;
+    abaixo = acima = abaixoFolgado = acimaFolgado = -1;
+    limitesDesdeUs = agoraUs;
+  }
+
+  // A cada passada do controlador
+  void modo(bool automatico, bool noturno, int64_t agoraUs)
+  {
+    const int64_t confirmacaoUs = (int64_t)confirmacaoMs * 1000;
+    if (automatico && !eraAuto)
+      autoDesdeUs = agoraUs;
+    if (automatico && eraAuto && noturno != eraNoturno)
+    {
+      trocaDesdeUs = agoraUs;
+      (noturno ? entradas : saidas)++;
+      const int64_t desde = noturno ? abaixoFolgado : acimaFolgado;
+      if (agoraUs - limitesDesdeUs >= confirmacaoUs + (int64_t)op.assentamentoMs * 1000 &&
+          (desde < 0 || agoraUs - desde < confirmacaoUs))
+        falhas.registrar(REGRA_HISTERESE_ESPURIA, "%s com a luz alem do limite so ha %.3f s",
+                         noturno ? "entrou no noturno" : "saiu do noturno", desde < 0 ? 0.0 : (agoraUs - desde) / 1e6);
+    }
+    eraAuto = automatico;
+    eraNoturno = noturno;
+  }
+
+  // Periódica: luz além do limite há tempo demais sem o modo acompanhar
+  void conferir(int64_t agoraUs)
+  {
+    if (!eraAuto)
+    {
+      atrasado = false;
+      return;
+    }
+    const int64_t prazoUs = (int64_t)(confirmacaoMs + op.assentamentoMs) * 1000;
+    const int64_t desde =
+        std::max(std::max(eraNoturno ? acima : abaixo, trocaDesdeUs), std::max(autoDesdeUs, limitesDesdeUs));
+    const bool devia = (eraNoturno ? acima : abaixo) >= 0 && agoraUs - desde >= prazoUs;
+    if (devia && !atrasado)
+      falhas.registrar(REGRA_HISTERESE_ATRASO, "luz %s do limite ha %.3f s e modo %s", eraNoturno ? "acima" : "abaixo",
+                       (agoraUs - desde) / 1e6, eraNoturno ? "noturno" : "diurno");
+    atrasado = devia;
+  }
+
+  uint32_t entradas = 0;
+  uint32_t saidas = 0;
+
+private:
+  const Opcoes &op;
+  FiltroLuz<5> filtro{LDR_ALFA_EMA};
+  int entrar = LDR_LIMITE_NOTURNO;
+  int sair = LDR_LIMITE_DIURNO;
+  uint32_t confirmacaoMs = LDR_CONFIRMACAO_MS;
+  int64_t abaixo = -1;
+  int64_t acima = -1;
+  int64_t abaixoFolgado = -1;
+  int64_t acimaFolgado = -1;
+  int64_t limitesDesdeUs = 0;
+  int64_t autoDesdeUs = 0;
+  int64_t trocaDesdeUs = 0;
+  bool eraAuto = false;
+  bool eraNoturno = false;
+  bool atrasado = false;
+
+  static void atualizar(int64_t &desde, bool dentro, int64_t agoraUs)
+  {
+    if (!dentro)
+      desde = -1;
+    else if (desde < 0)
+      desde = agoraUs;
+  }
+};
+
+// ==================== Comandos ====================
+enum class Efeito : uint8_t
+{
+  Nenhum,
+  Auto,
+  Normal,
+  Noturno,
+  Atuado,
+  Fixo,
+  Histerese
+};
+
+struct Injecao
+{
+  int64_t injetadoUs;
+  std::string descricao;
+  Efeito efeito;
+  int entrar;
+  int sair;
+  uint32_t confirmacaoMs;
+  bool geraComando;   // O firmware põe na fila (consultas como /status não)
+  uint32_t alvo;      // Número do comando na fila (aplicado quando getRecebidos() chega nele)
+};
+
+Efeito efeitoDe(const std::string &texto, Injecao &inj)
+{
+  std::string t = texto;
+  if (!t.empty() && t[0] == '/')
+    t = t.substr(1);
+  if (t == "auto" || t == "AUTO")
+    return Efeito::Auto;
+  if (t == "normal" || t == "NORMAL")
+    return Efeito::Normal;
+  if (t == "noturno" || t == "NOTURNO")
+    return Efeito::Noturno;
+  if (t == "atuado" || t == "ATUADO")
+    return Efeito::Atuado;
+  if (t == "fixo" || t == "FIXO")
+    return Efeito::Fixo;
+  unsigned long c = LDR_CONFIRMACAO_MS;
+  if (sscanf(t.c_str(), "histerese:%d:%d:%lu", &inj.entrar, &inj.sair, &c) >= 2)
+  {
+    inj.confirmacaoMs = (uint32_t)c;
+    return Efeito::Histerese;
+  }
+  return Efeito::Nenhum;
+}
+
+class Comandos
+{
+public:
+  Comandos(const Opcoes &op, ConferenciaHisterese &histerese) : op(op), histerese(histerese) {}
+
+  void mqtt(const std::string &topico, const std::string &dados)
+  {
+    Injecao inj = nova("mqtt " + topico + " " + dados);
+    if (topico == mqtt_topic_comandos)
+      inj.efeito = efeitoDe(dados, inj);
+    inj.geraComando = inj.efeito != Efeito::Nenhum || topico == mqtt_topic_detectores || topico == mqtt_topic_sync;
+    if (!mqttClient.entregar(topico, dados))
+    {
+      perdidos++;
+      return;
+    }
+    transitoMqtt.push_back(inj);
+    enviados++;
+  }
+
+  void http(const std::string &url)
+  {
+    Injecao inj = nova("http " + url);
+    inj.efeito = efeitoDe(url, inj);
+    inj.geraComando = inj.efeito != Efeito::Nenhum;
+    server.requisitar(url);
+    transitoHttp.push_back(inj);
+    (inj.geraComando ? enviados : consultas)++;
+  }
+
+  // Broker caiu: o que estava a caminho do firmware se perde (QoS 0)
+  void brokerCaiu()
+  {
+    perdidos += transitoMqtt.size();
+    transitoMqtt.clear();
+  }
+
+  // Em volta de passadaRede(): as mensagens entregues nela viraram (ou não)
+  // comandos na fila. handleClient() roda antes de mqttClient.loop()
+  void entregues(uint32_t http, uint32_t mqtt, uint32_t naFilaAntes, uint32_t naFilaDepois)
+  {
+    std::vector<Injecao> lote;
+    for (uint32_t i = 0; i < http && !transitoHttp.empty(); i++)
+    {
+      lote.push_back(transitoHttp.front());
+      transitoHttp.pop_front();
+    }
+    for (uint32_t i = 0; i < mqtt && !transitoMqtt.empty(); i++)
+    {
+      lote.push_back(transitoMqtt.front());
+      transitoMqtt.pop_front();
+    }
+    uint32_t esperados = 0;
+    for (const Injecao &inj : lote)
+      esperados += inj.geraComando;
+    // Todos na fila: um número para cada, na ordem. Senão (raro: dois na
+    // mesma passada e um recusado) todos esperam o último
+    const uint32_t novos = naFilaDepois - naFilaAntes;
+    uint32_t proximo = naFilaAntes;
+    for (Injecao &inj : lote)
+    {
+      if (!inj.geraComando)
+        continue;
+      if (novos == 0)
+      {
+        rejeitados++;   // Recusado pelo firmware (ex.: histerese inválida)
+        continue;
+      }
+      inj.alvo = novos == esperados ? ++proximo : naFilaDepois;
+      aguardando.push_back(inj);
+    }
+  }
+
+  // Depois de cada passada do controlador
+  void aplicados(int64_t agoraUs)
+  {
+    const uint32_t recebidos = filaComandos.getRecebidos();
+    while (!aguardando.empty() && (int32_t)(recebidos - aguardando.front().alvo) >= 0)
+    {
+      const Injecao &inj = aguardando.front();
+      const int64_t latencia = agoraUs - inj.injetadoUs;
+      latencias.amostra(latencia / 1000.0);
+      if (latencia > (int64_t)op.latenciaMs * 1000)
+        falhas.registrar(REGRA_COMANDO, "%s aplicado depois de %.3f ms", inj.descricao.c_str(), latencia / 1000.0);
+      if (!confere(inj))
+        falhas.registrar(REGRA_COMANDO, "%s sem efeito", inj.descricao.c_str());
+      if (inj.efeito == Efeito::Histerese && inj.entrar < inj.sair)
+        histerese.novosLimites(inj.entrar, inj.sair, inj.confirmacaoMs, agoraUs);
+      aplicadosTotal++;
+      aguardando.pop_front();
+    }
+  }
+
+  // Periódica: nada pode ficar preso no caminho
+  void conferir(int64_t agoraUs)
+  {
+    const int64_t prazoUs = (int64_t)op.latenciaMs * 1000 + 1000000;
+    for (std::deque<Injecao> *d : {&transitoMqtt, &transitoHttp, &aguardando})
+      while (!d->empty() && agoraUs - d->front().injetadoUs > prazoUs)
+      {
+        falhas.registrar(REGRA_COMANDO, "%s nao aplicado em %.3f s", d->front().descricao.c_str(),
+                         (agoraUs - d->front().injetadoUs) / 1e6);
+        d->pop_front();
+      }
+  }
+
+  Estatistica latencias;   // ms
+  uint32_t enviados = 0;
+  uint32_t consultas = 0;
+  uint32_t perdidos = 0;
+  uint32_t rejeitados = 0;
+  uint32_t aplicadosTotal = 0;
+
+private:
+  const Opcoes &op;
+  ConferenciaHisterese &histerese;
+  std::deque<Injecao> transitoMqtt;
+  std::deque<Injecao> transitoHttp;
+  std::deque<Injecao> aguardando;
+
+  Injecao nova(const std::string &descricao)
+  {
+    Injecao inj = {};
+    inj.injetadoUs = sim::agoraUs;
+    inj.descricao = descricao;
+    inj.efeito = Efeito::Nenhum;
+    return inj;
+  }
+
+  static bool confere(const Injecao &inj)
+  {
+    switch (inj.efeito)
+    {
+    case Efeito::Auto:
+      return controlador.isModoAuto();
+    case Efeito::Normal:
+      return controlador.isModoNormal();
+    case Efeito::Noturno:
+      return controlador.isModoNoturno() && !controlador.isModoAuto();
+    case Efeito::Atuado:
+      return controlador.isControleAtuado();
+    case Efeito::Fixo:
+      return !controlador.isControleAtuado();
+    case Efeito::Histerese:
+    {
+      // Limites invertidos o firmware recusa antes da fila
+      const SemaforoInteligente::Telemetria t = controlador.getTelemetria();
+      return inj.entrar >= inj.sair || (t.limiteNoturno == inj.entrar && t.limiteDiurno == inj.sair);
+    }
+    default:
+      return true;
+    }
+  }
+};
+
+// ==================== Roteiro ====================
+// Uma ação por linha: <tempo> <ação>, com o tempo desde a partida em ms, s
+// (padrão), min, h ou d:
+//   30min mqtt semaforo/comandos noturno
+//   2h    http /auto
+//   3h    broker off          (e "broker on")
+//   4h    ldr 1500            (luz fixa; "ldr auto" volta ao traço)
+struct PassoRoteiro
+{
+  int64_t tempoUs;
+  std::string acao;
+  std::vector<std::string> args;
+};
+
+bool lerTempo(const std::string &texto, int64_t &us)
+{
+  char *fim = nullptr;
+  double v = strtod(texto.c_str(), &fim);
+  std::string unidade = fim;
+  double escala = unidade == "ms"    ? 1e3
+                  : unidade == "" || unidade == "s" ? 1e6
+                  : unidade == "min" ? 60e6
+                  : unidade == "h"   ? 3600e6
+                  : unidade == "d"   ? 86400e6
+                                     : -1;
+  if (fim == texto.c_str() || escala < 0 || v < 0)
+    return false;
+  us = (int64_t)(v * escala);
+  return true;
+}
+
+bool lerRoteiro(const std::string &caminho, std::vector<PassoRoteiro> &passos)
+{
+  std::ifstream arquivo(caminho);
+  if (!arquivo)
+  {
+    fprintf(stderr, "Nao foi possivel abrir o roteiro %s\n", caminho.c_str());
+    return false;
+  }
+  std::string linha;
+  for (int n = 1; std::getline(arquivo, linha); n++)
+  {
+    linha = linha.substr(0, linha.find('#'));
+    std::stringstream ss(linha);
+    std::string tempo;
+    PassoRoteiro p;
+    if (!(ss >> tempo))
+      continue;
+    std::string arg;
+    ss >> p.acao;
+    while (ss >> arg)
+      p.args.push_back(arg);
+    const size_t argsEsperados = p.acao == "mqtt" ? 2 : 1;
+    if (!lerTempo(tempo, p.tempoUs) || p.args.size() < argsEsperados ||
+        (p.acao != "mqtt" && p.acao != "http" && p.acao != "broker" && p.acao != "ldr"))
+    {
+      fprintf(stderr, "%s:%d: linha invalida: %s\n", caminho.c_str(), n, linha.c_str());
+      return false;
+    }
+    // O payload do MQTT pode ter espaços
+    for (size_t i = 2; p.acao == "mqtt" && i < p.args.size(); i++)
+      p.args[1] += " " + p.args[i];
+    passos.push_back(p);
+  }
+  return true;
+}
+
+// ==================== Simulação ====================
+Observador *observador = nullptr;
+
+void aoEscreverGpio(int, int)
+{
+  observador->escrita();
+}
+
+struct Contagem
+{
+  uint64_t controle = 0;
+  uint64_t rede = 0;
+  uint64_t loops = 0;
+  uint64_t quadros = 0;
+  uint64_t veiculos[NUM_GRUPOS] = {};
+  uint64_t painel = 0;
+  uint64_t eventos = 0;
+};
+
+int main(int argc, char **argv)
+{
+  Opcoes op;
+  for (int i = 1; i < argc; i++)
+  {
+    const bool temValor = i + 1 < argc;
+    if (!strcmp(argv[i], "--horas") && temValor)
+      op.horas = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--dias") && temValor)
+      op.horas = 24 * atof(argv[++i]);
+    else if (!strcmp(argv[i], "--semente") && temValor)
+      op.semente = (unsigned)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--jitter-us") && temValor)
+      op.jitterUs = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--ldr") && temValor)
+      op.ldr = argv[++i];
+    else if (!strcmp(argv[i], "--hora-inicial") && temValor)
+      op.horaInicial = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--ruido") && temValor)
+      op.ruido = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--farois-hora") && temValor)
+      op.faroisHora = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--roteiro") && temValor)
+      op.roteiro = argv[++i];
+    else if (!strcmp(argv[i], "--comandos-hora") && temValor)
+      op.comandosHora = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--veiculos-hora") && temValor)
+      op.veiculosHora = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--painel-s") && temValor)
+      op.painelS = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--sem-broker"))
+      op.semBroker = true;
+    else if (!strcmp(argv[i], "--sem-adc-continuo"))
+      op.semAdcContinuo = true;
+    else if (!strcmp(argv[i], "--millis-inicial") && temValor)
+      op.millisInicial = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--folga-ldr") && temValor)
+      op.folgaLdr = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--assentamento-ms") && temValor)
+      op.assentamentoMs = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--latencia-ms") && temValor)
+      op.latenciaMs = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--log") && temValor)
+      op.log = argv[++i];
+    else
+    {
+      fprintf(stderr,
+              "Uso: %s [--horas H | --dias D] [--semente S] [--jitter-us US]\n"
+              "          [--ldr TRACO.csv] [--hora-inicial H] [--ruido R] [--farois-hora N]\n"
+              "          [--roteiro ARQ] [--comandos-hora N] [--veiculos-hora N] [--painel-s S]\n"
+              "          [--sem-broker] [--sem-adc-continuo] [--millis-inicial MS]\n"
+              "          [--folga-ldr N] [--assentamento-ms MS] [--latencia-ms MS] [--log ARQ|-]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (op.horas <= 0 || op.jitterUs >= PERIODO_CONTROLE_MS * 1000 || op.ruido < 0 || op.faroisHora < 0 ||
+      op.comandosHora < 0 || op.veiculosHora < 0 || op.painelS < 0)
+  {
+    fprintf(stderr, "Parametros invalidos (jitter menor que o periodo de %lu ms, taxas >= 0)\n",
+            (unsigned long)PERIODO_CONTROLE_MS);
+    return 2;
+  }
+
+  std::mt19937 gen(op.semente);
+  Luz luz(op, gen);
+  if (!op.ldr.empty() && !luz.carregar(op.ldr))
+  {
+    fprintf(stderr, "Traco de LDR vazio ou inexistente: %s\n", op.ldr.c_str());
+    return 2;
+  }
+  std::vector<PassoRoteiro> roteiro;
+  if (!op.roteiro.empty() && !lerRoteiro(op.roteiro, roteiro))
+    return 2;
+  FILE *arquivoLog = nullptr;
+  if (!op.log.empty())
+  {
+    arquivoLog = op.log == "-" ? stdout : fopen(op.log.c_str(), "w");
+    if (!arquivoLog)
+    {
+      fprintf(stderr, "Nao foi possivel criar %s\n", op.log.c_str());
+      return 2;
+    }
+  }
+
+  Observador obs(op.jitterUs);
+  observador = &obs;
+  ConferenciaDiario diario(op.jitterUs);
+  ConferenciaHisterese histerese(op);
+  Comandos comandos(op, histerese);
+  Contagem cont;
+
+  // Placa na partida: pinos, LDR, broker e ADC como nas opções
+  sim::millisInicial = op.millisInicial;
+  sim::aoEscrever = aoEscreverGpio;
+  sim::adcContinuoDisponivel = !op.semAdcContinuo;
+  sim::brokerDisponivel = !op.semBroker;
+  sim::saidaLog = arquivoLog;
+  luz.avancar(0, 0);
+  sim::adc[LDR_PIN] = luz.getAdc();
+
+  const auto inicioReal = std::chrono::steady_clock::now();
+  setup();
+  bool temControle = false;
+  bool temRede = false;
+  for (int i = 0; i < sim::numTarefas; i++)
+  {
+    temControle |= sim::tarefas[i].funcao == tarefaControle;
+    temRede |= sim::tarefas[i].funcao == tarefaRede;
+  }
+  if (!temControle || !temRede)
+  {
+    fprintf(stderr, "setup() nao criou as tarefas do controlador e da rede\n");
+    return 1;
+  }
+
+  // O relógio já passou do delay() do setup(); as tarefas começam agora
+  const int64_t fimUs = (int64_t)(op.horas * 3600e6);
+  const int64_t periodoUs = (int64_t)PERIODO_CONTROLE_MS * 1000;
+  // Sem ADC contínuo a luz muda no ritmo do analogRead() do firmware, para o
+  // filtro da conferência da histerese ver as mesmas amostras
+  const int64_t quadroUs = sim::adcContinuoAtivo ? (int64_t)sim::adcConversoes * 1000000 / sim::adcFrequenciaHz
+                                                 : (int64_t)LDR_PERIODO_MS * 1000;
+  std::exponential_distribution<double> chegada(op.veiculosHora > 0 ? op.veiculosHora / 3600e6 : 1);
+  std::exponential_distribution<double> farol(op.faroisHora > 0 ? op.faroisHora / 3600e6 : 1);
+  std::exponential_distribution<double> aleatorio(op.comandosHora > 0 ? op.comandosHora / 3600e6 : 1);
+  std::uniform_int_distribution<uint32_t> jitter(0, op.jitterUs);
+
+  Agenda agenda;
+  const int64_t partidaUs = sim::agoraUs;
+  int64_t proximoTick = (partidaUs / periodoUs + 1) * periodoUs;
+  agenda.agendar(proximoTick + jitter(gen), TipoEvento::Controle);
+  agenda.agendar(partidaUs, TipoEvento::Rede);
+  agenda.agendar(partidaUs, TipoEvento::Loop);
+  agenda.agendar(partidaUs, TipoEvento::QuadroAdc);
+  agenda.agendar(partidaUs, TipoEvento::Verificacao);
+  if (op.faroisHora > 0)
+    agenda.agendar(partidaUs + (int64_t)farol(gen), TipoEvento::Farol);
+  for (uint32_t g = 0; op.veiculosHora > 0 && g < NUM_GRUPOS; g++)
+    agenda.agendar(partidaUs + (int64_t)chegada(gen), TipoEvento::Veiculo, g);
+  if (op.comandosHora > 0)
+    agenda.agendar(partidaUs + (int64_t)aleatorio(gen), TipoEvento::Aleatorio);
+  if (op.painelS > 0)
+    agenda.agendar(partidaUs + (int64_t)(op.painelS * 1e6), TipoEvento::Painel);
+  for (size_t i = 0; i < roteiro.size(); i++)
+    agenda.agendar(std::max(roteiro[i].tempoUs, partidaUs), TipoEvento::Roteiro, (uint32_t)i);
+
+  int64_t anteriorControle = 0;
+  uint64_t amostrasCusto = 0;
+  double nsControle = 0;
+  uint32_t trocasModo = 0;
+  bool noturnoAnterior = controlador.isModoNoturno();
+  const int pinoDetector[NUM_GRUPOS] = {DET_S1, DET_S2};
+  const char *const ALEATORIOS[] = {"auto", "auto", "auto", "normal", "noturno", "atuado", "fixo"};
+
+  Evento e;
+  while (agenda.proximo(e) && e.tempoUs <= fimUs)
+  {
+    sim::agoraUs = e.tempoUs;
+    cont.eventos++;
+    switch (e.tipo)
+    {
+    case TipoEvento::Controle:
+    {
+      // 1 em 64 passadas cronometradas (o relógio do PC custa mais que a passada)
+      if ((cont.controle & 63) == 0)
+      {
+        const auto t0 = std::chrono::steady_clock::now();
+        passadaControle(anteriorControle);
+        nsControle += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        amostrasCusto++;
+      }
+      else
+      {
+        passadaControle(anteriorControle);
+      }
+      cont.controle++;
+      obs.passada(e.tempoUs);
+      const bool automatico = controlador.isModoAuto();
+      const bool noturno = controlador.isModoNoturno();
+      histerese.modo(automatico, noturno, e.tempoUs);
+      trocasModo += noturno != noturnoAnterior;
+      noturnoAnterior = noturno;
+      comandos.aplicados(e.tempoUs);
+      // vTaskDelayUntil: a grade de 1 ms não acumula o atraso da passada
+      proximoTick += periodoUs;
+      agenda.agendar(proximoTick + jitter(gen), TipoEvento::Controle);
+      break;
+    }
+    case TipoEvento::Rede:
+    {
+      const uint32_t http0 = server.getAtendidas();
+      const uint32_t mqtt0 = mqttClient.getEntregues();
+      const uint32_t fila0 = filaComandos.getEnviados();
+      passadaRede();
+      cont.rede++;
+      const uint32_t http = server.getAtendidas() - http0;
+      if (http > 0 && server.getResposta().codigo >= 400)
+        falhas.registrar(REGRA_HTTP, "%d", server.getResposta().codigo);
+      comandos.entregues(http, mqttClient.getEntregues() - mqtt0, fila0, filaComandos.getEnviados());
+      agenda.agendar(e.tempoUs + 2000, TipoEvento::Rede);
+      break;
+    }
+    case TipoEvento::Loop:
+      loop();
+      cont.loops++;
+      agenda.agendar(e.tempoUs + 10000000, TipoEvento::Loop);
+      break;
+    case TipoEvento::QuadroAdc:
+      luz.avancar(e.tempoUs, quadroUs / 1e6);
+      histerese.luz(luz.getSinal(), e.tempoUs);
+      sim::adc[LDR_PIN] = luz.getAdc();
+      if (sim::adcContinuoAtivo)
+      {
+        sim::quadroAdc.avg_read_raw = luz.getAdc();
+        sim::adcQuadroPronto();
+      }
+      cont.quadros++;
+      agenda.agendar(e.tempoUs + quadroUs, TipoEvento::QuadroAdc);
+      break;
+    case TipoEvento::Farol:
+      luz.farol(e.tempoUs);
+      agenda.agendar(e.tempoUs + (int64_t)farol(gen), TipoEvento::Farol);
+      break;
+    case TipoEvento::Veiculo:
+    {
+      // Pulso para o GND no detector (borda de descida)
+      const int pino = pinoDetector[e.dado];
+      sim::nivel[pino] = LOW;
+      if (sim::isr[pino] && sim::bordaIsr[pino] != RISING)
+        sim::isr[pino]();
+      sim::nivel[pino] = HIGH;
+      cont.veiculos[e.dado]++;
+      agenda.agendar(e.tempoUs + (int64_t)chegada(gen), TipoEvento::Veiculo, e.dado);
+      break;
+    }
+    case TipoEvento::Roteiro:
+    {
+      const PassoRoteiro &p = roteiro[e.dado];
+      if (p.acao == "mqtt")
+        comandos.mqtt(p.args[0], p.args[1]);
+      else if (p.acao == "http")
+        comandos.http(p.args[0]);
+      else if (p.acao == "broker")
+      {
+        sim::brokerDisponivel = p.args[0] == "on";
+        if (!sim::brokerDisponivel)
+          comandos.brokerCaiu();
+      }
+      else if (p.acao == "ldr")
+        luz.fixar(p.args[0] == "auto" ? -1 : atof(p.args[0].c_str()));
+      break;
+    }
+    case TipoEvento::Aleatorio:
+    {
+      // Modo e tempo fixo/atuado, metade por MQTT e metade pelo painel;
+      // às vezes uma contagem de veículos por MQTT
+      const std::string c = ALEATORIOS[std::uniform_int_distribution<int>(0, 6)(gen)];
+      const int canal = std::uniform_int_distribution<int>(0, 9)(gen);
+      if (canal == 0)
+        comandos.mqtt(mqtt_topic_detectores, std::string(gen() % 2 ? "S1:" : "S2:") + std::to_string(1 + gen() % 5));
+      else if (canal <= 5)
+        comandos.mqtt(mqtt_topic_comandos, c);
+      else
+        comandos.http("/" + c);
+      agenda.agendar(e.tempoUs + (int64_t)aleatorio(gen), TipoEvento::Aleatorio);
+      break;
+    }
+    case TipoEvento::Painel:
+      comandos.http("/status");
+      cont.painel++;
+      agenda.agendar(e.tempoUs + (int64_t)(op.painelS * 1e6), TipoEvento::Painel);
+      break;
+    case TipoEvento::Verificacao:
+      diario.ler();
+      histerese.conferir(e.tempoUs);
+      comandos.conferir(e.tempoUs);
+      agenda.agendar(e.tempoUs + 100000, TipoEvento::Verificacao);
+      break;
+    }
+  }
+  sim::agoraUs = fimUs;
+  diario.ler();
+  if (mqttClient.getGrandesDemais() > 0)
+    falhas.registrar(REGRA_MQTT_BUFFER, "%u mensagens recusadas", mqttClient.getGrandesDemais());
+  const double segundosReais = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicioReal).count();
+  if (arquivoLog && arquivoLog != stdout)
+    fclose(arquivoLog);
+
+  // ==================== Relatório ====================
+  const SemaforoInteligente::Telemetria t = controlador.getTelemetria();
+  printf("\nSemaforo Inteligente: firmware completo, %.1f h simuladas em %.2f s (%.0fx)\n", op.horas, segundosReais,
+         op.horas * 3600 / segundosReais);
+  printf("  LDR %s, jitter do tick 0-%u us, semente %u%s%s\n",
+         op.ldr.empty() ? "sintetico (dia/noite, nuvens, ruido, farois)" : op.ldr.c_str(), op.jitterUs, op.semente,
+         sim::adcContinuoAtivo ? "" : ", analogRead (sem ADC continuo)", op.semBroker ? ", sem broker" : "");
+  printf("  %llu eventos: %llu passadas do controlador, %llu da rede, %llu quadros do ADC, %llu loop()\n",
+         (unsigned long long)cont.eventos, (unsigned long long)cont.controle, (unsigned long long)cont.rede,
+         (unsigned long long)cont.quadros, (unsigned long long)cont.loops);
+  printf("\nFases (diario do firmware)\n");
+  printf("  %u trocas: %u no tempo, %u onda verde, %u gap-out, %u max-out, %u trocas de plano\n",
+         controlador.getDiario().proxima(), diario.causas[1], diario.causas[2], diario.causas[3], diario.causas[4],
+         diario.causas[5]);
+  printf("  Atraso das fases no tempo da tabela: media %.1f us, pior %.0f us (firmware: %ld us)\n",
+         diario.atrasos.media(), diario.atrasos.n ? diario.atrasos.max : 0.0, (long)t.atrasoTrocaMaxUs);
+  for (size_t g = 0; g < NUM_GRUPOS; g++)
+    printf("  Verdes S%zu: %llu, de %.3f a %.3f s (media %.3f s)\n", g + 1, (unsigned long long)obs.verdes[g].n,
+           obs.verdes[g].n ? obs.verdes[g].min : 0.0, obs.verdes[g].n ? obs.verdes[g].max : 0.0, obs.verdes[g].media());
+  printf("  Amarelos depois do verde: %llu, de %.3f a %.3f s\n", (unsigned long long)obs.amarelos.n,
+         obs.amarelos.n ? obs.amarelos.min : 0.0, obs.amarelos.n ? obs.amarelos.max : 0.0);
+  printf("  Jitter medido pelo firmware: pior %lu us\n", (unsigned long)t.jitterMaxUs);
+  printf("\nModo e comandos\n");
+  printf("  %u trocas de modo (histerese: %u entradas e %u saidas do noturno), %u farois no LDR\n", trocasModo,
+         histerese.entradas, histerese.saidas, luz.getFarois());
+  printf("  %u comandos enviados: %u aplicados (latencia media %.3f ms, pior %.3f ms), %u rejeitados, %u perdidos\n",
+         comandos.enviados, comandos.aplicadosTotal, comandos.latencias.media(),
+         comandos.latencias.n ? comandos.latencias.max : 0.0, comandos.rejeitados, comandos.perdidos);
+  printf("  Veiculos: S1 %llu gerados / %lu contados, S2 %llu / %lu; gap-out %lu, max-out %lu\n",
+         (unsigned long long)cont.veiculos[0], (unsigned long)t.veiculosS1, (unsigned long long)cont.veiculos[1],
+         (unsigned long)t.veiculosS2, (unsigned long)t.gapOuts, (unsigned long)t.maxOuts);
+  printf("\nRede\n");
+  printf("  HTTP: %u requisicoes atendidas (%llu do painel)\n", server.getAtendidas(), (unsigned long long)cont.painel);
+  printf("  MQTT: %u conexoes em %u tentativas", mqttClient.getConexoes(), mqttClient.getTentativas());
+  for (const auto &p : mqttClient.getPublicados())
+    printf(", %s %u (%.1f kB)", p.first.c_str(), p.second.mensagens, p.second.bytes / 1024.0);
+  printf("\n  Historico: %lu amostras (%lu perdidas); diario: %u eventos perdidos antes da leitura\n",
+         (unsigned long)historico.proxima(), (unsigned long)historico.getPerdidas(), diario.perdidos);
+  printf("\nCusto: %.0f ns por passada do controlador (%llu amostras)\n",
+         amostrasCusto ? nsControle / amostrasCusto : 0.0, (unsigned long long)amostrasCusto);
+
+  printf("\nVerificacoes\n");
+  for (int r = 0; r < NUM_REGRAS; r++)
+    printf("  %s %s: %llu\n", falhas.n[r] ? "✗" : "✓", NOMES_REGRAS[r], (unsigned long long)falhas.n[r]);
+  return falhas.total() == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Leitor dos eventos gravados no microSD pela ESP32-CAM (firmware/SdEventRecorder.h).
+
+Cada evento é um arquivo /events/evt_NNNNN.evr com o histórico pré-disparo, o frame
+do disparo (tirado com flash) e os frames pós-disparo. O índice no rodapé permite
+abrir qualquer frame direto; se o rodapé não existir (energia caiu durante a
+gravação), os frames são recuperados percorrendo os registros em sequência.
+
+Uso:
+    # Lista os frames de um ou mais eventos
+    python event_reader.py list /media/sd/events/*.evr
+
+    # Extrai os JPEGs (evt_00003_07_pre_-1400ms.jpg, ...)
+    python event_reader.py extract /media/sd/events/evt_00003.evr --out frames/
+
+    # Gera um vídeo MJPEG/AVI para revisão (pip install opencv-python)
+    python event_reader.py video /media/sd/events/evt_00003.evr --out evento.avi
+"""
+
+import argparse
+import glob
+import os
+import struct
+
+HEADER = struct.Struct("<4sHHII")      # "EVR1", versão, motivo, millis do disparo, reservado
+RECORD = struct.Struct("<4sIiB3x")     # "FRM1", tamanho, ms relativos, tipo
+INDEX = struct.Struct("<IIiB3x")       # offset do JPEG, tamanho, ms relativos, tipo
+FOOTER = struct.Struct("<II4s")        # número de frames, offset do índice, "EVRI"
+
+KINDS = {0: "pre", 1: "trigger", 2: "post"}
+REASONS = {0: "botão", 1: "PIR"}
+
+
+class Event:
+    def __init__(self, path):
+        self.path = path
+        with open(path, "rb") as f:
+            self.data = f.read()
+
+        if len(self.data) < HEADER.size:
+            raise ValueError(f"{path}: arquivo truncado")
+        magic, self.version, reason, self.trigger_millis, _ = HEADER.unpack_from(self.data, 0)
+        if magic != b"EVR1":
+            raise ValueError(f"{path}: não é um evento (.evr)")
+        self.reason = REASONS.get(reason, str(reason))
+
+        self.recovered = False
+        self.frames = self._read_index()
+        if self.frames is None:
+            self.recovered = True
+            self.frames = self._scan_records()
+
+    def _read_index(self):
+        # O rodapé normalmente fecha o arquivo, mas depois de uma escrita que
+        # falhou (cartão cheio) o firmware grava o índice por cima do registro
+        # incompleto e o resto dele fica depois do rodapé: procura de trás para
+        # frente o "EVRI" cujo índice termina exatamente nele
+        end = len(self.data)
+        while True:
+            pos = self.data.rfind(b"EVRI", HEADER.size + FOOTER.size - 4, end)
+            if pos < 0:
+                return None
+            footer = pos + 4 - FOOTER.size
+            count, index_offset, _ = FOOTER.unpack_from(self.data, footer)
+            if index_offset >= HEADER.size and index_offset + count * INDEX.size == footer:
+                return [INDEX.unpack_from(self.data, index_offset + i * INDEX.size) for i in range(count)]
+            end = pos + 3
+
+    def _scan_records(self):
+        frames = []
+        pos = HEADER.size
+        while pos + RECORD.size <= len(self.data):
+            magic, length, time_ms, kind = RECORD.unpack_from(self.data, pos)
+            start = pos + RECORD.size
+            if magic != b"FRM1" or start + length > len(self.data):
+                break
+            frames.append((start, length, time_ms, kind))
+            pos = start + length
+        return frames
+
+    def jpeg(self, frame):
+        offset, length, _, _ = frame
+        return self.data[offset:offset + length]
+
+
+def expand(patterns):
+    paths = []
+    for pattern in patterns:
+        paths.extend(sorted(glob.glob(pattern)) or [pattern])
+    return paths
+
+
+def cmd_list(args):
+    for path in expand(args.events):
+        event = Event(path)
+        total = sum(f[1] for f in event.frames)
+        note = " (sem rodapé: recuperado por varredura)" if event.recovered else ""
+        print(f"{path}: disparo por {event.reason}, {len(event.frames)} frames, {total / 1024:.0f} KB{note}")
+        for i, (_, length, time_ms, kind) in enumerate(event.frames):
+            print(f"  {i:3d}  {KINDS.get(kind, kind):8s} {time_ms:+7d} ms  {length / 1024:6.1f} KB")
+
+
+def cmd_extract(args):
+    os.makedirs(args.out, exist_ok=True)
+    for path in expand(args.events):
+        event = Event(path)
+        base = os.path.splitext(os.path.basename(path))[0]
+        for i, frame in enumerate(event.frames):
+            name = f"{base}_{i:02d}_{KINDS.get(frame[3], frame[3])}_{frame[2]}ms.jpg"
+            with open(os.path.join(args.out, name), "wb") as f:
+                f.write(event.jpeg(frame))
+        print(f"{path}: {len(event.frames)} frames extraídos para {args.out}")
+
+
+def cmd_video(args):
+    try:
+        import cv2
+        import numpy as np
+    except ImportError:
+        print("Erro: instale opencv-python e numpy para gerar vídeo")
+        exit(1)
+
+    event = Event(args.event)
+    images = [cv2.imdecode(np.frombuffer(event.jpeg(f), np.uint8), cv2.IMREAD_COLOR) for f in event.frames]
+    images = [img for img in images if img is not None]
+    if not images:
+        print("Nenhum frame decodificável")
+        exit(1)
+
+    height, width = images[0].shape[:2]
+    writer = cv2.VideoWriter(args.out, cv2.VideoWriter_fourcc(*"MJPG"), args.fps, (width, height))
+    for img, frame in zip(images, event.frames):
+        img = cv2.resize(img, (width, height))
+        cv2.putText(img, f"{KINDS.get(frame[3], frame[3])} {frame[2]:+d} ms", (10, 30),
+                    cv2.FONT_HERSHEY_SIMPLEX, 0.8, (0, 0, 255) if frame[3] == 1 else (255, 255, 255), 2)
+        writer.write(img)
+    writer.release()
+    print(f"Vídeo salvo em {args.out} ({len(images)} frames)")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Leitor de eventos .evr gravados no microSD")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_list = sub.add_parser("list", help="Lista os frames dos eventos")
+    p_list.add_argument("events", nargs="+")
+
+    p_extract = sub.add_parser("extract", help="Extrai os JPEGs")
+    p_extract.add_argument("events", nargs="+")
+    p_extract.add_argument("--out", default="frames")
+
+    p_video = sub.add_parser("video", help="Gera um vídeo AVI do evento")
+    p_video.add_argument("event")
+    p_video.add_argument("--out", default="evento.avi")
+    p_video.add_argument("--fps", type=float, default=5)
+
+    args = parser.parse_args()
+    {"list": cmd_list, "extract": cmd_extract, "video": cmd_video}[args.command](args)
+
+
+if __name__ == "__main__":
+    main()
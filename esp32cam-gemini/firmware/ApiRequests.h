@@ -0,0 +1,79 @@
+#ifndef API_REQUESTS_H
+#define API_REQUESTS_H
+
+#include <Arduino.h>
+#include "StreamingBody.h"
+
+// Montagem das requisições para o Gemini e para a plataforma web, e leitura da
+// resposta do modelo. Fica fora do sketch para que o mesmo código rode no
+// build nativo de ../host (benchmark contra ../mock_server.py, sem hardware).
+
+// Cabeçalhos de um POST com keep-alive; o corpo vem logo em seguida
+inline String buildPostHead(const String &path, const char *host, const char *contentType, size_t contentLength)
+{
+  return String("POST ") + path + " HTTP/1.1\r\n" +
+         "Host: " + String(host) + "\r\n" +
+         "Content-Type: " + String(contentType) + "\r\n" +
+         "Content-Length: " + String((unsigned long)contentLength) + "\r\n" +
+         "Connection: keep-alive\r\n\r\n";
+}
+
+// Payload JSON esperado pela API do Gemini, com o JPEG em base64 gerado durante o envio
+// Instrução: responder apenas "person" ou "no_person"
+inline StreamingBody buildGeminiBody(const uint8_t *jpeg, size_t len)
+{
+  String prefix = "{";
+  prefix += "\"contents\":[{\"parts\":[";
+  prefix += "{\"text\":\"Responda exatamente 'person' se houver pelo menos uma pessoa humana visível na imagem, ";
+  prefix += "ou 'no_person' se não houver nenhuma pessoa. Não explique, não adicione nada além dessas palavras.\"},";
+  prefix += "{\"inline_data\":{";
+  prefix += "\"mime_type\":\"image/jpeg\",";
+  prefix += "\"data\":\"";
+  return StreamingBody(prefix, jpeg, len, "\"}}]}]}");
+}
+
+// Caminho incluindo a API key na query string
+inline String buildGeminiPath(const char *modelPath, const char *apiKey)
+{
+  return String(modelPath) + "?key=" + apiKey;
+}
+
+// Payload de /api/upload (a imagem em base64 é gerada durante o envio)
+// ageSeconds > 0 só em capturas enviadas em lote
+inline StreamingBody buildUploadBody(const uint8_t *jpeg, size_t len, const char *decision, const char *captureId,
+                                     uint32_t ageSeconds, float batteryVoltage, int batteryPercentage)
+{
+  String suffix = "\",";
+  suffix += "\"decision\":\"" + String(decision) + "\",";
+  suffix += "\"capture_id\":\"" + String(captureId) + "\",";
+  if (ageSeconds > 0)
+  {
+    suffix += "\"age_s\":" + String((unsigned long)ageSeconds) + ",";
+  }
+  suffix += "\"battery\":{";
+  suffix += "\"voltage\":" + String(batteryVoltage, 3) + ",";
+  suffix += "\"percentage\":" + String(batteryPercentage);
+  suffix += "}";
+  suffix += "}";
+  return StreamingBody("{\"image\":\"data:image/jpeg;base64,", jpeg, len, suffix);
+}
+
+// Payload de /api/decision (decisão de uma imagem enviada como "pending")
+inline String buildDecisionBody(const char *captureId, const char *decision)
+{
+  return String("{\"capture_id\":\"") + captureId + "\",\"decision\":\"" + decision + "\"}";
+}
+
+// Texto do modelo: "no_person" => não há pessoa; "person" => há pessoa
+inline bool geminiAnswerIsPerson(String answer)
+{
+  answer.trim();
+  answer.toLowerCase();
+  if (answer.indexOf("no_person") != -1)
+  {
+    return false;
+  }
+  return answer.indexOf("person") != -1;
+}
+
+#endif // API_REQUESTS_H
@@ -0,0 +1,205 @@
+#ifndef BURST_CAPTURE_H
+#define BURST_CAPTURE_H
+
+#include <Arduino.h>
+#include <math.h>
+#include <JpegLuma.h>
+#include "esp_camera.h"
+#include "esp_timer.h"
+
+#ifndef BURST_TIMEOUT
+#define BURST_TIMEOUT 1000              // ms - Limite da rajada (câmera travada, sem frames)
+#endif
+#ifndef BURST_CLIP_LOW
+#define BURST_CLIP_LOW 16               // Luma abaixo disso conta como preto estourado
+#endif
+#ifndef BURST_CLIP_HIGH
+#define BURST_CLIP_HIGH 240             // Luma acima disso conta como branco estourado
+#endif
+
+// Rajada de frames por disparo e escolha do melhor (nitidez x exposição).
+//
+// Requer fb_count >= 3 e CAMERA_GRAB_LATEST: enquanto um frame é avaliado o
+// driver continua preenchendo os outros buffers, então cada esp_camera_fb_get()
+// devolve o frame mais novo sem esperar um ciclo inteiro. Só dois buffers ficam
+// presos (o melhor até agora e o candidato); o perdedor volta ao driver na hora.
+//
+// Frames cuja exposição começou antes de 'since' (ex.: antes de ligar o flash)
+// são descartados sem avaliação. Isso substitui a espera fixa pela
+// estabilização do flash: o primeiro frame já iluminado entra na disputa e os
+// seguintes (com a auto-exposição ajustada) só ganham se forem melhores.
+// Passado budgetMs (o firmware usa a antiga espera fixa, FLASH_STABILIZE_DELAY)
+// a rajada para no primeiro frame avaliado: o flash não fica ligado mais tempo
+// do que a espera fixa mais um frame. getLastMs() mede o custo real.
+//
+// A luma do vencedor fica em getBestLuma() e é a decodificação do evento: o
+// detector local e o cache de cenas usam o mesmo LumaFrame, sem decodificar de novo.
+//
+// Pontuação, sobre a luma na escala pedida (LumaFrame::scaleCovering):
+//   nitidez  = média de |dx| + |dy| entre pixels vizinhos (borrão de movimento
+//              e foco ruim reduzem as bordas)
+//   exposição = fração de pixels não estourados x proximidade da média ao
+//              cinza médio
+//   score    = nitidez x exposição
+class BurstCapture
+{
+public:
+  struct FrameScore
+  {
+    float sharpness;
+    float exposure;
+    float score;
+  };
+
+  // Melhor de até maxFrames frames capturados a partir de 'since' (µs de
+  // esp_timer_get_time), decodificados na maior redução que cobre minSide.
+  // Retorna nullptr se nenhum frame chegar a tempo
+  camera_fb_t *capture(uint8_t maxFrames, int64_t since, unsigned long budgetMs, uint16_t minSide)
+  {
+    const unsigned long start = millis();
+    camera_fb_t *best = nullptr;
+    bestLuma.invalidate();
+    lastFrames = 0;
+    lastSkipped = 0;
+    lastBestIndex = 0;
+    lastBest = {0, 0, -1.0f};
+
+    while (lastFrames < maxFrames && millis() - start < BURST_TIMEOUT)
+    {
+      if (best != nullptr && millis() - start >= budgetMs)
+      {
+        break; // Orçamento da antiga espera fixa esgotado
+      }
+      camera_fb_t *fb = esp_camera_fb_get();
+      if (fb == nullptr)
+      {
+        continue;
+      }
+      const int64_t frameTime = (int64_t)fb->timestamp.tv_sec * 1000000LL + fb->timestamp.tv_usec;
+      if (frameTime < since || fb->len == 0)
+      {
+        // Exposto antes do flash (buffer antigo do driver)
+        lastSkipped++;
+        esp_camera_fb_return(fb);
+        continue;
+      }
+
+      FrameScore s = {0, 0, 0};
+      if (candidate.decode(fb, LumaFrame::scaleCovering(fb->width, fb->height, minSide)))
+      {
+        score(candidate, &s);
+      }
+      lastFrames++;
+      if (best == nullptr || s.score > lastBest.score)
+      {
+        if (best != nullptr)
+        {
+          esp_camera_fb_return(best);
+        }
+        best = fb;
+        bestLuma.swap(candidate);
+        lastBest = s;
+        lastBestIndex = lastFrames;
+      }
+      else
+      {
+        esp_camera_fb_return(fb);
+      }
+    }
+
+    lastMs = millis() - start;
+    return best;
+  }
+
+  // Pontuação de um frame decodificado. Retorna false se for pequeno demais
+  static bool score(const LumaFrame &luma, FrameScore *out)
+  {
+    if (!luma.isValid() || luma.width() < 2 || luma.height() < 2)
+    {
+      return false;
+    }
+    *out = scoreLuma(luma.data(), luma.width(), luma.height());
+    return true;
+  }
+
+  // Luma do frame devolvido pela última capture() (inválida se a decodificação falhou)
+  const LumaFrame &getBestLuma() const
+  {
+    return bestLuma;
+  }
+
+  // Estatísticas da última rajada, para o log
+  uint8_t getLastFrames() const
+  {
+    return lastFrames;
+  }
+
+  uint8_t getLastSkipped() const
+  {
+    return lastSkipped;
+  }
+
+  uint8_t getLastBestIndex() const
+  {
+    return lastBestIndex;
+  }
+
+  const FrameScore &getLastBest() const
+  {
+    return lastBest;
+  }
+
+  unsigned long getLastMs() const
+  {
+    return lastMs;
+  }
+
+private:
+  uint8_t lastFrames = 0;
+  uint8_t lastSkipped = 0;
+  uint8_t lastBestIndex = 0;
+  FrameScore lastBest = {0, 0, -1.0f};
+  unsigned long lastMs = 0;
+
+  LumaFrame bestLuma;
+  LumaFrame candidate;
+
+  static FrameScore scoreLuma(const uint8_t *luma, uint16_t w, uint16_t h)
+  {
+    uint32_t gradient = 0;
+    uint32_t sum = 0;
+    uint32_t clipped = 0;
+    for (uint16_t y = 0; y < h; y++)
+    {
+      const uint8_t *row = luma + (size_t)y * w;
+      const uint8_t *below = y + 1 < h ? row + w : nullptr;
+      for (uint16_t x = 0; x < w; x++)
+      {
+        const uint8_t v = row[x];
+        sum += v;
+        if (v < BURST_CLIP_LOW || v > BURST_CLIP_HIGH)
+        {
+          clipped++;
+        }
+        if (x + 1 < w)
+        {
+          gradient += abs((int)v - (int)row[x + 1]);
+        }
+        if (below != nullptr)
+        {
+          gradient += abs((int)v - (int)below[x]);
+        }
+      }
+    }
+
+    const uint32_t pixels = (uint32_t)w * h;
+    const float mean = (float)sum / pixels;
+    FrameScore s;
+    s.sharpness = (float)gradient / pixels;
+    s.exposure = (1.0f - (float)clipped / pixels) * (1.0f - fabsf(mean - 128.0f) / 128.0f);
+    s.score = s.sharpness * s.exposure;
+    return s;
+  }
+};
+
+#endif // BURST_CAPTURE_H
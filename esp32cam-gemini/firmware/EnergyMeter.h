@@ -0,0 +1,133 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <Arduino.h>
+
+// Correntes médias típicas da ESP32-CAM (mA) por fase. Ajuste com um
+// amperímetro em série com a bateria para o seu módulo.
+#ifndef ENERGY_CURRENT_ACTIVE_MA
+#define ENERGY_CURRENT_ACTIVE_MA 110     // CPU 240 MHz + câmera, rádio desligado
+#endif
+#ifndef ENERGY_CURRENT_WIFI_MA
+#define ENERGY_CURRENT_WIFI_MA 180       // Associação/DHCP e rádio ocioso conectado
+#endif
+#ifndef ENERGY_CURRENT_TLS_MA
+#define ENERGY_CURRENT_TLS_MA 200        // Handshake TLS: criptografia assimétrica + rádio
+#endif
+#ifndef ENERGY_CURRENT_TX_MA
+#define ENERGY_CURRENT_TX_MA 240         // Envio do corpo HTTP
+#endif
+#ifndef ENERGY_CURRENT_FLASH_MA
+#define ENERGY_CURRENT_FLASH_MA 300      // Flash LED da câmera (adicional)
+#endif
+
+// Estimativa de energia por evento: cada fase medida soma tempo x corrente, e
+// o restante do tempo acordado conta como ACTIVE. Energia = V_bateria x I x t.
+class EnergyMeter
+{
+public:
+  enum Phase
+  {
+    PHASE_WIFI = 0,
+    PHASE_TLS,
+    PHASE_TX,
+    PHASE_FLASH,
+    PHASE_COUNT
+  };
+
+  // Último evento medido; guarde numa variável RTC para sobreviver ao deep sleep
+  struct Report
+  {
+    uint32_t awakeMs;
+    uint32_t phaseMs[PHASE_COUNT];
+    float millijoules;
+    float microAmpHours;
+  };
+
+  void begin()
+  {
+    memset(phaseMs, 0, sizeof(phaseMs));
+  }
+
+  void add(Phase phase, unsigned long ms)
+  {
+    phaseMs[phase] += ms;
+  }
+
+  // Soma as fases medidas por outra task (ex.: upload em paralelo no outro core).
+  // Fases simultâneas somam as duas correntes: a estimativa fica conservadora.
+  void merge(const EnergyMeter &other)
+  {
+    for (int i = 0; i < PHASE_COUNT; i++)
+    {
+      phaseMs[i] += other.phaseMs[i];
+    }
+  }
+
+  static float phaseCurrentMa(Phase phase)
+  {
+    static const float current[PHASE_COUNT] = {
+        ENERGY_CURRENT_WIFI_MA, ENERGY_CURRENT_TLS_MA, ENERGY_CURRENT_TX_MA, ENERGY_CURRENT_FLASH_MA};
+    return current[phase];
+  }
+
+  // Energia de ms milissegundos a currentMa: mA x ms = µC; x V = µJ
+  static float millijoules(float currentMa, unsigned long ms, float batteryVoltage)
+  {
+    return currentMa * ms * batteryVoltage / 1000.0f;
+  }
+
+  // Fecha a contabilidade do ciclo: awakeMs é o tempo desde o boot/despertar
+  Report finish(unsigned long awakeMs, float batteryVoltage) const
+  {
+    Report report;
+    report.awakeMs = awakeMs;
+    memcpy(report.phaseMs, phaseMs, sizeof(phaseMs));
+
+    // mA x ms = µC (microcoulombs)
+    float microCoulombs = 0;
+    unsigned long radioMs = 0;
+    for (int i = 0; i < PHASE_COUNT; i++)
+    {
+      microCoulombs += phaseCurrentMa((Phase)i) * phaseMs[i];
+      if (i != PHASE_FLASH)
+      {
+        radioMs += phaseMs[i];
+      }
+    }
+    // Flash é corrente adicional à fase ativa; as fases de rádio já incluem a CPU
+    const unsigned long activeMs = awakeMs > radioMs ? awakeMs - radioMs : 0;
+    microCoulombs += (float)ENERGY_CURRENT_ACTIVE_MA * activeMs;
+
+    report.millijoules = microCoulombs * batteryVoltage / 1000.0f;
+    report.microAmpHours = microCoulombs / 3600.0f;
+    return report;
+  }
+
+  static void print(const Report &report)
+  {
+    Serial.println("=== Energia do evento (estimada) ===");
+    Serial.print("Acordado: ");
+    Serial.print(report.awakeMs);
+    Serial.print(" ms | Wi-Fi: ");
+    Serial.print(report.phaseMs[PHASE_WIFI]);
+    Serial.print(" ms | TLS: ");
+    Serial.print(report.phaseMs[PHASE_TLS]);
+    Serial.print(" ms | Envio: ");
+    Serial.print(report.phaseMs[PHASE_TX]);
+    Serial.print(" ms | Flash: ");
+    Serial.print(report.phaseMs[PHASE_FLASH]);
+    Serial.println(" ms");
+    Serial.print("Energia: ");
+    Serial.print(report.millijoules, 1);
+    Serial.print(" mJ (");
+    Serial.print(report.microAmpHours, 1);
+    Serial.println(" µAh da bateria)");
+    Serial.println("=====================================");
+  }
+
+private:
+  unsigned long phaseMs[PHASE_COUNT] = {0};
+};
+
+#endif // ENERGY_METER_H
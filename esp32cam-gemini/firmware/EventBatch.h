@@ -0,0 +1,313 @@
+#ifndef EVENT_BATCH_H
+#define EVENT_BATCH_H
+
+#include <Arduino.h>
+#include <sys/time.h>
+#include "FS.h"
+#include "esp_camera.h"
+
+// Política padrão (pode ser sobrescrita com #define antes do include)
+#ifndef BATCH_MAX_EVENTS
+#define BATCH_MAX_EVENTS 8              // Capacidade do lote (índice na RTC)
+#endif
+#ifndef BATCH_FLUSH_COUNT
+#define BATCH_FLUSH_COUNT 5             // Envia quando o lote atingir esse número de capturas
+#endif
+#ifndef BATCH_MAX_AGE_S
+#define BATCH_MAX_AGE_S 900             // s - Envia quando a captura mais antiga tiver essa idade
+#endif
+#ifndef BATCH_LOW_BATTERY_VOLTAGE
+#define BATCH_LOW_BATTERY_VOLTAGE 3.5   // V - Abaixo disso envia logo (antes que a bateria acabe)
+#endif
+#ifndef BATCH_RETRY_S
+#define BATCH_RETRY_S 120               // s - Nova tentativa após falha no envio do lote
+#endif
+#ifndef BATCH_DIR
+#define BATCH_DIR "/batch"
+#endif
+
+// Lote de capturas acumulado entre vários despertares do deep sleep.
+//
+// A PSRAM é desligada no deep sleep e a RTC tem só 8 KB, então os JPEGs vão
+// para um sistema de arquivos (microSD ou LittleFS na flash interna) e só o
+// índice (State) fica na RTC. Cada despertar do PIR guarda a captura e volta a
+// dormir sem ligar o Wi-Fi; o lote é enviado numa única sessão Wi-Fi quando
+// shouldFlush() indicar (quantidade, idade, bateria baixa ou Wi-Fi já ligado).
+//
+// As idades usam o relógio do sistema (gettimeofday), que continua contando
+// durante o deep sleep; não precisa de NTP.
+class EventBatch
+{
+public:
+  enum FlushReason
+  {
+    FLUSH_NONE = 0,
+    FLUSH_COUNT,      // Lote cheio (BATCH_FLUSH_COUNT)
+    FLUSH_AGE,        // Captura mais antiga passou de BATCH_MAX_AGE_S
+    FLUSH_BATTERY,    // Bateria abaixo de BATCH_LOW_BATTERY_VOLTAGE
+    FLUSH_WIFI_UP     // Wi-Fi já ligado por outro motivo (ex.: botão): custo marginal
+  };
+
+  struct Entry
+  {
+    uint32_t id;
+    uint32_t capturedAt;   // s no relógio do sistema
+    uint32_t len;
+    uint16_t width;
+    uint16_t height;
+    uint16_t reason;       // SdEventRecorder::Reason
+    int16_t localScore;    // Probabilidade do detector local x1000 (-1: sem detector)
+  };
+
+  // Guarde numa variável RTC_DATA_ATTR
+  struct State
+  {
+    uint32_t magic;
+    uint32_t nextId;
+    uint8_t count;
+    Entry entries[BATCH_MAX_EVENTS];
+    uint32_t captureWakes;       // Despertares só de captura desde o último envio
+    float captureMillijoules;    // Energia desses despertares
+  };
+
+  explicit EventBatch(State &state) : state(state)
+  {
+  }
+
+  // Usa o sistema de arquivos já montado. Descarta um índice inválido (ex.:
+  // primeiro boot, RTC zerada por queda de energia).
+  bool begin(fs::FS &filesystem)
+  {
+    fs = &filesystem;
+    if (state.magic != STATE_MAGIC || state.count > BATCH_MAX_EVENTS)
+    {
+      memset(&state, 0, sizeof(state));
+      state.magic = STATE_MAGIC;
+    }
+    if (!fs->exists(BATCH_DIR))
+    {
+      fs->mkdir(BATCH_DIR);
+    }
+    return true;
+  }
+
+  bool isReady() const
+  {
+    return fs != nullptr;
+  }
+
+  size_t count() const
+  {
+    return state.count;
+  }
+
+  // Grava o JPEG e acrescenta ao índice. Retorna false se o lote estiver cheio
+  // ou a gravação falhar: o chamador envia a captura na hora.
+  bool add(const camera_fb_t *fb, uint16_t reason, float localScore)
+  {
+    if (!isReady() || state.count >= BATCH_MAX_EVENTS)
+    {
+      return false;
+    }
+
+    Entry &entry = state.entries[state.count];
+    entry.id = state.nextId;
+    entry.capturedAt = now();
+    entry.len = fb->len;
+    entry.width = fb->width;
+    entry.height = fb->height;
+    entry.reason = reason;
+    entry.localScore = localScore < 0 ? -1 : (int16_t)(localScore * 1000);
+
+    File file = fs->open(path(entry.id), FILE_WRITE);
+    if (!file)
+    {
+      Serial.println("✗ ERRO: Falha ao criar arquivo do lote");
+      return false;
+    }
+    const size_t written = file.write(fb->buf, fb->len);
+    file.close();
+    if (written != fb->len)
+    {
+      Serial.println("✗ ERRO: Sem espaço para guardar a captura no lote");
+      fs->remove(path(entry.id));
+      return false;
+    }
+
+    state.nextId++;
+    state.count++;
+    Serial.print("Captura guardada no lote (");
+    Serial.print(state.count);
+    Serial.print("/");
+    Serial.print(BATCH_FLUSH_COUNT);
+    Serial.println(")");
+    return true;
+  }
+
+  FlushReason shouldFlush(float batteryVoltage, bool wifiUp) const
+  {
+    if (state.count == 0)
+    {
+      return FLUSH_NONE;
+    }
+    if (wifiUp)
+    {
+      return FLUSH_WIFI_UP;
+    }
+    if (state.count >= BATCH_FLUSH_COUNT)
+    {
+      return FLUSH_COUNT;
+    }
+    if (ageOf(0) >= BATCH_MAX_AGE_S)
+    {
+      return FLUSH_AGE;
+    }
+    if (batteryVoltage <= BATCH_LOW_BATTERY_VOLTAGE)
+    {
+      return FLUSH_BATTERY;
+    }
+    return FLUSH_NONE;
+  }
+
+  // Segundos até a captura mais antiga vencer, para o despertar por timer.
+  // 0 se o lote estiver vazio (sem timer).
+  uint32_t secondsUntilDue() const
+  {
+    if (state.count == 0)
+    {
+      return 0;
+    }
+    const uint32_t age = ageOf(0);
+    return age >= BATCH_MAX_AGE_S ? BATCH_RETRY_S : BATCH_MAX_AGE_S - age;
+  }
+
+  const Entry &entry(size_t index) const
+  {
+    return state.entries[index];
+  }
+
+  uint32_t ageOf(size_t index) const
+  {
+    const uint32_t t = now();
+    const uint32_t capturedAt = state.entries[index].capturedAt;
+    return t > capturedAt ? t - capturedAt : 0;
+  }
+
+  // Lê a captura para a PSRAM como um frame da câmera. Libere com release()
+  camera_fb_t *load(size_t index)
+  {
+    const Entry &e = state.entries[index];
+    File file = fs->open(path(e.id), FILE_READ);
+    if (!file)
+    {
+      return nullptr;
+    }
+
+    camera_fb_t *fb = (camera_fb_t *)calloc(1, sizeof(camera_fb_t));
+    uint8_t *buf = (uint8_t *)(psramFound() ? ps_malloc(e.len) : malloc(e.len));
+    if (fb == nullptr || buf == nullptr || file.read(buf, e.len) != (int)e.len)
+    {
+      file.close();
+      free(buf);
+      free(fb);
+      return nullptr;
+    }
+    file.close();
+
+    fb->buf = buf;
+    fb->len = e.len;
+    fb->width = e.width;
+    fb->height = e.height;
+    fb->format = PIXFORMAT_JPEG;
+    return fb;
+  }
+
+  void release(camera_fb_t *fb)
+  {
+    if (fb != nullptr)
+    {
+      free(fb->buf);
+      free(fb);
+    }
+  }
+
+  // Fim do envio: apaga as capturas enviadas e mantém as que falharam
+  void finishFlush(const bool *sent)
+  {
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < state.count; i++)
+    {
+      if (sent[i])
+      {
+        fs->remove(path(state.entries[i].id));
+      }
+      else
+      {
+        state.entries[kept++] = state.entries[i];
+      }
+    }
+    state.count = kept;
+  }
+
+  // Energia dos despertares só de captura, para o relatório do próximo envio
+  void addCaptureWake(float millijoules)
+  {
+    state.captureWakes++;
+    state.captureMillijoules += millijoules;
+  }
+
+  void clearCaptureEnergy()
+  {
+    state.captureWakes = 0;
+    state.captureMillijoules = 0;
+  }
+
+  uint32_t getCaptureWakes() const
+  {
+    return state.captureWakes;
+  }
+
+  float getCaptureMillijoules() const
+  {
+    return state.captureMillijoules;
+  }
+
+  static const char *reasonName(FlushReason reason)
+  {
+    switch (reason)
+    {
+    case FLUSH_COUNT:
+      return "quantidade";
+    case FLUSH_AGE:
+      return "idade";
+    case FLUSH_BATTERY:
+      return "bateria baixa";
+    case FLUSH_WIFI_UP:
+      return "Wi-Fi já ligado";
+    default:
+      return "nenhum";
+    }
+  }
+
+private:
+  static const uint32_t STATE_MAGIC = 0x42415431; // "BAT1"
+
+  State &state;
+  fs::FS *fs = nullptr;
+
+  static uint32_t now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint32_t)tv.tv_sec;
+  }
+
+  static String path(uint32_t id)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), BATCH_DIR "/cap_%05lu.jpg", (unsigned long)id);
+    return String(name);
+  }
+};
+
+#endif // EVENT_BATCH_H
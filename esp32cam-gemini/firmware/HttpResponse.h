@@ -0,0 +1,222 @@
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+// Destino do corpo da resposta, alimentado em blocos à medida que os bytes
+// chegam (já sem o enquadramento chunked). Retornar false encerra a leitura:
+// o restante do corpo não é lido e a conexão não pode ser reutilizada.
+class HttpBodySink
+{
+public:
+  virtual ~HttpBodySink() {}
+  virtual bool write(const uint8_t *data, size_t len) = 0;
+};
+
+// Leitura de uma resposta HTTP/1.1 respeitando o enquadramento do corpo
+// (Content-Length, chunked ou fim de conexão). Necessário para keep-alive:
+// a resposta termina quando o corpo acaba, não quando o servidor fecha.
+struct HttpResponse
+{
+  int code = 0;
+  bool keepAlive = false;    // Conexão pode ser reutilizada na próxima requisição
+  bool truncated = false;    // Corpo maior que o limite: restante descartado
+  bool stoppedEarly = false; // O sink encerrou a leitura antes do fim do corpo
+  size_t bodyBytes = 0;      // Bytes de corpo recebidos (inclusive os descartados)
+  String body;
+
+  // Guarda até maxBody bytes do corpo em body.
+  // Retorna false em timeout ou conexão encerrada antes do fim do corpo
+  bool read(Client &client, size_t maxBody, unsigned long timeoutMs)
+  {
+    body = "";
+    StringSink sink(*this, maxBody);
+    return read(client, sink, timeoutMs);
+  }
+
+  // Entrega o corpo ao sink sem acumular em RAM (body fica vazio)
+  bool read(Client &client, HttpBodySink &sink, unsigned long timeoutMs)
+  {
+    deadline = millis() + timeoutMs;
+
+    String line;
+    if (!readLine(client, line))
+    {
+      return false;
+    }
+    // "HTTP/1.1 200 OK"
+    const int space = line.indexOf(' ');
+    code = space > 0 ? line.substring(space + 1).toInt() : 0;
+    keepAlive = line.startsWith("HTTP/1.1");
+
+    long contentLength = -1;
+    bool chunked = false;
+    bool headersEnded = false; // Linha vazia que fecha os cabeçalhos
+    while (readLine(client, line))
+    {
+      if (line.length() == 0)
+      {
+        headersEnded = true;
+        break;
+      }
+      line.toLowerCase();
+      if (line.startsWith("content-length:"))
+      {
+        contentLength = line.substring(15).toInt();
+      }
+      else if (line.startsWith("transfer-encoding:") && line.indexOf("chunked") != -1)
+      {
+        chunked = true;
+      }
+      else if (line.startsWith("connection:") && line.indexOf("close") != -1)
+      {
+        keepAlive = false;
+      }
+    }
+    if (!headersEnded)
+    {
+      return finish(false); // Timeout ou conexão encerrada no meio dos cabeçalhos
+    }
+
+    if (chunked)
+    {
+      while (true)
+      {
+        if (!readLine(client, line))
+        {
+          return finish(false);
+        }
+        const long size = strtol(line.c_str(), nullptr, 16);
+        if (size <= 0)
+        {
+          readLine(client, line); // Linha vazia após o último bloco
+          return finish(true);
+        }
+        if (!readBody(client, size, sink))
+        {
+          return finish(false);
+        }
+        if (stoppedEarly)
+        {
+          return finish(true);
+        }
+        if (!readLine(client, line))
+        {
+          return finish(false);
+        }
+      }
+    }
+    if (contentLength >= 0)
+    {
+      return finish(readBody(client, contentLength, sink));
+    }
+
+    // Sem tamanho: corpo vai até o servidor fechar
+    keepAlive = false;
+    readBody(client, -1, sink);
+    return true;
+  }
+
+private:
+  unsigned long deadline = 0;
+
+  // Acumula o corpo em body até o limite; o excedente é lido e descartado
+  class StringSink : public HttpBodySink
+  {
+  public:
+    StringSink(HttpResponse &response, size_t maxBody) : response(response), maxBody(maxBody)
+    {
+    }
+
+    bool write(const uint8_t *data, size_t len) override
+    {
+      String &body = response.body;
+      const size_t room = body.length() < maxBody ? maxBody - body.length() : 0;
+      if (len > room)
+      {
+        response.truncated = true;
+      }
+      for (size_t i = 0; i < min(len, room); i++)
+      {
+        body += (char)data[i];
+      }
+      return true;
+    }
+
+  private:
+    HttpResponse &response;
+    size_t maxBody;
+  };
+
+  bool finish(bool complete)
+  {
+    keepAlive = keepAlive && complete && !stoppedEarly;
+    return complete;
+  }
+
+  bool waitData(Client &client)
+  {
+    while (!client.available())
+    {
+      if (!client.connected() || (long)(millis() - deadline) > 0)
+      {
+        return false;
+      }
+      delay(1);
+    }
+    return true;
+  }
+
+  bool readLine(Client &client, String &line)
+  {
+    line = "";
+    while (waitData(client))
+    {
+      const char c = client.read();
+      if (c == '\n')
+      {
+        return true;
+      }
+      if (c != '\r')
+      {
+        line += c;
+      }
+    }
+    return false;
+  }
+
+  // remaining < 0: lê até a conexão fechar. Retorna true também quando o
+  // sink encerra a leitura (stoppedEarly)
+  bool readBody(Client &client, long remaining, HttpBodySink &sink)
+  {
+    uint8_t buf[256];
+    while (remaining != 0)
+    {
+      if (!waitData(client))
+      {
+        return remaining < 0;
+      }
+      const size_t want = remaining < 0 ? sizeof(buf) : min((size_t)remaining, sizeof(buf));
+      const int n = client.read(buf, want);
+      if (n <= 0)
+      {
+        continue;
+      }
+      if (remaining > 0)
+      {
+        remaining -= n;
+      }
+
+      bodyBytes += n;
+      if (!sink.write(buf, n))
+      {
+        stoppedEarly = true;
+        return true;
+      }
+    }
+    return true;
+  }
+};
+
+#endif // HTTP_RESPONSE_H
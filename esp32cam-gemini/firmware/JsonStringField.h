@@ -0,0 +1,151 @@
+#ifndef JSON_STRING_FIELD_H
+#define JSON_STRING_FIELD_H
+
+#include <Arduino.h>
+#include "HttpResponse.h"
+
+#ifndef JSON_FIELD_MAX_LENGTH
+#define JSON_FIELD_MAX_LENGTH 64    // bytes guardados do valor (o excedente é descartado)
+#endif
+#ifndef JSON_PREVIEW_LENGTH
+#define JSON_PREVIEW_LENGTH 256     // bytes iniciais do corpo guardados para log de erro
+#endif
+
+// Extrai o primeiro valor string de uma chave JSON enquanto o corpo chega.
+//
+// Não monta o documento: percorre os bytes uma vez, acompanhando só se está
+// dentro de uma string (com escapes) e se a última string fechada foi a chave
+// procurada seguida de ':'. Quando a string do valor fecha, write() retorna
+// false e a leitura HTTP termina ali, sem esperar o restante (ex.: os
+// metadados de uso que o Gemini envia depois do texto). RAM fixa:
+// JSON_FIELD_MAX_LENGTH + JSON_PREVIEW_LENGTH, qualquer que seja a resposta.
+class JsonStringField : public HttpBodySink
+{
+public:
+  explicit JsonStringField(const char *key) : key(key), keyLen(strlen(key))
+  {
+  }
+
+  bool write(const uint8_t *data, size_t len) override
+  {
+    for (size_t i = 0; i < len && !done; i++)
+    {
+      if (previewLen < JSON_PREVIEW_LENGTH)
+      {
+        preview[previewLen++] = data[i];
+        preview[previewLen] = '\0';
+      }
+      feed((char)data[i]);
+    }
+    return !done;
+  }
+
+  bool found() const
+  {
+    return done;
+  }
+
+  const char *value() const
+  {
+    return valueBuf;
+  }
+
+  // Início do corpo, para diagnosticar respostas sem a chave (ex.: erro da API)
+  const char *getPreview() const
+  {
+    return preview;
+  }
+
+private:
+  const char *key;
+  const size_t keyLen;
+
+  bool inString = false;
+  bool escape = false;
+  bool capturing = false;   // String atual é o valor procurado
+  bool done = false;
+
+  size_t matchPos = 0;      // Chars da string atual que batem com a chave
+  bool matching = false;
+  bool afterKey = false;    // Última string fechada foi a chave
+  bool valueNext = false;   // Chave + ':' vistos: próxima string é o valor
+
+  char valueBuf[JSON_FIELD_MAX_LENGTH + 1] = {0};
+  size_t valueLen = 0;
+  char preview[JSON_PREVIEW_LENGTH + 1] = {0};
+  size_t previewLen = 0;
+
+  void feed(char c)
+  {
+    if (inString)
+    {
+      if (escape)
+      {
+        escape = false;
+        stringChar(c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c);
+      }
+      else if (c == '\\')
+      {
+        escape = true;
+      }
+      else if (c == '"')
+      {
+        inString = false;
+        if (capturing)
+        {
+          done = true;
+        }
+        else
+        {
+          afterKey = matching && matchPos == keyLen;
+        }
+      }
+      else
+      {
+        stringChar(c);
+      }
+      return;
+    }
+
+    if (c == '"')
+    {
+      inString = true;
+      capturing = valueNext;
+      valueNext = false;
+      afterKey = false;
+      matching = true;
+      matchPos = 0;
+    }
+    else if (c == ':')
+    {
+      valueNext = afterKey;
+      afterKey = false;
+    }
+    else if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+    {
+      // Valor não string (número, objeto, lista...) ou separador
+      afterKey = false;
+      valueNext = false;
+    }
+  }
+
+  void stringChar(char c)
+  {
+    if (capturing)
+    {
+      if (valueLen < JSON_FIELD_MAX_LENGTH)
+      {
+        valueBuf[valueLen++] = c;
+        valueBuf[valueLen] = '\0';
+      }
+      return;
+    }
+    if (matching)
+    {
+      matching = matchPos < keyLen && key[matchPos] == c;
+      matchPos++;
+    }
+  }
+};
+
+#endif // JSON_STRING_FIELD_H
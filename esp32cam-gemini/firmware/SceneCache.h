@@ -0,0 +1,229 @@
+#ifndef SCENE_CACHE_H
+#define SCENE_CACHE_H
+
+#include <Arduino.h>
+#include <sys/time.h>
+#include <JpegLuma.h>
+#include "esp_camera.h"
+
+#ifndef SCENE_CACHE_SIZE
+#define SCENE_CACHE_SIZE 8                // Cenas lembradas (LRU na RTC, 40 bytes cada)
+#endif
+#ifndef SCENE_CACHE_MAX_DISTANCE
+#define SCENE_CACHE_MAX_DISTANCE 12       // bits diferentes (de 256) para considerar a mesma cena
+#endif
+#ifndef SCENE_CACHE_MAX_AGE_S
+#define SCENE_CACHE_MAX_AGE_S 600         // s - Depois disso o Gemini é consultado de novo
+#endif
+
+// Veredito do Gemini por cena, reaproveitado em disparos repetidos do PIR.
+//
+// A cena é resumida por um dHash de 256 bits: a luma do frame (o LumaFrame do
+// evento, já decodificado para o detector local, ou o JPEG em 1/8) é reduzida
+// a 17x16 em tons de cinza e cada bit diz se um pixel é mais claro que o
+// vizinho da direita. Mudanças globais de brilho (flash, auto-exposição) e o
+// ruído do sensor quase não alteram o hash; uma pessoa entrando ou saindo muda
+// vários bits. A grade de 16 colunas (em vez dos 8 do dHash clássico) é para
+// que uma pessoa ocupando uma faixa estreita do quadro não caiba dentro da
+// tolerância. Se a captura estiver a no máximo SCENE_CACHE_MAX_DISTANCE bits
+// de uma cena vista há menos de SCENE_CACHE_MAX_AGE_S, o veredito guardado é
+// usado sem chamar o Gemini.
+//
+// As entradas ficam em ordem de uso (a primeira é a mais recente); a última é
+// descartada quando o cache enche. A idade conta a partir do veredito do
+// Gemini, não do último acerto: uma cena parada é reavaliada periodicamente.
+class SceneCache
+{
+public:
+  struct Hash
+  {
+    uint64_t bits[4];
+  };
+
+  struct Entry
+  {
+    Hash hash;
+    uint32_t savedAt;   // s no relógio do sistema (continua no deep sleep)
+    uint8_t verdict;    // 1 = pessoa
+    uint8_t reserved[3];
+  };
+
+  // Guarde numa variável RTC_DATA_ATTR
+  struct State
+  {
+    uint32_t magic;
+    uint8_t count;
+    Entry entries[SCENE_CACHE_SIZE];
+    uint32_t hits;
+    uint32_t misses;
+  };
+
+  explicit SceneCache(State &state) : state(state)
+  {
+  }
+
+  // Descarta um estado inválido (ex.: primeiro boot, RTC zerada por queda de energia)
+  void begin()
+  {
+    if (state.magic != STATE_MAGIC || state.count > SCENE_CACHE_SIZE)
+    {
+      memset(&state, 0, sizeof(state));
+      state.magic = STATE_MAGIC;
+    }
+  }
+
+  // dHash do frame JPEG. Retorna false se a decodificação falhar
+  static bool hashFrame(const camera_fb_t *fb, Hash *hash)
+  {
+    LumaFrame luma;
+    return luma.decode(fb, 3) && hashLuma(luma, hash);
+  }
+
+  // dHash de um frame já decodificado, em qualquer escala que cubra 17x16
+  static bool hashLuma(const LumaFrame &luma, Hash *hash)
+  {
+    if (!luma.isValid() || luma.width() < HASH_W || luma.height() < HASH_H)
+    {
+      return false;
+    }
+    *hash = dHash(luma);
+    return true;
+  }
+
+  // Procura a cena mais parecida dentro do limite. Em caso de acerto, ela passa
+  // a ser a mais recente e verdict/distance são preenchidos
+  bool lookup(const Hash &hash, bool *verdict, uint16_t *distance)
+  {
+    const uint32_t t = now();
+    int best = -1;
+    uint16_t bestDistance = SCENE_CACHE_MAX_DISTANCE + 1;
+    for (uint8_t i = 0; i < state.count; i++)
+    {
+      const Entry &e = state.entries[i];
+      if (t - e.savedAt >= SCENE_CACHE_MAX_AGE_S)
+      {
+        continue;
+      }
+      const uint16_t d = hamming(e.hash, hash);
+      if (d < bestDistance)
+      {
+        best = i;
+        bestDistance = d;
+      }
+    }
+
+    if (best < 0)
+    {
+      state.misses++;
+      return false;
+    }
+    state.hits++;
+    moveToFront(best);
+    *verdict = state.entries[0].verdict != 0;
+    *distance = bestDistance;
+    return true;
+  }
+
+  // Guarda o veredito do Gemini como a cena mais recente
+  void store(const Hash &hash, bool verdict)
+  {
+    // Mesma cena já guardada (ex.: expirada): substitui no lugar. Senão ocupa
+    // uma posição livre ou descarta a menos usada (a última)
+    int slot = -1;
+    for (uint8_t i = 0; i < state.count && slot < 0; i++)
+    {
+      if (hamming(state.entries[i].hash, hash) == 0)
+      {
+        slot = i;
+      }
+    }
+    if (slot < 0)
+    {
+      slot = state.count < SCENE_CACHE_SIZE ? state.count++ : SCENE_CACHE_SIZE - 1;
+    }
+    Entry &e = state.entries[slot];
+    e.hash = hash;
+    e.savedAt = now();
+    e.verdict = verdict ? 1 : 0;
+    moveToFront(slot);
+  }
+
+  uint32_t getHits() const
+  {
+    return state.hits;
+  }
+
+  uint32_t getMisses() const
+  {
+    return state.misses;
+  }
+
+  size_t count() const
+  {
+    return state.count;
+  }
+
+  static uint16_t hamming(const Hash &a, const Hash &b)
+  {
+    uint16_t d = 0;
+    for (int i = 0; i < 4; i++)
+    {
+      d += __builtin_popcountll(a.bits[i] ^ b.bits[i]);
+    }
+    return d;
+  }
+
+private:
+  static const uint32_t STATE_MAGIC = 0x53434e31; // "SCN1"
+  static const int HASH_W = 17;
+  static const int HASH_H = 16;
+
+  State &state;
+
+  static uint32_t now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint32_t)tv.tv_sec;
+  }
+
+  void moveToFront(uint8_t index)
+  {
+    const Entry e = state.entries[index];
+    memmove(&state.entries[1], &state.entries[0], index * sizeof(Entry));
+    state.entries[0] = e;
+  }
+
+  // Redução por média de área para 17x16 e comparação com o vizinho da direita
+  static Hash dHash(const LumaFrame &luma)
+  {
+    const int w = luma.width();
+    const int h = luma.height();
+    uint16_t gray[HASH_H][HASH_W];
+    for (int oy = 0; oy < HASH_H; oy++)
+    {
+      const int sy0 = oy * h / HASH_H;
+      const int sy1 = (oy + 1) * h / HASH_H;
+      for (int ox = 0; ox < HASH_W; ox++)
+      {
+        gray[oy][ox] = luma.mean(ox * w / HASH_W, sy0, (ox + 1) * w / HASH_W, sy1);
+      }
+    }
+
+    Hash hash = {};
+    int bit = 0;
+    for (int y = 0; y < HASH_H; y++)
+    {
+      for (int x = 0; x < HASH_W - 1; x++, bit++)
+      {
+        if (gray[y][x] > gray[y][x + 1])
+        {
+          hash.bits[bit / 64] |= 1ULL << (bit % 64);
+        }
+      }
+    }
+    return hash;
+  }
+};
+
+#endif // SCENE_CACHE_H
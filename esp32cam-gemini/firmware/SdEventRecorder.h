@@ -0,0 +1,435 @@
+#ifndef SD_EVENT_RECORDER_H
+#define SD_EVENT_RECORDER_H
+
+#include <Arduino.h>
+#include "FS.h"
+#include "SD_MMC.h"
+#include "esp_camera.h"
+
+// Configuração padrão (pode ser sobrescrita com #define antes do include)
+#ifndef SD_PRE_TRIGGER_FRAMES
+#define SD_PRE_TRIGGER_FRAMES 15        // Frames mantidos na memória antes do disparo
+#endif
+#ifndef SD_POST_TRIGGER_FRAMES
+#define SD_POST_TRIGGER_FRAMES 10       // Frames gravados depois do disparo
+#endif
+#ifndef SD_FRAME_INTERVAL
+#define SD_FRAME_INTERVAL 200           // ms - Intervalo entre frames do histórico e pós-disparo
+#endif
+#ifndef SD_FRAME_SLOT_SIZE
+#define SD_FRAME_SLOT_SIZE (96 * 1024)  // bytes - Tamanho máximo de um JPEG no anel
+#endif
+
+// Gravador de eventos no cartão microSD com histórico pré-disparo.
+//
+// Enquanto o sistema está acordado, pushPreTrigger() guarda os últimos
+// SD_PRE_TRIGGER_FRAMES JPEGs num anel em PSRAM (slots fixos, sem fragmentar o heap).
+// No disparo (PIR/botão), recordEvent() grava em sequência no SD: o histórico,
+// o frame do disparo e SD_POST_TRIGGER_FRAMES frames novos, sem precisar de Wi-Fi.
+//
+// Formato de /events/evt_NNNNN.evr (little-endian, só anexação):
+//   Cabeçalho (16 B): "EVR1" | u16 versão | u16 motivo | u32 millis do disparo | u32 reservado
+//   Registro  (16 B + JPEG): "FRM1" | u32 tamanho | i32 ms relativos ao disparo | u8 tipo | 3 B
+//   Índice    (16 B por frame): u32 offset do JPEG | u32 tamanho | i32 ms | u8 tipo | 3 B
+//   Rodapé    (12 B): u32 número de frames | u32 offset do índice | "EVRI"
+// Se a energia cair antes do rodapé, os registros ainda podem ser recuperados
+// lendo o arquivo em sequência (veja ../event_reader.py). O FS do Arduino não
+// trunca arquivos: depois de uma escrita que falhou, o índice e o rodapé são
+// gravados por cima do registro incompleto e o que sobrar dele fica depois do
+// rodapé; o leitor procura o "EVRI" cujo índice termina nele.
+class SdEventRecorder
+{
+public:
+  enum FrameKind : uint8_t
+  {
+    FRAME_PRE = 0,
+    FRAME_TRIGGER = 1,
+    FRAME_POST = 2
+  };
+
+  enum Reason : uint16_t
+  {
+    REASON_BUTTON = 0,
+    REASON_PIR = 1
+  };
+
+  ~SdEventRecorder()
+  {
+    for (int i = 0; i < SD_PRE_TRIGGER_FRAMES; i++)
+    {
+      free(slots[i].buf);
+    }
+    free(triggerCopy);
+  }
+
+  // Monta o cartão (modo 1 bit: GPIO 2, 14 e 15) e aloca o anel em PSRAM
+  bool begin()
+  {
+    if (!SD_MMC.begin("/sdcard", true))
+    {
+      Serial.println("✗ ERRO: Cartão microSD não montado. Gravação de eventos desativada.");
+      return false;
+    }
+    if (!SD_MMC.exists("/events"))
+    {
+      SD_MMC.mkdir("/events");
+    }
+    nextEventId = findNextEventId();
+
+    if (!psramFound())
+    {
+      Serial.println("AVISO: Sem PSRAM - eventos serão gravados sem histórico pré-disparo.");
+    }
+    else
+    {
+      for (int i = 0; i < SD_PRE_TRIGGER_FRAMES; i++)
+      {
+        slots[i].buf = (uint8_t *)ps_malloc(SD_FRAME_SLOT_SIZE);
+        if (slots[i].buf == nullptr)
+        {
+          Serial.println("AVISO: PSRAM insuficiente para o histórico completo.");
+          break;
+        }
+        slotCount++;
+      }
+    }
+
+    ready = true;
+    Serial.print("✓ Gravador de eventos no microSD pronto (");
+    Serial.print(slotCount);
+    Serial.print(" frames de histórico, ");
+    Serial.print((uint32_t)(SD_MMC.totalBytes() / (1024 * 1024)));
+    Serial.println(" MB)");
+    return true;
+  }
+
+  bool isReady() const
+  {
+    return ready;
+  }
+
+  // Guarda uma cópia do frame no anel, descartando o mais antigo quando cheio
+  void pushPreTrigger(camera_fb_t *fb)
+  {
+    if (slotCount == 0 || fb == nullptr)
+    {
+      return;
+    }
+    if (fb->len > SD_FRAME_SLOT_SIZE)
+    {
+      droppedFrames++;
+      return;
+    }
+
+    Slot &slot = slots[head];
+    memcpy(slot.buf, fb->buf, fb->len);
+    slot.len = fb->len;
+    slot.timestamp = millis();
+    head = (head + 1) % slotCount;
+    if (filled < slotCount)
+    {
+      filled++;
+    }
+  }
+
+  // Captura frames sem flash para o anel enquanto espera (ex.: estabilização do PIR)
+  void fillPreTrigger(unsigned long durationMs)
+  {
+    const unsigned long start = millis();
+    while (millis() - start < durationMs)
+    {
+      const unsigned long frameStart = millis();
+      if (slotCount > 0)
+      {
+        camera_fb_t *fb = esp_camera_fb_get();
+        pushPreTrigger(fb);
+        if (fb)
+        {
+          esp_camera_fb_return(fb);
+        }
+      }
+      const unsigned long elapsed = millis() - frameStart;
+      if (elapsed < SD_FRAME_INTERVAL)
+      {
+        delay(SD_FRAME_INTERVAL - elapsed);
+      }
+    }
+  }
+
+  // Grava o evento completo. Devolve o frame do disparo à câmera logo após
+  // gravá-lo (o buffer fica livre para os frames pós-disparo) e retorna uma
+  // cópia em PSRAM para o restante do processamento. Se não houver memória
+  // para a cópia, retorna o próprio fb e o evento fica sem frames pós-disparo.
+  // Libere o retorno com releaseFrame().
+  camera_fb_t *recordEvent(camera_fb_t *fb, Reason reason)
+  {
+    if (!ready || fb == nullptr)
+    {
+      return fb;
+    }
+
+    const unsigned long start = millis();
+    triggerMillis = start;
+    if (!openEvent(reason))
+    {
+      return fb;
+    }
+
+    // Histórico, do mais antigo para o mais recente
+    for (int i = 0; i < filled; i++)
+    {
+      const Slot &slot = slots[(head + slotCount - filled + i) % slotCount];
+      appendFrame(slot.buf, slot.len, (int32_t)(slot.timestamp - triggerMillis), FRAME_PRE);
+    }
+    filled = 0;
+    appendFrame(fb->buf, fb->len, 0, FRAME_TRIGGER);
+    file.flush();
+
+    camera_fb_t *result = fb;
+    if (keepTriggerCopy(fb))
+    {
+      esp_camera_fb_return(fb);
+      result = &triggerFrame;
+      recordPostTrigger();
+    }
+
+    closeEvent();
+    lastWriteMs = millis() - start;
+
+    Serial.print("✓ Evento gravado em ");
+    Serial.print(lastEventPath);
+    Serial.print(": ");
+    Serial.print(lastEventFrames);
+    Serial.print(" frames, ");
+    Serial.print(lastEventBytes / 1024);
+    Serial.print(" KB em ");
+    Serial.print(lastWriteMs);
+    Serial.println(" ms");
+    return result;
+  }
+
+  // Libera um frame retornado por recordEvent()
+  void releaseFrame(camera_fb_t *fb)
+  {
+    if (fb != nullptr && fb != &triggerFrame)
+    {
+      esp_camera_fb_return(fb);
+    }
+  }
+
+  const String &getLastEventPath() const
+  {
+    return lastEventPath;
+  }
+
+  uint32_t getLastEventFrames() const
+  {
+    return lastEventFrames;
+  }
+
+  uint32_t getDroppedFrames() const
+  {
+    return droppedFrames;
+  }
+
+private:
+  struct Slot
+  {
+    uint8_t *buf = nullptr;
+    size_t len = 0;
+    unsigned long timestamp = 0;
+  };
+
+  struct __attribute__((packed)) IndexEntry
+  {
+    uint32_t offset;
+    uint32_t len;
+    int32_t timeMs;
+    uint8_t kind;
+    uint8_t reserved[3];
+  };
+
+  static const int MAX_EVENT_FRAMES = SD_PRE_TRIGGER_FRAMES + 1 + SD_POST_TRIGGER_FRAMES;
+
+  bool ready = false;
+  Slot slots[SD_PRE_TRIGGER_FRAMES];
+  int slotCount = 0;
+  int head = 0;
+  int filled = 0;
+  uint32_t droppedFrames = 0;
+
+  File file;
+  uint32_t nextEventId = 0;
+  uint32_t fileOffset = 0;
+  bool writeFailed = false;   // Uma escrita do evento atual falhou (cartão cheio)
+  unsigned long triggerMillis = 0;
+  IndexEntry index[MAX_EVENT_FRAMES];
+  int indexCount = 0;
+
+  uint8_t *triggerCopy = nullptr;
+  size_t triggerCapacity = 0;
+  camera_fb_t triggerFrame = {};
+
+  String lastEventPath;
+  uint32_t lastEventFrames = 0;
+  uint32_t lastEventBytes = 0;
+  unsigned long lastWriteMs = 0;
+
+  uint32_t findNextEventId()
+  {
+    uint32_t next = 0;
+    File dir = SD_MMC.open("/events");
+    File entry = dir.openNextFile();
+    while (entry)
+    {
+      // Nome esperado: evt_NNNNN.evr
+      const char *name = strrchr(entry.name(), '/');
+      name = name ? name + 1 : entry.name();
+      if (strncmp(name, "evt_", 4) == 0)
+      {
+        const uint32_t id = strtoul(name + 4, nullptr, 10);
+        if (id >= next)
+        {
+          next = id + 1;
+        }
+      }
+      entry = dir.openNextFile();
+    }
+    return next;
+  }
+
+  bool openEvent(Reason reason)
+  {
+    char path[32];
+    snprintf(path, sizeof(path), "/events/evt_%05u.evr", (unsigned)nextEventId);
+    file = SD_MMC.open(path, FILE_WRITE);
+    if (!file)
+    {
+      Serial.print("✗ ERRO: Não foi possível criar ");
+      Serial.println(path);
+      return false;
+    }
+
+    nextEventId++;
+    lastEventPath = path;
+    fileOffset = 0;
+    indexCount = 0;
+    writeFailed = false;
+
+    uint8_t header[16] = {'E', 'V', 'R', '1'};
+    const uint16_t version = 1;
+    const uint16_t reasonCode = reason;
+    const uint32_t trigger = triggerMillis;
+    memcpy(header + 4, &version, 2);
+    memcpy(header + 6, &reasonCode, 2);
+    memcpy(header + 8, &trigger, 4);
+    writeRaw(header, sizeof(header));
+    return true;
+  }
+
+  // Registro completo ou nada: se o cabeçalho ou o JPEG não couberem, o
+  // arquivo volta ao início do registro (o índice e o rodapé são gravados a
+  // partir dali; sobras do registro podem ficar depois do rodapé) e os frames
+  // seguintes do evento são descartados, porque o cartão encheu
+  void appendFrame(const uint8_t *buf, size_t len, int32_t timeMs, FrameKind kind)
+  {
+    if (indexCount >= MAX_EVENT_FRAMES || writeFailed)
+    {
+      return;
+    }
+
+    uint8_t record[16] = {'F', 'R', 'M', '1'};
+    const uint32_t length = len;
+    memcpy(record + 4, &length, 4);
+    memcpy(record + 8, &timeMs, 4);
+    record[12] = kind;
+
+    const uint32_t recordOffset = fileOffset;
+    if (!writeRaw(record, sizeof(record)) || !writeRaw(buf, len))
+    {
+      writeFailed = true;
+      if (file.seek(recordOffset))
+      {
+        fileOffset = recordOffset;
+      }
+      return;
+    }
+
+    IndexEntry &entry = index[indexCount];
+    entry.offset = recordOffset + sizeof(record);
+    entry.len = len;
+    entry.timeMs = timeMs;
+    entry.kind = kind;
+    memset(entry.reserved, 0, sizeof(entry.reserved));
+    indexCount++;
+  }
+
+  void recordPostTrigger()
+  {
+    for (int i = 0; i < SD_POST_TRIGGER_FRAMES; i++)
+    {
+      const unsigned long frameStart = millis();
+      camera_fb_t *fb = esp_camera_fb_get();
+      if (fb)
+      {
+        appendFrame(fb->buf, fb->len, (int32_t)(millis() - triggerMillis), FRAME_POST);
+        esp_camera_fb_return(fb);
+      }
+      const unsigned long elapsed = millis() - frameStart;
+      if (elapsed < SD_FRAME_INTERVAL)
+      {
+        delay(SD_FRAME_INTERVAL - elapsed);
+      }
+    }
+  }
+
+  void closeEvent()
+  {
+    const uint32_t indexOffset = fileOffset;
+    writeRaw((const uint8_t *)index, indexCount * sizeof(IndexEntry));
+
+    uint8_t footer[12] = {0};
+    const uint32_t count = indexCount;
+    memcpy(footer, &count, 4);
+    memcpy(footer + 4, &indexOffset, 4);
+    memcpy(footer + 8, "EVRI", 4);
+    writeRaw(footer, sizeof(footer));
+    file.close();
+
+    lastEventFrames = indexCount;
+    lastEventBytes = fileOffset;
+  }
+
+  bool writeRaw(const uint8_t *buf, size_t len)
+  {
+    const size_t written = file.write(buf, len);
+    fileOffset += written;
+    if (written != len)
+    {
+      Serial.println("✗ ERRO: Falha de escrita no microSD (cartão cheio?)");
+      return false;
+    }
+    return true;
+  }
+
+  bool keepTriggerCopy(camera_fb_t *fb)
+  {
+    if (fb->len > triggerCapacity)
+    {
+      free(triggerCopy);
+      triggerCopy = (uint8_t *)(psramFound() ? ps_malloc(fb->len) : malloc(fb->len));
+      triggerCapacity = triggerCopy ? fb->len : 0;
+    }
+    if (triggerCopy == nullptr)
+    {
+      return false;
+    }
+
+    memcpy(triggerCopy, fb->buf, fb->len);
+    triggerFrame = *fb;
+    triggerFrame.buf = triggerCopy;
+    return true;
+  }
+};
+
+#endif // SD_EVENT_RECORDER_H
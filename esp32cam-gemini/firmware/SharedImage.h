@@ -0,0 +1,105 @@
+#ifndef SHARED_IMAGE_H
+#define SHARED_IMAGE_H
+
+#include <Arduino.h>
+
+// Última imagem (JPEG) e decisão, compartilhadas entre o loop() e as tarefas do
+// servidor web.
+//
+// Cada imagem publicada é um bloco imutável com contador de referências: o
+// servidor pega uma referência, envia o JPEG no ritmo do navegador e a solta no
+// fim. Uma nova publicação só troca o ponteiro atual, então o loop() nunca
+// espera um cliente lento e um visitante nunca vê a imagem pela metade. A
+// memória da imagem antiga é liberada por quem soltar a última referência.
+//
+// A ETag é calculada uma vez na publicação (FNV-1a do conteúdo + tamanho), o
+// que permite ao servidor responder 304 a um If-None-Match sem tocar no JPEG.
+class SharedImage
+{
+public:
+  struct Image
+  {
+    const uint8_t *buf;
+    size_t len;
+    const char *decision;   // literal estático ("person"/"no_person")
+    uint32_t hash;          // FNV-1a do JPEG
+    char etag[24];          // entre aspas, pronta para o cabeçalho
+    uint32_t refs;
+  };
+
+  // Copia o JPEG e passa a servi-lo. Retorna false se faltar memória (a
+  // imagem anterior continua publicada)
+  bool publish(const uint8_t *jpeg, size_t len, const char *decision)
+  {
+    uint8_t *block = (uint8_t *)(psramFound() ? ps_malloc(sizeof(Image) + len) : malloc(sizeof(Image) + len));
+    if (block == nullptr)
+    {
+      return false;
+    }
+    Image *image = (Image *)block;
+    uint8_t *data = block + sizeof(Image);
+    memcpy(data, jpeg, len);
+    image->buf = data;
+    image->len = len;
+    image->decision = decision;
+    image->hash = fnv1a(data, len);
+    image->refs = 1;   // referência do próprio SharedImage
+    snprintf(image->etag, sizeof(image->etag), "\"%08lx-%lx\"", (unsigned long)image->hash, (unsigned long)len);
+
+    portENTER_CRITICAL(&mux);
+    Image *old = current;
+    current = image;
+    const bool freeOld = old != nullptr && --old->refs == 0;
+    portEXIT_CRITICAL(&mux);
+
+    if (freeOld)
+    {
+      free(old);
+    }
+    return true;
+  }
+
+  // Referência para a imagem atual (nullptr se ainda não houver). Devolva com release()
+  Image *acquire()
+  {
+    portENTER_CRITICAL(&mux);
+    Image *image = current;
+    if (image != nullptr)
+    {
+      image->refs++;
+    }
+    portEXIT_CRITICAL(&mux);
+    return image;
+  }
+
+  void release(Image *image)
+  {
+    if (image == nullptr)
+    {
+      return;
+    }
+    portENTER_CRITICAL(&mux);
+    const bool last = --image->refs == 0;
+    portEXIT_CRITICAL(&mux);
+    if (last)
+    {
+      free(image);
+    }
+  }
+
+private:
+  Image *current = nullptr;
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+  static uint32_t fnv1a(const uint8_t *data, size_t len)
+  {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+      h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+  }
+};
+
+#endif // SHARED_IMAGE_H
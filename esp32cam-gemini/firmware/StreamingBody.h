@@ -0,0 +1,86 @@
+#ifndef STREAMING_BODY_H
+#define STREAMING_BODY_H
+
+#include <Arduino.h>
+#include "mbedtls/base64.h"
+
+#ifndef STREAMING_BODY_CHUNK
+#define STREAMING_BODY_CHUNK 1536  // bytes de JPEG por bloco (múltiplo de 3 -> 2048 chars base64)
+#endif
+
+// Corpo JSON com um campo base64 escrito direto no cliente TLS.
+//
+// O corpo é prefixo + base64(dados) + sufixo. O Content-Length é calculado
+// antes do envio e o base64 é gerado em blocos de STREAMING_BODY_CHUNK bytes
+// num buffer alocado por envio, então o custo extra de RAM é ~2 KB, qualquer
+// que seja o tamanho do JPEG (antes: base64 + String + payload, ~3x o frame).
+// O buffer não é compartilhado: dois envios podem rodar em cores diferentes.
+class StreamingBody
+{
+public:
+  StreamingBody(const String &prefix, const uint8_t *data, size_t len, const String &suffix)
+      : prefix(prefix), suffix(suffix), data(data), len(len)
+  {
+  }
+
+  static constexpr size_t base64Length(size_t len)
+  {
+    return ((len + 2) / 3) * 4;
+  }
+
+  size_t contentLength() const
+  {
+    return prefix.length() + base64Length(len) + suffix.length();
+  }
+
+  // Escreve o corpo inteiro. Retorna false se o cliente aceitar menos bytes
+  // que o pedido (conexão caiu no meio do envio).
+  bool writeTo(Print &out) const
+  {
+    if (!writeAll(out, (const uint8_t *)prefix.c_str(), prefix.length()))
+    {
+      return false;
+    }
+
+    const size_t encodedSize = base64Length(STREAMING_BODY_CHUNK) + 1;
+    unsigned char *encoded = (unsigned char *)malloc(encodedSize);
+    if (!encoded)
+    {
+      return false;
+    }
+    bool ok = true;
+    for (size_t offset = 0; ok && offset < len; offset += STREAMING_BODY_CHUNK)
+    {
+      const size_t chunk = min((size_t)STREAMING_BODY_CHUNK, len - offset);
+      size_t encodedLen = 0;
+      ok = mbedtls_base64_encode(encoded, encodedSize, &encodedLen, data + offset, chunk) == 0 &&
+           writeAll(out, encoded, encodedLen);
+    }
+    free(encoded);
+
+    return ok && writeAll(out, (const uint8_t *)suffix.c_str(), suffix.length());
+  }
+
+private:
+  const String prefix;
+  const String suffix;
+  const uint8_t *data;
+  size_t len;
+
+  static bool writeAll(Print &out, const uint8_t *buf, size_t size)
+  {
+    while (size > 0)
+    {
+      const size_t written = out.write(buf, size);
+      if (written == 0)
+      {
+        return false;
+      }
+      buf += written;
+      size -= written;
+    }
+    return true;
+  }
+};
+
+#endif // STREAMING_BODY_H
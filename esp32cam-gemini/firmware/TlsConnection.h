@@ -0,0 +1,438 @@
+#ifndef TLS_CONNECTION_H
+#define TLS_CONNECTION_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <esp_system.h>
+#if __has_include(<esp_random.h>)
+#include <esp_random.h>
+#endif
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+
+#ifndef TLS_SESSION_MAX_SIZE
+#define TLS_SESSION_MAX_SIZE 1536   // bytes por host na RTC (sessão serializada + ticket)
+#endif
+#ifndef TLS_READ_TIMEOUT
+#define TLS_READ_TIMEOUT 5000       // ms - Timeout de leitura de um registro TLS
+#endif
+#ifndef TLS_RESUMED_MAX_BYTES
+#define TLS_RESUMED_MAX_BYTES 1024  // Handshake que recebe menos que isso não trouxe certificado: foi retomado
+#endif
+
+// Sessão TLS de um host guardada na memória RTC (sobrevive ao deep sleep)
+struct TlsSessionCache
+{
+  uint32_t magic;
+  char host[64];
+  uint16_t len;
+  uint8_t data[TLS_SESSION_MAX_SIZE];
+};
+
+// Estatísticas de handshake, também na RTC para aparecerem na página após acordar
+struct TlsStats
+{
+  uint32_t handshakes;
+  uint32_t resumed;
+  uint32_t reused;           // Requisições que aproveitaram conexão keep-alive
+  uint32_t lastHandshakeMs;
+  uint32_t lastHandshakeBytes;
+  uint32_t totalHandshakeMs;
+};
+
+// Os slots podem conectar ao mesmo tempo (upload em paralelo no outro core),
+// então as estatísticas compartilhadas são atualizadas em seção crítica
+static portMUX_TYPE &tlsStatsMux()
+{
+  static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  return mux;
+}
+
+// Cliente TLS (mbedtls direto sobre socket) com retomada de sessão.
+//
+// O WiFiClientSecure do Arduino faz setup + handshake dentro de connect() e não
+// permite entregar uma sessão salva antes do handshake. Aqui a sessão (com o
+// ticket RFC 5077 do servidor) é carregada de TlsSessionCache antes do
+// handshake e salva de volta depois, então após o deep sleep o servidor pula o
+// envio do certificado e a troca de chaves (1 RTT e ~10x menos CPU).
+// Como o servidor não confirma a retomada por API pública, ela é inferida pelo
+// volume recebido no handshake (sem certificado = retomado).
+class TlsConnection : public Client
+{
+public:
+  TlsConnection(TlsSessionCache &cache, TlsStats &stats) : cache(cache), stats(stats)
+  {
+  }
+
+  ~TlsConnection()
+  {
+    stop();
+  }
+
+  int connect(IPAddress ip, uint16_t port) override
+  {
+    return connect(ip.toString().c_str(), port);
+  }
+
+  int connect(const char *host, uint16_t port) override
+  {
+    stop();
+
+    char portStr[6];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+
+    mbedtls_net_init(&net);
+    mbedtls_ssl_init(&ssl);
+    mbedtls_ssl_config_init(&conf);
+    initialized = true;
+
+    const unsigned long start = millis();
+    if (mbedtls_net_connect(&net, host, portStr, MBEDTLS_NET_PROTO_TCP) != 0)
+    {
+      Serial.print("✗ ERRO: Falha na conexão TCP com ");
+      Serial.println(host);
+      stop();
+      return 0;
+    }
+
+    mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_NONE); // Para MVP: sem verificação de certificado (igual ao setInsecure)
+    mbedtls_ssl_conf_rng(&conf, randomBytes, nullptr);
+    mbedtls_ssl_conf_read_timeout(&conf, TLS_READ_TIMEOUT);
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+    mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+    mbedtls_ssl_setup(&ssl, &conf);
+    mbedtls_ssl_set_hostname(&ssl, host);
+    mbedtls_ssl_set_bio(&ssl, this, countingSend, nullptr, countingRecv);
+
+    const bool hasSession = loadSession(host);
+
+    bytesIn = 0;
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&ssl)) != 0)
+    {
+      if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+      {
+        Serial.print("✗ ERRO: Handshake TLS falhou (-0x");
+        Serial.print(-ret, HEX);
+        Serial.println(")");
+        if (hasSession)
+        {
+          cache.magic = 0; // Sessão possivelmente inválida: próxima tentativa faz handshake completo
+        }
+        stop();
+        return 0;
+      }
+    }
+
+    lastHandshakeMs = millis() - start;
+    lastResumed = hasSession && bytesIn < TLS_RESUMED_MAX_BYTES;
+    portENTER_CRITICAL(&tlsStatsMux());
+    stats.handshakes++;
+    stats.resumed += lastResumed ? 1 : 0;
+    stats.lastHandshakeMs = lastHandshakeMs;
+    stats.lastHandshakeBytes = bytesIn;
+    stats.totalHandshakeMs += lastHandshakeMs;
+    portEXIT_CRITICAL(&tlsStatsMux());
+
+    Serial.print("TLS com ");
+    Serial.print(host);
+    Serial.print(lastResumed ? ": sessão retomada em " : ": handshake completo em ");
+    Serial.print(lastHandshakeMs);
+    Serial.print(" ms (");
+    Serial.print(bytesIn);
+    Serial.println(" bytes recebidos)");
+
+    saveSession(host);
+    strncpy(connectedHost, host, sizeof(connectedHost) - 1);
+    connectedHost[sizeof(connectedHost) - 1] = '\0';
+    open = true;
+    return 1;
+  }
+
+  size_t write(uint8_t b) override
+  {
+    return write(&b, 1);
+  }
+
+  size_t write(const uint8_t *buf, size_t size) override
+  {
+    if (!open)
+    {
+      return 0;
+    }
+    int ret;
+    while ((ret = mbedtls_ssl_write(&ssl, buf, size)) < 0)
+    {
+      if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+      {
+        open = false;
+        return 0;
+      }
+    }
+    return ret;
+  }
+
+  int available() override
+  {
+    if (rxPos < rxLen)
+    {
+      return rxLen - rxPos;
+    }
+    if (!open)
+    {
+      return 0;
+    }
+    // Só chama ssl_read se há dados decifrados pendentes ou bytes no socket
+    if (mbedtls_ssl_get_bytes_avail(&ssl) == 0 && mbedtls_net_poll(&net, MBEDTLS_NET_POLL_READ, 0) <= 0)
+    {
+      return 0;
+    }
+
+    const int ret = mbedtls_ssl_read(&ssl, rxBuf, sizeof(rxBuf));
+    if (ret > 0)
+    {
+      rxPos = 0;
+      rxLen = ret;
+      return rxLen;
+    }
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+      open = false; // 0 ou close_notify: o servidor encerrou a conexão
+    }
+    return 0;
+  }
+
+  int read() override
+  {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+  }
+
+  int read(uint8_t *buf, size_t size) override
+  {
+    if (available() <= 0)
+    {
+      return -1;
+    }
+    const size_t n = min(size, rxLen - rxPos);
+    memcpy(buf, rxBuf + rxPos, n);
+    rxPos += n;
+    return n;
+  }
+
+  int peek() override
+  {
+    return available() > 0 ? rxBuf[rxPos] : -1;
+  }
+
+  void flush() override
+  {
+  }
+
+  void stop() override
+  {
+    if (open)
+    {
+      mbedtls_ssl_close_notify(&ssl);
+    }
+    if (initialized)
+    {
+      mbedtls_ssl_free(&ssl);
+      mbedtls_ssl_config_free(&conf);
+      mbedtls_net_free(&net);
+    }
+    initialized = false;
+    open = false;
+    rxPos = rxLen = 0;
+    connectedHost[0] = '\0';
+  }
+
+  uint8_t connected() override
+  {
+    return open || rxPos < rxLen;
+  }
+
+  operator bool() override
+  {
+    return connected();
+  }
+
+  // Conexão aberta com este host e sem sinal de encerramento pelo servidor
+  bool isAliveFor(const char *host)
+  {
+    if (!open || strcmp(host, connectedHost) != 0)
+    {
+      return false;
+    }
+    // Dados inesperados ou FIN numa conexão ociosa: o servidor fechou por inatividade
+    available();
+    if (!open || rxPos < rxLen)
+    {
+      stop();
+      return false;
+    }
+    return true;
+  }
+
+  unsigned long getLastHandshakeMs() const
+  {
+    return lastHandshakeMs;
+  }
+
+  bool wasResumed() const
+  {
+    return lastResumed;
+  }
+
+private:
+  static const uint32_t SESSION_MAGIC = 0x544C5331; // "TLS1"
+
+  TlsSessionCache &cache;
+  TlsStats &stats;
+
+  mbedtls_net_context net;
+  mbedtls_ssl_context ssl;
+  mbedtls_ssl_config conf;
+  bool initialized = false;
+  bool open = false;
+  char connectedHost[64] = {0};
+
+  uint8_t rxBuf[512];
+  size_t rxPos = 0;
+  size_t rxLen = 0;
+  uint32_t bytesIn = 0;
+
+  unsigned long lastHandshakeMs = 0;
+  bool lastResumed = false;
+
+  static int randomBytes(void *, unsigned char *out, size_t len)
+  {
+    esp_fill_random(out, len);
+    return 0;
+  }
+
+  static int countingSend(void *ctx, const unsigned char *buf, size_t len)
+  {
+    return mbedtls_net_send(&static_cast<TlsConnection *>(ctx)->net, buf, len);
+  }
+
+  static int countingRecv(void *ctx, unsigned char *buf, size_t len, uint32_t timeout)
+  {
+    TlsConnection *self = static_cast<TlsConnection *>(ctx);
+    const int ret = mbedtls_net_recv_timeout(&self->net, buf, len, timeout);
+    if (ret > 0)
+    {
+      self->bytesIn += ret;
+    }
+    return ret;
+  }
+
+  bool loadSession(const char *host)
+  {
+    if (cache.magic != SESSION_MAGIC || strcmp(cache.host, host) != 0 || cache.len == 0)
+    {
+      return false;
+    }
+
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    const bool ok = mbedtls_ssl_session_load(&session, cache.data, cache.len) == 0 &&
+                    mbedtls_ssl_set_session(&ssl, &session) == 0;
+    mbedtls_ssl_session_free(&session);
+    if (!ok)
+    {
+      cache.magic = 0;
+    }
+    return ok;
+  }
+
+  void saveSession(const char *host)
+  {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    size_t len = 0;
+    if (mbedtls_ssl_get_session(&ssl, &session) == 0 &&
+        mbedtls_ssl_session_save(&session, cache.data, sizeof(cache.data), &len) == 0)
+    {
+      cache.magic = SESSION_MAGIC;
+      strncpy(cache.host, host, sizeof(cache.host) - 1);
+      cache.host[sizeof(cache.host) - 1] = '\0';
+      cache.len = len;
+    }
+    else
+    {
+      cache.magic = 0;
+      Serial.println("AVISO: Sessão TLS não coube na RTC (aumente TLS_SESSION_MAX_SIZE)");
+    }
+    mbedtls_ssl_session_free(&session);
+  }
+};
+
+// Uma conexão keep-alive por host (Gemini e plataforma web), cada uma com sua
+// sessão TLS na RTC. get() devolve a conexão aberta se ela ainda estiver viva;
+// senão reconecta retomando a sessão salva.
+class TlsConnectionManager
+{
+public:
+  static const int MAX_HOSTS = 2;
+
+  TlsConnectionManager(TlsSessionCache *caches, TlsStats &stats) : stats(stats)
+  {
+    for (int i = 0; i < MAX_HOSTS; i++)
+    {
+      connections[i] = new TlsConnection(caches[i], stats);
+    }
+  }
+
+  // slot: índice fixo por host (a sessão na RTC é por slot). Cada slot deve ser
+  // usado por uma task de cada vez; slots diferentes podem rodar em paralelo.
+  // handshakeMs (opcional) recebe a duração do handshake desta chamada (0 se reutilizou)
+  TlsConnection *get(int slot, const char *host, uint16_t port, unsigned long *handshakeMs = nullptr)
+  {
+    if (handshakeMs)
+    {
+      *handshakeMs = 0;
+    }
+
+    TlsConnection *connection = connections[slot];
+    if (connection->isAliveFor(host))
+    {
+      portENTER_CRITICAL(&tlsStatsMux());
+      stats.reused++;
+      portEXIT_CRITICAL(&tlsStatsMux());
+      Serial.print("Reutilizando conexão keep-alive com ");
+      Serial.println(host);
+      return connection;
+    }
+    if (!connection->connect(host, port))
+    {
+      return nullptr;
+    }
+    if (handshakeMs)
+    {
+      *handshakeMs = connection->getLastHandshakeMs();
+    }
+    return connection;
+  }
+
+  void close(int slot)
+  {
+    connections[slot]->stop();
+  }
+
+  void closeAll()
+  {
+    for (int i = 0; i < MAX_HOSTS; i++)
+    {
+      connections[i]->stop();
+    }
+  }
+
+private:
+  TlsConnection *connections[MAX_HOSTS];
+  TlsStats &stats;
+};
+
+#endif // TLS_CONNECTION_H
@@ -11,20 +11,46 @@
 
 // Camera libraries
 #include "esp_camera.h"
+#include "esp_timer.h"
+#include "BurstCapture.h"  // Rajada por disparo e escolha do melhor frame
 #include "soc/soc.h"
 #include "soc/rtc_cntl_reg.h"
 #include "driver/rtc_io.h"
 
-// Wi-Fi & HTTPS
+// Wi-Fi & HTTPS (TLS com retomada de sessão e keep-alive)
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
+#include <WiFiCache.h>     // libraries/WiFiCache: canal/BSSID/IP da última conexão na RTC (reconexão rápida)
+#include "TlsConnection.h"
+#include "HttpResponse.h"
+#include "JsonStringField.h"   // Extrai o texto da resposta do Gemini enquanto ela chega
 
-// Base64 (usado para enviar JPEG em JSON para o Gemini)
-#include "mbedtls/base64.h"
+// Estimativa de energia por evento
+#include "EnergyMeter.h"
+
+// Corpo JSON com o JPEG em base64 gerado em blocos direto no cliente TLS
+#include "StreamingBody.h"
+#include "ApiRequests.h"       // Montagem das requisições (também usada pelo build nativo em ../host)
+
+// Servidor web interno
+#include <esp_http_server.h>
+#include "SharedImage.h"       // Última imagem com ETag, lida pelo servidor sem travar o loop()
 
 // Deep Sleep
 #include "esp_sleep.h"
 
+// Detector de pessoas embarcado (classificador int8 96x96)
+#include <PersonDetector.h>   // libraries/PersonDetector (compartilhado com Esp32S-CAM)
+
+// Veredito do Gemini por cena (hash perceptual), guardado na RTC
+#include "SceneCache.h"
+
+// Gravação de eventos no microSD com histórico pré-disparo
+#include "SdEventRecorder.h"
+
+// Lote de capturas entre despertares (microSD ou LittleFS na flash interna)
+#include <LittleFS.h>
+#include "EventBatch.h"
+
 // ============================================================================
 // ==== CONFIGURAÇÕES DE HARDWARE - CONSTANTES ====
 // ============================================================================
@@ -50,7 +76,7 @@
 #define BATTERY_VOLTAGE_NOMINAL 3.7   // Volts - tensão nominal (~50%)
 
 // Constantes de timing e delays
-#define FLASH_STABILIZE_DELAY 100     // ms - Delay para estabilização do flash LED
+#define FLASH_STABILIZE_DELAY 100     // ms - Delay para estabilização do flash LED (sem rajada)
 #define DEEP_SLEEP_DELAY 2000         // ms - Delay antes de entrar em deep sleep
 #define SERIAL_BAUD_RATE 115200       // Baud rate do Serial Monitor
 #define SERIAL_INIT_DELAY 1000        // ms - Delay inicial do Serial
@@ -72,13 +98,32 @@
 
 // Constantes de comunicação de rede
 #define WIFI_CONNECT_TIMEOUT 20000     // ms - Timeout para conexão WiFi
-#define WIFI_CONNECT_RETRY_DELAY 500  // ms - Delay entre tentativas de conexão WiFi
+#define WIFI_CONNECT_RETRY_DELAY 500  // ms - Intervalo entre os pontos de progresso no Serial
+#define WIFI_CONNECT_POLL_DELAY 10     // ms - Intervalo de verificação do status da conexão
+#define WIFI_FAST_CONNECT_ENABLED 1    // Reusar canal, BSSID e IP da última conexão (WiFiCache.h)
+#define WIFI_FAST_CONNECT_TIMEOUT 3000 // ms - Sem conexão nesse tempo, volta para varredura + DHCP
 #define HTTP_RESPONSE_TIMEOUT 15000    // ms - Timeout para resposta HTTP
-#define HTTP_RESPONSE_READ_TIMEOUT 5000 // ms - Timeout para leitura completa da resposta
 #define HTTP_RESPONSE_MAX_LENGTH 2000 // bytes - Tamanho máximo da resposta HTTP
 #define GEMINI_REQUEST_TIMEOUT 10000  // ms - Timeout para requisição ao Gemini
 #define HTTPS_PORT 443                 // Porta HTTPS padrão
 #define HTTP_PORT 80                   // Porta HTTP padrão
+#define WEB_IMAGE_CHUNK 4096           // bytes - Pedaço do JPEG por httpd_resp_send_chunk
+#define WEB_SEND_TIMEOUT_S 2           // s - Cliente que não recebe um pedaço nesse tempo é derrubado
+
+// Resolução da câmera. Como o JPEG é enviado em base64 por blocos (StreamingBody.h),
+// a RAM extra do envio não depende do tamanho do frame; com PSRAM dá para usar XGA/UXGA.
+// Sem PSRAM o firmware volta para SVGA, que cabe no frame buffer em DRAM.
+#define CAMERA_FRAME_SIZE FRAMESIZE_XGA
+
+// Com PSRAM: CAMERA_FB_COUNT buffers em CAMERA_GRAB_LATEST e rajada de até
+// CAPTURE_BURST_FRAMES frames por disparo, com o flash ligado; fica o mais nítido e
+// bem exposto (BurstCapture.h). A rajada substitui a espera fixa do flash e usa o
+// mesmo orçamento (FLASH_STABILIZE_DELAY): passado esse tempo, fica o melhor já avaliado.
+// Sem PSRAM: um buffer em DRAM, frame único após FLASH_STABILIZE_DELAY.
+#define CAMERA_FB_COUNT 3
+#define CAPTURE_BURST_FRAMES 3         // 1 = frame único, como sem PSRAM
+
+BurstCapture burstCapture;
 
 // ==== Configurações de rede ====
 
@@ -94,21 +139,111 @@ const char* GEMINI_API_KEY = "sua_api_gemini";
 // Host e caminho do modelo Gemini 2.5 Flash-Lite
 const char* GEMINI_HOST = "generativelanguage.googleapis.com";
 const char* GEMINI_MODEL_PATH = "/v1beta/models/gemini-2.5-flash-lite:generateContent";
+const uint16_t GEMINI_PORT = HTTPS_PORT;  // Troque host/porta para testar com ../mock_server.py --tls
 
 // ==== Configurações da Plataforma Web (Vercel) ====
 // TODO: substitua pela URL da sua aplicação deployada na Vercel
 const char* WEB_APP_HOST = "seu-app.vercel.app";  // Apenas o hostname, sem https:// e sem /
 const char* WEB_APP_PATH = "/api/upload";
+const char* WEB_APP_DECISION_PATH = "/api/decision";  // Decisão enviada depois do upload paralelo
 const uint16_t WEB_APP_PORT = 443;  // HTTPS
 
+// ==== Conexões HTTPS ====
+// Uma conexão keep-alive por host; as sessões TLS ficam na RTC e são retomadas após o deep sleep
+#define TLS_SLOT_GEMINI 0
+#define TLS_SLOT_WEB_APP 1
+
+RTC_DATA_ATTR TlsSessionCache tlsSessions[TlsConnectionManager::MAX_HOSTS];
+RTC_DATA_ATTR TlsStats tlsStats;
+TlsConnectionManager tlsManager(tlsSessions, tlsStats);
+
+// Energia do último evento (RTC: exibida na página web depois de acordar)
+EnergyMeter energyMeter;
+RTC_DATA_ATTR EnergyMeter::Report lastEnergyReport;
+RTC_DATA_ATTR bool hasEnergyReport = false;
+bool wokeFromSleep = false;
+
+// ==== Reconexão rápida e latência do despertar ====
+RTC_DATA_ATTR WiFiCache wifiCache;
+RTC_DATA_ATTR uint32_t lastWiFiConnectMs = 0;      // Última associação + IP
+RTC_DATA_ATTR bool lastWiFiFast = false;           // Última conexão usou o cache
+RTC_DATA_ATTR uint32_t lastWakeToFirstByteMs = 0;  // Último despertar até o 1º byte enviado
+// millis() do primeiro byte de requisição deste boot (0: nenhum ainda). Escrito pelas
+// duas tasks de envio; escrita de 32 bits é atômica e qualquer das duas serve.
+volatile uint32_t firstByteMs = 0;
+
+void markFirstByte() {
+  if (firstByteMs == 0) {
+    firstByteMs = millis();
+  }
+}
+
+// ==== Pipeline paralelo (dois cores) ====
+// Com 1, o upload da imagem para a plataforma web começa numa task no core 0 ao
+// mesmo tempo que o Gemini classifica no loop (core 1). A imagem chega com decisão
+// "pending" e a decisão vai depois numa requisição pequena (WEB_APP_DECISION_PATH)
+// pela mesma conexão keep-alive. Com 0, o envio é sequencial: Gemini e depois upload.
+#define PARALLEL_UPLOAD_ENABLED 1
+#define UPLOAD_TASK_STACK 12288        // bytes - TLS + montagem do payload
+#define UPLOAD_TASK_CORE 0             // Loop do Arduino roda no core 1
+
+// ==== Detector de pessoas embarcado ====
+// Requer libraries/PersonDetector/src/person_model_data.h gerado por
+// Esp32S-CAM/person_model_tool.py; com o modelo vazio o detector fica inativo
+// e todas as imagens seguem para o Gemini.
+// 0 = desativado: toda imagem vai ao Gemini
+// 1 = filtro: negativos locais não saem do dispositivo; positivos são confirmados pelo Gemini
+// 2 = somente local: o Gemini não é chamado; positivos vão direto para a plataforma web
+#define PERSON_DETECTOR_MODE 1
+#define PERSON_DETECTOR_THRESHOLD 0.6  // Probabilidade mínima para considerar "pessoa"
+
+PersonDetector personDetector;
+
+// ==== Cache de veredito por cena ====
+// Com 1, o veredito do Gemini fica guardado na RTC junto com um hash perceptual da
+// imagem (dHash de 256 bits). Um novo disparo do PIR diante da mesma cena (até
+// SCENE_CACHE_MAX_DISTANCE bits diferentes, há menos de SCENE_CACHE_MAX_AGE_S)
+// reaproveita o veredito sem chamar o Gemini; o upload para a plataforma web continua.
+// Custo: decodificar o JPEG em 1/8 da resolução (dezenas de ms) contra ~1-2 s de rádio.
+// O botão sempre consulta o Gemini (e atualiza o cache). Veja SceneCache.h.
+#define SCENE_CACHE_ENABLED 1
+
+RTC_DATA_ATTR SceneCache::State sceneCacheState;
+SceneCache sceneCache(sceneCacheState);
+
+// ==== Gravação de eventos no microSD ====
+// Mantém os últimos SD_PRE_TRIGGER_FRAMES frames em PSRAM e, a cada disparo, grava
+// histórico + disparo + SD_POST_TRIGGER_FRAMES frames em /events (veja SdEventRecorder.h).
+// ATENÇÃO: o SD em modo 1 bit usa os GPIO 14 e 15, os mesmos dos LEDs vermelho/verde.
+// Com a gravação ativada os LEDs de decisão ficam desligados.
+#define SD_RECORDER_ENABLED 0
+
+SdEventRecorder sdRecorder;
+
+// ==== Lote de eventos entre despertares ====
+// Com 1, cada despertar do PIR guarda a captura (no microSD se SD_RECORDER_ENABLED,
+// senão no LittleFS da flash) e volta a dormir sem ligar o Wi-Fi. O lote sobe numa
+// única sessão Wi-Fi quando atingir BATCH_FLUSH_COUNT capturas, quando a mais antiga
+// passar de BATCH_MAX_AGE_S (despertar por timer) ou com bateria abaixo de
+// BATCH_LOW_BATTERY_VOLTAGE (veja EventBatch.h). O botão sempre envia na hora, e o
+// lote pendente vai junto. Requer partição com sistema de arquivos
+// (ex.: "Huge APP (3MB No OTA/1MB SPIFFS)").
+#define BATCH_ENABLED 0
+
+RTC_DATA_ATTR EventBatch::State batchState;
+EventBatch eventBatch(batchState);
+
 // ==== Servidor web interno (HTTP) ====
 
-WiFiServer webServer(80);
+// esp_http_server roda em tarefa própria (fora do core do loop); o loop() nunca
+// para por causa da página. A tarefa é uma só: as conexões ficam abertas ao mesmo
+// tempo (pool de sockets), mas as requisições são atendidas uma por vez. Por isso
+// o JPEG sai em pedaços com timeout curto: um cliente parado é derrubado em
+// WEB_SEND_TIMEOUT_S em vez de segurar os outros
+httpd_handle_t webServer = nullptr;
 
-// Buffer da última imagem capturada (cópia do JPEG) e última decisão do Gemini
-uint8_t* lastImage = nullptr;
-size_t lastImageLen = 0;
-String lastDecision = "unknown";
+// Última imagem capturada (cópia do JPEG) e última decisão do Gemini
+SharedImage lastImage;
 
 // Pin definitions for CAMERA_MODEL_AI_THINKER
 #define PWDN_GPIO_NUM     32
@@ -154,10 +289,24 @@ void configESPCamera() {
   config.pin_reset = RESET_GPIO_NUM;
   config.xclk_freq_hz = 20000000;
   config.pixel_format = PIXFORMAT_JPEG; // Choices are YUV422, GRAYSCALE, RGB565, JPEG
-  // Para evitar problemas de memória, usamos sempre um frame moderado
-  config.frame_size = FRAMESIZE_SVGA; // FRAMESIZE_ + QVGA|CIF|VGA|SVGA|XGA|SXGA|UXGA
+  // Frame buffer em PSRAM permite resoluções maiores; sem PSRAM, frame moderado
+  if (psramFound()) {
+    config.frame_size = CAMERA_FRAME_SIZE; // FRAMESIZE_ + QVGA|CIF|VGA|SVGA|XGA|SXGA|UXGA
+    config.fb_location = CAMERA_FB_IN_PSRAM;
+  } else {
+    config.frame_size = FRAMESIZE_SVGA;
+    config.fb_location = CAMERA_FB_IN_DRAM;
+  }
   config.jpeg_quality = 12;           //10-63 lower número = maior qualidade
-  config.fb_count = 1;
+  // Vários buffers só cabem em PSRAM; com eles o driver segue capturando enquanto
+  // um frame é avaliado ou enviado, e fb_get entrega sempre o mais recente
+  if (psramFound()) {
+    config.fb_count = CAMERA_FB_COUNT;
+    config.grab_mode = CAMERA_GRAB_LATEST;
+  } else {
+    config.fb_count = 1;
+    config.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
+  }
 
   // Initialize the Camera
   esp_err_t err = esp_camera_init(&config);
@@ -388,24 +537,61 @@ bool connectWiFi() {
   Serial.print("SSID: ");
   Serial.println(WIFI_SSID);
   
-  // Configurar modo estação (cliente)
+  // Configurar modo estação (cliente), sem gravar credenciais na flash a cada conexão
+  WiFi.persistent(false);
   WiFi.mode(WIFI_STA);
-  
-  // Tentar conectar
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
-  // Aguardar conexão com timeout
   unsigned long startAttemptTime = millis();
-  while (WiFi.status() != WL_CONNECTED && 
-         (millis() - startAttemptTime) < WIFI_CONNECT_TIMEOUT) {
-    delay(WIFI_CONNECT_RETRY_DELAY);
-    Serial.print(".");
+  lastWiFiFast = false;
+
+  // Caminho rápido: canal + BSSID (sem varredura) e IP do último lease (sem DHCP)
+  if (WIFI_FAST_CONNECT_ENABLED && wifiCache.isValidFor(WIFI_SSID, WIFI_PASSWORD)) {
+    WiFi.config(IPAddress(wifiCache.ip), IPAddress(wifiCache.gateway),
+                IPAddress(wifiCache.subnet), IPAddress(wifiCache.dns));
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD, wifiCache.channel, wifiCache.bssid);
+    while (WiFi.status() != WL_CONNECTED &&
+           (millis() - startAttemptTime) < WIFI_FAST_CONNECT_TIMEOUT) {
+      delay(WIFI_CONNECT_POLL_DELAY);
+    }
+
+    if (WiFi.status() == WL_CONNECTED) {
+      lastWiFiFast = true;
+    } else {
+      // AP mudou de canal, roteador trocado ou IP recusado: conexão completa
+      Serial.println("Reconexão rápida falhou. Fazendo varredura + DHCP...");
+      wifiCache.clear();
+      WiFi.disconnect();
+      WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // Volta para DHCP
+    }
+  }
+
+  if (WiFi.status() != WL_CONNECTED) {
+    // Tentar conectar
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+
+    // Aguardar conexão com timeout (verificação curta; pontos a cada WIFI_CONNECT_RETRY_DELAY)
+    unsigned long lastDot = millis();
+    while (WiFi.status() != WL_CONNECTED && 
+           (millis() - startAttemptTime) < WIFI_CONNECT_TIMEOUT) {
+      delay(WIFI_CONNECT_POLL_DELAY);
+      if (millis() - lastDot >= WIFI_CONNECT_RETRY_DELAY) {
+        lastDot = millis();
+        Serial.print(".");
+      }
+    }
+    if (WiFi.status() == WL_CONNECTED) {
+      wifiCache.save(WIFI_SSID, WIFI_PASSWORD);
+    }
   }
+  lastWiFiConnectMs = millis() - startAttemptTime;
+  energyMeter.add(EnergyMeter::PHASE_WIFI, lastWiFiConnectMs);
 
   // Verificar resultado da conexão
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("");
-    Serial.print("✓ Wi-Fi conectado. IP: ");
+    Serial.print("✓ Wi-Fi conectado em ");
+    Serial.print(lastWiFiConnectMs);
+    Serial.print(lastWiFiFast ? " ms (reconexão rápida). IP: " : " ms. IP: ");
     Serial.println(WiFi.localIP());
     Serial.print("RSSI: ");
     Serial.print(WiFi.RSSI());
@@ -436,14 +622,41 @@ camera_fb_t* captureImage() {
   // (não há função direta para isso, mas podemos tentar capturar)
   
   // Ligar o flash LED antes de capturar para melhor iluminação
+  unsigned long flashStart = millis();
   digitalWrite(FLASH_LED_PIN, HIGH);
-  delay(FLASH_STABILIZE_DELAY); // Delay para o flash estabilizar
-  
-  // Capturar frame da câmera
-  camera_fb_t* fb = esp_camera_fb_get();
+
+  camera_fb_t* fb = nullptr;
+  if (psramFound() && CAPTURE_BURST_FRAMES > 1) {
+    // Rajada: frames expostos antes do flash são descartados; fica o melhor dos seguintes
+    fb = burstCapture.capture(CAPTURE_BURST_FRAMES, esp_timer_get_time(), FLASH_STABILIZE_DELAY,
+                              PersonDetector::INPUT_SIZE);
+  } else {
+    delay(FLASH_STABILIZE_DELAY); // Delay para o flash estabilizar
+    fb = esp_camera_fb_get();
+  }
   
   // Desligar o flash LED após capturar
   digitalWrite(FLASH_LED_PIN, LOW);
+  energyMeter.add(EnergyMeter::PHASE_FLASH, millis() - flashStart);
+
+  if (fb && psramFound() && CAPTURE_BURST_FRAMES > 1) {
+    const BurstCapture::FrameScore& best = burstCapture.getLastBest();
+    Serial.print("Rajada: melhor frame ");
+    Serial.print(burstCapture.getLastBestIndex());
+    Serial.print("/");
+    Serial.print(burstCapture.getLastFrames());
+    Serial.print(" (nitidez ");
+    Serial.print(best.sharpness, 1);
+    Serial.print(", exposição ");
+    Serial.print(best.exposure, 2);
+    Serial.print("), ");
+    Serial.print(burstCapture.getLastSkipped());
+    Serial.print(" anteriores ao flash descartados, ");
+    Serial.print(burstCapture.getLastMs());
+    Serial.print(" ms (espera fixa: ");
+    Serial.print(FLASH_STABILIZE_DELAY);
+    Serial.println(" ms)");
+  }
   
   // Validação: verificar se a captura foi bem-sucedida
   if (!fb) {
@@ -473,6 +686,29 @@ camera_fb_t* captureImage() {
   return fb;
 }
 
+// Sinaliza a decisão nos LEDs e guarda cópia da imagem para o servidor web interno
+void applyDecision(camera_fb_t* fb, bool detected) {
+  if (SD_RECORDER_ENABLED) {
+    // LEDs compartilham pinos com o microSD
+    Serial.println(detected ? "Detecção: pessoa encontrada." : "Detecção: nenhuma pessoa.");
+  } else if (detected) {
+    Serial.println("Detecção: pessoa encontrada. Acendendo LED vermelho.");
+    digitalWrite(LED_RED_PIN, HIGH);
+    digitalWrite(LED_GREEN_PIN, LOW);
+  } else {
+    Serial.println("Detecção: nenhuma pessoa. Acendendo LED verde.");
+    digitalWrite(LED_RED_PIN, LOW);
+    digitalWrite(LED_GREEN_PIN, HIGH);
+  }
+
+  // Atualizar cópia da última imagem e decisão para visualização via servidor web interno
+  if (lastImage.publish(fb->buf, fb->len, detected ? "person" : "no_person")) {
+    Serial.println("Última imagem e decisão armazenadas para visualização web.");
+  } else {
+    Serial.println("Falha ao alocar memória para armazenar última imagem.");
+  }
+}
+
 // Envia a imagem para o Gemini 2.5 Flash-Lite usando JSON com inline_data base64
 // Retorna true se sucesso, e personDetected será preenchido com a decisão
 bool sendImageToGemini(camera_fb_t* fb, bool* personDetected) {
@@ -490,14 +726,14 @@ bool sendImageToGemini(camera_fb_t* fb, bool* personDetected) {
     }
   }
 
-  WiFiClientSecure client;
-  client.setInsecure(); // Para MVP: desabilita verificação de certificado (não usar em produção)
-
   Serial.print("Conectando a ");
   Serial.print(GEMINI_HOST);
   Serial.println("...");
 
-  if (!client.connect(GEMINI_HOST, HTTPS_PORT)) {
+  unsigned long handshakeMs = 0;
+  TlsConnection* client = tlsManager.get(TLS_SLOT_GEMINI, GEMINI_HOST, GEMINI_PORT, &handshakeMs);
+  energyMeter.add(EnergyMeter::PHASE_TLS, handshakeMs);
+  if (!client) {
     Serial.print("✗ ERRO: Falha ao conectar ao host Gemini (");
     Serial.print(GEMINI_HOST);
     Serial.print(":");
@@ -506,142 +742,93 @@ bool sendImageToGemini(camera_fb_t* fb, bool* personDetected) {
     return false;
   }
 
-  // Codificar o JPEG em base64
-  size_t encoded_len = 0;
-  size_t max_encoded_len = (fb->len * 4) / 3 + 4;
-  unsigned char* encoded = (unsigned char*)malloc(max_encoded_len);
-  if (!encoded) {
-    Serial.println("Falha ao alocar memória para base64");
+  // Payload JSON com o JPEG em base64 gerado durante o envio (ApiRequests.h)
+  StreamingBody body = buildGeminiBody(fb->buf, fb->len);
+  String request = buildPostHead(buildGeminiPath(GEMINI_MODEL_PATH, GEMINI_API_KEY), GEMINI_HOST,
+                                 "application/json; charset=utf-8", body.contentLength());
+
+  Serial.println("Enviando requisição ao Gemini...");
+  unsigned long sendStart = millis();
+  markFirstByte();
+  client->print(request);
+  if (!body.writeTo(*client)) {
+    Serial.println("✗ ERRO: Conexão interrompida durante o envio ao Gemini");
+    tlsManager.close(TLS_SLOT_GEMINI);
     return false;
   }
-
-  int res = mbedtls_base64_encode(encoded, max_encoded_len, &encoded_len, fb->buf, fb->len);
-  if (res != 0) {
-    Serial.print("Erro ao codificar base64, código: ");
-    Serial.println(res);
-    free(encoded);
+  energyMeter.add(EnergyMeter::PHASE_TX, millis() - sendStart);
+  Serial.print("Corpo de ");
+  Serial.print((unsigned long)body.contentLength());
+  Serial.print(" bytes enviado em ");
+  Serial.print(millis() - sendStart);
+  Serial.println(" ms");
+
+  // Ler resposta extraindo só candidates[0].content.parts[0].text enquanto os bytes
+  // chegam; a leitura para assim que o texto fecha (metadados de uso são ignorados)
+  unsigned long responseStart = millis();
+  JsonStringField text("text");
+  HttpResponse http;
+  if (!http.read(*client, text, GEMINI_REQUEST_TIMEOUT)) {
+    Serial.println("✗ ERRO: Timeout aguardando resposta do Gemini");
+    tlsManager.close(TLS_SLOT_GEMINI);
     return false;
   }
-
-  String base64Data = String((char*)encoded);
-  free(encoded);
-
-  // Montar o payload JSON esperado pela API do Gemini
-  // Instrução: responder apenas "person" ou "no_person"
-  String payload = "{";
-  payload += "\"contents\":[{\"parts\":[";
-  payload += "{\"text\":\"Responda exatamente 'person' se houver pelo menos uma pessoa humana visível na imagem, ";
-  payload += "ou 'no_person' se não houver nenhuma pessoa. Não explique, não adicione nada além dessas palavras.\"},";
-  payload += "{\"inline_data\":{";
-  payload += "\"mime_type\":\"image/jpeg\",";
-  payload += "\"data\":\"" + base64Data + "\"";
-  payload += "}}]}]";
-  payload += "}";
-
-  // Caminho incluindo a API key na query string
-  String urlPath = String(GEMINI_MODEL_PATH) + "?key=" + GEMINI_API_KEY;
-
-  // Cabeçalhos HTTP
-  String request = String("POST ") + urlPath + " HTTP/1.1\r\n" +
-                   "Host: " + String(GEMINI_HOST) + "\r\n" +
-                   "Content-Type: application/json; charset=utf-8\r\n" +
-                   "Content-Length: " + String(payload.length()) + "\r\n" +
-                   "Connection: close\r\n\r\n";
-
-  Serial.println("Enviando requisição ao Gemini...");
-  client.print(request);
-  client.print(payload);
-
-  // Ler resposta com timeout configurável
-  unsigned long timeout = millis();
-  while (client.connected() && !client.available()) {
-    if (millis() - timeout > GEMINI_REQUEST_TIMEOUT) {
-      Serial.println("✗ ERRO: Timeout aguardando resposta do Gemini");
-      client.stop();
-      return false;
-    }
-    delay(LOOP_DELAY);
+  if (!http.keepAlive) {
+    // Inclui o encerramento antecipado: o restante do corpo ficou no socket
+    tlsManager.close(TLS_SLOT_GEMINI);
   }
 
-  // Ler resposta completa
-  String response = "";
-  while (client.available()) {
-    String line = client.readStringUntil('\n');
-    response += line + "\n";
+  Serial.print("Resposta do Gemini (HTTP ");
+  Serial.print(http.code);
+  Serial.print(") em ");
+  Serial.print(millis() - responseStart);
+  Serial.print(" ms, ");
+  Serial.print((unsigned long)http.bodyBytes);
+  Serial.println(http.stoppedEarly ? " bytes lidos (encerrada após o texto)" : " bytes lidos");
+  if (!text.found()) {
+    Serial.println("✗ ERRO: Resposta sem campo \"text\". Início da resposta:");
+    Serial.println(text.getPreview());
+    return false;
   }
 
-  Serial.println("Resposta do Gemini:");
-  Serial.println(response);
-
-  // Lógica simples: se contiver "no_person" => não há pessoa;
-  // senão, se contiver "person" => há pessoa.
-  bool detected = false;
-  if (response.indexOf("no_person") != -1) {
-    detected = false;
-  } else if (response.indexOf("person") != -1) {
-    detected = true;
-  }
+  Serial.print("Texto do Gemini: ");
+  Serial.println(text.value());
+  bool detected = geminiAnswerIsPerson(text.value());
 
   // Retornar a decisão através do parâmetro
   if (personDetected != nullptr) {
     *personDetected = detected;
   }
 
-  if (detected) {
-    Serial.println("Detecção: pessoa encontrada. Acendendo LED vermelho.");
-    digitalWrite(LED_RED_PIN, HIGH);
-    digitalWrite(LED_GREEN_PIN, LOW);
-  } else {
-    Serial.println("Detecção: nenhuma pessoa. Acendendo LED verde.");
-    digitalWrite(LED_RED_PIN, LOW);
-    digitalWrite(LED_GREEN_PIN, HIGH);
-  }
+  applyDecision(fb, detected);
 
-  // Atualizar cópia da última imagem e decisão para visualização via servidor web interno
-  if (lastImage != nullptr) {
-    free(lastImage);
-    lastImage = nullptr;
-    lastImageLen = 0;
-  }
-
-    lastImage = (uint8_t*)malloc(fb->len);
-    if (lastImage) {
-      memcpy(lastImage, fb->buf, fb->len);
-      lastImageLen = fb->len;
-      lastDecision = detected ? "person" : "no_person";
-      Serial.println("Última imagem e decisão armazenadas para visualização web.");
-    } else {
-      Serial.println("Falha ao alocar memória para armazenar última imagem.");
-    }
-
-  client.stop();
   return true;
 }
 
 // Envia a imagem e decisão para a plataforma web (Vercel)
-bool sendImageToWebApp(camera_fb_t* fb, bool personDetected) {
+// decision: "person", "no_person" ou "pending" (decisão chega depois via sendDecisionToWebApp)
+// captureId liga a imagem à decisão; meter recebe as fases de TLS/envio (pode rodar na task de upload)
+// ageSeconds: idade da captura (envio em lote); 0 para captura feita agora
+// Não reconecta o Wi-Fi: a reconexão fica com o loop principal
+bool sendImageToWebApp(camera_fb_t* fb, const char* decision, const char* captureId, uint32_t ageSeconds, EnergyMeter& meter) {
   if (!fb) {
     Serial.println("Frame buffer nulo, não é possível enviar para a plataforma web");
     return false;
   }
 
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("Wi-Fi desconectado, tentando reconectar...");
-    connectWiFi();
-    if (WiFi.status() != WL_CONNECTED) {
-      Serial.println("Ainda sem Wi-Fi. Abortando envio para plataforma web.");
-      return false;
-    }
+    Serial.println("Sem Wi-Fi. Abortando envio para plataforma web.");
+    return false;
   }
 
-  WiFiClientSecure client;
-  client.setInsecure(); // Para MVP: desabilita verificação de certificado
-
   Serial.print("Conectando a ");
   Serial.print(WEB_APP_HOST);
   Serial.println("...");
 
-  if (!client.connect(WEB_APP_HOST, WEB_APP_PORT)) {
+  unsigned long handshakeMs = 0;
+  TlsConnection* client = tlsManager.get(TLS_SLOT_WEB_APP, WEB_APP_HOST, WEB_APP_PORT, &handshakeMs);
+  meter.add(EnergyMeter::PHASE_TLS, handshakeMs);
+  if (!client) {
     Serial.print("✗ ERRO: Falha ao conectar ao servidor web (");
     Serial.print(WEB_APP_HOST);
     Serial.print(":");
@@ -650,26 +837,6 @@ bool sendImageToWebApp(camera_fb_t* fb, bool personDetected) {
     return false;
   }
 
-  // Codificar o JPEG em base64
-  size_t encoded_len = 0;
-  size_t max_encoded_len = (fb->len * 4) / 3 + 4;
-  unsigned char* encoded = (unsigned char*)malloc(max_encoded_len);
-  if (!encoded) {
-    Serial.println("Falha ao alocar memória para base64");
-    return false;
-  }
-
-  int res = mbedtls_base64_encode(encoded, max_encoded_len, &encoded_len, fb->buf, fb->len);
-  if (res != 0) {
-    Serial.print("Erro ao codificar base64, código: ");
-    Serial.println(res);
-    free(encoded);
-    return false;
-  }
-
-  String base64Data = String((char*)encoded);
-  free(encoded);
-
   // Ler dados da bateria antes de enviar
   float batteryVoltage = readBatteryVoltage();
   int batteryPercentage = calculateBatteryPercentage(batteryVoltage);
@@ -680,27 +847,16 @@ bool sendImageToWebApp(camera_fb_t* fb, bool personDetected) {
   Serial.print(batteryPercentage);
   Serial.println("%");
   
-  // Montar o payload JSON
-  String decision = personDetected ? "person" : "no_person";
-  String payload = "{";
-  payload += "\"image\":\"data:image/jpeg;base64," + base64Data + "\",";
-  payload += "\"decision\":\"" + decision + "\",";
-  payload += "\"battery\":{";
-  payload += "\"voltage\":" + String(batteryVoltage, 3) + ",";
-  payload += "\"percentage\":" + String(batteryPercentage);
-  payload += "}";
-  payload += "}";
+  // Montar o payload JSON (a imagem em base64 é gerada durante o envio)
+  StreamingBody body = buildUploadBody(fb->buf, fb->len, decision, captureId, ageSeconds,
+                                       batteryVoltage, batteryPercentage);
 
   Serial.print("Tamanho do payload: ");
-  Serial.print(payload.length());
+  Serial.print((unsigned long)body.contentLength());
   Serial.println(" bytes");
 
   // Cabeçalhos HTTP
-  String request = String("POST ") + String(WEB_APP_PATH) + " HTTP/1.1\r\n" +
-                   "Host: " + String(WEB_APP_HOST) + "\r\n" +
-                   "Content-Type: application/json\r\n" +
-                   "Content-Length: " + String(payload.length()) + "\r\n" +
-                   "Connection: close\r\n\r\n";
+  String request = buildPostHead(WEB_APP_PATH, WEB_APP_HOST, "application/json", body.contentLength());
 
   Serial.println("Enviando imagem para plataforma web...");
   Serial.print("Host: ");
@@ -709,83 +865,47 @@ bool sendImageToWebApp(camera_fb_t* fb, bool personDetected) {
   Serial.println(WEB_APP_PATH);
   
   // Enviar requisição
-  size_t requestLen = client.print(request);
-  size_t payloadLen = client.print(payload);
+  unsigned long sendStart = millis();
+  markFirstByte();
+  size_t requestLen = client->print(request);
+  if (!body.writeTo(*client)) {
+    Serial.println("✗ ERRO: Conexão interrompida durante o envio para a plataforma web");
+    tlsManager.close(TLS_SLOT_WEB_APP);
+    return false;
+  }
+  meter.add(EnergyMeter::PHASE_TX, millis() - sendStart);
   
   Serial.print("Bytes enviados - Request: ");
   Serial.print(requestLen);
   Serial.print(", Payload: ");
-  Serial.println(payloadLen);
-
-  // Aguardar resposta com timeout configurável
-  unsigned long timeout = millis();
-  while (client.connected() && !client.available()) {
-    if (millis() - timeout > HTTP_RESPONSE_TIMEOUT) {
-      Serial.print("✗ ERRO: Timeout aguardando resposta da plataforma web (");
-      Serial.print(HTTP_RESPONSE_TIMEOUT / 1000);
-      Serial.println("s)");
-      client.stop();
-      return false;
-    }
-    delay(LOOP_DELAY);
+  Serial.println((unsigned long)body.contentLength());
+
+  // Aguardar e ler resposta (status, cabeçalhos e corpo) com timeout e limite de tamanho
+  HttpResponse http;
+  if (!http.read(*client, HTTP_RESPONSE_MAX_LENGTH, HTTP_RESPONSE_TIMEOUT)) {
+    Serial.print("✗ ERRO: Timeout aguardando resposta da plataforma web (");
+    Serial.print(HTTP_RESPONSE_TIMEOUT / 1000);
+    Serial.println("s)");
+    tlsManager.close(TLS_SLOT_WEB_APP);
+    return false;
   }
-
-  // Ler resposta completa
-  String response = "";
-  String statusLine = "";
-  int httpCode = 0;
-  bool firstLine = true;
-  
-  // Ler resposta completa com timeout e limite de tamanho
-  unsigned long responseTimeout = millis();
-  while (client.available() || client.connected()) {
-    if (millis() - responseTimeout > HTTP_RESPONSE_READ_TIMEOUT) {
-      Serial.println("AVISO: Timeout lendo resposta completa");
-      break;
-    }
-    
-    if (client.available()) {
-      String line = client.readStringUntil('\n');
-      response += line + "\n";
-      
-      if (firstLine) {
-        statusLine = line;
-        // Extrair código HTTP (ex: "HTTP/1.1 200 OK")
-        int spaceIndex = line.indexOf(' ');
-        if (spaceIndex > 0) {
-          int codeIndex = spaceIndex + 1;
-          int codeEndIndex = line.indexOf(' ', codeIndex);
-          if (codeEndIndex > 0) {
-            httpCode = line.substring(codeIndex, codeEndIndex).toInt();
-          }
-        }
-        firstLine = false;
-      }
-      
-      // Limitar tamanho da resposta para não sobrecarregar memória
-      if (response.length() > HTTP_RESPONSE_MAX_LENGTH) {
-        response += "... (truncado)";
-        Serial.print("AVISO: Resposta truncada em ");
-        Serial.print(HTTP_RESPONSE_MAX_LENGTH);
-        Serial.println(" bytes");
-        break;
-      }
-    } else {
-      delay(LOOP_DELAY);
-    }
+  if (!http.keepAlive) {
+    tlsManager.close(TLS_SLOT_WEB_APP);
   }
+  if (http.truncated) {
+    Serial.print("AVISO: Resposta truncada em ");
+    Serial.print(HTTP_RESPONSE_MAX_LENGTH);
+    Serial.println(" bytes");
+  }
+  int httpCode = http.code;
 
   Serial.println("=== Resposta da plataforma web ===");
-  Serial.print("Status: ");
-  Serial.println(statusLine);
   Serial.print("Código HTTP: ");
   Serial.println(httpCode);
   Serial.println("Resposta completa:");
-  Serial.println(response);
+  Serial.println(http.body);
   Serial.println("===================================");
 
-  client.stop();
-  
   // Verificar se foi sucesso
   if (httpCode >= 200 && httpCode < 300) {
     Serial.println("✓ Envio bem-sucedido!");
@@ -797,6 +917,125 @@ bool sendImageToWebApp(camera_fb_t* fb, bool personDetected) {
   }
 }
 
+// Envia só a decisão de uma imagem já enviada com decisão "pending"
+// Corpo pequeno: reaproveita a conexão keep-alive aberta pelo upload
+bool sendDecisionToWebApp(const char* captureId, const char* decision) {
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("Sem Wi-Fi. Abortando envio da decisão.");
+    return false;
+  }
+
+  unsigned long handshakeMs = 0;
+  TlsConnection* client = tlsManager.get(TLS_SLOT_WEB_APP, WEB_APP_HOST, WEB_APP_PORT, &handshakeMs);
+  energyMeter.add(EnergyMeter::PHASE_TLS, handshakeMs);
+  if (!client) {
+    Serial.println("✗ ERRO: Falha ao conectar ao servidor web para enviar a decisão");
+    return false;
+  }
+
+  String body = buildDecisionBody(captureId, decision);
+  String request = buildPostHead(WEB_APP_DECISION_PATH, WEB_APP_HOST, "application/json", body.length()) + body;
+
+  unsigned long sendStart = millis();
+  client->print(request);
+  energyMeter.add(EnergyMeter::PHASE_TX, millis() - sendStart);
+
+  HttpResponse http;
+  if (!http.read(*client, HTTP_RESPONSE_MAX_LENGTH, HTTP_RESPONSE_TIMEOUT)) {
+    Serial.println("✗ ERRO: Timeout aguardando resposta do envio da decisão");
+    tlsManager.close(TLS_SLOT_WEB_APP);
+    return false;
+  }
+  if (!http.keepAlive) {
+    tlsManager.close(TLS_SLOT_WEB_APP);
+  }
+
+  Serial.print("Decisão '");
+  Serial.print(decision);
+  Serial.print("' enviada (HTTP ");
+  Serial.print(http.code);
+  Serial.println(")");
+  return http.code >= 200 && http.code < 300;
+}
+
+// ============================================================================
+// ==== UPLOAD EM PARALELO (CORE 0) ====
+// ============================================================================
+
+/**
+ * Upload em andamento na task do core 0. O frame é só lido pelas duas tasks e
+ * só pode ser liberado depois de finishParallelUpload().
+ */
+struct UploadJob {
+  camera_fb_t* fb;
+  char captureId[9];          // 8 dígitos hex aleatórios
+  uint32_t ageSeconds;        // Idade da captura (envio em lote)
+  EnergyMeter meter;          // Fases medidas pela task (somadas ao evento no fim)
+  bool ok;
+  SemaphoreHandle_t done;     // Liberado pela task ao terminar
+};
+
+UploadJob uploadJob = {nullptr, "", 0, EnergyMeter(), false, nullptr};
+
+void uploadTask(void* arg) {
+  UploadJob* job = (UploadJob*)arg;
+  job->ok = sendImageToWebApp(job->fb, "pending", job->captureId, job->ageSeconds, job->meter);
+  xSemaphoreGive(job->done);
+  vTaskDelete(nullptr);
+}
+
+// Inicia o upload da imagem no core 0. Retorna false se não foi possível
+// (sem Wi-Fi ou sem memória para a task): o chamador envia de forma sequencial.
+bool startParallelUpload(camera_fb_t* fb, uint32_t ageSeconds) {
+  if (WiFi.status() != WL_CONNECTED && !connectWiFi()) {
+    return false;
+  }
+  if (uploadJob.done == nullptr) {
+    uploadJob.done = xSemaphoreCreateBinary();
+    if (uploadJob.done == nullptr) {
+      return false;
+    }
+  }
+
+  uploadJob.fb = fb;
+  uploadJob.ageSeconds = ageSeconds;
+  snprintf(uploadJob.captureId, sizeof(uploadJob.captureId), "%08lx", (unsigned long)esp_random());
+  uploadJob.meter.begin();
+  uploadJob.ok = false;
+
+  if (xTaskCreatePinnedToCore(uploadTask, "upload", UPLOAD_TASK_STACK, &uploadJob, 1, nullptr, UPLOAD_TASK_CORE) != pdPASS) {
+    Serial.println("AVISO: Falha ao criar task de upload. Enviando de forma sequencial.");
+    return false;
+  }
+
+  Serial.print("Upload em paralelo iniciado (captura ");
+  Serial.print(uploadJob.captureId);
+  Serial.println(")");
+  return true;
+}
+
+// Aguarda o upload terminar e envia a decisão. Retorna false se o upload da
+// imagem falhou (o chamador refaz o envio completo com a decisão).
+bool finishParallelUpload(const char* decision) {
+  unsigned long waitStart = millis();
+  xSemaphoreTake(uploadJob.done, portMAX_DELAY);
+  energyMeter.merge(uploadJob.meter);
+
+  Serial.print("Upload em paralelo ");
+  Serial.print(uploadJob.ok ? "concluído" : "falhou");
+  Serial.print(" (aguardado ");
+  Serial.print(millis() - waitStart);
+  Serial.println(" ms após o Gemini)");
+  if (!uploadJob.ok) {
+    return false;
+  }
+
+  if (!sendDecisionToWebApp(uploadJob.captureId, decision)) {
+    Serial.println("Falha no envio da decisão: imagem fica como 'pending' na plataforma web.");
+  }
+  return true;
+}
+
 // ============================================================================
 // ==== ESTRUTURAS DE DADOS PARA ENCAPSULAMENTO ====
 // ============================================================================
@@ -830,41 +1069,205 @@ struct PIRState {
 ButtonState buttonState = {HIGH, HIGH, 0};
 PIRState pirState = {LOW, LOW, 0, 0, 0, false};
 
-// Buffer da última imagem capturada (necessário para servidor web interno)
-uint8_t* lastImage = nullptr;
-size_t lastImageLen = 0;
-String lastDecision = "unknown";
-
-// Função para processar captura e envio (usada tanto por botão quanto PIR)
-void processCaptureAndSend() {
-  Serial.println("Iniciando captura e envio ao Gemini...");
+// Classifica a captura (Gemini, ou detector local no modo 2) e envia para a plataforma web
+// localScore: probabilidade do detector local (-1 sem detector); ageSeconds: idade (lote)
+// allowCached: aceita o veredito de uma cena igual já classificada (disparos do PIR)
+// Retorna true se a imagem chegou à plataforma web
+// luma: frame já decodificado no evento (nullptr decodifica aqui, ex.: capturas do lote)
+bool classifyAndUpload(camera_fb_t* fb, float localScore, uint32_t ageSeconds, bool allowCached,
+                       const LumaFrame* luma) {
+  bool personDetected = false;
+  bool upload = true;
+  bool webOk = false;
+
+  if (localScore >= 0.0 && PERSON_DETECTOR_MODE == 2) {
+    Serial.println("Positivo no detector local (modo somente local).");
+    personDetected = true;
+    applyDecision(fb, true);
+  } else {
+    // Hash da cena: veredito guardado se ela foi classificada há pouco
+    SceneCache::Hash sceneHash;
+    bool hashed = false;
+    bool cachedVerdict = false;
+    uint16_t distance = 0;
+    if (SCENE_CACHE_ENABLED) {
+      unsigned long hashStart = millis();
+      hashed = luma != nullptr ? SceneCache::hashLuma(*luma, &sceneHash) : SceneCache::hashFrame(fb, &sceneHash);
+      Serial.print("Hash da cena: ");
+      Serial.print(hashed ? "ok" : "falhou");
+      Serial.print(" em ");
+      Serial.print(millis() - hashStart);
+      Serial.println(" ms");
+    }
 
-  camera_fb_t* fb = captureImage();
-  if (fb) {
-    bool personDetected = false;
-    bool ok = sendImageToGemini(fb, &personDetected);
-    if (ok) {
-      Serial.println("Envio ao Gemini concluído.");
+    if (hashed && allowCached && sceneCache.lookup(sceneHash, &cachedVerdict, &distance)) {
+      Serial.print("Cena conhecida (");
+      Serial.print(distance);
+      Serial.println(" bits de diferença): veredito reaproveitado, Gemini dispensado.");
+      personDetected = cachedVerdict;
+      applyDecision(fb, personDetected);
     } else {
-      Serial.println("Falha no envio ao Gemini. Continuando mesmo assim...");
-      // Continuar mesmo se o Gemini falhar
+      // Upload da imagem no core 0 enquanto o Gemini classifica aqui
+      bool parallel = PARALLEL_UPLOAD_ENABLED && startParallelUpload(fb, ageSeconds);
+
+      bool ok = sendImageToGemini(fb, &personDetected);
+      if (ok) {
+        Serial.println("Envio ao Gemini concluído.");
+        if (hashed) {
+          sceneCache.store(sceneHash, personDetected);
+        }
+      } else {
+        Serial.println("Falha no envio ao Gemini. Continuando mesmo assim...");
+        // Continuar mesmo se o Gemini falhar
+      }
+
+      if (parallel && finishParallelUpload(ok ? (personDetected ? "person" : "no_person") : "unknown")) {
+        upload = false; // Imagem e decisão já enviadas
+        webOk = true;
+      }
     }
-    
-    // Sempre tentar enviar para a plataforma web, mesmo se o Gemini falhar
+  }
+
+  // Enviar para a plataforma web mesmo se o Gemini falhar
+  if (upload) {
     Serial.println("Enviando imagem para plataforma web...");
-    bool webOk = sendImageToWebApp(fb, personDetected);
+    if (WiFi.status() != WL_CONNECTED) {
+      connectWiFi();
+    }
+    char captureId[9];
+    snprintf(captureId, sizeof(captureId), "%08lx", (unsigned long)esp_random());
+    webOk = sendImageToWebApp(fb, personDetected ? "person" : "no_person", captureId, ageSeconds, energyMeter);
     if (webOk) {
       Serial.println("Envio para plataforma web concluído.");
     } else {
       Serial.println("Falha no envio para plataforma web.");
     }
+  }
+  return webOk;
+}
 
-    // Liberar frame buffer para evitar vazamento de memória
-    esp_camera_fb_return(fb);
+// Envia as capturas do lote numa única sessão Wi-Fi (conexões keep-alive entre elas)
+// Retorna quantas chegaram à plataforma web; as que falharam ficam para o próximo envio
+size_t flushBatch(EventBatch::FlushReason why) {
+  Serial.print("Enviando lote de ");
+  Serial.print(eventBatch.count());
+  Serial.print(" capturas (motivo: ");
+  Serial.print(EventBatch::reasonName(why));
+  Serial.println(")");
+
+  if (WiFi.status() != WL_CONNECTED && !connectWiFi()) {
+    Serial.println("Sem Wi-Fi: lote mantido para nova tentativa.");
+    return 0;
   }
 
+  const size_t total = eventBatch.count();
+  bool sent[BATCH_MAX_EVENTS] = {false};
+  size_t sentCount = 0;
+  for (size_t i = 0; i < total; i++) {
+    const EventBatch::Entry& entry = eventBatch.entry(i);
+    camera_fb_t* fb = eventBatch.load(i);
+    if (!fb) {
+      Serial.println("✗ ERRO: Captura do lote ilegível, descartada.");
+      sent[i] = true; // Apagar: nova tentativa falharia igual
+      continue;
+    }
+
+    Serial.print("Captura ");
+    Serial.print(i + 1);
+    Serial.print("/");
+    Serial.print(total);
+    Serial.print(" do lote (há ");
+    Serial.print(eventBatch.ageOf(i));
+    Serial.println(" s)");
+    float localScore = entry.localScore < 0 ? -1.0 : entry.localScore / 1000.0;
+    sent[i] = classifyAndUpload(fb, localScore, eventBatch.ageOf(i), entry.reason == SdEventRecorder::REASON_PIR, nullptr);
+    sentCount += sent[i] ? 1 : 0;
+    eventBatch.release(fb);
+  }
+
+  eventBatch.finishFlush(sent);
+  return sentCount;
+}
+
+// Compara a energia do lote (despertares de captura + envio) com a estimativa de
+// enviar cada captura na hora, que pagaria de novo Wi-Fi, handshake e a espera final
+void printBatchEnergy(size_t sentCount, float batteryVoltage) {
+  const float captureMj = eventBatch.getCaptureMillijoules();
+  const float batchMj = captureMj + lastEnergyReport.millijoules;
+  const float connectMj =
+      EnergyMeter::millijoules(EnergyMeter::phaseCurrentMa(EnergyMeter::PHASE_WIFI), lastEnergyReport.phaseMs[EnergyMeter::PHASE_WIFI], batteryVoltage) +
+      EnergyMeter::millijoules(EnergyMeter::phaseCurrentMa(EnergyMeter::PHASE_TLS), lastEnergyReport.phaseMs[EnergyMeter::PHASE_TLS], batteryVoltage) +
+      EnergyMeter::millijoules(ENERGY_CURRENT_ACTIVE_MA, DEEP_SLEEP_DELAY, batteryVoltage);
+  const float unbatchedMj = batchMj + connectMj * (sentCount - 1);
+
+  Serial.println("=== Energia do lote (estimada) ===");
+  Serial.print(sentCount);
+  Serial.print(" capturas: ");
+  Serial.print(eventBatch.getCaptureWakes());
+  Serial.print(" despertares de captura (");
+  Serial.print(captureMj, 1);
+  Serial.print(" mJ) + envio (");
+  Serial.print(lastEnergyReport.millijoules, 1);
+  Serial.println(" mJ)");
+  Serial.print("Total: ");
+  Serial.print(batchMj, 1);
+  Serial.print(" mJ (");
+  Serial.print(batchMj / sentCount, 1);
+  Serial.print(" mJ/captura). Sem lote: ~");
+  Serial.print(unbatchedMj, 1);
+  Serial.print(" mJ (economia de ");
+  Serial.print(unbatchedMj > 0 ? 100.0 * (unbatchedMj - batchMj) / unbatchedMj : 0.0, 0);
+  Serial.println("%)");
+  Serial.println("==================================");
+  eventBatch.clearCaptureEnergy();
+}
+
+// Fecha a contabilidade do despertar e entra em deep sleep
+// eventStart: início do evento (0 se acordou do deep sleep); batchSent: capturas do lote enviadas
+void finishEventAndSleep(unsigned long eventStart, size_t batchSent) {
+  bool wifiUsed = WiFi.status() == WL_CONNECTED;
+
   // Aguardar um pouco antes de entrar em deep sleep (permite logs finais)
-  delay(DEEP_SLEEP_DELAY);
+  // Despertar só de captura (lote) não usou rede: basta esvaziar o Serial
+  if (wifiUsed) {
+    delay(DEEP_SLEEP_DELAY);
+  } else {
+    Serial.flush();
+  }
+
+  // Encerrar conexões (close_notify) e registrar energia/handshakes do evento
+  tlsManager.closeAll();
+  float batteryVoltage = readBatteryVoltage();
+  lastEnergyReport = energyMeter.finish(millis() - eventStart, batteryVoltage);
+  hasEnergyReport = true;
+  EnergyMeter::print(lastEnergyReport);
+  Serial.print("TLS: ");
+  Serial.print(tlsStats.handshakes);
+  Serial.print(" handshakes (");
+  Serial.print(tlsStats.resumed);
+  Serial.print(" retomados), ");
+  Serial.print(tlsStats.reused);
+  Serial.print(" reutilizações keep-alive, último handshake ");
+  Serial.print(tlsStats.lastHandshakeMs);
+  Serial.println(" ms");
+
+  // Latência do despertar: boot até o primeiro byte de requisição (sem o boot da ROM)
+  if (wokeFromSleep && firstByteMs != 0) {
+    lastWakeToFirstByteMs = firstByteMs;
+    Serial.print("Despertar até o 1º byte: ");
+    Serial.print(lastWakeToFirstByteMs);
+    Serial.print(" ms (Wi-Fi ");
+    Serial.print(lastWiFiConnectMs);
+    Serial.println(lastWiFiFast ? " ms, reconexão rápida)" : " ms, conexão completa)");
+  }
+
+  if (eventBatch.isReady()) {
+    if (!wifiUsed) {
+      eventBatch.addCaptureWake(lastEnergyReport.millijoules);
+    } else if (batchSent > 0) {
+      printBatchEnergy(batchSent, batteryVoltage);
+    }
+  }
   
   // Entrar em deep sleep
   Serial.println("Entrando em modo deep sleep...");
@@ -887,6 +1290,17 @@ void processCaptureAndSend() {
   } else {
     Serial.println("AVISO: Wake-up do PIR desabilitado - sensor pode estar desconectado");
   }
+
+  // Lote pendente: acordar pelo timer quando a captura mais antiga vencer
+  if (eventBatch.isReady() && eventBatch.count() > 0) {
+    uint32_t seconds = eventBatch.secondsUntilDue();
+    esp_sleep_enable_timer_wakeup((uint64_t)seconds * 1000000ULL);
+    Serial.print("Lote com ");
+    Serial.print(eventBatch.count());
+    Serial.print(" capturas pendentes. Timer de envio em ");
+    Serial.print(seconds);
+    Serial.println(" s");
+  }
   
   // Nota: O botão (GPIO 13) é LOW quando pressionado, então será verificado manualmente
   // no setup após acordar, já que EXT1 não pode detectar LOW diretamente com ANY_HIGH
@@ -896,6 +1310,226 @@ void processCaptureAndSend() {
   esp_deep_sleep_start();
 }
 
+// Função para processar captura e envio (usada tanto por botão quanto PIR)
+void processCaptureAndSend(SdEventRecorder::Reason reason) {
+  Serial.println("Iniciando captura e envio ao Gemini...");
+
+  // Após o deep sleep o evento começa no boot; acordado, começa agora
+  unsigned long eventStart = wokeFromSleep ? 0 : millis();
+  if (!wokeFromSleep) {
+    energyMeter.begin();
+  }
+
+  camera_fb_t* fb = captureImage();
+  if (fb && sdRecorder.isReady()) {
+    // Grava o evento antes da rede; a câmera é liberada e fb passa a ser uma cópia
+    fb = sdRecorder.recordEvent(fb, reason);
+  }
+  if (fb) {
+    // Uma decodificação por evento, para o detector local e o cache de cenas.
+    // Com rajada é a luma que escolheu o frame; sem ela, decodifica aqui
+    const bool detectorOn = PERSON_DETECTOR_MODE != 0 && personDetector.isReady();
+    LumaFrame decoded;
+    const LumaFrame* luma = nullptr;
+    if (psramFound() && CAPTURE_BURST_FRAMES > 1) {
+      luma = &burstCapture.getBestLuma();
+    } else if (detectorOn || SCENE_CACHE_ENABLED) {
+      decoded.decode(fb, PersonDetector::inputScale(fb));
+      luma = &decoded;
+    }
+    if (luma != nullptr && !luma->isValid()) {
+      luma = nullptr; // Falhou uma vez: cada consumidor tenta por conta própria
+    }
+
+    // Classificação local antes de qualquer ida à rede
+    float localScore = -1.0;
+    if (detectorOn) {
+      localScore = luma != nullptr ? personDetector.detect(*luma) : personDetector.detect(fb);
+      Serial.print("Detector local: probabilidade de pessoa ");
+      Serial.print(localScore, 2);
+      Serial.print(" em ");
+      Serial.print(personDetector.getLastInferenceMs());
+      Serial.println(" ms");
+    }
+
+    if (localScore >= 0.0 && localScore < PERSON_DETECTOR_THRESHOLD) {
+      // Negativo local: decisão imediata, imagem não sai do dispositivo
+      Serial.println("Negativo no detector local. Gemini e upload dispensados.");
+      applyDecision(fb, false);
+    } else if (eventBatch.isReady() && reason == SdEventRecorder::REASON_PIR &&
+               WiFi.status() != WL_CONNECTED && eventBatch.add(fb, reason, localScore)) {
+      // Guardada para o envio em lote; sem rede neste despertar
+    } else {
+      classifyAndUpload(fb, localScore, 0, reason == SdEventRecorder::REASON_PIR, luma);
+    }
+
+    // Liberar frame buffer para evitar vazamento de memória
+    sdRecorder.releaseFrame(fb);
+  }
+
+  // Enviar o lote pendente se a política indicar (ou se o Wi-Fi já está ligado)
+  size_t batchSent = 0;
+  if (eventBatch.isReady()) {
+    EventBatch::FlushReason why = eventBatch.shouldFlush(readBatteryVoltage(), WiFi.status() == WL_CONNECTED);
+    if (why != EventBatch::FLUSH_NONE) {
+      batchSent = flushBatch(why);
+    }
+  }
+
+  finishEventAndSleep(eventStart, batchSent);
+}
+
+// ==== Servidor web interno: handlers ====
+
+// GET / - Página de status. A imagem é referenciada pela ETag: o navegador só
+// baixa o JPEG de novo quando ele muda
+esp_err_t webRootHandler(httpd_req_t* req) {
+  SharedImage::Image* image = lastImage.acquire();
+
+  String page;
+  page.reserve(1536);
+  page += "<!DOCTYPE html><html><head><meta charset='utf-8'><title>ESP32-CAM Gemini</title></head><body>\n";
+  page += "<h1>ESP32-CAM + Gemini</h1>\n";
+  page += "<p>Última decisão: <strong>";
+  page += image != nullptr ? image->decision : "unknown";
+  page += "</strong></p>\n";
+
+  // Custo de rede e energia do último evento (guardados na RTC)
+  page += "<p>TLS: ";
+  page += String(tlsStats.handshakes);
+  page += " handshakes, ";
+  page += String(tlsStats.resumed);
+  page += " com sessão retomada, ";
+  page += String(tlsStats.reused);
+  page += " conexões reutilizadas. Último handshake: ";
+  page += String(tlsStats.lastHandshakeMs);
+  page += " ms</p>\n";
+  page += "<p>Wi-Fi: ";
+  page += String(lastWiFiConnectMs);
+  page += lastWiFiFast ? " ms (reconexão rápida)" : " ms (varredura + DHCP)";
+  if (lastWakeToFirstByteMs > 0) {
+    page += ". Despertar até o 1º byte: ";
+    page += String(lastWakeToFirstByteMs);
+    page += " ms";
+  }
+  page += "</p>\n";
+  if (SCENE_CACHE_ENABLED) {
+    page += "<p>Cache de cenas: ";
+    page += String(sceneCache.getHits());
+    page += " chamadas ao Gemini evitadas, ";
+    page += String(sceneCache.getMisses());
+    page += " cenas novas, ";
+    page += String((unsigned long)sceneCache.count());
+    page += " guardadas</p>\n";
+  }
+  if (hasEnergyReport) {
+    page += "<p>Último evento: ";
+    page += String(lastEnergyReport.awakeMs);
+    page += " ms acordado (TLS ";
+    page += String(lastEnergyReport.phaseMs[EnergyMeter::PHASE_TLS]);
+    page += " ms), ~";
+    page += String(lastEnergyReport.millijoules, 0);
+    page += " mJ / ";
+    page += String(lastEnergyReport.microAmpHours, 1);
+    page += " µAh</p>\n";
+  }
+
+  if (image != nullptr) {
+    // A ETag na URL muda junto com a imagem; a mesma URL é servida do cache
+    page += "<img src='/image.jpg?v=";
+    page += String((unsigned long)image->hash, HEX);
+    page += "' style='max-width:100%;height:auto;' />\n";
+  } else {
+    page += "<p>Nenhuma imagem disponível ainda. Pressione o botão ou aguarde detecção do PIR.</p>\n";
+  }
+  page += "</body></html>\n";
+  lastImage.release(image);
+
+  httpd_resp_set_type(req, "text/html; charset=utf-8");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+  return httpd_resp_send(req, page.c_str(), page.length());
+}
+
+// GET /image.jpg - Última imagem. Responde 304 sem corpo se o navegador já
+// tiver a versão atual (If-None-Match igual à ETag)
+esp_err_t webImageHandler(httpd_req_t* req) {
+  SharedImage::Image* image = lastImage.acquire();
+  if (image == nullptr) {
+    return httpd_resp_send_404(req);
+  }
+
+  httpd_resp_set_hdr(req, "ETag", image->etag);
+  httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+  // O cabeçalho pode trazer uma lista de ETags; basta conter a atual
+  char ifNoneMatch[64];
+  esp_err_t res;
+  if (httpd_req_get_hdr_value_str(req, "If-None-Match", ifNoneMatch, sizeof(ifNoneMatch)) == ESP_OK &&
+      strstr(ifNoneMatch, image->etag) != nullptr) {
+    httpd_resp_set_status(req, "304 Not Modified");
+    res = httpd_resp_send(req, nullptr, 0);
+  } else {
+    httpd_resp_set_type(req, "image/jpeg");
+    res = ESP_OK;
+    for (size_t sent = 0; sent < image->len && res == ESP_OK; sent += WEB_IMAGE_CHUNK) {
+      const size_t n = min((size_t)WEB_IMAGE_CHUNK, image->len - sent);
+      res = httpd_resp_send_chunk(req, (const char*)image->buf + sent, n);
+    }
+    if (res == ESP_OK) {
+      res = httpd_resp_send_chunk(req, nullptr, 0); // Fim da resposta
+    }
+  }
+
+  // O envio pode ter levado segundos num cliente lento; só agora a imagem
+  // antiga (se já substituída) é liberada
+  lastImage.release(image);
+  return res;
+}
+
+void startWebServer() {
+  if (webServer != nullptr) {
+    return;
+  }
+
+  httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+  config.server_port = HTTP_PORT;
+  config.core_id = 0;               // Fora do core do loop (PIR/botão)
+  config.lru_purge_enable = true;   // Com todos os sockets ocupados, fecha o visitante ocioso mais antigo
+  config.send_wait_timeout = WEB_SEND_TIMEOUT_S;
+
+  httpd_uri_t rootUri = {
+      .uri = "/",
+      .method = HTTP_GET,
+      .handler = webRootHandler,
+      .user_ctx = nullptr};
+
+  httpd_uri_t imageUri = {
+      .uri = "/image.jpg",
+      .method = HTTP_GET,
+      .handler = webImageHandler,
+      .user_ctx = nullptr};
+
+  // Caminho antigo, mantido para links salvos
+  httpd_uri_t imageLegacyUri = {
+      .uri = "/image",
+      .method = HTTP_GET,
+      .handler = webImageHandler,
+      .user_ctx = nullptr};
+
+  if (httpd_start(&webServer, &config) == ESP_OK) {
+    httpd_register_uri_handler(webServer, &rootUri);
+    httpd_register_uri_handler(webServer, &imageUri);
+    httpd_register_uri_handler(webServer, &imageLegacyUri);
+    Serial.print("✓ Servidor web iniciado na porta ");
+    Serial.print(HTTP_PORT);
+    Serial.print(". Acesse: http://");
+    Serial.println(WiFi.localIP());
+  } else {
+    webServer = nullptr;
+    Serial.println("✗ ERRO: Falha ao iniciar servidor web");
+  }
+}
+
 void setup() {
 
   // Disable brownout detector
@@ -911,6 +1545,7 @@ void setup() {
   // Verificar qual GPIO acordou o sistema
   bool wokeByPIR = false;
   bool wokeByButton = false;
+  bool wokeByTimer = false;
   
   if (wakeup_reason == ESP_SLEEP_WAKEUP_EXT0) {
     // Acordou pelo EXT0 (PIR no GPIO 12)
@@ -927,9 +1562,13 @@ void setup() {
       wokeByButton = true;
       Serial.println("Acordou pelo botão (GPIO 13)!");
     }
+  } else if (wakeup_reason == ESP_SLEEP_WAKEUP_TIMER) {
+    wokeByTimer = true;
+    Serial.println("Acordou pelo timer do lote de capturas");
   } else {
     Serial.println("Inicialização normal (não foi deep sleep)");
   }
+  wokeFromSleep = wakeup_reason != ESP_SLEEP_WAKEUP_UNDEFINED;
 
   // Inicializa sensor PIR
   // O PIR deve estar configurado como RTC GPIO para funcionar no deep sleep
@@ -1003,22 +1642,54 @@ void setup() {
   configESPCamera();
   Serial.println("Camera OK!");
 
-  // Conecta ao Wi-Fi
-  connectWiFi();
+  // Detector embarcado (fica inativo se o modelo não foi gerado)
+  if (PERSON_DETECTOR_MODE != 0) {
+    personDetector.begin();
+  }
 
-  // Inicia servidor web interno na porta HTTP padrão
-  webServer.begin();
-  Serial.print("✓ Servidor web iniciado na porta ");
-  Serial.print(HTTP_PORT);
-  Serial.print(". Acesse: http://");
-  Serial.println(WiFi.localIP());
+  // Vereditos por cena guardados antes do deep sleep
+  if (SCENE_CACHE_ENABLED) {
+    sceneCache.begin();
+  }
+
+  // Cartão microSD para gravação de eventos
+  if (SD_RECORDER_ENABLED) {
+    sdRecorder.begin();
+  }
+
+  // Lote de capturas: usa o microSD se montado, senão o LittleFS da flash interna
+  if (BATCH_ENABLED) {
+    if (sdRecorder.isReady()) {
+      eventBatch.begin(SD_MMC);
+    } else if (LittleFS.begin(true)) {
+      eventBatch.begin(LittleFS);
+    } else {
+      Serial.println("✗ ERRO: LittleFS indisponível. Capturas serão enviadas na hora.");
+    }
+  }
+
+  // Com o lote ativo, despertares do PIR e do timer só ligam o Wi-Fi se o lote for enviado
+  bool deferWiFi = eventBatch.isReady() && (wokeByPIR || wokeByTimer);
+  if (!deferWiFi) {
+    // Conecta ao Wi-Fi
+    connectWiFi();
+
+    // Inicia servidor web interno na porta HTTP padrão
+    startWebServer();
+  }
 
   // Se acordou pelo PIR ou pelo botão, processar imediatamente
   if (wokeByPIR) {
     if (!pirState.isConnected) {
       Serial.println("AVISO: Sistema acordou pelo PIR, mas sensor pode estar desconectado. Ignorando...");
     } else {
-      delay(PIR_WAKE_STABILIZE_DELAY); // Delay maior para estabilizar o PIR após acordar (reduz falsos positivos)
+      // Delay maior para estabilizar o PIR após acordar (reduz falsos positivos).
+      // Com o microSD ativo, o intervalo é aproveitado para preencher o histórico pré-disparo.
+      if (sdRecorder.isReady()) {
+        sdRecorder.fillPreTrigger(PIR_WAKE_STABILIZE_DELAY);
+      } else {
+        delay(PIR_WAKE_STABILIZE_DELAY);
+      }
       // Verificar novamente se o PIR ainda está ativo após estabilização
       bool pirStillActive = false;
       for (int i = 0; i < PIR_STABILITY_CHECK_COUNT; i++) {
@@ -1032,16 +1703,24 @@ void setup() {
       if (pirStillActive) {
         Serial.println("Processando captura acionada pelo PIR (confirmado após estabilização)...");
         pirState.lastTriggerTime = millis(); // Registrar tempo da detecção
-        processCaptureAndSend();
+        processCaptureAndSend(SdEventRecorder::REASON_PIR);
       } else {
         Serial.println("PIR acionou mas não confirmou após estabilização - provável falso positivo, ignorando...");
+        if (deferWiFi) {
+          // Sem Wi-Fi nem servidor web neste despertar: voltar a dormir
+          finishEventAndSleep(0, 0);
+        }
       }
     }
   } else if (wokeByButton) {
     // Se acordou pelo botão, também processa automaticamente
     delay(BUTTON_WAKE_STABILIZE_DELAY); // Pequeno delay para estabilização após acordar
     Serial.println("Processando captura acionada pelo botão...");
-    processCaptureAndSend();
+    processCaptureAndSend(SdEventRecorder::REASON_BUTTON);
+  } else if (wokeByTimer) {
+    // Captura mais antiga do lote venceu: enviar sem nova captura
+    EventBatch::FlushReason why = eventBatch.isReady() ? eventBatch.shouldFlush(readBatteryVoltage(), false) : EventBatch::FLUSH_NONE;
+    finishEventAndSleep(0, why != EventBatch::FLUSH_NONE ? flushBatch(why) : 0);
   } else {
     Serial.println("Sistema pronto. Botão (GPIO 13) e PIR (GPIO 12) podem acordar do deep sleep e tirar foto automaticamente.");
   }
@@ -1072,7 +1751,7 @@ void loop() {
       // Botão pressionado (LOW quando pressionado, pull-up externo)
       if (buttonState.currentState == LOW) {
         Serial.println("✓ Botão pressionado!");
-        processCaptureAndSend();
+        processCaptureAndSend(SdEventRecorder::REASON_BUTTON);
       }
     }
   }
@@ -1114,7 +1793,7 @@ void loop() {
               Serial.println("✓ Movimento detectado pelo PIR (confirmado após estabilidade)!");
               pirState.lastTriggerTime = millis(); // Registrar tempo da detecção
               pirState.stabilityCount = 0; // Resetar contador
-              processCaptureAndSend();
+              processCaptureAndSend(SdEventRecorder::REASON_PIR);
             } else {
               // Ainda não confirmado, aguardar mais leituras
               Serial.print("PIR detectou movimento, aguardando confirmação (");
@@ -1144,6 +1823,17 @@ void loop() {
   // Pequeno delay para reduzir ruído de leitura e economizar CPU
   delay(LOOP_DELAY);
 
+  // --- Histórico pré-disparo para o microSD (frames sem flash) ---
+  static unsigned long lastPreTriggerFrame = 0;
+  if (sdRecorder.isReady() && millis() - lastPreTriggerFrame >= SD_FRAME_INTERVAL) {
+    lastPreTriggerFrame = millis();
+    camera_fb_t* preFb = esp_camera_fb_get();
+    if (preFb) {
+      sdRecorder.pushPreTrigger(preFb);
+      esp_camera_fb_return(preFb);
+    }
+  }
+
   // --- Leitura periódica de bateria ---
   static unsigned long lastBatteryRead = 0;
   
@@ -1152,82 +1842,4 @@ void loop() {
     printBatteryStatus();
   }
 
-  // --- Servidor web interno: atender requisições HTTP ---
-  WiFiClient webClient = webServer.available();
-  if (webClient) {
-    Serial.println("Cliente web conectado.");
-    
-    // Ler linha de requisição
-    String requestLine = webClient.readStringUntil('\r');
-    if (requestLine.length() == 0) {
-      // Requisição inválida, fechar conexão
-      webClient.stop();
-      Serial.println("✗ Requisição HTTP inválida");
-      return;
-    }
-    
-    webClient.readStringUntil('\n'); // Descartar \n
-
-    // Ler e descartar o restante dos cabeçalhos HTTP
-    while (webClient.available()) {
-      String headerLine = webClient.readStringUntil('\n');
-      if (headerLine == "\r" || headerLine.length() == 1) {
-        break; // Fim dos cabeçalhos
-      }
-    }
-
-    // Verificar tipo de requisição
-    bool requestImage = false;
-    if (requestLine.startsWith("GET /image")) {
-      requestImage = true;
-    }
-
-    // Responder conforme o tipo de requisição
-    if (requestImage && lastImage != nullptr && lastImageLen > 0) {
-      // Responder com a última imagem JPEG
-      webClient.println("HTTP/1.1 200 OK");
-      webClient.println("Content-Type: image/jpeg");
-      webClient.print("Content-Length: ");
-      webClient.println(lastImageLen);
-      webClient.println("Connection: close");
-      webClient.println();
-      
-      // Enviar dados da imagem
-      size_t bytesWritten = webClient.write(lastImage, lastImageLen);
-      if (bytesWritten != lastImageLen) {
-        Serial.print("AVISO: Nem todos os bytes foram enviados. Esperado: ");
-        Serial.print(lastImageLen);
-        Serial.print(", Enviado: ");
-        Serial.println(bytesWritten);
-      }
-    } else {
-      // Página HTML simples com a decisão e a imagem (se houver)
-      webClient.println("HTTP/1.1 200 OK");
-      webClient.println("Content-Type: text/html; charset=utf-8");
-      webClient.println("Connection: close");
-      webClient.println();
-
-      webClient.println("<!DOCTYPE html><html><head><meta charset='utf-8'><title>ESP32-CAM Gemini</title></head><body>");
-      webClient.println("<h1>ESP32-CAM + Gemini</h1>");
-      webClient.print("<p>Última decisão: <strong>");
-      webClient.print(lastDecision);
-      webClient.println("</strong></p>");
-
-      if (lastImage != nullptr && lastImageLen > 0) {
-        // Parâmetro ts para evitar cache do navegador
-        webClient.print("<img src='/image.jpg?ts=");
-        webClient.print(millis());
-        webClient.println("' style='max-width:100%;height:auto;' />");
-      } else {
-        webClient.println("<p>Nenhuma imagem disponível ainda. Pressione o botão ou aguarde detecção do PIR.</p>");
-      }
-
-      webClient.println("</body></html>");
-    }
-
-    delay(1); // Pequeno delay para garantir que os dados foram enviados
-    webClient.stop();
-    Serial.println("Cliente web desconectado.");
-  }
-
 }
\ No newline at end of file
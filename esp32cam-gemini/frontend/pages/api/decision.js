@@ -0,0 +1,52 @@
+/**
+ * API Route: /api/decision
+ * 
+ * Recebe a decisão do Gemini para uma imagem já enviada com decisão "pending".
+ * A ESP32 envia a imagem em paralelo à classificação e depois só esta
+ * requisição pequena, reduzindo o tempo acordada por evento.
+ * 
+ * @module pages/api/decision
+ * @requires ./store
+ */
+
+import { updateLatestDecision } from './store';
+
+/** Decisões aceitas */
+const VALID_DECISIONS = ['person', 'no_person', 'unknown'];
+
+/**
+ * Handler principal da API route
+ * 
+ * @param {Object} req - Objeto de requisição do Next.js
+ * @param {string} req.method - Método HTTP (deve ser POST)
+ * @param {Object} req.body - Corpo da requisição
+ * @param {string} req.body.capture_id - Identificador enviado junto com a imagem em /api/upload
+ * @param {string} req.body.decision - Decisão do Gemini: "person" ou "no_person"
+ * 
+ * @param {Object} res - Objeto de resposta do Next.js
+ * 
+ * @returns {void}
+ * 
+ * @throws {405} Se o método não for POST
+ * @throws {400} Se capture_id ou decision estiverem ausentes/inválidos
+ * @throws {404} Se a última imagem não corresponder ao capture_id
+ */
+export default function handler(req, res) {
+  if (req.method !== 'POST') {
+    return res.status(405).json({ error: 'Method not allowed' });
+  }
+
+  const captureId = req.body?.capture_id;
+  const decision = req.body?.decision;
+  if (!captureId || !VALID_DECISIONS.includes(decision)) {
+    return res.status(400).json({ error: 'capture_id and a valid decision are required' });
+  }
+
+  if (!updateLatestDecision(captureId, decision)) {
+    console.log('Decisão descartada: captura não é a última armazenada', captureId);
+    return res.status(404).json({ error: 'Capture not found', captureId });
+  }
+
+  console.log('✓ Decisão atualizada:', { captureId, decision });
+  return res.status(200).json({ success: true, captureId, decision });
+}
@@ -273,6 +273,7 @@ export function setLatestImage(imageData) {
       decision: imageData.decision || 'unknown',
       timestamp: imageData.timestamp,
       battery: imageData.battery || null,
+      captureId: imageData.captureId || null,
       imageUrl: imageData.imageUrl, // Manter a URL completa (base64)
     };
 
@@ -309,3 +310,23 @@ export function setLatestImage(imageData) {
   }
 }
 
+/**
+ * Atualiza a decisão da última imagem armazenada
+ * 
+ * @param {string} captureId - Identificador da captura enviado pela ESP32 no upload
+ * @param {string} decision - Decisão do Gemini ("person" ou "no_person")
+ * 
+ * @returns {boolean} true se a última imagem corresponde ao captureId e foi atualizada
+ * 
+ * @description
+ * Usado pelo pipeline paralelo da ESP32: a imagem chega com decisão "pending"
+ * enquanto o Gemini classifica, e a decisão chega depois em /api/decision.
+ * Se outra imagem já substituiu a última, a decisão atrasada é descartada.
+ */
+export function updateLatestDecision(captureId, decision) {
+  const latest = getLatestImage();
+  if (!latest || !captureId || latest.captureId !== captureId) {
+    return false;
+  }
+  return setLatestImage({ ...latest, decision });
+}
@@ -54,7 +54,11 @@ export const config = {
  * @param {string} req.method - Método HTTP (deve ser POST)
  * @param {Object} req.body - Corpo da requisição
  * @param {string} req.body.image - Imagem em base64 (data URI ou string)
- * @param {string} req.body.decision - Decisão do Gemini: "person" ou "no_person"
+ * @param {string} req.body.decision - Decisão do Gemini: "person", "no_person" ou "pending"
+ *   ("pending": a imagem foi enviada em paralelo à classificação e a decisão
+ *   chega depois em POST /api/decision com o mesmo capture_id)
+ * @param {string} [req.body.capture_id] - Identificador da captura gerado pela ESP32
+ * @param {number} [req.body.age_s] - Idade da captura em segundos (envio em lote após deep sleep)
  * @param {Object} req.body.battery - Dados da bateria
  * @param {number} req.body.battery.voltage - Tensão da bateria em Volts
  * @param {number} req.body.battery.percentage - Porcentagem de carga (0-100)
@@ -111,6 +115,7 @@ export default async function handler(req, res) {
     let imageData;
     let decision = req.body.decision || DEFAULT_DECISION;
     let battery = req.body.battery || null; // Dados de bateria (voltage e percentage)
+    let captureId = req.body.capture_id || null; // Liga a imagem à decisão enviada depois
 
     console.log('Processando imagem...');
     console.log('Decision:', decision);
@@ -141,7 +146,9 @@ export default async function handler(req, res) {
     }
 
     // Gerar nome do arquivo com timestamp (formato ISO)
-    const timestamp = new Date().toISOString();
+    // Capturas enviadas em lote chegam com a idade: o timestamp é o momento da captura
+    const ageSeconds = Number(req.body.age_s) > 0 ? Number(req.body.age_s) : 0;
+    const timestamp = new Date(Date.now() - ageSeconds * 1000).toISOString();
     const filename = `${FILENAME_PREFIX}${timestamp.replace(TIMESTAMP_REPLACE_PATTERN, TIMESTAMP_REPLACE_CHAR)}${FILENAME_EXTENSION}`;
 
     // Preparar dados da imagem
@@ -150,7 +157,8 @@ export default async function handler(req, res) {
       decision,
       imageUrl: imageData,
       timestamp,
-      battery // Incluir dados de bateria
+      battery, // Incluir dados de bateria
+      captureId
     };
 
     console.log('Armazenando imagem...');
@@ -172,7 +180,8 @@ export default async function handler(req, res) {
       filename: imageDataObj.filename,
       decision: imageDataObj.decision,
       timestamp: imageDataObj.timestamp,
-      battery: imageDataObj.battery
+      battery: imageDataObj.battery,
+      captureId: imageDataObj.captureId
     });
 
   } catch (error) {
@@ -118,7 +118,7 @@ export default function Home() {
   /**
    * Retorna cor e texto baseado na decisão do Gemini
    * 
-   * @param {string} decision - Decisão: "person", "no_person" ou outro
+   * @param {string} decision - Decisão: "person", "no_person", "pending" ou outro
    * @returns {Object} Objeto com color (hex), text (string) e icon (emoji)
    */
   const getDecisionColor = (decision) => {
@@ -126,6 +126,8 @@ export default function Home() {
       return { color: '#ef4444', text: 'Pessoa Detectada', icon: '🔴' };
     } else if (decision === 'no_person') {
       return { color: '#22c55e', text: 'Sem Pessoa', icon: '🟢' };
+    } else if (decision === 'pending') {
+      return { color: '#f59e0b', text: 'Analisando...', icon: '🟡' };
     }
     return { color: '#6b7280', text: 'Desconhecido', icon: '⚪' };
   };
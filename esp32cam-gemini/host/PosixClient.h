@@ -0,0 +1,141 @@
+#ifndef POSIX_CLIENT_H
+#define POSIX_CLIENT_H
+
+#include <Client.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Client TCP (HTTP sem TLS) sobre sockets POSIX, para rodar o código de
+// ../firmware contra o mock_server.py no PC. Leitura com buffer próprio, como
+// o WiFiClient: available() não bloqueia.
+class PosixClient : public Client
+{
+public:
+  ~PosixClient() override
+  {
+    stop();
+  }
+
+  int connect(const char *host, uint16_t port) override
+  {
+    stop();
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &result) != 0)
+    {
+      return 0;
+    }
+    for (addrinfo *ai = result; ai != nullptr && fd < 0; ai = ai->ai_next)
+    {
+      fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd >= 0 && ::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0)
+      {
+        close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(result);
+    if (fd < 0)
+    {
+      return 0;
+    }
+    // Igual ao lwIP do ESP32 com setNoDelay: cabeçalho e corpo saem sem esperar ACK
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    peerClosed = false;
+    return 1;
+  }
+
+  size_t write(uint8_t c) override
+  {
+    return write(&c, 1);
+  }
+
+  size_t write(const uint8_t *buf, size_t size) override
+  {
+    if (fd < 0)
+    {
+      return 0;
+    }
+    const ssize_t n = send(fd, buf, size, MSG_NOSIGNAL);
+    return n > 0 ? (size_t)n : 0;
+  }
+
+  int available() override
+  {
+    fill();
+    return (int)(end - start);
+  }
+
+  int read() override
+  {
+    if (available() <= 0)
+    {
+      return -1;
+    }
+    return buffer[start++];
+  }
+
+  int read(uint8_t *buf, size_t size) override
+  {
+    const int n = min((size_t)available(), size);
+    if (n <= 0)
+    {
+      return -1;
+    }
+    memcpy(buf, buffer + start, n);
+    start += n;
+    return n;
+  }
+
+  void stop() override
+  {
+    if (fd >= 0)
+    {
+      close(fd);
+      fd = -1;
+    }
+    start = end = 0;
+  }
+
+  uint8_t connected() override
+  {
+    fill();
+    return fd >= 0 && (!peerClosed || end > start);
+  }
+
+private:
+  int fd = -1;
+  bool peerClosed = false;
+  uint8_t buffer[4096];
+  size_t start = 0;
+  size_t end = 0;
+
+  // Lê o que já chegou, sem bloquear
+  void fill()
+  {
+    if (fd < 0 || peerClosed || start < end)
+    {
+      return;
+    }
+    start = end = 0;
+    const ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (n > 0)
+    {
+      end = (size_t)n;
+    }
+    else if (n == 0)
+    {
+      peerClosed = true;
+    }
+  }
+};
+
+#endif // POSIX_CLIENT_H
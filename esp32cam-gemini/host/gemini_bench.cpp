@@ -0,0 +1,403 @@
+// Benchmark no PC dos caminhos de requisição/resposta do firmware.
+//
+// Usa os mesmos headers de ../firmware (ApiRequests.h, StreamingBody.h,
+// HttpResponse.h, JsonStringField.h) sobre sockets POSIX, contra o
+// ../mock_server.py (ou qualquer servidor HTTP com os mesmos contratos). Mede
+// por requisição: montagem, envio (base64 incluído), tempo até o primeiro
+// byte da resposta, leitura/parse e total, e conta as conexões TCP abertas
+// (reuso por keep-alive).
+//
+// Com --offline não há rede: o corpo é escrito num contador e a resposta vem
+// de um buffer fixo, isolando o custo de CPU de montagem e parse.
+//
+// Uso:
+//   make
+//   python ../mock_server.py serve --port 8080 --latency-ms 300 &
+//   ./gemini_bench --port 8080 --image foto.jpg --requests 50
+//   ./gemini_bench --offline --size 30000 --requests 2000
+
+#include <Arduino.h>
+#include "PosixClient.h"
+#include "ApiRequests.h"
+#include "HttpResponse.h"
+#include "JsonStringField.h"
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+static const char *GEMINI_MODEL_PATH = "/v1beta/models/gemini-2.5-flash-lite:generateContent";
+static const char *WEB_APP_PATH = "/api/upload";
+static const unsigned long RESPONSE_TIMEOUT_MS = 30000;
+
+// Respostas usadas no modo --offline (formato do Gemini e de /api/upload)
+static const char GEMINI_JSON[] =
+    "{\n  \"candidates\": [\n    {\n      \"content\": {\n        \"parts\": [\n"
+    "          {\n            \"text\": \"person\"\n          }\n        ],\n        \"role\": \"model\"\n"
+    "      },\n      \"finishReason\": \"STOP\"\n    }\n  ],\n"
+    "  \"usageMetadata\": {\"totalTokenCount\": 302}\n}";
+static const char UPLOAD_JSON[] = "{\"success\":true,\"message\":\"Image received and stored\"}";
+
+// Mesmo enquadramento do mock_server.py: chunked em blocos de 64 bytes
+static std::string chunkedResponse(const std::string &json)
+{
+  std::string out = "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=UTF-8\r\n"
+                    "Transfer-Encoding: chunked\r\n\r\n";
+  char size[16];
+  for (size_t offset = 0; offset < json.size(); offset += 64)
+  {
+    const std::string part = json.substr(offset, 64);
+    snprintf(size, sizeof(size), "%zx\r\n", part.size());
+    out += size + part + "\r\n";
+  }
+  return out + "0\r\n\r\n";
+}
+
+static std::string lengthResponse(const std::string &json)
+{
+  return "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=UTF-8\r\nContent-Length: " +
+         std::to_string(json.size()) + "\r\n\r\n" + json;
+}
+
+// Client sem rede: conta o que é escrito e devolve uma resposta fixa
+class MemoryClient : public Client
+{
+public:
+  size_t written = 0;
+
+  void respondWith(const std::string &response)
+  {
+    data = response.data();
+    size = response.size();
+    pos = 0;
+  }
+
+  int connect(const char *, uint16_t) override { return 1; }
+  size_t write(uint8_t) override { written++; return 1; }
+  size_t write(const uint8_t *, size_t n) override { written += n; return n; }
+  int available() override { return (int)(size - pos); }
+  int read() override { return pos < size ? (uint8_t)data[pos++] : -1; }
+  int read(uint8_t *buf, size_t n) override
+  {
+    n = min(n, size - pos);
+    memcpy(buf, data + pos, n);
+    pos += n;
+    return (int)n;
+  }
+  void stop() override {}
+  uint8_t connected() override { return 1; }
+
+private:
+  const char *data = "";
+  size_t size = 0;
+  size_t pos = 0;
+};
+
+// Amostras de uma fase, em µs
+struct Phase
+{
+  const char *name;
+  std::vector<double> samples;
+
+  void add(unsigned long us) { samples.push_back((double)us); }
+
+  void print() const
+  {
+    if (samples.empty())
+    {
+      return;
+    }
+    std::vector<double> ordered(samples);
+    std::sort(ordered.begin(), ordered.end());
+    double sum = 0;
+    for (double v : ordered)
+    {
+      sum += v;
+    }
+    const double p95 = ordered[std::min(ordered.size() - 1, (size_t)(ordered.size() * 0.95))];
+    printf("  %-10s média %9.3f ms  p50 %9.3f ms  p95 %9.3f ms  máx %9.3f ms\n", name,
+           sum / ordered.size() / 1000.0, ordered[ordered.size() / 2] / 1000.0, p95 / 1000.0,
+           ordered.back() / 1000.0);
+  }
+};
+
+// Cada destino tem a sua conexão, como os slots do TlsConnectionManager
+struct Target
+{
+  const char *label;
+  Client *client = nullptr;
+  bool open = false;
+  Phase build{"montagem", {}};
+  Phase send{"envio", {}};
+  Phase ttfb{"espera", {}};
+  Phase parse{"leitura", {}};
+  Phase total{"total", {}};
+  unsigned ok = 0;
+  unsigned errors = 0;
+  unsigned connections = 0;
+  size_t requestBytes = 0;
+
+  explicit Target(const char *label) : label(label) {}
+
+  void print(unsigned requests) const
+  {
+    printf("%s: %u ok, %u erros, %u conexões TCP, %.1f KB por requisição\n", label, ok, errors, connections,
+           requests ? requestBytes / 1024.0 / requests : 0.0);
+    build.print();
+    send.print();
+    ttfb.print();
+    parse.print();
+    total.print();
+  }
+};
+
+struct Options
+{
+  const char *host = "127.0.0.1";
+  uint16_t port = 8080;
+  const char *image = nullptr;
+  size_t size = 20000;
+  unsigned requests = 20;
+  bool gemini = true;
+  bool upload = true;
+  bool offline = false;
+};
+
+static void usage()
+{
+  printf("Uso: gemini_bench [--host H] [--port P] [--image foto.jpg | --size BYTES]\n"
+         "                    [--requests N] [--target gemini|upload|both] [--offline]\n");
+}
+
+static bool parseArgs(int argc, char **argv, Options &opt)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--host" && hasValue)
+    {
+      opt.host = argv[++i];
+    }
+    else if (arg == "--port" && hasValue)
+    {
+      opt.port = (uint16_t)atoi(argv[++i]);
+    }
+    else if (arg == "--image" && hasValue)
+    {
+      opt.image = argv[++i];
+    }
+    else if (arg == "--size" && hasValue)
+    {
+      opt.size = (size_t)atol(argv[++i]);
+    }
+    else if (arg == "--requests" && hasValue)
+    {
+      opt.requests = (unsigned)atoi(argv[++i]);
+    }
+    else if (arg == "--target" && hasValue)
+    {
+      const std::string target = argv[++i];
+      opt.gemini = target != "upload";
+      opt.upload = target != "gemini";
+    }
+    else if (arg == "--offline")
+    {
+      opt.offline = true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// JPEG lido do disco, ou bytes aleatórios entre SOI e EOI (o mock só confere a assinatura)
+static std::vector<uint8_t> loadImage(const Options &opt)
+{
+  if (opt.image)
+  {
+    std::ifstream file(opt.image, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+  }
+  std::vector<uint8_t> jpeg(std::max(opt.size, (size_t)4));
+  std::mt19937 rng(42);
+  for (uint8_t &b : jpeg)
+  {
+    b = (uint8_t)rng();
+  }
+  jpeg[0] = 0xFF;
+  jpeg[1] = 0xD8;
+  jpeg[jpeg.size() - 2] = 0xFF;
+  jpeg[jpeg.size() - 1] = 0xD9;
+  return jpeg;
+}
+
+// Abre a conexão só se a anterior não puder ser reutilizada (como o TlsConnectionManager)
+static bool ensureConnected(Target &target, const Options &opt)
+{
+  if (target.open && target.client->connected())
+  {
+    return true;
+  }
+  target.open = target.client->connect(opt.host, opt.port) == 1;
+  if (target.open)
+  {
+    target.connections++;
+  }
+  return target.open;
+}
+
+static bool waitFirstByte(Client &client)
+{
+  const unsigned long deadline = millis() + RESPONSE_TIMEOUT_MS;
+  while (!client.available())
+  {
+    if (!client.connected() || (long)(millis() - deadline) > 0)
+    {
+      return false;
+    }
+    delayMicroseconds(50);
+  }
+  return true;
+}
+
+// Uma requisição: montagem -> envio -> espera pelo primeiro byte -> leitura
+template <typename Build, typename Read>
+static bool runRequest(Target &target, const Options &opt, Build build, Read read)
+{
+  Client &client = *target.client;
+  const unsigned long t0 = micros();
+  String head;
+  StreamingBody body = build(head);
+  const unsigned long t1 = micros();
+
+  if (!ensureConnected(target, opt))
+  {
+    return false;
+  }
+  const unsigned long t2 = micros();
+  const bool sent = client.write((const uint8_t *)head.c_str(), head.length()) == head.length() && body.writeTo(client);
+  const unsigned long t3 = micros();
+  if (!sent || !waitFirstByte(client))
+  {
+    client.stop();
+    target.open = false;
+    return false;
+  }
+  const unsigned long t4 = micros();
+  HttpResponse response;
+  const bool ok = read(response);
+  const unsigned long t5 = micros();
+  if (!response.keepAlive)
+  {
+    client.stop();
+    target.open = false;
+  }
+
+  target.build.add(t1 - t0);
+  target.send.add(t3 - t2);
+  target.ttfb.add(t4 - t3);
+  target.parse.add(t5 - t4);
+  target.total.add(t5 - t0);
+  target.requestBytes += head.length() + body.contentLength();
+  return ok;
+}
+
+int main(int argc, char **argv)
+{
+  Options opt;
+  if (!parseArgs(argc, argv, opt))
+  {
+    usage();
+    return 1;
+  }
+  const std::vector<uint8_t> jpeg = loadImage(opt);
+  if (jpeg.size() < 4)
+  {
+    printf("✗ ERRO: imagem vazia ou não encontrada\n");
+    return 1;
+  }
+
+  PosixClient geminiTcp, uploadTcp;
+  MemoryClient geminiMemory, uploadMemory;
+  const std::string geminiCanned = chunkedResponse(GEMINI_JSON);
+  const std::string uploadCanned = lengthResponse(UPLOAD_JSON);
+  Target gemini("Gemini");
+  Target upload("Upload");
+  gemini.client = opt.offline ? (Client *)&geminiMemory : &geminiTcp;
+  upload.client = opt.offline ? (Client *)&uploadMemory : &uploadTcp;
+  unsigned persons = 0;
+
+  printf("%s, imagem de %zu bytes, %u requisições\n",
+         opt.offline ? "Modo offline (sem rede)" : (std::string("Servidor ") + opt.host + ":" + std::to_string(opt.port)).c_str(),
+         jpeg.size(), opt.requests);
+
+  for (unsigned i = 0; i < opt.requests; i++)
+  {
+    const char *decision = "unknown";
+    if (opt.gemini)
+    {
+      geminiMemory.respondWith(geminiCanned);
+      JsonStringField text("text");
+      bool detected = false;
+      const bool ok = runRequest(
+          gemini, opt,
+          [&](String &head) {
+            StreamingBody body = buildGeminiBody(jpeg.data(), jpeg.size());
+            head = buildPostHead(buildGeminiPath(GEMINI_MODEL_PATH, "mock"), opt.host,
+                                 "application/json; charset=utf-8", body.contentLength());
+            return body;
+          },
+          [&](HttpResponse &response) {
+            if (!response.read(*gemini.client, text, RESPONSE_TIMEOUT_MS) || response.code != 200 || !text.found())
+            {
+              return false;
+            }
+            detected = geminiAnswerIsPerson(text.value());
+            return true;
+          });
+      if (ok)
+      {
+        gemini.ok++;
+        persons += detected;
+        decision = detected ? "person" : "no_person";
+      }
+      else
+      {
+        gemini.errors++;
+      }
+    }
+
+    if (opt.upload)
+    {
+      uploadMemory.respondWith(uploadCanned);
+      char captureId[9];
+      snprintf(captureId, sizeof(captureId), "%08x", i);
+      const bool ok = runRequest(
+          upload, opt,
+          [&](String &head) {
+            StreamingBody body = buildUploadBody(jpeg.data(), jpeg.size(), decision, captureId, 0, 3.912f, 76);
+            head = buildPostHead(WEB_APP_PATH, opt.host, "application/json", body.contentLength());
+            return body;
+          },
+          [&](HttpResponse &response) {
+            return response.read(*upload.client, 512, RESPONSE_TIMEOUT_MS) && response.code == 200;
+          });
+      ok ? upload.ok++ : upload.errors++;
+    }
+  }
+
+  if (opt.gemini)
+  {
+    gemini.print(opt.requests);
+    printf("  veredito: %u person / %u no_person\n", persons, gemini.ok - persons);
+  }
+  if (opt.upload)
+  {
+    upload.print(opt.requests);
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Subconjunto do core Arduino (String, Print, Serial, millis/delay) para
+// compilar os headers de ../firmware no PC. Só o que eles usam.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using std::min;
+
+inline unsigned long millis()
+{
+  static const auto start = std::chrono::steady_clock::now();
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline unsigned long micros()
+{
+  static const auto start = std::chrono::steady_clock::now();
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+class String
+{
+public:
+  String() {}
+  String(const char *c) : s(c ? c : "") {}
+  String(const std::string &c) : s(c) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(float v, int decimals = 2) : String((double)v, decimals) {}
+  String(double v, int decimals = 2)
+  {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s = buf;
+  }
+
+  const char *c_str() const { return s.c_str(); }
+  unsigned length() const { return (unsigned)s.size(); }
+  bool reserve(unsigned n) { s.reserve(n); return true; }
+
+  String &operator+=(const String &o) { s += o.s; return *this; }
+  String &operator+=(const char *o) { s += o; return *this; }
+  String &operator+=(char o) { s += o; return *this; }
+  friend String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+  friend String operator+(const String &a, const char *b) { return String(a.s + b); }
+  friend String operator+(const char *a, const String &b) { return String(a + b.s); }
+  bool operator==(const char *o) const { return s == o; }
+
+  int indexOf(const char *x, unsigned from = 0) const { return pos(s.find(x, from)); }
+  int indexOf(char x, unsigned from = 0) const { return pos(s.find(x, from)); }
+  String substring(unsigned a, unsigned b) const { return String(s.substr(a, b - a)); }
+  String substring(unsigned a) const { return String(s.substr(a)); }
+  long toInt() const { return atol(s.c_str()); }
+  bool startsWith(const char *p) const { return s.rfind(p, 0) == 0; }
+  void trim()
+  {
+    const size_t a = s.find_first_not_of(" \t\r\n");
+    const size_t b = s.find_last_not_of(" \t\r\n");
+    s = a == std::string::npos ? "" : s.substr(a, b - a + 1);
+  }
+  void toLowerCase()
+  {
+    for (char &c : s)
+    {
+      c = (char)tolower((unsigned char)c);
+    }
+  }
+
+private:
+  std::string s;
+
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size)
+  {
+    size_t n = 0;
+    while (n < size && write(buf[n]))
+    {
+      n++;
+    }
+    return n;
+  }
+  size_t print(const char *v) { return write((const uint8_t *)v, strlen(v)); }
+  size_t print(const String &v) { return write((const uint8_t *)v.c_str(), v.length()); }
+  size_t print(long v) { return print(String(v)); }
+  size_t print(unsigned long v) { return print(String(v)); }
+  size_t print(int v) { return print(String(v)); }
+  size_t print(unsigned v) { return print(String(v)); }
+  size_t print(double v, int decimals = 2) { return print(String(v, decimals)); }
+  template <typename T>
+  size_t println(const T &v) { return print(v) + print("\n"); }
+  size_t println() { return print("\n"); }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+};
+
+class HostSerial : public Print
+{
+public:
+  size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+  size_t write(const uint8_t *buf, size_t size) override { return fwrite(buf, 1, size, stdout); }
+};
+
+inline HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,18 @@
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+#include <Arduino.h>
+
+// Interface Client do core Arduino (sem connect por IPAddress)
+class Client : public Stream
+{
+public:
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual int read(uint8_t *buf, size_t size) = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  using Print::write;
+  using Stream::read;
+};
+
+#endif // HOST_CLIENT_H
@@ -0,0 +1,43 @@
+#ifndef HOST_MBEDTLS_BASE64_H
+#define HOST_MBEDTLS_BASE64_H
+
+#include <cstddef>
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL -0x002A
+
+// Mesma assinatura e semântica de mbedtls_base64_encode (olen inclui o '\0'
+// quando o destino é pequeno demais), sem depender da mbedTLS no PC
+inline int mbedtls_base64_encode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen)
+{
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const size_t needed = ((slen + 2) / 3) * 4;
+  if (dlen < needed + 1)
+  {
+    *olen = needed + 1;
+    return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+  }
+
+  unsigned char *p = dst;
+  size_t i = 0;
+  for (; i + 2 < slen; i += 3)
+  {
+    const unsigned v = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+    *p++ = table[(v >> 18) & 0x3F];
+    *p++ = table[(v >> 12) & 0x3F];
+    *p++ = table[(v >> 6) & 0x3F];
+    *p++ = table[v & 0x3F];
+  }
+  if (i < slen)
+  {
+    const unsigned v = (src[i] << 16) | (i + 1 < slen ? src[i + 1] << 8 : 0);
+    *p++ = table[(v >> 18) & 0x3F];
+    *p++ = table[(v >> 12) & 0x3F];
+    *p++ = i + 1 < slen ? table[(v >> 6) & 0x3F] : '=';
+    *p++ = '=';
+  }
+  *p = '\0';
+  *olen = p - dst;
+  return 0;
+}
+
+#endif // HOST_MBEDTLS_BASE64_H
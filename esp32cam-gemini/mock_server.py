@@ -0,0 +1,389 @@
+#!/usr/bin/env python3
+"""
+Servidor local que substitui o Gemini e a plataforma web (frontend/) em testes.
+
+Implementa os mesmos contratos usados pelo firmware (firmware/ApiRequests.h):
+    POST /v1beta/models/<modelo>:generateContent?key=...
+        {"contents":[{"parts":[{"text":...},{"inline_data":{"mime_type":"image/jpeg","data":...}}]}]}
+        -> {"candidates":[{"content":{"parts":[{"text":"person"}]}}], "usageMetadata":{...}}
+    POST /api/upload    {"image":"data:image/jpeg;base64,...","decision":...,"capture_id":...,"battery":{...}}
+    POST /api/decision  {"capture_id":...,"decision":...}
+    GET  /api/latest
+    GET  /stats         contadores e latências (JSON)
+
+Latência, taxa de erros (429/503, como o Gemini devolve sob carga) e veredito
+são configuráveis, para exercitar os caminhos de erro e medir o firmware sem
+gastar cota nem depender da internet. As respostas usam HTTP/1.1 com
+keep-alive e, no Gemini, Transfer-Encoding: chunked, como a API real.
+
+Uso:
+    # HTTP simples (firmware de teste ou o benchmark nativo em host/)
+    python mock_server.py serve --port 8080 --latency-ms 600 --jitter-ms 150 --verdict random
+
+    # HTTPS (o firmware só fala TLS): gere um certificado autoassinado
+    openssl req -x509 -newkey rsa:2048 -nodes -days 365 -subj "/CN=mock" -keyout key.pem -out cert.pem
+    python mock_server.py serve --port 8443 --tls --cert cert.pem --key key.pem --error-rate 0.1
+
+    # Guardar as imagens recebidas
+    python mock_server.py serve --save-dir recebidas/
+
+No firmware, aponte GEMINI_HOST/WEB_APP_HOST para o IP do PC e GEMINI_PORT para
+a porta do servidor (com --tls; o firmware não valida o certificado).
+"""
+
+import argparse
+import base64
+import itertools
+import json
+import os
+import random
+import ssl
+import statistics
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+DECISIONS = ("person", "no_person", "unknown")
+UPLOAD_DECISIONS = ("person", "no_person", "pending", "unknown")
+
+GEMINI_ERRORS = (
+    (429, "RESOURCE_EXHAUSTED", "Resource has been exhausted (e.g. check quota)."),
+    (503, "UNAVAILABLE", "The model is overloaded. Please try again later."),
+)
+
+
+class Stats:
+    """Contadores por rota e latências de atendimento (recebimento + resposta)."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.routes = {}
+        self.connections = 0
+
+    def add(self, route, status, latency_ms, request_bytes, closed_early=False):
+        with self.lock:
+            entry = self.routes.setdefault(route, {"requests": 0, "errors": 0, "early_closes": 0, "bytes": 0,
+                                                   "latencies": []})
+            entry["requests"] += 1
+            if closed_early:
+                entry["early_closes"] += 1
+            entry["bytes"] += request_bytes
+            entry["latencies"].append(latency_ms)
+            if status >= 400:
+                entry["errors"] += 1
+
+    def connection(self):
+        with self.lock:
+            self.connections += 1
+
+    def snapshot(self):
+        with self.lock:
+            result = {"connections": self.connections, "routes": {}}
+            for route, entry in self.routes.items():
+                ordered = sorted(entry["latencies"])
+                result["routes"][route] = {
+                    "requests": entry["requests"],
+                    "errors": entry["errors"],
+                    "early_closes": entry["early_closes"],
+                    "request_bytes": entry["bytes"],
+                    "latency_ms_mean": round(statistics.mean(ordered), 1),
+                    "latency_ms_p95": round(ordered[min(len(ordered) - 1, int(len(ordered) * 0.95))], 1),
+                }
+            return result
+
+
+def summarize(snapshot):
+    lines = [f"{snapshot['connections']} conexões TCP"]
+    for route, entry in sorted(snapshot["routes"].items()):
+        lines.append(f"{route}: {entry['requests']} req ({entry['errors']} erros, "
+                     f"{entry['early_closes']} fechadas pelo cliente antes do fim), "
+                     f"{entry['request_bytes'] / 1024:.0f} KB recebidos, "
+                     f"média {entry['latency_ms_mean']:.0f} ms, p95 {entry['latency_ms_p95']:.0f} ms")
+    return "\n".join(lines)
+
+
+class MockState:
+    """Veredito simulado, última imagem (como frontend/pages/api/store.js) e erros."""
+
+    def __init__(self, args):
+        self.args = args
+        self.lock = threading.Lock()
+        self.alternate = itertools.cycle(("person", "no_person"))
+        self.latest = None
+        self.saved = 0
+
+    def verdict(self):
+        mode = self.args.verdict
+        if mode == "alternate":
+            with self.lock:
+                return next(self.alternate)
+        if mode == "random":
+            return "person" if random.random() < self.args.person_ratio else "no_person"
+        return mode
+
+    def sleep(self, latency_ms, jitter_ms):
+        delay = max(0.0, random.gauss(latency_ms, jitter_ms))
+        time.sleep(delay / 1000.0)
+
+    def save_image(self, jpeg, prefix):
+        if not self.args.save_dir:
+            return
+        with self.lock:
+            self.saved += 1
+            name = os.path.join(self.args.save_dir, f"{prefix}_{self.saved:05d}.jpg")
+        with open(name, "wb") as f:
+            f.write(jpeg)
+
+
+def decode_jpeg(data):
+    """Base64 (com ou sem prefixo data URI) -> bytes, validando a assinatura JPEG."""
+    if data.startswith("data:"):
+        data = data.split(",", 1)[1]
+    jpeg = base64.b64decode(data, validate=True)
+    if not jpeg.startswith(b"\xff\xd8"):
+        raise ValueError("imagem não é JPEG")
+    return jpeg
+
+
+def make_handler(state, stats):
+    args = state.args
+
+    class MockHandler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"  # keep-alive, como o Gemini e a Vercel
+        disable_nagle_algorithm = True  # Cabeçalho e corpo saem em write() separados
+
+        def setup(self):
+            super().setup()
+            stats.connection()
+
+        # ---------- respostas ----------
+
+        def send_json(self, status, obj, chunked=False):
+            body = json.dumps(obj, indent=2 if chunked else None).encode()
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json; charset=UTF-8")
+            if chunked:
+                self.send_header("Transfer-Encoding", "chunked")
+            else:
+                self.send_header("Content-Length", str(len(body)))
+            if args.close:
+                self.send_header("Connection", "close")
+                self.close_connection = True
+            try:
+                self.end_headers()
+                if not chunked:
+                    self.wfile.write(body)
+                    return
+                # Blocos pequenos: exercita a leitura incremental (JsonStringField)
+                for offset in range(0, len(body), args.chunk_size):
+                    part = body[offset:offset + args.chunk_size]
+                    self.wfile.write(f"{len(part):x}\r\n".encode() + part + b"\r\n")
+                self.wfile.write(b"0\r\n\r\n")
+            except (BrokenPipeError, ConnectionResetError):
+                # O firmware fecha a conexão assim que lê o "text" do Gemini
+                # (parada antecipada do JsonStringField): não é erro do servidor
+                self.closed_early = True
+                self.close_connection = True
+
+        def read_json(self):
+            length = int(self.headers.get("Content-Length", 0))
+            raw = self.rfile.read(length)
+            self.request_bytes = len(raw)
+            return json.loads(raw)
+
+        # ---------- rotas ----------
+
+        def do_POST(self):
+            start = time.time()
+            self.request_bytes = 0
+            self.closed_early = False
+            url = urlparse(self.path)
+            if url.path.endswith(":generateContent"):
+                route, status = "gemini", self.gemini(url)
+            elif url.path == "/api/upload":
+                route, status = "upload", self.upload()
+            elif url.path == "/api/decision":
+                route, status = "decision", self.decision()
+            else:
+                route, status = "outros", 404
+                self.send_json(404, {"error": "Not found"})
+            stats.add(route, status, (time.time() - start) * 1000, self.request_bytes, self.closed_early)
+
+        def do_GET(self):
+            path = urlparse(self.path).path
+            if path == "/api/latest":
+                self.send_json(200, state.latest)
+            elif path == "/stats":
+                self.send_json(200, stats.snapshot())
+            else:
+                self.send_json(404, {"error": "Not found"})
+
+        def gemini(self, url):
+            try:
+                payload = self.read_json()
+                parts = payload["contents"][0]["parts"]
+                inline = next(p["inline_data"] for p in parts if "inline_data" in p)
+                if inline.get("mime_type") != "image/jpeg":
+                    raise ValueError("mime_type deve ser image/jpeg")
+                jpeg = decode_jpeg(inline["data"])
+            except (ValueError, KeyError, IndexError, StopIteration) as exc:
+                self.send_json(400, {"error": {"code": 400, "message": f"Invalid request: {exc}",
+                                               "status": "INVALID_ARGUMENT"}})
+                return 400
+
+            if args.api_key and parse_qs(url.query).get("key", [""])[0] != args.api_key:
+                self.send_json(400, {"error": {"code": 400, "message": "API key not valid.",
+                                               "status": "INVALID_ARGUMENT"}})
+                return 400
+
+            state.sleep(args.latency_ms, args.jitter_ms)
+            if random.random() < args.error_rate:
+                code, status, message = random.choice(GEMINI_ERRORS)
+                self.send_json(code, {"error": {"code": code, "message": message, "status": status}})
+                return code
+
+            state.save_image(jpeg, "gemini")
+            verdict = state.verdict()
+            # Mesmo formato da API real: o texto vem antes dos metadados de uso
+            self.send_json(200, {
+                "candidates": [{
+                    "content": {"parts": [{"text": verdict}], "role": "model"},
+                    "finishReason": "STOP",
+                    "index": 0,
+                }],
+                "usageMetadata": {"promptTokenCount": 300, "candidatesTokenCount": 2, "totalTokenCount": 302},
+                "modelVersion": "mock",
+            }, chunked=not args.no_chunked)
+            return 200
+
+        def upload(self):
+            try:
+                payload = self.read_json()
+                jpeg = decode_jpeg(payload["image"])
+            except (ValueError, KeyError) as exc:
+                self.send_json(400, {"error": "No image provided", "details": str(exc)})
+                return 400
+
+            state.sleep(args.upload_latency_ms, args.upload_jitter_ms)
+            if random.random() < args.upload_error_rate:
+                self.send_json(500, {"error": "Internal server error", "details": "erro simulado"})
+                return 500
+
+            decision = payload.get("decision") or "unknown"
+            if decision not in UPLOAD_DECISIONS:
+                decision = "unknown"
+            age = payload.get("age_s") or 0
+            timestamp = time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime(time.time() - age))
+            state.save_image(jpeg, "upload")
+            with state.lock:
+                state.latest = {
+                    "filename": f"capture-{timestamp.replace(':', '-')}.jpg",
+                    "decision": decision,
+                    "imageUrl": payload["image"],
+                    "timestamp": timestamp,
+                    "battery": payload.get("battery"),
+                    "captureId": payload.get("capture_id"),
+                }
+            self.send_json(200, {"success": True, "message": "Image received and stored",
+                                 "decision": decision, "timestamp": timestamp,
+                                 "battery": payload.get("battery"), "captureId": payload.get("capture_id")})
+            return 200
+
+        def decision(self):
+            try:
+                payload = self.read_json()
+            except ValueError:
+                payload = {}
+            capture_id = payload.get("capture_id")
+            decision = payload.get("decision")
+            if not capture_id or decision not in DECISIONS:
+                self.send_json(400, {"error": "capture_id and a valid decision are required"})
+                return 400
+            with state.lock:
+                latest = state.latest
+                if latest is None or latest.get("captureId") != capture_id:
+                    found = False
+                else:
+                    latest["decision"] = decision
+                    found = True
+            if not found:
+                self.send_json(404, {"error": "Capture not found", "captureId": capture_id})
+                return 404
+            self.send_json(200, {"success": True, "captureId": capture_id, "decision": decision})
+            return 200
+
+        def log_message(self, fmt, *log_args):
+            if args.verbose:
+                super().log_message(fmt, *log_args)
+
+    return MockHandler
+
+
+def serve(args):
+    if args.save_dir:
+        os.makedirs(args.save_dir, exist_ok=True)
+    stats = Stats()
+    state = MockState(args)
+    server = ThreadingHTTPServer(("0.0.0.0", args.port), make_handler(state, stats))
+    scheme = "http"
+    if args.tls:
+        if not args.cert or not args.key:
+            print("Erro: --tls exige --cert e --key")
+            exit(1)
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(args.cert, args.key)
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+        scheme = "https"
+
+    if args.report_interval > 0:
+        def report():
+            while True:
+                time.sleep(args.report_interval)
+                print(f"[Mock]\n{summarize(stats.snapshot())}")
+
+        threading.Thread(target=report, daemon=True).start()
+
+    print(f"[Mock] Gemini + plataforma web em {scheme}://0.0.0.0:{args.port} "
+          f"(Gemini {args.latency_ms:.0f}±{args.jitter_ms:.0f} ms, erros {args.error_rate:.0%}, "
+          f"veredito {args.verdict})")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print(f"[Mock] Total:\n{summarize(stats.snapshot())}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Servidor local que simula o Gemini e a plataforma web")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p_serve = sub.add_parser("serve", help="Inicia o servidor simulado")
+    p_serve.add_argument("--port", type=int, default=8080)
+    p_serve.add_argument("--tls", action="store_true", help="Atende HTTPS (exige --cert e --key)")
+    p_serve.add_argument("--cert", help="Certificado PEM")
+    p_serve.add_argument("--key", help="Chave privada PEM")
+    p_serve.add_argument("--latency-ms", type=float, default=800, help="Latência média do Gemini")
+    p_serve.add_argument("--jitter-ms", type=float, default=200)
+    p_serve.add_argument("--error-rate", type=float, default=0.0,
+                         help="Fração de respostas 429/503 do Gemini")
+    p_serve.add_argument("--verdict", choices=("person", "no_person", "random", "alternate"), default="random")
+    p_serve.add_argument("--person-ratio", type=float, default=0.5, help="Fração de 'person' com --verdict random")
+    p_serve.add_argument("--api-key", help="Rejeita requisições ao Gemini com outra key")
+    p_serve.add_argument("--upload-latency-ms", type=float, default=150)
+    p_serve.add_argument("--upload-jitter-ms", type=float, default=50)
+    p_serve.add_argument("--upload-error-rate", type=float, default=0.0, help="Fração de respostas 500 do upload")
+    p_serve.add_argument("--chunk-size", type=int, default=64, help="Bytes por bloco chunked do Gemini")
+    p_serve.add_argument("--no-chunked", action="store_true", help="Gemini com Content-Length em vez de chunked")
+    p_serve.add_argument("--close", action="store_true", help="Fecha a conexão após cada resposta (sem keep-alive)")
+    p_serve.add_argument("--save-dir", help="Guarda as imagens recebidas")
+    p_serve.add_argument("--report-interval", type=int, default=0, help="s entre relatórios (0: só ao sair)")
+    p_serve.add_argument("-v", "--verbose", action="store_true")
+
+    args = parser.parse_args()
+    if args.command == "serve":
+        serve(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,161 @@
+#ifndef JPEG_LUMA_H
+#define JPEG_LUMA_H
+
+#include <Arduino.h>
+#include <utility>
+#include <img_converters.h>
+#include "esp_camera.h"
+
+// Frame JPEG decodificado em escala reduzida e convertido para luma.
+//
+// jpg2rgb565 entrega RGB565 com o byte alto primeiro; a conversão para luma é
+// feita no próprio buffer (o pixel i, nos bytes 2i e 2i+1, vira o byte i), então
+// não há segundo buffer. O buffer é reaproveitado enquanto o tamanho não muda.
+// Usado pelos dois firmwares da ESP32-CAM: um só lugar converte RGB565 em luma.
+class LumaFrame
+{
+public:
+  LumaFrame() {}
+  LumaFrame(const LumaFrame &) = delete;
+  LumaFrame &operator=(const LumaFrame &) = delete;
+
+  ~LumaFrame()
+  {
+    free(buffer);
+  }
+
+  // Decodifica fb em 1/2^scale (0 = 1:1, 3 = 1/8, o mais barato: só o DC de cada bloco)
+  bool decode(const camera_fb_t *fb, uint8_t scale)
+  {
+    valid = false;
+    if (fb == nullptr || fb->format != PIXFORMAT_JPEG || scale > 3)
+    {
+      return false;
+    }
+    const uint16_t w = fb->width >> scale;
+    const uint16_t h = fb->height >> scale;
+    if (w == 0 || h == 0 || !reserve((size_t)w * h * 2))
+    {
+      return false;
+    }
+    if (!jpg2rgb565(fb->buf, fb->len, buffer, (jpg_scale_t)scale))
+    {
+      return false;
+    }
+
+    const size_t pixels = (size_t)w * h;
+    for (size_t i = 0; i < pixels; i++)
+    {
+      buffer[i] = luma565(buffer + 2 * i);
+    }
+    frameWidth = w;
+    frameHeight = h;
+    frameScale = scale;
+    valid = true;
+    return true;
+  }
+
+  // Maior redução (1/8 no máximo) que ainda deixa largura e altura >= minSide
+  static uint8_t scaleCovering(uint16_t width, uint16_t height, uint16_t minSide)
+  {
+    uint8_t scale = 3;
+    while (scale > 0 && ((width >> scale) < minSide || (height >> scale) < minSide))
+    {
+      scale--;
+    }
+    return scale;
+  }
+
+  // Média da luma no retângulo [x0, x1) x [y0, y1); área vazia conta o pixel (x0, y0)
+  uint8_t mean(int x0, int y0, int x1, int y1) const
+  {
+    x1 = max(x1, x0 + 1);
+    y1 = max(y1, y0 + 1);
+    uint32_t sum = 0;
+    for (int y = y0; y < y1; y++)
+    {
+      const uint8_t *row = buffer + (size_t)y * frameWidth;
+      for (int x = x0; x < x1; x++)
+      {
+        sum += row[x];
+      }
+    }
+    return sum / ((y1 - y0) * (x1 - x0));
+  }
+
+  bool isValid() const
+  {
+    return valid;
+  }
+
+  const uint8_t *data() const
+  {
+    return buffer;
+  }
+
+  uint16_t width() const
+  {
+    return frameWidth;
+  }
+
+  uint16_t height() const
+  {
+    return frameHeight;
+  }
+
+  uint8_t scale() const
+  {
+    return frameScale;
+  }
+
+  // Troca o conteúdo com outro frame (sem copiar pixels)
+  void swap(LumaFrame &other)
+  {
+    std::swap(buffer, other.buffer);
+    std::swap(capacity, other.capacity);
+    std::swap(frameWidth, other.frameWidth);
+    std::swap(frameHeight, other.frameHeight);
+    std::swap(frameScale, other.frameScale);
+    std::swap(valid, other.valid);
+  }
+
+  void invalidate()
+  {
+    valid = false;
+  }
+
+  static inline uint8_t luma565(const uint8_t *px)
+  {
+    const uint16_t p = (px[0] << 8) | px[1];
+    const uint16_t r = ((p >> 11) & 0x1F) << 3;
+    const uint16_t g = ((p >> 5) & 0x3F) << 2;
+    const uint16_t b = (p & 0x1F) << 3;
+    return (r * 77 + g * 150 + b * 29) >> 8;
+  }
+
+private:
+  uint8_t *buffer = nullptr;
+  size_t capacity = 0;
+  uint16_t frameWidth = 0;
+  uint16_t frameHeight = 0;
+  uint8_t frameScale = 0;
+  bool valid = false;
+
+  bool reserve(size_t bytes)
+  {
+    if (bytes <= capacity)
+    {
+      return true;
+    }
+    free(buffer);
+    buffer = (uint8_t *)(psramFound() ? ps_malloc(bytes) : malloc(bytes));
+    capacity = buffer != nullptr ? bytes : 0;
+    if (buffer == nullptr)
+    {
+      Serial.println("[Luma] Falha ao alocar buffer de decodificação");
+    }
+    return buffer != nullptr;
+  }
+};
+
+#endif // JPEG_LUMA_H
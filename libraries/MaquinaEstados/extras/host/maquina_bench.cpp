@@ -0,0 +1,598 @@
+// Verificação e custo no PC da máquina de estados (../../src/MaquinaEstados.h).
+//
+// 1. Ordem de saída/entrada nas transições entre estados aninhados.
+// 2. Semáforo do Ponderada03: a versão na máquina e o switch antigo rodam
+//    lado a lado por horas de relógio simulado (começando perto do estouro
+//    do millis(), com passadas do loop() em intervalos aleatórios) e os LEDs
+//    têm que estar iguais depois de toda passada.
+// 3. Modo do Ponderada04: a tabela do .ino contra a histerese antiga, com um
+//    LDR simulado (dia/noite, ruído e nuvens) e comandos de modo aleatórios.
+// 4. Custo de uma passada do loop() e de um despacho, contra os switches.
+//
+// As tabelas dos dois sketches estão copiadas aqui (os .ino não compilam no
+// PC), com os avisos do Serial trocados por contadores. Toda alocação no heap
+// é contada e tem que ficar em zero.
+//
+// Uso: ./maquina_bench [--horas H] [--passadas N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <random>
+
+#include "MaquinaEstados.h"
+
+// ---- Contagem de alocações ----
+
+static unsigned long alocacoes = 0;
+
+void *operator new(size_t n)
+{
+  alocacoes++;
+  void *p = malloc(n ? n : 1);
+  if (p == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static uint32_t agoraMs = 0;
+static uint32_t millis() { return agoraMs; }
+
+// ==================== 1. Ordem das ações ====================
+
+struct Rastro
+{
+  char texto[128];
+  void anotar(const char *s)
+  {
+    strncat(texto, s, sizeof(texto) - strlen(texto) - 1);
+  }
+};
+
+enum EstadoTeste : uint8_t { T_RAIZ, T_A, T_A1, T_A11, T_A12, T_A2, T_B, T_B1, NUM_ESTADOS_TESTE };
+enum EventoTeste : uint8_t { IR_B1, IR_A12, REPETIR, INTERNO, IR_A1 };
+
+#define ANOTAR(nome, s) \
+  void nome(Rastro &r) { r.anotar(s); }
+ANOTAR(entraA, "+A ") ANOTAR(saiA, "-A ") ANOTAR(entraA1, "+A1 ") ANOTAR(saiA1, "-A1 ")
+ANOTAR(entraA11, "+a11 ") ANOTAR(saiA11, "-a11 ") ANOTAR(entraA12, "+a12 ") ANOTAR(saiA12, "-a12 ")
+ANOTAR(entraB, "+B ") ANOTAR(saiB, "-B ") ANOTAR(entraB1, "+b1 ") ANOTAR(saiB1, "-b1 ")
+ANOTAR(acao, "* ")
+
+constexpr EstadoDef<Rastro> ESTADOS_TESTE[] = {
+    {MAQUINA_SEM_ESTADO, T_A, nullptr, nullptr, "raiz"},
+    {T_RAIZ, T_A1, entraA, saiA, "A"},
+    {T_A, T_A11, entraA1, saiA1, "A1"},
+    {T_A1, MAQUINA_SEM_ESTADO, entraA11, saiA11, "a11"},
+    {T_A1, MAQUINA_SEM_ESTADO, entraA12, saiA12, "a12"},
+    {T_A, MAQUINA_SEM_ESTADO, nullptr, nullptr, "A2"},
+    {T_RAIZ, T_B1, entraB, saiB, "B"},
+    {T_B, MAQUINA_SEM_ESTADO, entraB1, saiB1, "b1"},
+};
+
+constexpr TransicaoDef<Rastro> TRANSICOES_TESTE[] = {
+    {T_A, IR_A1, T_A1, nullptr, acao, nullptr},
+    {T_A11, IR_B1, T_B1, nullptr, acao, nullptr},
+    {T_A11, IR_A12, T_A12, nullptr, acao, nullptr},
+    {T_A11, REPETIR, T_A11, nullptr, acao, nullptr},
+    {T_A12, INTERNO, MAQUINA_SEM_ESTADO, nullptr, acao, nullptr},
+};
+
+constexpr TabelaEstados<Rastro, NUM_ESTADOS_TESTE> TABELA_TESTE = criarTabela(ESTADOS_TESTE, TRANSICOES_TESTE);
+static_assert(tabelaValida(TABELA_TESTE), "Tabela de teste inválida");
+
+// Uma tabela com as transições da mesma origem separadas não passa
+constexpr TransicaoDef<Rastro> TRANSICOES_ESPALHADAS[] = {
+    {T_A11, IR_B1, T_B1, nullptr, nullptr, nullptr},
+    {T_A12, INTERNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, nullptr},
+    {T_A11, REPETIR, T_A11, nullptr, nullptr, nullptr},
+};
+static_assert(!tabelaValida(criarTabela(ESTADOS_TESTE, TRANSICOES_ESPALHADAS)), "Transições espalhadas aceitas");
+
+static bool conferirOrdem()
+{
+  printf("Ordem de saida/entrada\n");
+  struct Caso
+  {
+    uint8_t evento;
+    const char *esperado;
+  };
+  const Caso casos[] = {
+      {REPETIR, "-a11 * +a11 "},
+      {IR_A12, "-a11 * +a12 "},
+      {INTERNO, "* "},
+      {IR_A1, "-a12 -A1 -A * +A +A1 +a11 "},   // Tratado no pai A
+      {IR_B1, "-a11 -A1 -A * +B +b1 "},
+      {INTERNO, ""},                           // Ninguém trata em b1
+  };
+  Rastro r = {};
+  MaquinaEstados<Rastro, NUM_ESTADOS_TESTE> m(TABELA_TESTE, r);
+  m.iniciar(0);
+  bool ok = strcmp(r.texto, "+A +A1 +a11 ") == 0;
+  printf("  %s iniciar: %s\n", ok ? "✓" : "✗", r.texto);
+  for (const Caso &c : casos)
+  {
+    r.texto[0] = '\0';
+    m.despachar(c.evento, 0);
+    const bool igual = strcmp(r.texto, c.esperado) == 0;
+    printf("  %s -> %-4s %s\n", igual ? "✓" : "✗", m.nome(), r.texto);
+    ok = ok && igual;
+  }
+  ok = ok && m.esta(T_B) && m.esta(T_RAIZ) && !m.esta(T_A);
+  printf("\n");
+  return ok;
+}
+
+// ==================== 2. Semáforo do Ponderada03 ====================
+
+struct Led
+{
+  bool aceso = false;
+  uint32_t escritas = 0;
+  void begin() { off(); }
+  void on() { aceso = true; escritas++; }
+  void off() { aceso = false; escritas++; }
+};
+
+enum class LightState { Green, Yellow, Red };
+
+// O TrafficLight de antes, com o switch em update() (uint32_t no lugar de
+// unsigned long, que no ESP32 tem 32 bits e no PC 64)
+class TrafficLightSwitch
+{
+public:
+  TrafficLightSwitch(Led *g, Led *y, Led *r, unsigned long gMs, unsigned long yMs, unsigned long rMs)
+      : green(g), yellow(y), red(r), greenMs(gMs), yellowMs(yMs), redMs(rMs) {}
+
+  void begin()
+  {
+    green->begin();
+    yellow->begin();
+    red->begin();
+    setState(LightState::Red);
+  }
+
+  void update()
+  {
+    const uint32_t elapsed = millis() - lastChange;
+    switch (state)
+    {
+    case LightState::Green:
+      if (elapsed >= greenMs) setState(LightState::Yellow);
+      break;
+    case LightState::Yellow:
+      if (elapsed >= yellowMs) setState(LightState::Red);
+      break;
+    case LightState::Red:
+      if (elapsed >= redMs) setState(LightState::Green);
+      break;
+    }
+  }
+
+private:
+  void setState(LightState next)
+  {
+    green->off();
+    yellow->off();
+    red->off();
+    state = next;
+    lastChange = millis();
+    (state == LightState::Green ? green : state == LightState::Yellow ? yellow : red)->on();
+  }
+
+  Led *green;
+  Led *yellow;
+  Led *red;
+  unsigned long greenMs;
+  unsigned long yellowMs;
+  unsigned long redMs;
+  LightState state = LightState::Red;
+  uint32_t lastChange = 0;
+};
+
+// O TrafficLight de agora (mesma tabela do .ino)
+enum TrafficState : uint8_t { STATE_RUNNING, STATE_GREEN, STATE_YELLOW, STATE_RED, NUM_TRAFFIC_STATES };
+
+class TrafficLight
+{
+public:
+  TrafficLight(Led *g, Led *y, Led *r, unsigned long gMs, unsigned long yMs, unsigned long rMs);
+
+  void begin()
+  {
+    green->begin();
+    yellow->begin();
+    red->begin();
+    machine.iniciar(millis());
+  }
+
+  void update() { machine.atualizar(millis()); }
+
+  void show(LightState next)
+  {
+    green->off();
+    yellow->off();
+    red->off();
+    (next == LightState::Green ? green : next == LightState::Yellow ? yellow : red)->on();
+  }
+
+  unsigned long getGreenMs() const { return greenMs; }
+  unsigned long getYellowMs() const { return yellowMs; }
+  unsigned long getRedMs() const { return redMs; }
+
+private:
+  Led *green;
+  Led *yellow;
+  Led *red;
+  unsigned long greenMs;
+  unsigned long yellowMs;
+  unsigned long redMs;
+  MaquinaEstados<TrafficLight, NUM_TRAFFIC_STATES> machine;
+};
+
+void enterGreen(TrafficLight &t) { t.show(LightState::Green); }
+void enterYellow(TrafficLight &t) { t.show(LightState::Yellow); }
+void enterRed(TrafficLight &t) { t.show(LightState::Red); }
+uint32_t greenTime(const TrafficLight &t) { return t.getGreenMs(); }
+uint32_t yellowTime(const TrafficLight &t) { return t.getYellowMs(); }
+uint32_t redTime(const TrafficLight &t) { return t.getRedMs(); }
+
+constexpr EstadoDef<TrafficLight> TRAFFIC_STATES[] = {
+    {MAQUINA_SEM_ESTADO, STATE_RED, nullptr, nullptr, "Running"},
+    {STATE_RUNNING, MAQUINA_SEM_ESTADO, enterGreen, nullptr, "Green"},
+    {STATE_RUNNING, MAQUINA_SEM_ESTADO, enterYellow, nullptr, "Yellow"},
+    {STATE_RUNNING, MAQUINA_SEM_ESTADO, enterRed, nullptr, "Red"},
+};
+
+constexpr TransicaoDef<TrafficLight> TRAFFIC_TRANSITIONS[] = {
+    {STATE_GREEN, MAQUINA_EVENTO_TEMPO, STATE_YELLOW, nullptr, nullptr, greenTime},
+    {STATE_YELLOW, MAQUINA_EVENTO_TEMPO, STATE_RED, nullptr, nullptr, yellowTime},
+    {STATE_RED, MAQUINA_EVENTO_TEMPO, STATE_GREEN, nullptr, nullptr, redTime},
+};
+
+constexpr TabelaEstados<TrafficLight, NUM_TRAFFIC_STATES> TRAFFIC_TABLE =
+    criarTabela(TRAFFIC_STATES, TRAFFIC_TRANSITIONS);
+static_assert(tabelaValida(TRAFFIC_TABLE), "Tabela de estados do semaforo invalida");
+
+TrafficLight::TrafficLight(Led *g, Led *y, Led *r, unsigned long gMs, unsigned long yMs, unsigned long rMs)
+    : green(g), yellow(y), red(r), greenMs(gMs), yellowMs(yMs), redMs(rMs), machine(TRAFFIC_TABLE, *this) {}
+
+struct Opcoes
+{
+  double horas = 24.0;
+  uint64_t passadas = 20000000;
+};
+
+static bool compararSemaforo(const Opcoes &op)
+{
+  printf("Ponderada03: maquina x switch (%.1f h simuladas)\n", op.horas);
+  Led antigo[3];
+  Led novo[3];
+  TrafficLightSwitch a(&antigo[0], &antigo[1], &antigo[2], 4000, 2000, 6000);
+  TrafficLight b(&novo[0], &novo[1], &novo[2], 4000, 2000, 6000);
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<uint32_t> passo(0, 3);  // loop() com atrasos de até 3 ms
+  agoraMs = 0xFFFFFFFFu - 30000u;                       // estoura o millis() no 1º ciclo
+  a.begin();
+  b.begin();
+  const uint64_t fimMs = (uint64_t)(op.horas * 3600e3);
+  uint64_t passadas = 0;
+  uint64_t divergencias = 0;
+  uint32_t ciclos = 0;
+  bool vermelhoAntes = true;
+  for (uint64_t ms = 0; ms < fimMs; ms += passo(rng), passadas++)
+  {
+    agoraMs = (0xFFFFFFFFu - 30000u) + (uint32_t)ms;
+    a.update();
+    b.update();
+    for (int i = 0; i < 3; i++)
+    {
+      if (antigo[i].aceso != novo[i].aceso || antigo[i].escritas != novo[i].escritas)
+      {
+        if (divergencias == 0)
+        {
+          printf("  ✗ LED %d diferente em t=%llu ms\n", i, (unsigned long long)ms);
+        }
+        divergencias++;
+      }
+    }
+    ciclos += novo[2].aceso && !vermelhoAntes;
+    vermelhoAntes = novo[2].aceso;
+  }
+  printf("  %llu passadas, %u ciclos, %u escritas de LED em cada versao\n",
+         (unsigned long long)passadas, ciclos, novo[0].escritas + novo[1].escritas + novo[2].escritas);
+  printf("  %s Passadas com LEDs diferentes: %llu\n\n", divergencias == 0 ? "✓" : "✗",
+         (unsigned long long)divergencias);
+  return divergencias == 0;
+}
+
+// ==================== 3. Modo do Ponderada04 ====================
+
+const int LDR_LIMITE_NOTURNO = 1800;
+const int LDR_LIMITE_DIURNO = 2200;
+const unsigned long LDR_CONFIRMACAO_MS = 1000;
+
+struct Avisos
+{
+  uint32_t modo = 0;
+  uint32_t entradas = 0;
+  uint32_t saidas = 0;
+};
+static Avisos avisos;
+
+// A histerese de antes (campos e métodos do SemaforoInteligente)
+struct HistereseAntiga
+{
+  int limiteEntrar = LDR_LIMITE_NOTURNO;
+  int limiteSair = LDR_LIMITE_DIURNO;
+  unsigned long confirmacaoMs = LDR_CONFIRMACAO_MS;
+  bool confirmando = false;
+  unsigned long inicioConfirmacao = 0;
+  bool modoAuto = true;
+  bool modoNoturno = false;
+  Avisos avisos;
+
+  void setModoAuto() { modoAuto = true; avisos.modo++; }
+  void setModoNormal() { modoAuto = false; modoNoturno = false; avisos.modo++; }
+  void setModoNoturno() { modoAuto = false; modoNoturno = true; avisos.modo++; }
+
+  void passada(int luminosidade)
+  {
+    if (!modoAuto) return;
+    bool cruzou = modoNoturno ? luminosidade > limiteSair : luminosidade < limiteEntrar;
+    if (!cruzou)
+    {
+      confirmando = false;
+      return;
+    }
+    unsigned long agora = millis();
+    if (!confirmando)
+    {
+      confirmando = true;
+      inicioConfirmacao = agora;
+    }
+    if (agora - inicioConfirmacao < confirmacaoMs) return;
+    confirmando = false;
+    modoNoturno = !modoNoturno;
+    (modoNoturno ? avisos.entradas : avisos.saidas)++;
+  }
+};
+
+// A tabela do .ino
+struct ContextoModo
+{
+  int luz = 0;
+  int limiteEntrar = LDR_LIMITE_NOTURNO;
+  int limiteSair = LDR_LIMITE_DIURNO;
+  unsigned long confirmacaoMs = LDR_CONFIRMACAO_MS;
+};
+
+enum EstadoModo : uint8_t {
+  ESTADO_OPERANDO,
+  ESTADO_AUTOMATICO,
+  ESTADO_AUTO_DIURNO,
+  ESTADO_DIA,
+  ESTADO_CONFIRMANDO_NOITE,
+  ESTADO_AUTO_NOTURNO,
+  ESTADO_NOITE,
+  ESTADO_CONFIRMANDO_DIA,
+  ESTADO_MANUAL,
+  ESTADO_MANUAL_NORMAL,
+  ESTADO_MANUAL_NOTURNO,
+  NUM_ESTADOS_MODO
+};
+
+enum EventoModo : uint8_t { EVENTO_AUTO, EVENTO_NORMAL, EVENTO_NOTURNO, EVENTO_LUZ };
+
+bool luzEscura(const ContextoModo &c) { return c.luz < c.limiteEntrar; }
+bool luzNaoEscura(const ContextoModo &c) { return !luzEscura(c); }
+bool luzClara(const ContextoModo &c) { return c.luz > c.limiteSair; }
+bool luzNaoClara(const ContextoModo &c) { return !luzClara(c); }
+uint32_t tempoConfirmacao(const ContextoModo &c) { return c.confirmacaoMs; }
+void avisarModo(ContextoModo &) { avisos.modo++; }
+void avisarEntradaNoturno(ContextoModo &) { avisos.entradas++; }
+void avisarSaidaNoturno(ContextoModo &) { avisos.saidas++; }
+
+constexpr EstadoDef<ContextoModo> ESTADOS_MODO[] = {
+    {MAQUINA_SEM_ESTADO, ESTADO_AUTOMATICO, nullptr, nullptr, "OPERANDO"},
+    {ESTADO_OPERANDO, ESTADO_AUTO_DIURNO, nullptr, nullptr, "AUTOMATICO"},
+    {ESTADO_AUTOMATICO, ESTADO_DIA, nullptr, nullptr, "AUTO_DIURNO"},
+    {ESTADO_AUTO_DIURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "DIA"},
+    {ESTADO_AUTO_DIURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "CONFIRMANDO_NOITE"},
+    {ESTADO_AUTOMATICO, ESTADO_NOITE, nullptr, nullptr, "AUTO_NOTURNO"},
+    {ESTADO_AUTO_NOTURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "NOITE"},
+    {ESTADO_AUTO_NOTURNO, MAQUINA_SEM_ESTADO, nullptr, nullptr, "CONFIRMANDO_DIA"},
+    {ESTADO_OPERANDO, ESTADO_MANUAL_NORMAL, nullptr, nullptr, "MANUAL"},
+    {ESTADO_MANUAL, MAQUINA_SEM_ESTADO, nullptr, nullptr, "MANUAL_NORMAL"},
+    {ESTADO_MANUAL, MAQUINA_SEM_ESTADO, nullptr, nullptr, "MANUAL_NOTURNO"},
+};
+
+constexpr TransicaoDef<ContextoModo> TRANSICOES_MODO[] = {
+    {ESTADO_OPERANDO, EVENTO_NORMAL, ESTADO_MANUAL_NORMAL, nullptr, avisarModo, nullptr},
+    {ESTADO_OPERANDO, EVENTO_NOTURNO, ESTADO_MANUAL_NOTURNO, nullptr, avisarModo, nullptr},
+    {ESTADO_AUTOMATICO, EVENTO_AUTO, MAQUINA_SEM_ESTADO, nullptr, avisarModo, nullptr},
+    {ESTADO_DIA, EVENTO_LUZ, ESTADO_CONFIRMANDO_NOITE, luzEscura, nullptr, nullptr},
+    {ESTADO_CONFIRMANDO_NOITE, EVENTO_LUZ, ESTADO_DIA, luzNaoEscura, nullptr, nullptr},
+    {ESTADO_CONFIRMANDO_NOITE, MAQUINA_EVENTO_TEMPO, ESTADO_AUTO_NOTURNO, nullptr, avisarEntradaNoturno, tempoConfirmacao},
+    {ESTADO_NOITE, EVENTO_LUZ, ESTADO_CONFIRMANDO_DIA, luzClara, nullptr, nullptr},
+    {ESTADO_CONFIRMANDO_DIA, EVENTO_LUZ, ESTADO_NOITE, luzNaoClara, nullptr, nullptr},
+    {ESTADO_CONFIRMANDO_DIA, MAQUINA_EVENTO_TEMPO, ESTADO_AUTO_DIURNO, nullptr, avisarSaidaNoturno, tempoConfirmacao},
+    {ESTADO_MANUAL_NORMAL, EVENTO_AUTO, ESTADO_AUTO_DIURNO, nullptr, avisarModo, nullptr},
+    {ESTADO_MANUAL_NOTURNO, EVENTO_AUTO, ESTADO_AUTO_NOTURNO, nullptr, avisarModo, nullptr},
+};
+
+constexpr TabelaEstados<ContextoModo, NUM_ESTADOS_MODO> TABELA_MODO = criarTabela(ESTADOS_MODO, TRANSICOES_MODO);
+static_assert(tabelaValida(TABELA_MODO), "Tabela do modo de operacao invalida");
+
+struct ModoMaquina
+{
+  ContextoModo ctx;
+  MaquinaEstados<ContextoModo, NUM_ESTADOS_MODO> modo{TABELA_MODO, ctx};
+
+  void passada(int luminosidade)
+  {
+    ctx.luz = luminosidade;
+    modo.despachar(EVENTO_LUZ, millis());
+    modo.atualizar(millis());
+  }
+  bool isModoAuto() const { return modo.esta(ESTADO_AUTOMATICO); }
+  bool isModoNoturno() const { return modo.esta(ESTADO_AUTO_NOTURNO) || modo.esta(ESTADO_MANUAL_NOTURNO); }
+};
+
+// Luminosidade filtrada: ciclo de 24 h entre ~600 e ~3400, nuvens e ruído
+struct LdrSimulado
+{
+  std::mt19937 rng{11};
+  std::normal_distribution<double> ruido{0.0, 25.0};
+  std::exponential_distribution<double> nuvem{1.0 / 600000.0};
+  uint64_t fimNuvem = 0;
+  uint64_t proximaNuvem = 0;
+
+  int ler(uint64_t ms)
+  {
+    const double dia = 2000.0 - 1400.0 * cos(2.0 * 3.14159265358979 * (double)(ms % 86400000ull) / 86400000.0);
+    if (ms >= proximaNuvem)
+    {
+      fimNuvem = ms + 5000 + (uint64_t)(nuvem(rng) / 20.0);
+      proximaNuvem = fimNuvem + (uint64_t)nuvem(rng);
+    }
+    return (int)(dia - (ms < fimNuvem ? 500.0 : 0.0) + ruido(rng));
+  }
+};
+
+static bool compararModo(const Opcoes &op)
+{
+  printf("Ponderada04: modo na maquina x histerese antiga (%.1f h simuladas)\n", op.horas);
+  HistereseAntiga antiga;
+  ModoMaquina nova;
+  LdrSimulado ldr;
+  std::mt19937 rng(3);
+  std::exponential_distribution<double> comando(1.0 / 1800000.0);  // ~1 comando a cada 30 min
+  std::uniform_int_distribution<int> qual(0, 2);
+
+  agoraMs = 0xFFFFFFFFu - 30000u;
+  nova.modo.iniciar(millis());
+  const uint64_t fimMs = (uint64_t)(op.horas * 3600e3);
+  uint64_t proximoComando = (uint64_t)comando(rng);
+  uint64_t divergencias = 0;
+  uint32_t comandos = 0;
+  avisos = Avisos();
+  for (uint64_t ms = 0; ms < fimMs; ms++)
+  {
+    agoraMs = (0xFFFFFFFFu - 30000u) + (uint32_t)ms;
+    if (ms >= proximoComando)
+    {
+      const int c = qual(rng);
+      if (c == 0) { antiga.setModoAuto(); nova.modo.despachar(EVENTO_AUTO, millis()); }
+      if (c == 1) { antiga.setModoNormal(); nova.modo.despachar(EVENTO_NORMAL, millis()); }
+      if (c == 2) { antiga.setModoNoturno(); nova.modo.despachar(EVENTO_NOTURNO, millis()); }
+      comandos++;
+      proximoComando = ms + 1 + (uint64_t)comando(rng);
+    }
+    const int luz = ldr.ler(ms);
+    antiga.passada(luz);
+    nova.passada(luz);
+    if (antiga.modoAuto != nova.isModoAuto() || antiga.modoNoturno != nova.isModoNoturno())
+    {
+      if (divergencias == 0)
+      {
+        printf("  ✗ Modo diferente em t=%llu ms (luz %d, estado %s)\n", (unsigned long long)ms, luz, nova.modo.nome());
+      }
+      divergencias++;
+    }
+  }
+  const bool avisosIguais = antiga.avisos.modo == avisos.modo && antiga.avisos.entradas == avisos.entradas &&
+                            antiga.avisos.saidas == avisos.saidas;
+  printf("  %u comandos, %u entradas e %u saidas do noturno pela histerese, %u transicoes da maquina\n", comandos,
+         avisos.entradas, avisos.saidas, nova.modo.getTransicoes());
+  printf("  %s Passadas com modo diferente: %llu, avisos %s\n\n", divergencias == 0 && avisosIguais ? "✓" : "✗",
+         (unsigned long long)divergencias, avisosIguais ? "iguais" : "diferentes");
+  return divergencias == 0 && avisosIguais;
+}
+
+// ==================== 4. Custo ====================
+
+template <typename F>
+static double nsPorPassada(uint64_t passadas, F &&passada)
+{
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < passadas; i++)
+  {
+    agoraMs = (uint32_t)(i / 20);  // 20 passadas por ms, como um loop() ocioso
+    passada(i);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / passadas;
+}
+
+static void medirCusto(const Opcoes &op)
+{
+  printf("Custo por passada do loop() (%llu passadas, 20 por ms simulado)\n", (unsigned long long)op.passadas);
+  Led leds[6];
+  TrafficLightSwitch a(&leds[0], &leds[1], &leds[2], 4000, 2000, 6000);
+  TrafficLight b(&leds[3], &leds[4], &leds[5], 4000, 2000, 6000);
+  agoraMs = 0;
+  a.begin();
+  b.begin();
+  const double nsSwitch = nsPorPassada(op.passadas, [&](uint64_t) { a.update(); });
+  const double nsMaquina = nsPorPassada(op.passadas, [&](uint64_t) { b.update(); });
+  printf("  Ponderada03 update():  switch %6.2f ns, maquina %6.2f ns\n", nsSwitch, nsMaquina);
+
+  // Luz que atravessa o limite a cada 1,5 s (metade confirma, metade não)
+  auto luz = [](uint64_t i) { return (i / 30000) % 3 == 0 ? 1500 : 2500; };
+  HistereseAntiga antiga;
+  ModoMaquina nova;
+  nova.modo.iniciar(0);
+  const double nsAntiga = nsPorPassada(op.passadas, [&](uint64_t i) { antiga.passada(luz(i)); });
+  const double nsNova = nsPorPassada(op.passadas, [&](uint64_t i) { nova.passada(luz(i)); });
+  printf("  Ponderada04 histerese: antiga %6.2f ns, maquina %6.2f ns (despacho + temporizadas)\n", nsAntiga, nsNova);
+
+  uint8_t eventos[] = {EVENTO_NORMAL, EVENTO_AUTO, EVENTO_NOTURNO, EVENTO_AUTO};
+  const double nsComando = nsPorPassada(op.passadas / 4, [&](uint64_t i) { nova.modo.despachar(eventos[i & 3], 0); });
+  printf("  Comando de modo (sai e entra em 2 a 3 niveis): %6.2f ns\n", nsComando);
+
+  printf("  sizeof: MaquinaEstados P03 %zu B, P04 %zu B (RAM); tabelas P03 %zu B, P04 %zu B (flash)\n",
+         sizeof(MaquinaEstados<TrafficLight, NUM_TRAFFIC_STATES>), sizeof(MaquinaEstados<ContextoModo, NUM_ESTADOS_MODO>),
+         sizeof(TRAFFIC_STATES) + sizeof(TRAFFIC_TRANSITIONS), sizeof(ESTADOS_MODO) + sizeof(TRANSICOES_MODO));
+  printf("  (ponteiros de 64 bits no PC; no ESP32 as tabelas ocupam cerca de metade)\n\n");
+}
+
+int main(int argc, char **argv)
+{
+  Opcoes op;
+  for (int i = 1; i < argc; i++)
+  {
+    const bool temValor = i + 1 < argc;
+    if (!strcmp(argv[i], "--horas") && temValor)
+      op.horas = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--passadas") && temValor)
+      op.passadas = strtoull(argv[++i], nullptr, 10);
+    else
+    {
+      fprintf(stderr, "Uso: %s [--horas H] [--passadas N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (op.horas <= 0 || op.passadas == 0)
+  {
+    fprintf(stderr, "--horas e --passadas precisam ser positivos\n");
+    return 2;
+  }
+
+  const unsigned long antes = alocacoes;
+  bool ok = conferirOrdem();
+  ok = compararSemaforo(op) && ok;
+  ok = compararModo(op) && ok;
+  medirCusto(op);
+  const unsigned long heap = alocacoes - antes;
+  printf("%s Alocacoes no heap: %lu\n", heap == 0 ? "✓" : "✗", heap);
+  return ok && heap == 0 ? 0 : 1;
+}
@@ -0,0 +1,391 @@
+#ifndef MAQUINA_ESTADOS_H
+#define MAQUINA_ESTADOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Máquina de estados hierárquica, não bloqueante e dirigida por tabela.
+//
+// Os estados e as transições são vetores constexpr. Cada estado tem um pai
+// (os estados compostos agrupam transições comuns aos filhos), um filho
+// inicial e ações de entrada e saída. Cada transição tem um evento, uma
+// guarda, uma ação e um destino. O evento MAQUINA_EVENTO_TEMPO é o das
+// transições temporizadas: disparam sozinhas quando o estado de origem está
+// ativo há apos(ctx) ms, conferido em atualizar(). O destino
+// MAQUINA_SEM_ESTADO faz uma transição interna: roda só a ação, sem sair
+// nem entrar em nenhum estado.
+//
+// Um evento é tratado pelo estado ativo mais profundo que tiver uma
+// transição para ele com a guarda verdadeira. Se nenhum tiver, o evento sobe
+// para o pai, e assim até a raiz. Numa transição externa, a máquina sai dos
+// estados ativos até o ancestral comum de origem e destino (de baixo para
+// cima), roda a ação e entra até o destino (de cima para baixo), descendo
+// pelos filhos iniciais até uma folha. Origem igual ao destino sai e entra
+// de novo, o que reinicia o tempo do estado.
+//
+// Não usa heap: a tabela fica na flash e a máquina guarda só o caminho
+// ativo e o instante de entrada em cada nível. As regras da tabela são
+// conferidas em tempo de compilação (static_assert com tabelaValida()).
+// Não depende do Arduino: o tempo chega por parâmetro e as ações recebem o
+// contexto, o que permite rodar a mesma tabela no PC (veja extras/host/).
+
+#define MAQUINA_SEM_ESTADO 0xFF
+#define MAQUINA_EVENTO_TEMPO 0xFF
+#define MAQUINA_MAX_PROFUNDIDADE 8
+
+template <typename C>
+struct EstadoDef
+{
+  uint8_t pai;            // MAQUINA_SEM_ESTADO na raiz
+  uint8_t inicial;        // Filho em que a entrada continua; MAQUINA_SEM_ESTADO nas folhas
+  void (*entrada)(C &);   // nullptr = sem ação
+  void (*saida)(C &);
+  const char *nome;
+};
+
+template <typename C>
+struct TransicaoDef
+{
+  uint8_t origem;
+  uint8_t evento;                  // MAQUINA_EVENTO_TEMPO nas temporizadas
+  uint8_t destino;                 // MAQUINA_SEM_ESTADO = interna
+  bool (*guarda)(const C &);       // nullptr = sempre
+  void (*acao)(C &);
+  uint32_t (*apos)(const C &);     // Só nas temporizadas: ms no estado de origem
+};
+
+template <typename C, size_t NE>
+struct TabelaEstados
+{
+  const EstadoDef<C> *estados;
+  const TransicaoDef<C> *transicoes;
+  uint8_t numTransicoes;
+};
+
+template <typename C, size_t NE, size_t NT>
+constexpr TabelaEstados<C, NE> criarTabela(const EstadoDef<C> (&estados)[NE], const TransicaoDef<C> (&transicoes)[NT])
+{
+  static_assert(NE > 0 && NE < MAQUINA_SEM_ESTADO, "Tabela precisa de 1 a 254 estados");
+  static_assert(NT < 256, "No máximo 255 transições");
+  return TabelaEstados<C, NE>{estados, transicoes, (uint8_t)NT};
+}
+
+// ---- Verificações da tabela (constexpr) ----
+
+// Profundidade de um estado (0 na raiz), ou -1 se a cadeia de pais sai da
+// tabela, tem ciclo ou passa de MAQUINA_MAX_PROFUNDIDADE
+template <typename C, size_t NE>
+constexpr int profundidadeEstado(const TabelaEstados<C, NE> &tabela, uint8_t estado)
+{
+  int nivel = 0;
+  while (tabela.estados[estado].pai != MAQUINA_SEM_ESTADO)
+  {
+    estado = tabela.estados[estado].pai;
+    if (estado >= NE || ++nivel >= MAQUINA_MAX_PROFUNDIDADE)
+    {
+      return -1;
+    }
+  }
+  return nivel;
+}
+
+// Uma raiz só, e todo estado chega nela
+template <typename C, size_t NE>
+constexpr bool hierarquiaValida(const TabelaEstados<C, NE> &tabela)
+{
+  int raizes = 0;
+  for (size_t e = 0; e < NE; e++)
+  {
+    if (profundidadeEstado(tabela, (uint8_t)e) < 0)
+    {
+      return false;
+    }
+    raizes += tabela.estados[e].pai == MAQUINA_SEM_ESTADO ? 1 : 0;
+  }
+  return raizes == 1;
+}
+
+// Estado com filhos tem um filho inicial, e o inicial é filho dele
+template <typename C, size_t NE>
+constexpr bool iniciaisValidos(const TabelaEstados<C, NE> &tabela)
+{
+  for (size_t e = 0; e < NE; e++)
+  {
+    bool temFilhos = false;
+    for (size_t f = 0; f < NE; f++)
+    {
+      temFilhos = temFilhos || tabela.estados[f].pai == e;
+    }
+    const uint8_t inicial = tabela.estados[e].inicial;
+    if (temFilhos != (inicial != MAQUINA_SEM_ESTADO))
+    {
+      return false;
+    }
+    if (inicial != MAQUINA_SEM_ESTADO && (inicial >= NE || tabela.estados[inicial].pai != e))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Estados dentro da tabela, temporizadas com apos(), e as transições de cada
+// origem juntas (a máquina indexa a tabela por origem)
+template <typename C, size_t NE>
+constexpr bool transicoesValidas(const TabelaEstados<C, NE> &tabela)
+{
+  for (uint8_t t = 0; t < tabela.numTransicoes; t++)
+  {
+    const TransicaoDef<C> &tr = tabela.transicoes[t];
+    if (tr.origem >= NE || (tr.destino != MAQUINA_SEM_ESTADO && tr.destino >= NE))
+    {
+      return false;
+    }
+    if ((tr.evento == MAQUINA_EVENTO_TEMPO) != (tr.apos != nullptr))
+    {
+      return false;
+    }
+    for (uint8_t antes = 0; t > 0 && tabela.transicoes[t - 1].origem != tr.origem && antes + 1 < t; antes++)
+    {
+      if (tabela.transicoes[antes].origem == tr.origem)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename C, size_t NE>
+constexpr bool tabelaValida(const TabelaEstados<C, NE> &tabela)
+{
+  return hierarquiaValida(tabela) && iniciaisValidos(tabela) && transicoesValidas(tabela);
+}
+
+// ---- Máquina ----
+
+template <typename C, size_t NE>
+class MaquinaEstados
+{
+public:
+  // Os vetores da tabela precisam existir enquanto a máquina existir
+  // (normalmente são constexpr globais). Nada roda até iniciar()
+  MaquinaEstados(const TabelaEstados<C, NE> &tabelaRef, C &contexto) : tabela(tabelaRef), ctx(contexto)
+  {
+    for (size_t e = 0; e < NE; e++)
+    {
+      profundidade[e] = (uint8_t)profundidadeEstado(tabela, (uint8_t)e);
+    }
+    // Faixa de transições de cada origem (as de uma origem estão juntas)
+    for (uint8_t t = 0; t < tabela.numTransicoes; t++)
+    {
+      const uint8_t origem = tabela.transicoes[t].origem;
+      if (inicio[origem] == fim[origem])
+      {
+        inicio[origem] = t;
+      }
+      fim[origem] = t + 1;
+      eventos[origem] |= bitEvento(tabela.transicoes[t].evento);
+      temporizado[origem] = temporizado[origem] || tabela.transicoes[t].evento == MAQUINA_EVENTO_TEMPO;
+    }
+  }
+
+  // Entra na raiz e desce pelos filhos iniciais
+  void iniciar(uint32_t agora)
+  {
+    uint8_t raiz = 0;
+    while (tabela.estados[raiz].pai != MAQUINA_SEM_ESTADO)
+    {
+      raiz = tabela.estados[raiz].pai;
+    }
+    nivel = 0;
+    ativo[0] = raiz;
+    desde[0] = agora;
+    entrar(raiz);
+    descer(agora);
+    iniciada = true;
+    recalcularAtivos();
+  }
+
+  // Trata um evento (não chamar de dentro de uma ação). Retorna true se
+  // alguma transição, interna ou externa, tratou o evento
+  bool despachar(uint8_t evento, uint32_t agora)
+  {
+    // Nenhum estado ativo trata o evento: nem percorre a tabela
+    if (!iniciada || (eventosAtivos & bitEvento(evento)) == 0)
+    {
+      return false;
+    }
+    for (int n = nivel; n >= 0; n--)
+    {
+      const uint8_t estado = ativo[n];
+      if ((eventos[estado] & bitEvento(evento)) == 0)
+      {
+        continue;
+      }
+      for (uint8_t t = inicio[estado]; t < fim[estado]; t++)
+      {
+        const TransicaoDef<C> &tr = tabela.transicoes[t];
+        if (tr.evento == evento && (tr.guarda == nullptr || tr.guarda(ctx)))
+        {
+          disparar(tr, agora);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // Confere as transições temporizadas dos estados ativos (a mais profunda
+  // vence). No máximo uma por chamada; retorna true se disparou
+  bool atualizar(uint32_t agora)
+  {
+    if (!iniciada || niveisTemporizados == 0)
+    {
+      return false;
+    }
+    for (int n = nivel; n >= 0; n--)
+    {
+      const uint8_t estado = ativo[n];
+      if ((niveisTemporizados & (1u << n)) == 0)
+      {
+        continue;
+      }
+      const uint32_t decorrido = agora - desde[n];
+      for (uint8_t t = inicio[estado]; t < fim[estado]; t++)
+      {
+        const TransicaoDef<C> &tr = tabela.transicoes[t];
+        if (tr.evento == MAQUINA_EVENTO_TEMPO && decorrido >= tr.apos(ctx) &&
+            (tr.guarda == nullptr || tr.guarda(ctx)))
+        {
+          disparar(tr, agora);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // true se o estado está ativo (a folha atual ou um ancestral dela)
+  bool esta(uint8_t estado) const
+  {
+    return iniciada && profundidade[estado] <= nivel && ativo[profundidade[estado]] == estado;
+  }
+
+  uint8_t getEstado() const { return ativo[nivel]; }
+  const char *nome() const { return tabela.estados[ativo[nivel]].nome; }
+  uint32_t getTempoNoEstado(uint32_t agora) const { return agora - desde[nivel]; }
+  uint32_t getTransicoes() const { return transicoes; }
+
+private:
+  const TabelaEstados<C, NE> tabela;
+  C &ctx;
+  uint8_t profundidade[NE];
+  uint8_t inicio[NE] = {};
+  uint8_t fim[NE] = {};
+  uint32_t eventos[NE] = {};   // Eventos com transição em cada estado (bitEvento)
+  bool temporizado[NE] = {};
+  uint32_t eventosAtivos = 0;  // União de eventos[] no caminho ativo
+  uint8_t niveisTemporizados = 0;
+  uint8_t ativo[MAQUINA_MAX_PROFUNDIDADE] = {};
+  uint32_t desde[MAQUINA_MAX_PROFUNDIDADE] = {};
+  uint8_t nivel = 0;
+  bool iniciada = false;
+  uint32_t transicoes = 0;
+
+  // Um bit por evento até 30; os demais (e o de tempo) dividem o bit 31
+  static uint32_t bitEvento(uint8_t evento) { return evento < 31 ? 1u << evento : 1u << 31; }
+
+  // Só quando o caminho ativo muda; as passadas sem troca usam o resultado
+  void recalcularAtivos()
+  {
+    eventosAtivos = 0;
+    niveisTemporizados = 0;
+    for (int n = 0; n <= nivel; n++)
+    {
+      eventosAtivos |= eventos[ativo[n]];
+      niveisTemporizados |= temporizado[ativo[n]] ? (uint8_t)(1u << n) : 0;
+    }
+  }
+
+  void entrar(uint8_t estado)
+  {
+    if (tabela.estados[estado].entrada != nullptr)
+    {
+      tabela.estados[estado].entrada(ctx);
+    }
+  }
+
+  void sair(uint8_t estado)
+  {
+    if (tabela.estados[estado].saida != nullptr)
+    {
+      tabela.estados[estado].saida(ctx);
+    }
+  }
+
+  // Entra nos filhos iniciais até chegar numa folha
+  void descer(uint32_t agora)
+  {
+    while (tabela.estados[ativo[nivel]].inicial != MAQUINA_SEM_ESTADO)
+    {
+      const uint8_t filho = tabela.estados[ativo[nivel]].inicial;
+      nivel++;
+      ativo[nivel] = filho;
+      desde[nivel] = agora;
+      entrar(filho);
+    }
+  }
+
+  void disparar(const TransicaoDef<C> &tr, uint32_t agora)
+  {
+    transicoes++;
+    if (tr.destino == MAQUINA_SEM_ESTADO)
+    {
+      if (tr.acao != nullptr)
+      {
+        tr.acao(ctx);
+      }
+      return;
+    }
+
+    // Caminho da raiz até o destino
+    const int nivelOrigem = profundidade[tr.origem];
+    const int nivelDestino = profundidade[tr.destino];
+    uint8_t caminho[MAQUINA_MAX_PROFUNDIDADE];
+    uint8_t e = tr.destino;
+    for (int n = nivelDestino; n >= 0; n--)
+    {
+      caminho[n] = e;
+      e = tabela.estados[e].pai;
+    }
+
+    // Ancestral comum mais profundo, acima da origem e do destino (-1 = sai
+    // até da raiz)
+    int comum = -1;
+    for (int n = 0; n < nivelOrigem && n < nivelDestino && ativo[n] == caminho[n]; n++)
+    {
+      comum = n;
+    }
+
+    for (int n = nivel; n > comum; n--)
+    {
+      sair(ativo[n]);
+    }
+    if (tr.acao != nullptr)
+    {
+      tr.acao(ctx);
+    }
+    for (int n = comum + 1; n <= nivelDestino; n++)
+    {
+      nivel = (uint8_t)n;
+      ativo[n] = caminho[n];
+      desde[n] = agora;
+      entrar(caminho[n]);
+    }
+    descer(agora);
+    recalcularAtivos();
+  }
+};
+
+#endif // MAQUINA_ESTADOS_H
@@ -0,0 +1,305 @@
+#ifndef PERSON_DETECTOR_H
+#define PERSON_DETECTOR_H
+
+#include <Arduino.h>
+#include <math.h>
+#include <JpegLuma.h>
+#include "esp_camera.h"
+#include "person_model_data.h"
+
+// No ESP32-S3 as convoluções podem usar as instruções SIMD via esp-nn
+// (biblioteca da Espressif). Ative com -DPERSON_DETECTOR_USE_ESP_NN=1.
+#if PERSON_DETECTOR_USE_ESP_NN && __has_include(<esp_nn.h>)
+#include <esp_nn.h>
+#define PERSON_DETECTOR_ESP_NN 1
+#else
+#define PERSON_DETECTOR_ESP_NN 0
+#endif
+
+// Detector de pessoas embarcado (classificador int8 de 96x96 em tons de cinza).
+// Roda o modelo de person_model_data.h sobre o frame da câmera e devolve a
+// probabilidade de haver uma pessoa, sem ida e volta pela rede (~150 ms no ESP32).
+//
+// Arquitetura: 4 x Conv 3x3 stride 2 + ReLU (8, 16, 32, 32 canais), média global
+// e camada densa com um logit. Ativações int8 com zero point -128 e pesos
+// simétricos por canal, como no TFLite. Treine e exporte com
+// Esp32S-CAM/person_model_tool.py; a função int8_forward() do script é a
+// referência deste kernel. Usado pelos dois firmwares da ESP32-CAM
+// (Esp32S-CAM e esp32cam-gemini).
+class PersonDetector
+{
+public:
+  static const int INPUT_SIZE = 96;
+
+  ~PersonDetector()
+  {
+    free(bufferA);
+    free(bufferB);
+  }
+
+  // Aloca a área de trabalho. Retorna false se o modelo não foi treinado.
+  bool begin()
+  {
+    if (!PERSON_MODEL_TRAINED)
+    {
+      Serial.println("[Person] Modelo não treinado (person_model_data.h vazio). Gere com person_model_tool.py.");
+      return false;
+    }
+
+    if (bufferA == nullptr)
+    {
+      bufferA = (int8_t *)allocate(ARENA_SIZE);
+      bufferB = (int8_t *)allocate(ARENA_SIZE);
+    }
+    ready = bufferA != nullptr && bufferB != nullptr;
+    if (!ready)
+    {
+      Serial.println("[Person] Falha ao alocar memória do detector");
+    }
+    return ready;
+  }
+
+  bool isReady() const
+  {
+    return ready;
+  }
+
+  unsigned long getLastInferenceMs() const
+  {
+    return lastInferenceMs;
+  }
+
+  // Probabilidade (0-1) de haver uma pessoa no frame JPEG. Negativo em erro.
+  float detect(camera_fb_t *fb)
+  {
+    if (!ready || fb == nullptr || fb->format != PIXFORMAT_JPEG || fb->width == 0 || fb->height == 0)
+    {
+      return -1.0f;
+    }
+
+    const unsigned long start = millis();
+    LumaFrame luma;
+    float score = -1.0f;
+    if (luma.decode(fb, inputScale(fb)))
+    {
+      score = detect(luma);
+    }
+    lastInferenceMs = millis() - start;
+    return score;
+  }
+
+  // Mesmo que detect(fb), sobre um frame já decodificado (ex.: compartilhado
+  // com outros consumidores do mesmo evento). Qualquer escala serve; a de
+  // inputScale() é a mais barata que cobre 96x96.
+  float detect(const LumaFrame &luma)
+  {
+    if (!ready || !luma.isValid())
+    {
+      return -1.0f;
+    }
+
+    const unsigned long start = millis();
+    cropToInput(luma, (uint8_t *)bufferB);
+    const float score = run((const uint8_t *)bufferB);
+    lastInferenceMs = millis() - start;
+    return score;
+  }
+
+  // Menor escala de decodificação que ainda cobre 96x96
+  static uint8_t inputScale(const camera_fb_t *fb)
+  {
+    return LumaFrame::scaleCovering(fb->width, fb->height, INPUT_SIZE);
+  }
+
+  // Executa o modelo sobre uma imagem 96x96 em tons de cinza (0-255).
+  // A entrada pode estar em bufferB: ela é convertida para int8 em bufferA.
+  float run(const uint8_t *gray)
+  {
+    if (!ready)
+    {
+      return -1.0f;
+    }
+
+    for (int i = 0; i < INPUT_SIZE * INPUT_SIZE; i++)
+    {
+      bufferA[i] = (int8_t)(gray[i] - 128);
+    }
+
+    int8_t *in = bufferA;
+    int8_t *out = bufferB;
+    int size = INPUT_SIZE;
+    for (const PersonConvLayerData &layer : PERSON_CONV_LAYERS)
+    {
+      conv3x3s2(in, size, size, layer, out);
+      size = (size + 1) / 2;
+      int8_t *tmp = in;
+      in = out;
+      out = tmp;
+    }
+
+    // Média global + camada densa: soma de (x - zero point) por canal
+    const int channels = PERSON_CONV_LAYERS[3].outChannels;
+    const int pixels = size * size;
+    int32_t acc = 0;
+    for (int c = 0; c < channels; c++)
+    {
+      int32_t sum = 0;
+      for (int i = 0; i < pixels; i++)
+      {
+        sum += in[i * channels + c] - ACT_ZERO_POINT;
+      }
+      acc += sum * PERSON_FC_WEIGHTS[c];
+    }
+
+    const float logit = acc * PERSON_FC_SCALE + PERSON_FC_BIAS;
+    return 1.0f / (1.0f + expf(-logit));
+  }
+
+private:
+  static const int ACT_ZERO_POINT = -128;
+  static const size_t ARENA_SIZE = (INPUT_SIZE / 2) * (INPUT_SIZE / 2) * 8; // Maior ativação (48x48x8)
+  static const int MAX_PATCH = 9 * 32;
+
+  int8_t *bufferA = nullptr;
+  int8_t *bufferB = nullptr;
+  int16_t patch[MAX_PATCH];
+  bool ready = false;
+  unsigned long lastInferenceMs = 0;
+
+  static void *allocate(size_t size)
+  {
+    return psramFound() ? ps_malloc(size) : malloc(size);
+  }
+
+  // Recorte central quadrado com redução por média de área para 96x96.
+  // Com o recorte menor que 96 px, cada pixel de saída pega pelo menos um
+  // pixel de entrada (vizinho mais próximo) em vez de uma área vazia.
+  static void cropToInput(const LumaFrame &luma, uint8_t *gray)
+  {
+    const uint16_t w = luma.width();
+    const uint16_t h = luma.height();
+    const uint16_t side = min(w, h);
+    const uint16_t x0 = (w - side) / 2;
+    const uint16_t y0 = (h - side) / 2;
+
+    for (int oy = 0; oy < INPUT_SIZE; oy++)
+    {
+      const int sy0 = y0 + oy * side / INPUT_SIZE;
+      const int sy1 = y0 + (oy + 1) * side / INPUT_SIZE;
+      for (int ox = 0; ox < INPUT_SIZE; ox++)
+      {
+        const int sx0 = x0 + ox * side / INPUT_SIZE;
+        const int sx1 = x0 + (ox + 1) * side / INPUT_SIZE;
+        gray[oy * INPUT_SIZE + ox] = luma.mean(sx0, sy0, sx1, sy1);
+      }
+    }
+  }
+
+  // Requantização do acumulador int32: acc * mult (Q31) * 2^shift com arredondamento
+  static inline int32_t requantize(int32_t acc, int32_t mult, int32_t shift)
+  {
+    const int total = 31 - shift;
+    const int64_t v = (int64_t)acc * mult + ((int64_t)1 << (total - 1));
+    return (int32_t)(v >> total);
+  }
+
+  static inline int32_t dot(const int16_t *a, const int8_t *b, int len)
+  {
+    int32_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    int i = 0;
+    for (; i + 4 <= len; i += 4)
+    {
+      acc0 += a[i] * b[i];
+      acc1 += a[i + 1] * b[i + 1];
+      acc2 += a[i + 2] * b[i + 2];
+      acc3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < len; i++)
+    {
+      acc0 += a[i] * b[i];
+    }
+    return acc0 + acc1 + acc2 + acc3;
+  }
+
+  // Conv 3x3, stride 2, padding 'same' (só embaixo/à direita para entrada par), ReLU.
+  // Layout HWC. Para cada pixel de saída o patch 3x3xC é montado uma vez em int16
+  // com o zero point já removido e reaproveitado por todos os canais de saída.
+  void conv3x3s2(const int8_t *in, int inH, int inW, const PersonConvLayerData &layer, int8_t *out)
+  {
+    const int inC = layer.inChannels;
+    const int outC = layer.outChannels;
+    const int outH = (inH + 1) / 2;
+    const int outW = (inW + 1) / 2;
+
+#if PERSON_DETECTOR_ESP_NN
+    data_dims_t inputDims = {inW, inH, inC, 1};
+    data_dims_t filterDims = {3, 3, inC, outC};
+    data_dims_t outputDims = {outW, outH, outC, 1};
+    conv_params_t params = {};
+    params.in_offset = -ACT_ZERO_POINT;
+    params.out_offset = ACT_ZERO_POINT;
+    params.stride.width = params.stride.height = 2;
+    params.dilation.width = params.dilation.height = 1;
+    params.activation.min = ACT_ZERO_POINT;
+    params.activation.max = 127;
+    quant_data_t quant = {(int32_t *)layer.shift, (int32_t *)layer.mult};
+    static void *scratch = nullptr;
+    static int scratchSize = 0;
+    const int needed = esp_nn_get_conv_scratch_size(&inputDims, &filterDims, &outputDims, &params);
+    if (needed > scratchSize)
+    {
+      free(scratch);
+      scratch = allocate(needed);
+      scratchSize = scratch ? needed : 0;
+    }
+    if (scratch != nullptr)
+    {
+      esp_nn_set_conv_scratch_buf(scratch);
+      esp_nn_conv_s8(&inputDims, in, &filterDims, layer.weights, layer.bias,
+                     &outputDims, out, &params, &quant);
+      return;
+    }
+#endif
+
+    const int patchLen = 9 * inC;
+    for (int oy = 0; oy < outH; oy++)
+    {
+      for (int ox = 0; ox < outW; ox++)
+      {
+        int16_t *p = patch;
+        for (int ky = 0; ky < 3; ky++)
+        {
+          const int iy = oy * 2 + ky;
+          for (int kx = 0; kx < 3; kx++)
+          {
+            const int ix = ox * 2 + kx;
+            if (iy < inH && ix < inW)
+            {
+              const int8_t *src = in + (iy * inW + ix) * inC;
+              for (int c = 0; c < inC; c++)
+              {
+                *p++ = src[c] - ACT_ZERO_POINT;
+              }
+            }
+            else
+            {
+              memset(p, 0, inC * sizeof(int16_t)); // Padding = zero real
+              p += inC;
+            }
+          }
+        }
+
+        const int8_t *w = layer.weights;
+        int8_t *dst = out + (oy * outW + ox) * outC;
+        for (int oc = 0; oc < outC; oc++, w += patchLen)
+        {
+          const int32_t acc = layer.bias[oc] + dot(patch, w, patchLen);
+          const int32_t v = requantize(acc, layer.mult[oc], layer.shift[oc]) + ACT_ZERO_POINT;
+          dst[oc] = (int8_t)constrain(v, ACT_ZERO_POINT, 127);
+        }
+      }
+    }
+  }
+};
+
+#endif // PERSON_DETECTOR_H
@@ -0,0 +1,32 @@
+// Modelo vazio: o detector embarcado fica desativado até que este arquivo seja
+// substituído pelo header gerado com `person_model_tool.py export` (um só
+// modelo para os dois firmwares da ESP32-CAM).
+#ifndef PERSON_MODEL_DATA_H
+#define PERSON_MODEL_DATA_H
+
+#include <stdint.h>
+
+#define PERSON_MODEL_TRAINED 0
+
+struct PersonConvLayerData
+{
+  uint8_t inChannels;
+  uint8_t outChannels;
+  const int8_t *weights; // [saída][ky][kx][entrada]
+  const int32_t *bias;
+  const int32_t *mult;   // Multiplicador Q31 por canal de saída
+  const int32_t *shift;  // Positivo = deslocamento à esquerda
+};
+
+static const PersonConvLayerData PERSON_CONV_LAYERS[4] = {
+  {1, 8, nullptr, nullptr, nullptr, nullptr},
+  {8, 16, nullptr, nullptr, nullptr, nullptr},
+  {16, 32, nullptr, nullptr, nullptr, nullptr},
+  {32, 32, nullptr, nullptr, nullptr, nullptr},
+};
+
+static const int8_t PERSON_FC_WEIGHTS[32] = {0};
+static const float PERSON_FC_SCALE = 0.0f;
+static const float PERSON_FC_BIAS = 0.0f;
+
+#endif // PERSON_MODEL_DATA_H
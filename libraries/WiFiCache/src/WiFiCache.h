@@ -0,0 +1,88 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <sys/time.h>
+
+#ifndef WIFI_CACHE_MAX_AGE_S
+#define WIFI_CACHE_MAX_AGE_S (6 * 3600)  // s - Refaz DHCP periodicamente para renovar o lease
+#endif
+
+// Dados da última associação bem-sucedida, guardados na RTC.
+//
+// Com canal + BSSID o driver pula a varredura de canais e com o IP do último
+// lease aplicado como estático pula o DHCP: após o deep sleep a conexão cai de
+// alguns segundos para algumas centenas de ms. O cache só vale para o mesmo
+// SSID/senha e expira em WIFI_CACHE_MAX_AGE_S (o roteador não sabe que o IP
+// continua em uso depois do lease; refazer o DHCP periodicamente o renova).
+// Usado pelos dois firmwares da ESP32-CAM (Esp32S-CAM e esp32cam-gemini).
+struct WiFiCache
+{
+  uint32_t magic;
+  uint32_t credentialsHash;
+  uint32_t savedAt;         // s no relógio do sistema (continua no deep sleep)
+  uint8_t bssid[6];
+  int32_t channel;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+
+  static const uint32_t MAGIC = 0x57494649; // "WIFI"
+
+  bool isValidFor(const char *ssid, const char *pass) const
+  {
+    return magic == MAGIC && credentialsHash == hashCredentials(ssid, pass) && ip != 0 &&
+           now() - savedAt < WIFI_CACHE_MAX_AGE_S;
+  }
+
+  // Chame logo após conectar com DHCP
+  void save(const char *ssid, const char *pass)
+  {
+    const uint8_t *current = WiFi.BSSID();
+    if (current == nullptr)
+    {
+      return;
+    }
+    memcpy(bssid, current, sizeof(bssid));
+    channel = WiFi.channel();
+    ip = (uint32_t)WiFi.localIP();
+    gateway = (uint32_t)WiFi.gatewayIP();
+    subnet = (uint32_t)WiFi.subnetMask();
+    dns = (uint32_t)WiFi.dnsIP();
+    credentialsHash = hashCredentials(ssid, pass);
+    savedAt = now();
+    magic = MAGIC;
+  }
+
+  void clear()
+  {
+    magic = 0;
+  }
+
+  // FNV-1a de "ssid\0senha": detecta troca de rede sem guardar a senha na RTC
+  static uint32_t hashCredentials(const char *ssid, const char *pass)
+  {
+    uint32_t hash = 2166136261u;
+    for (const char *p = ssid; *p; p++)
+    {
+      hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    hash = hash * 16777619u;
+    for (const char *p = pass; *p; p++)
+    {
+      hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    return hash;
+  }
+
+  static uint32_t now()
+  {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint32_t)tv.tv_sec;
+  }
+};
+
+#endif // WIFI_CACHE_H